@@ -152,6 +152,8 @@ std::vector<std::pair<std::string, std::string> > GetUsage()
   s.push_back(mp("-merge", "Merge next files"));
   s.push_back(mp("-open", "Open next files"));
   s.push_back(mp("-log filename", "Log all messages to filename"));
+  s.push_back(mp("-profile filename", "Write a per-phase profile (wall time and "
+                 "memory) of the run to filename, in JSON format"));
 #if defined(HAVE_FLTK)
   s.push_back(mp("-a, -g, -m, -s, -p", "Start in automatic, geometry, mesh, solver "
                  "or post-processing mode"));
@@ -460,6 +462,16 @@ void GetOptions(int argc, char *argv[], bool readConfigFiles, bool exitOnError)
           if(exitOnError) Msg::Exit(1);
         }
       }
+      else if(!strcmp(argv[i] + 1, "profile")) {
+        i++;
+        if(argv[i]){
+          Msg::SetProfileFileName(argv[i++]);
+        }
+        else{
+          Msg::Error("Missing filename");
+          if(exitOnError) Msg::Exit(1);
+        }
+      }
       else if(!strcmp(argv[i] + 1, "refine")) {
         CTX::instance()->batch = 5;
         i++;
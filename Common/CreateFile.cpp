@@ -275,6 +275,7 @@ void CreateOutputFile(const std::string &fileName, int format,
 {
   std::string name = fileName;
   if(name.empty()) name = GetDefaultFileName(format);
+  MsgProfile profile("Write " + name);
 
   int oldFormat = CTX::instance()->print.fileFormat;
   CTX::instance()->print.fileFormat = format;
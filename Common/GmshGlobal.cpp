@@ -241,6 +241,8 @@ int GmshWriteFile(const std::string &fileName)
 
 int GmshFinalize()
 {
+  Msg::PrintProfile();
+
 #if defined(HAVE_POST)
   // Delete all PViewData stored in static list of PView class
   while(PView::list.size() > 0) delete PView::list[PView::list.size() - 1];
@@ -19,6 +19,8 @@
 #include <string.h>
 #include <time.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <mutex>
 #include "GmshMessage.h"
 #include "GmshSocket.h"
 #include "GmshGlobal.h"
@@ -77,6 +79,7 @@ onelab::server *onelab::server::_server = 0;
 #endif
 std::string Msg::_logFileName;
 FILE *Msg::_logFile = 0;
+std::string Msg::_profileFileName;
 
 #if defined(_MSC_VER) && (_MSC_VER >= 1310) //NET 2003
 #define vsnprintf _vsnprintf
@@ -310,6 +313,8 @@ onelab::client *Msg::GetOnelabClient()
 
 void Msg::Exit(int level)
 {
+  PrintProfile();
+
   if(GModel::current())
     delete GModel::current();
 
@@ -818,6 +823,140 @@ void Msg::PrintTimers()
   }
 }
 
+// Tree of profiled phases: the phases are identified by their name and their
+// parent phase, and accumulate the wall time and the number of calls of all
+// the threads
+struct profilePhase {
+  std::string name;
+  std::map<std::string, int> children;
+  double wall;
+  long calls;
+  // largest growth of the peak resident memory during a call, and peak
+  // resident memory at the end of the last call
+  long memDelta, mem;
+  profilePhase(const std::string &n)
+    : name(n), wall(0.), calls(0), memDelta(0), mem(0)
+  {
+  }
+};
+
+struct profileFrame {
+  int phase;
+  double wall;
+  long mem;
+};
+
+static std::mutex _profileMutex;
+static std::vector<profilePhase> _profilePhases(1, profilePhase("Gmsh"));
+// current phase outside of parallel regions
+static int _profileSerialPhase = 0;
+// phases started (and not yet stopped) by the calling thread
+static thread_local std::vector<profileFrame> _profileStack;
+
+void Msg::SetProfileFileName(const std::string &name)
+{
+  _profileFileName = name;
+}
+
+void Msg::StartProfile(const std::string &name)
+{
+  profileFrame f;
+  {
+    std::lock_guard<std::mutex> lock(_profileMutex);
+    const int parent =
+      _profileStack.empty() ? _profileSerialPhase : _profileStack.back().phase;
+    std::map<std::string, int>::iterator it =
+      _profilePhases[parent].children.find(name);
+    if(it == _profilePhases[parent].children.end()) {
+      f.phase = _profilePhases.size();
+      _profilePhases[parent].children[name] = f.phase;
+      _profilePhases.push_back(profilePhase(name));
+    }
+    else
+      f.phase = it->second;
+    if(GetNumThreads() == 1 && !GetThreadNum()) _profileSerialPhase = f.phase;
+  }
+  f.mem = GetMemoryUsage();
+  f.wall = TimeOfDay();
+  _profileStack.push_back(f);
+}
+
+void Msg::StopProfile()
+{
+  if(_profileStack.empty()) return;
+  const double wall = TimeOfDay();
+  const long mem = GetMemoryUsage();
+  profileFrame f = _profileStack.back();
+  _profileStack.pop_back();
+  std::lock_guard<std::mutex> lock(_profileMutex);
+  profilePhase &p = _profilePhases[f.phase];
+  p.wall += wall - f.wall;
+  p.calls++;
+  p.memDelta = std::max(p.memDelta, mem - f.mem);
+  p.mem = mem;
+  if(GetNumThreads() == 1 && !GetThreadNum())
+    _profileSerialPhase = _profileStack.empty() ? 0 : _profileStack.back().phase;
+}
+
+static void writeProfilePhase(FILE *fp, int i, int indent)
+{
+  const profilePhase &p = _profilePhases[i];
+  std::string name;
+  for(std::size_t j = 0; j < p.name.size(); j++) {
+    if(p.name[j] == '"' || p.name[j] == '\\') name += '\\';
+    name += p.name[j];
+  }
+  std::string s(indent, ' ');
+  fprintf(fp, "%s{\"name\": \"%s\", \"calls\": %ld, \"wall\": %g, "
+          "\"memoryDelta\": %ld, \"memory\": %ld", s.c_str(), name.c_str(),
+          p.calls, p.wall, p.memDelta, p.mem);
+  if(p.children.size()) {
+    // children in the order of their first call
+    std::vector<int> children;
+    for(std::map<std::string, int>::const_iterator it = p.children.begin();
+        it != p.children.end(); it++)
+      children.push_back(it->second);
+    std::sort(children.begin(), children.end());
+    fprintf(fp, ",\n%s \"phases\": [\n", s.c_str());
+    for(std::size_t j = 0; j < children.size(); j++) {
+      writeProfilePhase(fp, children[j], indent + 2);
+      fprintf(fp, (j + 1 < children.size()) ? ",\n" : "\n");
+    }
+    fprintf(fp, "%s ]", s.c_str());
+  }
+  fprintf(fp, "}");
+}
+
+void Msg::PrintProfile()
+{
+  if(_profileFileName.empty()) return;
+  std::lock_guard<std::mutex> lock(_profileMutex);
+  // the root phase spans the whole run
+  profilePhase &root = _profilePhases[0];
+  root.wall = TimeOfDay() - _startTime;
+  root.calls = 1;
+  root.mem = root.memDelta = GetMemoryUsage();
+  std::string name = _profileFileName;
+  // the profile is written only once, by GmshFinalize() or Msg::Exit(),
+  // whichever comes first
+  _profileFileName.clear();
+  if(_commSize > 1) {
+    std::vector<std::string> split = SplitFileName(name);
+    char tmp[32];
+    sprintf(tmp, "_%d", GetCommRank());
+    name = split[0] + split[1] + tmp + split[2];
+  }
+  FILE *fp = Fopen(name.c_str(), "w");
+  if(!fp) {
+    Error("Unable to open file '%s'", name.c_str());
+    return;
+  }
+  writeProfilePhase(fp, 0, 0);
+  fprintf(fp, "\n");
+  fclose(fp);
+  Info("Wrote profile '%s'", name.c_str());
+}
+
 void Msg::ResetErrorCounter()
 {
   _warningCount = 0; _errorCount = 0;
@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <stdarg.h>
+#include <stdio.h>
 
 #include "GmshConfig.h"
 
@@ -65,6 +66,8 @@ private:
   // log file
   static std::string _logFileName;
   static FILE *_logFile;
+  // profile file (profiling is enabled if not empty)
+  static std::string _profileFileName;
 
 public:
   Msg() {}
@@ -108,6 +111,11 @@ public:
   static void SetInfoCpu(bool val);
   static double &Timer(const std::string &str);
   static void PrintTimers();
+  static void SetProfileFileName(const std::string &name);
+  static bool GetProfile() { return !_profileFileName.empty(); }
+  static void StartProfile(const std::string &name);
+  static void StopProfile();
+  static void PrintProfile();
   static void ResetErrorCounter();
   static void PrintErrorCounter(const char *title);
   static int GetWarningCount();
@@ -168,6 +176,37 @@ public:
   static void ImportPhysicalGroupsInOnelab();
 };
 
+// Profile the enclosing scope (wall time and growth of the peak resident
+// memory), as a phase nested in the current phase of the calling thread.
+// Phases started by the threads of a parallel region are nested in the phase
+// that was current when the region started. This does nothing if profiling is
+// disabled.
+class MsgProfile {
+private:
+  bool _on;
+
+public:
+  MsgProfile(const char *name, int tag = 0) : _on(Msg::GetProfile())
+  {
+    if(!_on) return;
+    if(tag) {
+      char tmp[256];
+      snprintf(tmp, sizeof(tmp), "%s %d", name, tag);
+      Msg::StartProfile(tmp);
+    }
+    else
+      Msg::StartProfile(name);
+  }
+  MsgProfile(const std::string &name) : _on(Msg::GetProfile())
+  {
+    if(_on) Msg::StartProfile(name);
+  }
+  ~MsgProfile()
+  {
+    if(_on) Msg::StopProfile();
+  }
+};
+
 // a class to print the progression and estimated remaining time
 class MsgProgressStatus {
 private:
@@ -0,0 +1,277 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <new>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <stdlib.h>
+#if defined(WIN32) && !defined(__CYGWIN__)
+#include <malloc.h>
+#endif
+#include "MemoryPool.h"
+
+namespace {
+
+  const std::size_t granularity = 16;
+  const std::size_t numClasses = MemoryPool::maxBlockSize / granularity;
+  // chunks are aligned on their size, so that the header of the chunk
+  // containing a block can be found from the address of the block
+  const std::size_t chunkSize = 1 << 16;
+  const std::size_t headerSize = 64;
+
+  struct freeBlock {
+    freeBlock *next;
+  };
+
+  struct threadCache;
+
+  struct chunkHeader {
+    threadCache *owner; // cache that carves blocks out of the chunk
+    std::size_t sizeClass;
+    std::size_t numFree; // only used by releaseUnused()
+  };
+  static_assert(sizeof(chunkHeader) <= headerSize, "chunk header too large");
+
+  // free lists and current chunk for each size class. A cache is used by one
+  // thread at a time: blocks freed by other threads are pushed (without
+  // locking) on its "remote" lists, and are recycled when its own free list
+  // is empty. The number of blocks allocated minus the number of blocks freed
+  // by the thread is only written by that thread. Caches are never destroyed:
+  // when a thread exits, its cache is handed over to the next new thread.
+  struct threadCache {
+    freeBlock *free[numClasses];
+    char *cur[numClasses], *end[numClasses];
+    std::atomic<freeBlock *> remote[numClasses];
+    std::atomic<long> inUse;
+    threadCache() : inUse(0)
+    {
+      for(std::size_t i = 0; i < numClasses; i++) {
+        free[i] = 0;
+        cur[i] = end[i] = 0;
+        remote[i].store(0);
+      }
+    }
+  };
+
+  // shared state; never destroyed, even when static objects are destroyed at
+  // exit
+  std::mutex *poolMutex = new std::mutex();
+  std::vector<char *> *chunks = new std::vector<char *>();
+  std::vector<threadCache *> *caches = new std::vector<threadCache *>();
+  std::vector<threadCache *> *idleCaches = new std::vector<threadCache *>();
+
+  thread_local threadCache *cache = 0;
+  thread_local bool cacheReleased = false;
+
+  struct cacheReleaser {
+    ~cacheReleaser()
+    {
+      if(!cache) return;
+      std::lock_guard<std::mutex> lock(*poolMutex);
+      idleCaches->push_back(cache);
+      cache = 0;
+      cacheReleased = true;
+    }
+  };
+
+  threadCache &getCache()
+  {
+    if(!cache) {
+      {
+        std::lock_guard<std::mutex> lock(*poolMutex);
+        if(idleCaches->size()) {
+          cache = idleCaches->back();
+          idleCaches->pop_back();
+        }
+        else {
+          cache = new threadCache();
+          caches->push_back(cache);
+        }
+      }
+      // give the cache back when the thread exits (unless the thread is
+      // already exiting)
+      if(!cacheReleased) {
+        static thread_local cacheReleaser releaser;
+        (void)releaser;
+      }
+    }
+    return *cache;
+  }
+
+  inline chunkHeader *getChunk(void *p)
+  {
+    return reinterpret_cast<chunkHeader *>(reinterpret_cast<uintptr_t>(p) &
+                                           ~(uintptr_t)(chunkSize - 1));
+  }
+
+  inline std::size_t getBlockSize(std::size_t c)
+  {
+    return (c + 1) * granularity;
+  }
+
+  inline std::size_t getNumBlocks(std::size_t c)
+  {
+    return (chunkSize - headerSize) / getBlockSize(c);
+  }
+
+  char *newChunk(threadCache *tc, std::size_t c)
+  {
+#if defined(WIN32) && !defined(__CYGWIN__)
+    void *p = _aligned_malloc(chunkSize, chunkSize);
+#else
+    void *p = 0;
+    if(posix_memalign(&p, chunkSize, chunkSize)) p = 0;
+#endif
+    if(!p) throw std::bad_alloc();
+    chunkHeader *h = static_cast<chunkHeader *>(p);
+    h->owner = tc;
+    h->sizeClass = c;
+    h->numFree = 0;
+    std::lock_guard<std::mutex> lock(*poolMutex);
+    chunks->push_back(static_cast<char *>(p));
+    return static_cast<char *>(p);
+  }
+
+  void deleteChunk(char *p)
+  {
+#if defined(WIN32) && !defined(__CYGWIN__)
+    _aligned_free(p);
+#else
+    ::free(p);
+#endif
+  }
+
+  inline void addInUse(threadCache &tc, long n)
+  {
+    tc.inUse.store(tc.inUse.load(std::memory_order_relaxed) + n,
+                   std::memory_order_relaxed);
+  }
+
+} // namespace
+
+void *MemoryPool::allocate(std::size_t size)
+{
+  if(!size || size > maxBlockSize) return ::operator new(size);
+  const std::size_t c = (size - 1) / granularity;
+  threadCache &tc = getCache();
+  addInUse(tc, 1);
+  if(!tc.free[c] && tc.remote[c].load(std::memory_order_relaxed))
+    tc.free[c] = tc.remote[c].exchange(0, std::memory_order_acquire);
+  if(tc.free[c]) {
+    freeBlock *b = tc.free[c];
+    tc.free[c] = b->next;
+    return b;
+  }
+  const std::size_t bs = getBlockSize(c);
+  if(tc.cur[c] + bs > tc.end[c]) {
+    tc.cur[c] = newChunk(&tc, c) + headerSize;
+    tc.end[c] = tc.cur[c] + getNumBlocks(c) * bs;
+  }
+  void *p = tc.cur[c];
+  tc.cur[c] += bs;
+  return p;
+}
+
+void MemoryPool::deallocate(void *p, std::size_t size)
+{
+  if(!p) return;
+  if(!size || size > maxBlockSize) {
+    ::operator delete(p);
+    return;
+  }
+  const std::size_t c = (size - 1) / granularity;
+  threadCache &tc = getCache();
+  addInUse(tc, -1);
+  freeBlock *b = static_cast<freeBlock *>(p);
+  threadCache *owner = getChunk(p)->owner;
+  if(owner == &tc) {
+    b->next = tc.free[c];
+    tc.free[c] = b;
+  }
+  else {
+    // the block goes back to the cache its chunk belongs to
+    freeBlock *head = owner->remote[c].load(std::memory_order_relaxed);
+    do {
+      b->next = head;
+    } while(!owner->remote[c].compare_exchange_weak(
+      head, b, std::memory_order_release, std::memory_order_relaxed));
+  }
+}
+
+bool MemoryPool::releaseUnused()
+{
+  std::lock_guard<std::mutex> lock(*poolMutex);
+
+  // count the free blocks (in the free lists, or not carved yet) of each chunk
+  for(std::size_t i = 0; i < chunks->size(); i++)
+    reinterpret_cast<chunkHeader *>((*chunks)[i])->numFree = 0;
+  for(std::size_t i = 0; i < caches->size(); i++) {
+    threadCache *tc = (*caches)[i];
+    for(std::size_t c = 0; c < numClasses; c++) {
+      freeBlock *r = tc->remote[c].exchange(0);
+      while(r) {
+        freeBlock *next = r->next;
+        r->next = tc->free[c];
+        tc->free[c] = r;
+        r = next;
+      }
+      for(freeBlock *b = tc->free[c]; b; b = b->next) getChunk(b)->numFree++;
+      if(tc->end[c])
+        getChunk(tc->end[c] - 1)->numFree +=
+          (tc->end[c] - tc->cur[c]) / getBlockSize(c);
+    }
+  }
+
+  // remove the blocks of the unused chunks from the caches
+  for(std::size_t i = 0; i < caches->size(); i++) {
+    threadCache *tc = (*caches)[i];
+    for(std::size_t c = 0; c < numClasses; c++) {
+      freeBlock **b = &tc->free[c];
+      while(*b) {
+        chunkHeader *h = getChunk(*b);
+        if(h->numFree == getNumBlocks(h->sizeClass))
+          *b = (*b)->next;
+        else
+          b = &(*b)->next;
+      }
+      if(tc->end[c]) {
+        chunkHeader *h = getChunk(tc->end[c] - 1);
+        if(h->numFree == getNumBlocks(h->sizeClass))
+          tc->cur[c] = tc->end[c] = 0;
+      }
+    }
+  }
+
+  // release the unused chunks
+  std::size_t n = 0;
+  for(std::size_t i = 0; i < chunks->size(); i++) {
+    chunkHeader *h = reinterpret_cast<chunkHeader *>((*chunks)[i]);
+    if(h->numFree == getNumBlocks(h->sizeClass))
+      deleteChunk((*chunks)[i]);
+    else
+      (*chunks)[n++] = (*chunks)[i];
+  }
+  bool released = (n != chunks->size());
+  chunks->resize(n);
+  if(!n) std::vector<char *>().swap(*chunks);
+  return released;
+}
+
+std::size_t MemoryPool::getNumBlocksInUse()
+{
+  std::lock_guard<std::mutex> lock(*poolMutex);
+  long n = 0;
+  for(std::size_t i = 0; i < caches->size(); i++)
+    n += (*caches)[i]->inUse.load(std::memory_order_relaxed);
+  return n;
+}
+
+std::size_t MemoryPool::getReservedMemory()
+{
+  std::lock_guard<std::mutex> lock(*poolMutex);
+  return chunks->size() * chunkSize;
+}
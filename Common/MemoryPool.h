@@ -0,0 +1,32 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <cstddef>
+
+// A slab allocator for small objects that are created and destroyed in large
+// numbers (mesh vertices and elements). Blocks are carved out of large chunks,
+// grouped by size class, and recycled through per-thread free lists, so that
+// allocation and deallocation never lock; blocks freed by another thread are
+// returned to the thread that owns their chunk. Chunks are only returned to
+// the system by releaseUnused(), once none of their blocks is in use anymore.
+class MemoryPool {
+public:
+  // objects larger than this are forwarded to the global operator new
+  static const std::size_t maxBlockSize = 256;
+  static void *allocate(std::size_t size);
+  static void deallocate(void *p, std::size_t size);
+  // free the chunks none of whose blocks is in use, and return true if any
+  // chunk was freed; this must not be called concurrently with allocate() or
+  // deallocate()
+  static bool releaseUnused();
+  // number of blocks in use, and memory (in bytes) reserved by the pool
+  static std::size_t getNumBlocksInUse();
+  static std::size_t getReservedMemory();
+};
+
+#endif
@@ -204,6 +204,8 @@ int ParseFile(const std::string &fileName, bool close, bool warnIfMissing)
   gmsh_yyerrorstate = 0;
   gmsh_yylineno = 1;
   gmsh_yyviewindex = 0;
+  // the loops of the file are cached separately from the ones of the caller
+  gmsh_yypushtokens();
 
   while(!feof(gmsh_yyin)) {
     gmsh_yyparse();
@@ -222,6 +224,7 @@ int ParseFile(const std::string &fileName, bool close, bool warnIfMissing)
   else {
     openedFiles.push_back(gmsh_yyin);
   }
+  gmsh_yypoptokens();
 
   gmsh_yyname = old_yyname;
   gmsh_yyin = old_yyin;
@@ -299,6 +302,8 @@ int MergeFile(const std::string &fileName, bool warnIfMissing,
               bool setBoundingBox, bool importPhysicalsInOnelab,
               int partitionToRead)
 {
+  MsgProfile profile("Read " + fileName);
+
   // added 'b' for pure Windows programs, since some of these files
   // contain binary data
   FILE *fp = Fopen(fileName.c_str(), "rb");
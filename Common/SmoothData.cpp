@@ -47,7 +47,7 @@ xyzv &xyzv::operator=(const xyzv &other)
   return *this;
 }
 
-void xyzv::update(int n, double *v)
+void xyzv::update(int n, double *v, int nb)
 {
   if(!vals) {
     vals = new double[n];
@@ -57,55 +57,57 @@ void xyzv::update(int n, double *v)
   }
   else if(nbvals != n)
     return; // error
-  double x1 = (double)(nboccurrences) / (double)(nboccurrences + 1);
-  double x2 = 1. / (double)(nboccurrences + 1);
+  double x1 = (double)(nboccurrences) / (double)(nboccurrences + nb);
+  double x2 = (double)nb / (double)(nboccurrences + nb);
   for(int i = 0; i < nbvals; i++) vals[i] = (x1 * vals[i] + x2 * v[i]);
-  nboccurrences++;
+  nboccurrences += nb;
 }
 
 // Added by Trevor Strickler
-void xyzv::scale_update(double scale_inp)
+void xyzv::scale_update(double scale_inp, int nb)
 {
   if(std::abs(1.0 - scale_inp) <= eps) scale_inp = 1.0;
   if(scale_inp != 1.0 || scaleValue != 1.0) {
-    double x1 = (double)(scale_numvals) / (double)(scale_numvals + 1);
-    double x2 = 1.0 / (double)(scale_numvals + 1);
+    double x1 = (double)(scale_numvals) / (double)(scale_numvals + nb);
+    double x2 = (double)nb / (double)(scale_numvals + nb);
     scaleValue = (x1 * scaleValue + x2 * scale_inp);
   }
   if(std::abs(1.0 - scaleValue) <= eps) scaleValue = 1.0;
-  scale_numvals++;
+  scale_numvals += nb;
 }
 
-void smooth_data::add(double x, double y, double z, int n, double *vals)
+void smooth_data::add(double x, double y, double z, int n, double *vals,
+                      int nb)
 {
   xyzv xyz(x, y, z);
   std::set<xyzv, lessthanxyzv>::const_iterator it = c.find(xyz);
   if(it == c.end()) {
-    xyz.update(n, vals);
+    xyz.update(n, vals, nb);
     c.insert(xyz);
   }
   else {
     // we can do this because we know that it will not destroy the set
     // ordering
     xyzv *p = (xyzv *)&(*it);
-    p->update(n, vals);
+    p->update(n, vals, nb);
   }
 }
 
 // added by Trevor Strickler
-void smooth_data::add_scale(double x, double y, double z, double scale_val)
+void smooth_data::add_scale(double x, double y, double z, double scale_val,
+                            int nb)
 {
   xyzv xyz(x, y, z);
   std::set<xyzv, lessthanxyzv>::const_iterator it = c.find(xyz);
   if(it == c.end()) {
-    xyz.scale_update(scale_val);
+    xyz.scale_update(scale_val, nb);
     c.insert(xyz);
   }
   else {
     // we can do this because we know that it will not destroy the set
     // ordering
     xyzv *p = (xyzv *)&(*it);
-    p->scale_update(scale_val);
+    p->scale_update(scale_val, nb);
   }
 }
 
@@ -34,8 +34,9 @@ struct xyzv {
   // won't allocate *vals
   xyzv(const xyzv &other);
   xyzv &operator=(const xyzv &other);
-  void update(int n, double *v);
-  void scale_update(double scale_val);
+  // v (resp. scale_val) is the average of nb contributions
+  void update(int n, double *v, int nb = 1);
+  void scale_update(double scale_val, int nb = 1);
 };
 
 struct lessthanxyzv {
@@ -59,9 +60,11 @@ public:
   iter begin() { return c.begin(); }
   iter end() { return c.end(); }
   smooth_data() {}
-  void add(double x, double y, double z, int n, double *vals);
+  // add values at (x, y, z); vals (resp. scale_val) can be the average of nb
+  // contributions already accumulated by the caller for this point
+  void add(double x, double y, double z, int n, double *vals, int nb = 1);
   bool get(double x, double y, double z, int n, double *vals) const;
-  void add_scale(double x, double y, double z, double scale_val);
+  void add_scale(double x, double y, double z, double scale_val, int nb = 1);
   bool get_scale(double x, double y, double z, double *scale_val) const;
   void normalize();
   bool exportview(const std::string &filename) const;
@@ -0,0 +1,421 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <locale.h>
+#include <cmath>
+#include "TextBuffer.h"
+
+// Shortest round-trip conversion of doubles with the Grisu3 algorithm of
+// F. Loitsch ("Printing floating-point numbers quickly and accurately with
+// integers", PLDI 2010). The digits are generated with 64-bit integer
+// arithmetic; for the few values (about 0.5%) for which Grisu3 cannot prove
+// that its result is the shortest correctly rounded one, the digits are
+// obtained with printf.
+
+namespace {
+
+  struct diyFp {
+    uint64_t f;
+    int e;
+    diyFp(uint64_t ff, int ee) : f(ff), e(ee) {}
+  };
+
+  // product rounded to 64 bits
+  diyFp multiply(const diyFp &a, const diyFp &b)
+  {
+    const uint64_t m32 = 0xFFFFFFFFULL;
+    const uint64_t a1 = a.f >> 32, a0 = a.f & m32;
+    const uint64_t b1 = b.f >> 32, b0 = b.f & m32;
+    const uint64_t p11 = a1 * b1, p10 = a1 * b0, p01 = a0 * b1, p00 = a0 * b0;
+    uint64_t t = (p00 >> 32) + (p10 & m32) + (p01 & m32);
+    t += (uint64_t)1 << 31;
+    return diyFp(p11 + (p10 >> 32) + (p01 >> 32) + (t >> 32), a.e + b.e + 64);
+  }
+
+  diyFp normalize(diyFp a)
+  {
+    while(!(a.f & ((uint64_t)1 << 63))) {
+      a.f <<= 1;
+      a.e--;
+    }
+    return a;
+  }
+
+  // 10^q = f * 2^e (rounded), for q = -348, -340, ..., 340
+  struct cachedPower {
+    uint64_t f;
+    int e, q;
+  };
+
+  const cachedPower cachedPowers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220, -348},
+    {0xbaaee17fa23ebf76ULL, -1193, -340},
+    {0x8b16fb203055ac76ULL, -1166, -332},
+    {0xcf42894a5dce35eaULL, -1140, -324},
+    {0x9a6bb0aa55653b2dULL, -1113, -316},
+    {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300},
+    {0xff77b1fcbebcdc4fULL, -1034, -292},
+    {0xbe5691ef416bd60cULL, -1007, -284},
+    {0x8dd01fad907ffc3cULL, -980, -276},
+    {0xd3515c2831559a83ULL, -954, -268},
+    {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252},
+    {0xaecc49914078536dULL, -874, -244},
+    {0x823c12795db6ce57ULL, -847, -236},
+    {0xc21094364dfb5637ULL, -821, -228},
+    {0x9096ea6f3848984fULL, -794, -220},
+    {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204},
+    {0xef340a98172aace5ULL, -715, -196},
+    {0xb23867fb2a35b28eULL, -688, -188},
+    {0x84c8d4dfd2c63f3bULL, -661, -180},
+    {0xc5dd44271ad3cdbaULL, -635, -172},
+    {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156},
+    {0xa3ab66580d5fdaf6ULL, -555, -148},
+    {0xf3e2f893dec3f126ULL, -529, -140},
+    {0xb5b5ada8aaff80b8ULL, -502, -132},
+    {0x87625f056c7c4a8bULL, -475, -124},
+    {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108},
+    {0xdff9772470297ebdULL, -396, -100},
+    {0xa6dfbd9fb8e5b88fULL, -369, -92},
+    {0xf8a95fcf88747d94ULL, -343, -84},
+    {0xb94470938fa89bcfULL, -316, -76},
+    {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60},
+    {0x993fe2c6d07b7facULL, -236, -52},
+    {0xe45c10c42a2b3b06ULL, -210, -44},
+    {0xaa242499697392d3ULL, -183, -36},
+    {0xfd87b5f28300ca0eULL, -157, -28},
+    {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12},
+    {0xd1b71758e219652cULL, -77, -4},
+    {0x9c40000000000000ULL, -50, 4},
+    {0xe8d4a51000000000ULL, -24, 12},
+    {0xad78ebc5ac620000ULL, 3, 20},
+    {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36},
+    {0x8f7e32ce7bea5c70ULL, 83, 44},
+    {0xd5d238a4abe98068ULL, 109, 52},
+    {0x9f4f2726179a2245ULL, 136, 60},
+    {0xed63a231d4c4fb27ULL, 162, 68},
+    {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84},
+    {0xc45d1df942711d9aULL, 242, 92},
+    {0x924d692ca61be758ULL, 269, 100},
+    {0xda01ee641a708deaULL, 295, 108},
+    {0xa26da3999aef774aULL, 322, 116},
+    {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132},
+    {0x865b86925b9bc5c2ULL, 402, 140},
+    {0xc83553c5c8965d3dULL, 428, 148},
+    {0x952ab45cfa97a0b3ULL, 455, 156},
+    {0xde469fbd99a05fe3ULL, 481, 164},
+    {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180},
+    {0xb7dcbf5354e9beceULL, 561, 188},
+    {0x88fcf317f22241e2ULL, 588, 196},
+    {0xcc20ce9bd35c78a5ULL, 614, 204},
+    {0x98165af37b2153dfULL, 641, 212},
+    {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228},
+    {0xfb9b7cd9a4a7443cULL, 720, 236},
+    {0xbb764c4ca7a44410ULL, 747, 244},
+    {0x8bab8eefb6409c1aULL, 774, 252},
+    {0xd01fef10a657842cULL, 800, 260},
+    {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276},
+    {0xac2820d9623bf429ULL, 880, 284},
+    {0x80444b5e7aa7cf85ULL, 907, 292},
+    {0xbf21e44003acdd2dULL, 933, 300},
+    {0x8e679c2f5e44ff8fULL, 960, 308},
+    {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324},
+    {0xeb96bf6ebadf77d9ULL, 1039, 332},
+    {0xaf87023b9bf0ee6bULL, 1066, 340},
+  };
+
+  const uint32_t powersOf10[] = {1,         10,        100,     1000,
+                                 10000,     100000,    1000000, 10000000,
+                                 100000000, 1000000000};
+
+  // adjust the last digit towards w, and check that the result is guaranteed
+  // to be the closest representation in the (uncertain) rounding interval
+  bool roundWeed(char *digits, int length, uint64_t distanceTooHighW,
+                 uint64_t unsafeInterval, uint64_t rest, uint64_t tenKappa,
+                 uint64_t unit)
+  {
+    const uint64_t smallDistance = distanceTooHighW - unit;
+    const uint64_t bigDistance = distanceTooHighW + unit;
+    while(rest < smallDistance && unsafeInterval - rest >= tenKappa &&
+          (rest + tenKappa < smallDistance ||
+           smallDistance - rest >= rest + tenKappa - smallDistance)) {
+      digits[length - 1]--;
+      rest += tenKappa;
+    }
+    if(rest < bigDistance && unsafeInterval - rest >= tenKappa &&
+       (rest + tenKappa < bigDistance ||
+        bigDistance - rest > rest + tenKappa - bigDistance))
+      return false;
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+  }
+
+  // generate the shortest digits of w in the interval ]low, high[, all scaled
+  // so that their exponent is in [-60, -32]; w = digits * 10^kappa
+  bool digitGen(const diyFp &low, const diyFp &w, const diyFp &high,
+                char *digits, int &length, int &kappa)
+  {
+    uint64_t unit = 1;
+    const uint64_t tooLow = low.f - unit, tooHigh = high.f + unit;
+    uint64_t unsafeInterval = tooHigh - tooLow;
+    const int shift = -w.e;
+    const uint64_t one = (uint64_t)1 << shift;
+    uint32_t integrals = (uint32_t)(tooHigh >> shift);
+    uint64_t fractionals = tooHigh & (one - 1);
+    kappa = 10;
+    while(kappa > 1 && powersOf10[kappa - 1] > integrals) kappa--;
+    length = 0;
+    while(kappa > 0) {
+      const uint32_t divisor = powersOf10[kappa - 1];
+      digits[length++] = (char)('0' + integrals / divisor);
+      integrals %= divisor;
+      kappa--;
+      const uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+      if(rest < unsafeInterval)
+        return roundWeed(digits, length, tooHigh - w.f, unsafeInterval, rest,
+                         (uint64_t)divisor << shift, unit);
+    }
+    while(true) {
+      fractionals *= 10;
+      unit *= 10;
+      unsafeInterval *= 10;
+      digits[length++] = (char)('0' + (fractionals >> shift));
+      fractionals &= one - 1;
+      kappa--;
+      if(fractionals < unsafeInterval)
+        return roundWeed(digits, length, (tooHigh - w.f) * unit,
+                         unsafeInterval, fractionals, one, unit);
+    }
+  }
+
+  // shortest digits of d > 0 (finite), with d = digits * 10^exponent; return
+  // false if the result is not guaranteed to be the shortest one
+  bool grisu3(double d, char *digits, int &length, int &exponent)
+  {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(double));
+    const uint64_t hidden = (uint64_t)1 << 52;
+    const int biasedExponent = (int)((bits >> 52) & 0x7FF);
+    uint64_t f = bits & (hidden - 1);
+    int e = -1074;
+    if(biasedExponent) {
+      f += hidden;
+      e = biasedExponent - 1075;
+    }
+    // boundaries of the rounding interval of d (the lower one is closer if d
+    // is a normalized power of 2)
+    const diyFp w = normalize(diyFp(f, e));
+    const diyFp high = normalize(diyFp((f << 1) + 1, e - 1));
+    diyFp low = (f == hidden && biasedExponent > 1) ?
+                  diyFp((f << 2) - 1, e - 2) :
+                  diyFp((f << 1) - 1, e - 1);
+    low.f <<= low.e - high.e;
+    low.e = high.e;
+    // cached power of 10 bringing the exponent of w in [-60, -32]
+    const int minExponent = -60 - (w.e + 64), maxExponent = -32 - (w.e + 64);
+    int i =
+      ((int)std::ceil((minExponent + 63) * 0.30102999566398114) + 348 + 7) / 8;
+    while(i > 0 && cachedPowers[i].e > maxExponent) i--;
+    while(cachedPowers[i].e < minExponent) i++;
+    const diyFp c(cachedPowers[i].f, cachedPowers[i].e);
+    int kappa;
+    const bool ok = digitGen(multiply(low, c), multiply(w, c),
+                             multiply(high, c), digits, length, kappa);
+    exponent = kappa - cachedPowers[i].q;
+    return ok;
+  }
+
+  // same with printf: a value with at most 15 significant digits is always
+  // correctly recovered from its rounding to 15 digits
+  void shortestDigits(double d, char *digits, int &length, int &exponent)
+  {
+    char tmp[64];
+    for(int p = 15; p <= 17; p++) {
+      snprintf(tmp, sizeof(tmp), "%.*e", p - 1, d);
+      if(p == 17 || strtod(tmp, 0) == d) break;
+    }
+    length = 0;
+    const char *s = tmp;
+    for(; *s && *s != 'e'; s++)
+      if(*s >= '0' && *s <= '9') digits[length++] = *s;
+    exponent = atoi(s + 1) - (length - 1);
+  }
+
+} // namespace
+
+void TextBuffer::_fixDecimalPoint(char *str)
+{
+  // printf uses the decimal point of the current locale
+  const char *point = localeconv()->decimal_point;
+  if(!point || (point[0] == '.' && !point[1])) return;
+  const std::size_t n = strlen(point);
+  char *p = strstr(str, point);
+  if(!p) return;
+  *p = '.';
+  memmove(p + 1, p + n, strlen(p + n) + 1);
+}
+
+void TextBuffer::addString(const char *str, int width)
+{
+  const int n = (int)strlen(str);
+  const int pad = (width > 0 ? width : -width) - n;
+  if(width > 0)
+    for(int i = 0; i < pad; i++) _data.push_back(' ');
+  _data.insert(_data.end(), str, str + n);
+  if(width < 0)
+    for(int i = 0; i < pad; i++) _data.push_back(' ');
+}
+
+void TextBuffer::addUnsigned(unsigned long i, int width)
+{
+  char tmp[32];
+  char *p = tmp + sizeof(tmp);
+  *--p = '\0';
+  do {
+    *--p = (char)('0' + i % 10);
+    i /= 10;
+  } while(i);
+  if(!width) {
+    _data.insert(_data.end(), p, tmp + sizeof(tmp) - 1);
+    return;
+  }
+  addString(p, width);
+}
+
+void TextBuffer::addInt(long i, int width)
+{
+  if(i >= 0) {
+    addUnsigned((unsigned long)i, width);
+    return;
+  }
+  char tmp[32];
+  char *p = tmp + sizeof(tmp);
+  *--p = '\0';
+  unsigned long u = 0UL - (unsigned long)i;
+  do {
+    *--p = (char)('0' + u % 10);
+    u /= 10;
+  } while(u);
+  *--p = '-';
+  if(!width) {
+    _data.insert(_data.end(), p, tmp + sizeof(tmp) - 1);
+    return;
+  }
+  addString(p, width);
+}
+
+void TextBuffer::addDouble(double d)
+{
+  // fast path for small integer values
+  if(d == 0. || (std::abs(d) < 1.e9 && d == (double)(long)d)) {
+    if(d == 0. && std::signbit(d)) _data.push_back('-');
+    addInt((long)d);
+    return;
+  }
+  if(!std::isfinite(d)) {
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%.16g", d);
+    _data.insert(_data.end(), tmp, tmp + strlen(tmp));
+    return;
+  }
+  char digits[32];
+  int n, k;
+  if(d < 0.) _data.push_back('-');
+  if(!grisu3(std::abs(d), digits, n, k))
+    shortestDigits(std::abs(d), digits, n, k);
+  while(n > 1 && digits[n - 1] == '0') {
+    n--;
+    k++;
+  }
+  // same layout as "%g": fixed notation if the exponent in scientific notation
+  // is in [-4, 16[, scientific notation otherwise
+  const int x = n + k - 1;
+  if(x >= -4 && x < 16) {
+    if(x < 0) {
+      _data.push_back('0');
+      _data.push_back('.');
+      _data.insert(_data.end(), -x - 1, '0');
+      _data.insert(_data.end(), digits, digits + n);
+    }
+    else if(n <= x + 1) {
+      _data.insert(_data.end(), digits, digits + n);
+      _data.insert(_data.end(), x + 1 - n, '0');
+    }
+    else {
+      _data.insert(_data.end(), digits, digits + x + 1);
+      _data.push_back('.');
+      _data.insert(_data.end(), digits + x + 1, digits + n);
+    }
+  }
+  else {
+    _data.push_back(digits[0]);
+    if(n > 1) {
+      _data.push_back('.');
+      _data.insert(_data.end(), digits + 1, digits + n);
+    }
+    _data.push_back('e');
+    _data.push_back(x < 0 ? '-' : '+');
+    if(std::abs(x) < 10) _data.push_back('0');
+    addInt(std::abs(x));
+  }
+}
+
+void TextBuffer::addDouble(double d, const char *format)
+{
+  char tmp[128];
+  snprintf(tmp, sizeof(tmp), format, d);
+  _fixDecimalPoint(tmp);
+  _data.insert(_data.end(), tmp, tmp + strlen(tmp));
+}
+
+void TextBuffer::append(const TextBuffer &other)
+{
+  _data.insert(_data.end(), other._data.begin(), other._data.end());
+}
+
+void TextBuffer::replace(std::size_t start, char c, char r)
+{
+  for(std::size_t i = start; i < _data.size(); i++)
+    if(_data[i] == c) _data[i] = r;
+}
+
+bool TextBuffer::write(FILE *fp)
+{
+  bool ok = true;
+  if(_data.size())
+    ok = (fwrite(&_data[0], 1, _data.size(), fp) == _data.size());
+  _data.clear();
+  return ok;
+}
+
+TextBuffer &getLocalTextBuffer()
+{
+  static thread_local TextBuffer buf;
+  return buf;
+}
+
+void addTextBufferChunks(std::vector<TextBufferChunk> &chunks,
+                         std::size_t entity, std::size_t numItems, int part,
+                         std::size_t maxItems)
+{
+  for(std::size_t i = 0; i < numItems; i += maxItems)
+    chunks.push_back(TextBufferChunk(
+      entity, part, i, (numItems - i > maxItems) ? i + maxItems : numItems));
+}
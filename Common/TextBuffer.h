@@ -0,0 +1,71 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef TEXT_BUFFER_H
+#define TEXT_BUFFER_H
+
+#include <stdio.h>
+#include <vector>
+
+// Buffered, locale-independent number formatting for ASCII file writers:
+// integers are converted without going through printf, and doubles are
+// written with the shortest representation that reads back to the same value
+// (or with an explicit printf conversion for fixed-width formats). Each buffer
+// is independent, so that chunks of a file can be formatted in parallel and
+// written sequentially.
+
+class TextBuffer {
+private:
+  std::vector<char> _data;
+  void _fixDecimalPoint(char *str);
+
+public:
+  TextBuffer() {}
+  std::size_t size() const { return _data.size(); }
+  bool empty() const { return _data.empty(); }
+  const char *data() const { return _data.empty() ? 0 : &_data[0]; }
+  void clear() { _data.clear(); }
+  void reserve(std::size_t n) { _data.reserve(n); }
+  void addChar(char c) { _data.push_back(c); }
+  // add a string, left-aligned (width < 0) or right-aligned (width > 0) in a
+  // field of |width| characters
+  void addString(const char *str, int width = 0);
+  void addInt(long i, int width = 0);
+  void addUnsigned(unsigned long i, int width = 0);
+  // shortest round-trip representation, with the same layout as "%g"
+  void addDouble(double d);
+  // printf-style conversion of a single double, e.g. "%25.16E"
+  void addDouble(double d, const char *format);
+  void append(const TextBuffer &other);
+  // replace all the occurrences of character c by r, from position start
+  void replace(std::size_t start, char c, char r);
+  // write the content of the buffer to the file and clear it
+  bool write(FILE *fp);
+};
+
+// buffer of the calling thread, reused from call to call (e.g. by the writers
+// of a single node or element to a FILE)
+TextBuffer &getLocalTextBuffer();
+
+// Range [begin, end) of the items (nodes, elements) of part "part" of entity
+// "entity": writers format chunks instead of whole entities, so that the
+// memory used by the buffers filled in parallel stays bounded
+class TextBufferChunk {
+public:
+  std::size_t entity, begin, end;
+  int part;
+  TextBufferChunk(std::size_t e, int p, std::size_t b, std::size_t en)
+    : entity(e), begin(b), end(en), part(p)
+  {
+  }
+};
+
+// split the numItems items of part "part" of entity "entity" into chunks of
+// at most maxItems items
+void addTextBufferChunks(std::vector<TextBufferChunk> &chunks,
+                         std::size_t entity, std::size_t numItems,
+                         int part = 0, std::size_t maxItems = 10000);
+
+#endif
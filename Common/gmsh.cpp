@@ -2527,6 +2527,338 @@ GMSH_API void gmsh::model::mesh::preallocateBasisFunctions(
   delete basis;
 }
 
+static HierarchicalBasis *_getHierarchicalBasis(const std::string &fsName,
+                                                int familyType, int order)
+{
+  if(fsName == "H1Legendre" || fsName == "GradH1Legendre") {
+    switch(familyType) {
+    case TYPE_HEX: return new HierarchicalBasisH1Brick(order);
+    case TYPE_PRI: return new HierarchicalBasisH1Pri(order);
+    case TYPE_TET: return new HierarchicalBasisH1Tetra(order);
+    case TYPE_QUA: return new HierarchicalBasisH1Quad(order);
+    case TYPE_TRI: return new HierarchicalBasisH1Tria(order);
+    case TYPE_LIN: return new HierarchicalBasisH1Line(order);
+    default: Msg::Error("Unknown familyType "); throw 2;
+    }
+  }
+  else if(fsName == "HcurlLegendre" || fsName == "CurlHcurlLegendre") {
+    switch(familyType) {
+    case TYPE_QUA: return new HierarchicalBasisHcurlQuad(order);
+    case TYPE_HEX: return new HierarchicalBasisHcurlBrick(order);
+    case TYPE_TRI: return new HierarchicalBasisHcurlTria(order);
+    case TYPE_TET: return new HierarchicalBasisHcurlTetra(order);
+    case TYPE_PRI: return new HierarchicalBasisHcurlPri(order);
+    case TYPE_LIN: return new HierarchicalBasisHcurlLine(order);
+    default: Msg::Error("Unknown familyType "); throw 2;
+    }
+  }
+  Msg::Error("Unknown function space named '%s'", fsName.c_str());
+  throw 3;
+}
+
+// The orientation of an element for a hierarchical basis is encoded as a
+// mixed radix integer: one binary digit per edge (1 if the edge is reversed),
+// followed by one digit per face (quadrangular faces first, then triangular
+// faces, in the order of getFaceSolin), which encodes the face orientation
+// flags: 3 binary digits for quadrangles, flag1 * 2 + (flag2 < 0) for
+// triangles. Edges and faces that do not carry any basis function are not
+// taken into account.
+static void _getOrientationRadices(HierarchicalBasis *basis,
+                                   std::vector<int> &radices)
+{
+  radices.clear();
+  if(basis->getnEdgeFunction() > 0)
+    radices.resize(basis->getNumEdge(), 2);
+  for(int jj = 0; jj < basis->getNumQuadFace(); jj++)
+    radices.push_back(basis->getnQuadFaceFunction() > 0 ? 8 : 1);
+  for(int jj = 0; jj < basis->getNumTriFace(); jj++)
+    radices.push_back(basis->getnTriFaceFunction() > 0 ? 6 : 1);
+}
+
+static int _getNumberOfOrientations(HierarchicalBasis *basis)
+{
+  std::vector<int> radices;
+  _getOrientationRadices(basis, radices);
+  int n = 1;
+  for(std::size_t i = 0; i < radices.size(); i++) n *= radices[i];
+  return n;
+}
+
+static int _getOrientation(HierarchicalBasis *basis,
+                           const std::vector<int> &radices, MElement *e)
+{
+  int orientation = 0, radix = 1;
+  std::size_t d = 0;
+  if(basis->getnEdgeFunction() > 0) {
+    for(int jj = 0; jj < basis->getNumEdge(); jj++) {
+      MEdge edge = e->getEdge(jj);
+      if(edge.getMinVertex()->getNum() != unsigned(e->getVertexSolin(jj, 0)))
+        orientation += radix;
+      radix *= radices[d++];
+    }
+  }
+  std::vector<int> flag(3, 0);
+  for(int jj = 0; jj < basis->getNumQuadFace() + basis->getNumTriFace();
+      jj++, d++) {
+    if(radices[d] == 1) continue;
+    MFace face = e->getFaceSolin(jj);
+    face.getOrientationFlagForFace(flag);
+    if(radices[d] == 8)
+      orientation += radix * ((flag[0] < 0) + 2 * (flag[1] < 0) +
+                              4 * (flag[2] < 0));
+    else
+      orientation += radix * (2 * flag[0] + (flag[1] < 0));
+    radix *= radices[d];
+  }
+  return orientation;
+}
+
+// reorient the edge and face functions computed at a point for the given
+// orientation, exactly as done element by element in
+// getBasisFunctionsForElements
+template <class T>
+static void _orientBasisFunctions(
+  HierarchicalBasis *basis, const std::vector<int> &radices, int orientation,
+  const std::vector<T> &eTable, const std::vector<T> &eTableNegativeFlag,
+  const std::vector<T> &quadFaceFunctionsAllOrientations,
+  const std::vector<T> &triFaceFunctionsAllOrientations,
+  std::vector<T> &eTableCopy, std::vector<T> &fTableCopy)
+{
+  std::size_t d = 0;
+  if(basis->getnEdgeFunction() > 0) {
+    for(int jj = 0; jj < basis->getNumEdge(); jj++) {
+      basis->orientEdge((orientation % 2) ? -1 : 1, jj, eTableCopy, eTable,
+                        eTableNegativeFlag);
+      orientation /= radices[d++];
+    }
+  }
+  for(int jj = 0; jj < basis->getNumQuadFace() + basis->getNumTriFace();
+      jj++, d++) {
+    if(radices[d] == 1) continue;
+    const int digit = orientation % radices[d];
+    orientation /= radices[d];
+    int flag[3] = {0, 0, 0};
+    if(radices[d] == 8) {
+      flag[0] = (digit & 1) ? -1 : 1;
+      flag[1] = (digit & 2) ? -1 : 1;
+      flag[2] = (digit & 4) ? -1 : 1;
+    }
+    else {
+      flag[0] = digit / 2;
+      flag[1] = (digit % 2) ? -1 : 1;
+    }
+    basis->orientFace(flag[0], flag[1], flag[2], jj,
+                      quadFaceFunctionsAllOrientations,
+                      triFaceFunctionsAllOrientations, fTableCopy);
+  }
+}
+
+static void _copyBasisFunctions(const std::vector<double> &table,
+                                double *out)
+{
+  for(std::size_t k = 0; k < table.size(); k++) out[k] = table[k];
+}
+
+static void
+_copyBasisFunctions(const std::vector<std::vector<double> > &table, double *out)
+{
+  for(std::size_t k = 0; k < table.size(); k++)
+    for(int c = 0; c < 3; c++) out[3 * k + c] = table[k][c];
+}
+
+GMSH_API void gmsh::model::mesh::getBasisFunctionsOrientationForElements(
+  const int elementType, const std::string &functionSpaceType,
+  std::vector<int> &orientations, std::vector<int> &elementOrientations,
+  const int tag)
+{
+  if(!_isInitialized()) { throw - 1; }
+  orientations.clear();
+  elementOrientations.clear();
+  int basisOrder = 0;
+  int numComponents = 0;
+  std::string fsName = "";
+  if(!_getFunctionSpaceInfo(functionSpaceType, fsName, basisOrder,
+                            numComponents)) {
+    Msg::Error("Unknown function space type '%s'", functionSpaceType.c_str());
+    throw 2;
+  }
+  int dim = ElementType::getDimension(elementType);
+  std::map<int, std::vector<GEntity *> > typeEnt;
+  _getEntitiesForElementTypes(dim, tag, typeEnt);
+  const std::vector<GEntity *> &entities(typeEnt[elementType]);
+  int familyType = ElementType::getParentType(elementType);
+  HierarchicalBasis *basis =
+    _getHierarchicalBasis(fsName, familyType, basisOrder);
+
+  std::vector<MElement *> elements;
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    GEntity *ge = entities[i];
+    std::size_t numElementsInEntitie = ge->getNumMeshElementsByType(familyType);
+    elements.reserve(elements.size() + numElementsInEntitie);
+    for(std::size_t j = 0; j < numElementsInEntitie; j++)
+      elements.push_back(ge->getMeshElementByType(familyType, j));
+  }
+  const int numElements = (int)elements.size();
+  elementOrientations.resize(numElements);
+  std::vector<int> radices;
+  _getOrientationRadices(basis, radices);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < numElements; i++)
+    elementOrientations[i] = _getOrientation(basis, radices, elements[i]);
+  delete basis;
+
+  // list the distinct orientations, and replace the orientation of each
+  // element by its index in the list
+  orientations = elementOrientations;
+  std::sort(orientations.begin(), orientations.end());
+  orientations.erase(std::unique(orientations.begin(), orientations.end()),
+                     orientations.end());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < numElements; i++)
+    elementOrientations[i] =
+      std::lower_bound(orientations.begin(), orientations.end(),
+                       elementOrientations[i]) -
+      orientations.begin();
+}
+
+GMSH_API int gmsh::model::mesh::getNumberOfOrientations(
+  const int elementType, const std::string &functionSpaceType)
+{
+  if(!_isInitialized()) { throw - 1; }
+  int basisOrder = 0;
+  int numComponents = 0;
+  std::string fsName = "";
+  if(!_getFunctionSpaceInfo(functionSpaceType, fsName, basisOrder,
+                            numComponents)) {
+    Msg::Error("Unknown function space type '%s'", functionSpaceType.c_str());
+    throw 2;
+  }
+  int familyType = ElementType::getParentType(elementType);
+  HierarchicalBasis *basis =
+    _getHierarchicalBasis(fsName, familyType, basisOrder);
+  int n = _getNumberOfOrientations(basis);
+  delete basis;
+  return n;
+}
+
+GMSH_API void gmsh::model::mesh::getBasisFunctionsForOrientations(
+  const int elementType, const std::vector<double> &integrationPoints,
+  const std::string &functionSpaceType, const std::vector<int> &orientations,
+  int &numComponents, int &numFunctionsPerElement,
+  std::vector<double> &basisFunctions)
+{
+  if(!_isInitialized()) { throw - 1; }
+  basisFunctions.clear();
+  int basisOrder = 0;
+  std::string fsName = "";
+  if(!_getFunctionSpaceInfo(functionSpaceType, fsName, basisOrder,
+                            numComponents)) {
+    Msg::Error("Unknown function space type '%s'", functionSpaceType.c_str());
+    throw 2;
+  }
+  int familyType = ElementType::getParentType(elementType);
+  HierarchicalBasis *basis =
+    _getHierarchicalBasis(fsName, familyType, basisOrder);
+  const int numOrientations = _getNumberOfOrientations(basis);
+  std::vector<int> radices;
+  _getOrientationRadices(basis, radices);
+  for(std::size_t o = 0; o < orientations.size(); o++) {
+    if(orientations[o] < 0 || orientations[o] >= numOrientations) {
+      Msg::Error("Wrong orientation %d (should be in [0, %d[)",
+                 orientations[o], numOrientations);
+      delete basis;
+      throw 4;
+    }
+  }
+
+  int nq = integrationPoints.size() / 3;
+  int vSize = basis->getnVertexFunction();
+  int bSize = basis->getnBubbleFunction();
+  int eSize = basis->getnEdgeFunction();
+  int fSize = basis->getnTriFaceFunction() + basis->getnQuadFaceFunction();
+  numFunctionsPerElement = vSize + bSize + eSize + fSize;
+  // one table per orientation: [o1g1f1, ..., o1g1fN, o1g2f1, ..., o2g1f1, ...]
+  const std::size_t sizePerPoint = numFunctionsPerElement * numComponents;
+  const std::size_t sizePerOrientation = nq * sizePerPoint;
+  basisFunctions.resize(orientations.size() * sizePerOrientation);
+
+  for(int i = 0; i < nq; i++) {
+    double u = integrationPoints[3 * i];
+    double v = integrationPoints[3 * i + 1];
+    double w = integrationPoints[3 * i + 2];
+    if(numComponents == 1) {
+      std::vector<double> vTable(vSize), eTable(eSize), fTable(fSize),
+        bTable(bSize);
+      basis->generateBasis(u, v, w, vTable, eTable, fTable, bTable);
+      std::vector<double> eTableNegativeFlag(eTable);
+      if(eSize > 0) basis->orientEdgeFunctionsForNegativeFlag(eTableNegativeFlag);
+      std::vector<double> quadFaceFunctionsAllOrientations(
+        basis->getnQuadFaceFunction() * 8, 0);
+      std::vector<double> triFaceFunctionsAllOrientations(
+        basis->getnTriFaceFunction() * 6, 0);
+      if(fSize > 0)
+        basis->addAllOrientedFaceFunctions(u, v, w, fTable,
+                                           quadFaceFunctionsAllOrientations,
+                                           triFaceFunctionsAllOrientations);
+      std::vector<double> eTableCopy(eSize, 0.), fTableCopy(fTable);
+      for(std::size_t o = 0; o < orientations.size(); o++) {
+        _orientBasisFunctions(basis, radices, orientations[o], eTable,
+                              eTableNegativeFlag,
+                              quadFaceFunctionsAllOrientations,
+                              triFaceFunctionsAllOrientations, eTableCopy,
+                              fTableCopy);
+        double *out = &basisFunctions[o * sizePerOrientation + i * sizePerPoint];
+        _copyBasisFunctions(vTable, out);
+        _copyBasisFunctions(eTableCopy, out + vSize);
+        _copyBasisFunctions(fTableCopy, out + vSize + eSize);
+        _copyBasisFunctions(bTable, out + vSize + eSize + fSize);
+      }
+    }
+    else {
+      std::vector<std::vector<double> > vTable(vSize,
+                                               std::vector<double>(3, 0.));
+      std::vector<std::vector<double> > eTable(eSize,
+                                               std::vector<double>(3, 0.));
+      std::vector<std::vector<double> > fTable(fSize,
+                                               std::vector<double>(3, 0.));
+      std::vector<std::vector<double> > bTable(bSize,
+                                               std::vector<double>(3, 0.));
+      basis->generateBasis(u, v, w, vTable, eTable, fTable, bTable, fsName);
+      std::vector<std::vector<double> > eTableNegativeFlag(eTable);
+      if(eSize > 0) basis->orientEdgeFunctionsForNegativeFlag(eTableNegativeFlag);
+      std::vector<std::vector<double> > quadFaceFunctionsAllOrientations(
+        basis->getnQuadFaceFunction() * 8, std::vector<double>(3, 0));
+      std::vector<std::vector<double> > triFaceFunctionsAllOrientations(
+        basis->getnTriFaceFunction() * 6, std::vector<double>(3, 0));
+      if(fSize > 0)
+        basis->addAllOrientedFaceFunctions(
+          u, v, w, fTable, quadFaceFunctionsAllOrientations,
+          triFaceFunctionsAllOrientations, fsName);
+      std::vector<std::vector<double> > eTableCopy(
+        eSize, std::vector<double>(3, 0.));
+      std::vector<std::vector<double> > fTableCopy(
+        fSize, std::vector<double>(3, 0.));
+      for(std::size_t o = 0; o < orientations.size(); o++) {
+        _orientBasisFunctions(basis, radices, orientations[o], eTable,
+                              eTableNegativeFlag,
+                              quadFaceFunctionsAllOrientations,
+                              triFaceFunctionsAllOrientations, eTableCopy,
+                              fTableCopy);
+        double *out = &basisFunctions[o * sizePerOrientation + i * sizePerPoint];
+        _copyBasisFunctions(vTable, out);
+        _copyBasisFunctions(eTableCopy, out + 3 * vSize);
+        _copyBasisFunctions(fTableCopy, out + 3 * (vSize + eSize));
+        _copyBasisFunctions(bTable, out + 3 * (vSize + eSize + fSize));
+      }
+    }
+  }
+  delete basis;
+}
+
 GMSH_API void gmsh::model::mesh::getKeysForElements(
   const int elementType, const std::string &functionSpaceType,
   gmsh::vectorpair &keys, std::vector<double> &coord, const int tag,
@@ -2679,99 +3011,125 @@ GMSH_API void gmsh::model::mesh::getKeysForElements(
     int const4 = bSize + std::max(const3, const2);
     delete basis;
 
+    std::vector<MElement *> elements;
     for(std::size_t i = 0; i < entities.size(); i++) {
       GEntity *ge = entities[i];
       std::size_t numElementsInEntitie = ge->getNumMeshElementsByType(familyType);
-      if(generateCoord) {
-        coord.reserve(coord.size() + numElementsInEntitie * numDofsPerElement * 3);
-      }
-      keys.reserve(keys.size() + numElementsInEntitie * numDofsPerElement);
+      elements.reserve(elements.size() + numElementsInEntitie);
+      for(std::size_t j = 0; j < numElementsInEntitie; j++)
+        elements.push_back(ge->getMeshElementByType(familyType, j));
+    }
+    const int numElements = (int)elements.size();
+    if(!numElements) return;
+
+    // number the edges and the faces of all the elements at once; the numbers
+    // are the same as if the edges and faces were numbered element by element
+    const int numberEdges = (eSize > 0) ? elements[0]->getNumEdges() : 0;
+    const int numberFaces = (fSize > 0) ? numberQuadFaces + numberTriFaces : 0;
+    std::vector<MEdge> edges(numElements * numberEdges);
+    std::vector<MFace> faces(numElements * numberFaces);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+    for(int i = 0; i < numElements; i++) {
+      for(int jj = 0; jj < numberEdges; jj++)
+        edges[i * numberEdges + jj] = elements[i]->getEdge(jj);
+      for(int jj = 0; jj < numberFaces; jj++)
+        faces[i * numberFaces + jj] = elements[i]->getFaceSolin(jj);
+    }
+    std::vector<int> edgeGlobalIndices, faceGlobalIndices;
+    GModel::current()->addMEdges(edges, edgeGlobalIndices);
+    GModel::current()->addMFaces(faces, faceGlobalIndices);
 
-      for(std::size_t j = 0; j < numElementsInEntitie; j++) {
-        MElement *e = ge->getMeshElementByType(familyType, j);
-        // vertices
-        for(int k = 0; k < vSize; k++) {
-          keys.push_back(std::pair<int, std::size_t>(0, e->getVertex(k)->getNum()));
-          if (generateCoord) {
-            coord.push_back(e->getVertex(k)->x());
-            coord.push_back(e->getVertex(k)->y());
-            coord.push_back(e->getVertex(k)->z());
+    keys.resize(numElements * numDofsPerElement);
+    if(generateCoord) coord.resize(numElements * numDofsPerElement * 3);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+    for(int i = 0; i < numElements; i++) {
+      MElement *e = elements[i];
+      std::size_t index = (std::size_t)i * numDofsPerElement;
+      // vertices
+      for(int k = 0; k < vSize; k++) {
+        keys[index] = std::pair<int, std::size_t>(0, e->getVertex(k)->getNum());
+        if(generateCoord) {
+          coord[3 * index] = e->getVertex(k)->x();
+          coord[3 * index + 1] = e->getVertex(k)->y();
+          coord[3 * index + 2] = e->getVertex(k)->z();
+        }
+        index++;
+      }
+      // edges
+      for(int jj = 0; jj < numberEdges; jj++) {
+        const MEdge &edge = edges[i * numberEdges + jj];
+        double coordEdge[3] = {0., 0., 0.};
+        if(generateCoord) {
+          MVertex *v1 = edge.getVertex(0);
+          MVertex *v2 = edge.getVertex(1);
+          coordEdge[0] = (v1->x() + v2->x()) / 2;
+          coordEdge[1] = (v1->y() + v2->y()) / 2;
+          coordEdge[2] = (v1->z() + v2->z()) / 2;
+        }
+        const int edgeGlobalIndice = edgeGlobalIndices[i * numberEdges + jj];
+        for(int k = 1; k < const1; k++) {
+          keys[index] = std::pair<int, std::size_t>(k, edgeGlobalIndice);
+          if(generateCoord) {
+            coord[3 * index] = coordEdge[0];
+            coord[3 * index + 1] = coordEdge[1];
+            coord[3 * index + 2] = coordEdge[2];
           }
+          index++;
         }
-        // edges
-        if(eSize > 0) {
-          for(int jj = 0; jj < e->getNumEdges(); jj++) {
-            MEdge edge = e->getEdge(jj);
-            double coordEdge[3];
-            if (generateCoord) {
-              MVertex *v1 = edge.getVertex(0);
-              MVertex *v2 = edge.getVertex(1);
-
-              coordEdge[0] = (v1->x() + v2->x()) / 2;
-              coordEdge[1] = (v1->y() + v2->y()) / 2;
-              coordEdge[2] = (v1->z() + v2->z()) / 2;
-            }
-            int edgeGlobalIndice = GModel::current()->addMEdge(edge);
-            for(int k = 1; k < const1; k++) {
-              keys.push_back(std::pair<int, std::size_t>(k, edgeGlobalIndice));
-              if (generateCoord) {
-                coord.push_back(coordEdge[0]);
-                coord.push_back(coordEdge[1]);
-                coord.push_back(coordEdge[2]);
-              }
-            }
+      }
+      // faces
+      for(int jj = 0; jj < numberFaces; jj++) {
+        const MFace &face = faces[i * numberFaces + jj];
+        double coordFace[3] = {0., 0., 0.};
+        if(generateCoord) {
+          for(std::size_t indexV = 0; indexV < face.getNumVertices(); ++indexV) {
+            coordFace[0] += face.getVertex(indexV)->x();
+            coordFace[1] += face.getVertex(indexV)->y();
+            coordFace[2] += face.getVertex(indexV)->z();
           }
+          coordFace[0] /= face.getNumVertices();
+          coordFace[1] /= face.getNumVertices();
+          coordFace[2] /= face.getNumVertices();
         }
-        // faces
-        if(fSize > 0) {
-          for(int jj = 0; jj < numberQuadFaces + numberTriFaces; jj++) {
-            // Number the faces
-            MFace face = e->getFaceSolin(jj);
-            double coordFace[3] = {0., 0., 0.};
-            if (generateCoord) {
-              for(std::size_t indexV = 0; indexV < face.getNumVertices(); ++indexV) {
-                coordFace[0] += face.getVertex(indexV)->x();
-                coordFace[1] += face.getVertex(indexV)->y();
-                coordFace[2] += face.getVertex(indexV)->z();
-              }
-              coordFace[0] /= face.getNumVertices();
-              coordFace[1] /= face.getNumVertices();
-              coordFace[2] /= face.getNumVertices();
-            }
-            int faceGlobalIndice = GModel::current()->addMFace(face);
-            int it2 = const2;
-            if(jj >= numberQuadFaces) { it2 = const3; }
-            for(int k = const1; k < it2; k++) {
-              keys.push_back(std::pair<int, std::size_t>(k, faceGlobalIndice));
-              if (generateCoord) {
-                coord.push_back(coordFace[0]);
-                coord.push_back(coordFace[1]);
-                coord.push_back(coordFace[2]);
-              }
-            }
+        const int faceGlobalIndice = faceGlobalIndices[i * numberFaces + jj];
+        int it2 = const2;
+        if(jj >= numberQuadFaces) { it2 = const3; }
+        for(int k = const1; k < it2; k++) {
+          keys[index] = std::pair<int, std::size_t>(k, faceGlobalIndice);
+          if(generateCoord) {
+            coord[3 * index] = coordFace[0];
+            coord[3 * index + 1] = coordFace[1];
+            coord[3 * index + 2] = coordFace[2];
           }
+          index++;
         }
-        // volumes
-        if(bSize > 0) {
-          double bubbleCenterCoord[3] = {0., 0., 0.};
-          if (generateCoord) {
-            for(unsigned int indexV = 0; indexV < e->getNumVertices(); ++indexV) {
-              bubbleCenterCoord[0] += e->getVertex(indexV)->x();
-              bubbleCenterCoord[1] += e->getVertex(indexV)->y();
-              bubbleCenterCoord[2] += e->getVertex(indexV)->z();
-            }
-            bubbleCenterCoord[0] /= e->getNumVertices();
-            bubbleCenterCoord[1] /= e->getNumVertices();
-            bubbleCenterCoord[2] /= e->getNumVertices();
+      }
+      // volumes
+      if(bSize > 0) {
+        double bubbleCenterCoord[3] = {0., 0., 0.};
+        if(generateCoord) {
+          for(unsigned int indexV = 0; indexV < e->getNumVertices(); ++indexV) {
+            bubbleCenterCoord[0] += e->getVertex(indexV)->x();
+            bubbleCenterCoord[1] += e->getVertex(indexV)->y();
+            bubbleCenterCoord[2] += e->getVertex(indexV)->z();
           }
-          for(int k = std::max(const3, const2); k < const4; k++) {
-            keys.push_back(std::pair<int, std::size_t>(k, e->getNum()));
-            if (generateCoord) {
-              coord.push_back(bubbleCenterCoord[0]);
-              coord.push_back(bubbleCenterCoord[1]);
-              coord.push_back(bubbleCenterCoord[2]);
-            }
+          bubbleCenterCoord[0] /= e->getNumVertices();
+          bubbleCenterCoord[1] /= e->getNumVertices();
+          bubbleCenterCoord[2] /= e->getNumVertices();
+        }
+        for(int k = std::max(const3, const2); k < const4; k++) {
+          keys[index] = std::pair<int, std::size_t>(k, e->getNum());
+          if(generateCoord) {
+            coord[3 * index] = bubbleCenterCoord[0];
+            coord[3 * index + 1] = bubbleCenterCoord[1];
+            coord[3 * index + 2] = bubbleCenterCoord[2];
           }
+          index++;
         }
       }
     }
@@ -3637,8 +3995,7 @@ GMSH_API void gmsh::model::mesh::getPeriodicNodes(
   }
   if(ge->getMeshMaster() != ge) {
     tagMaster = ge->getMeshMaster()->tag();
-    for(std::map<MVertex *, MVertex *>::iterator it =
-          ge->correspondingVertices.begin();
+    for(MVertexPairs::iterator it = ge->correspondingVertices.begin();
         it != ge->correspondingVertices.end(); ++it) {
       nodeTags.push_back(it->first->getNum());
       nodeTagsMaster.push_back(it->second->getNum());
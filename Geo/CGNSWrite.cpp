@@ -26,7 +26,7 @@
 namespace {
 
   // Type for periodic node correpondence (global indices)
-  typedef std::map<MVertex *, MVertex *> VertVertMap;
+  typedef MVertexPairs VertVertMap;
 
   // Types for periodic and interface connectivities
   typedef std::pair<unsigned int, unsigned int> PartitionInterface;
@@ -382,7 +382,7 @@ int writePeriodic(const std::vector<GEntity *> &entitiesPer, int cgIndexFile,
   Msg::Info("Constructing connectivities for %i periodic entities",
             entitiesPer.size());
   PeriodicConnection connect;
-  typedef std::map<MVertex *, MVertex *> VertVertMap;
+  typedef MVertexPairs VertVertMap;
   for(std::size_t iEnt = 0; iEnt < entitiesPer.size(); iEnt++) {
     GEntity *slaveEnt = entitiesPer[iEnt];
     GEntity *masterEnt = slaveEnt->getMeshMaster();
@@ -250,8 +250,7 @@ void GEntity::updateCorrespondingVertices()
 void GEntity::copyMasterCoordinates()
 {
   if(_meshMaster != this && affineTransform.size() == 16) {
-    std::map<MVertex *, MVertex *>::iterator cvIter =
-      correspondingVertices.begin();
+    MVertexPairs::iterator cvIter = correspondingVertices.begin();
 
     for(; cvIter != correspondingVertices.end(); ++cvIter) {
       MVertex *tv = cvIter->first;
@@ -15,6 +15,7 @@
 #include "SBoundingBox3d.h"
 #include "SOrientedBoundingBox.h"
 #include "affineTransformation.h"
+#include "MVertexPairs.h"
 
 #define MAX_LC 1.e22
 
@@ -392,10 +393,10 @@ public:
   std::vector<double> affineTransform;
 
   // corresponding mesh vertices
-  std::map<MVertex *, MVertex *> correspondingVertices;
+  MVertexPairs correspondingVertices;
 
   // corresponding high order control points
-  std::map<MVertex *, MVertex *> correspondingHOPoints;
+  MVertexPairs correspondingHOPoints;
 
   // reorder the mesh elements of the given type, according to ordering
   virtual bool reorder(const int elementType, const std::vector<std::size_t> &ordering)
@@ -2249,8 +2249,7 @@ void GFace::alignElementsWithMaster()
       for(std::size_t j = 0; j < face->getNumVertices(); j++) {
         MVertex *tv = face->getVertex(j);
 
-        std::map<MVertex *, MVertex *>::iterator cIter =
-          correspondingVertices.find(tv);
+        MVertexPairs::iterator cIter = correspondingVertices.find(tv);
         if(cIter != correspondingVertices.end()) vtcs.push_back(cIter->second);
       }
 
@@ -4,6 +4,7 @@
 // issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <limits>
+#include <functional>
 #include <stdlib.h>
 #include <sstream>
 #include <stack>
@@ -33,6 +34,7 @@
 #include "partitionVertex.h"
 #include "gmshSurface.h"
 #include "SmoothData.h"
+#include "MemoryPool.h"
 #include "Context.h"
 #include "OS.h"
 #include "StringUtils.h"
@@ -219,6 +221,7 @@ void GModel::destroyMeshCaches()
 
 void GModel::deleteMesh()
 {
+  double t1 = TimeOfDay();
   for(riter it = firstRegion(); it != lastRegion(); ++it)
     (*it)->deleteMesh();
   for(fiter it = firstFace(); it != lastFace(); ++it)
@@ -231,6 +234,14 @@ void GModel::deleteMesh()
   _currentMeshEntity = 0;
   _lastMeshEntityError.clear();
   _lastMeshVertexError.clear();
+
+  // give the vertex and element slabs that are not used by another mesh back
+  // to the system (this must not happen while another thread allocates
+  // vertices or elements, e.g. while another model is being meshed)
+  std::size_t mem = MemoryPool::getReservedMemory();
+  if(mem && MemoryPool::releaseUnused())
+    Msg::Debug("Deleted mesh in %g s (%g Mb released)", TimeOfDay() - t1,
+               (mem - MemoryPool::getReservedMemory()) / 1024. / 1024.);
 }
 
 void GModel::deleteVertexArrays()
@@ -1375,6 +1386,88 @@ int GModel::addMFace(const MFace &face)
   return it.first->second;
 }
 
+// order mesh edges or faces (given by their index in a vector) by their
+// sorted vertices, and then by index
+template <class T> class meshEntityIndexLessThan {
+private:
+  const std::vector<T> &_ents;
+
+public:
+  meshEntityIndexLessThan(const std::vector<T> &ents) : _ents(ents) {}
+  bool operator()(std::size_t i, std::size_t j) const
+  {
+    const T &a = _ents[i], &b = _ents[j];
+    if(a.getNumVertices() != b.getNumVertices())
+      return a.getNumVertices() < b.getNumVertices();
+    std::less<MVertex *> lt;
+    for(std::size_t k = 0; k < a.getNumVertices(); k++) {
+      if(lt(a.getSortedVertex(k), b.getSortedVertex(k))) return true;
+      if(lt(b.getSortedVertex(k), a.getSortedVertex(k))) return false;
+    }
+    return i < j;
+  }
+};
+
+template <class T, class H>
+static void addMeshEntities(const std::vector<T> &ents, H &map,
+                            std::vector<int> &num)
+{
+  const std::size_t n = ents.size();
+  num.resize(n);
+
+  // look up the entities that are already numbered (concurrent lookups in
+  // the hash map are safe)
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < (int)n; i++) {
+    typename H::const_iterator it = map.find(ents[i]);
+    num[i] = (it == map.end()) ? -1 : it->second;
+  }
+
+  // group the occurrences of the new entities by sorting them; in each group
+  // the first index is the first occurrence of the entity
+  std::vector<std::size_t> idx;
+  for(std::size_t i = 0; i < n; i++)
+    if(num[i] < 0) idx.push_back(i);
+  if(idx.empty()) return;
+  std::sort(idx.begin(), idx.end(), meshEntityIndexLessThan<T>(ents));
+
+  std::vector<std::size_t> group(idx.size());
+  std::vector<int> firstOf(n, -1);
+  int numGroups = 0;
+  for(std::size_t k = 0; k < idx.size(); k++) {
+    if(k == 0 || !(ents[idx[k]] == ents[idx[k - 1]])) {
+      firstOf[idx[k]] = numGroups;
+      numGroups++;
+    }
+    group[k] = numGroups - 1;
+  }
+
+  // number the new entities in the order of their first occurrence
+  std::vector<int> groupNum(numGroups);
+#if __cplusplus >= 201103L
+  map.reserve(map.size() + numGroups);
+#endif
+  for(std::size_t i = 0; i < n; i++) {
+    if(firstOf[i] < 0) continue;
+    const int m = (int)map.size();
+    map.insert(std::make_pair(ents[i], m));
+    groupNum[firstOf[i]] = m;
+  }
+  for(std::size_t k = 0; k < idx.size(); k++) num[idx[k]] = groupNum[group[k]];
+}
+
+void GModel::addMEdges(const std::vector<MEdge> &edges, std::vector<int> &num)
+{
+  addMeshEntities(edges, _mapEdgeNum, num);
+}
+
+void GModel::addMFaces(const std::vector<MFace> &faces, std::vector<int> &num)
+{
+  addMeshEntities(faces, _mapFaceNum, num);
+}
+
 void GModel::renumberMeshVertices()
 {
   destroyMeshCaches();
@@ -2225,28 +2318,25 @@ int GModel::removeDuplicateMeshVertices(double tolerance)
       }
     }
     // replace vertices in periodic copies
-    std::map<MVertex *, MVertex *> &corrVtcs = ge->correspondingVertices;
+    MVertexPairs &corrVtcs = ge->correspondingVertices;
     if(corrVtcs.size()) {
       std::map<MVertex *, MVertex *>::iterator cIter;
       for(cIter = duplicates.begin(); cIter != duplicates.end(); ++cIter) {
         MVertex *oldTgt = cIter->first;
         MVertex *newTgt = cIter->second;
-        std::map<MVertex *, MVertex *>::iterator cvIter = corrVtcs.find(oldTgt);
+        MVertexPairs::iterator cvIter = corrVtcs.find(oldTgt);
         if(cvIter != corrVtcs.end()) {
           MVertex *src = cvIter->second;
           corrVtcs.erase(cvIter);
           corrVtcs[newTgt] = src;
         }
       }
-      for(cIter = corrVtcs.begin(); cIter != corrVtcs.end(); ++cIter) {
-        MVertex *oldSrc = cIter->second;
+      for(MVertexPairs::iterator cvIter = corrVtcs.begin();
+          cvIter != corrVtcs.end(); ++cvIter) {
+        MVertex *oldSrc = cvIter->second;
         std::map<MVertex *, MVertex *>::iterator nIter =
           duplicates.find(oldSrc);
-        if(nIter != duplicates.end()) {
-          MVertex *tgt = cIter->first;
-          MVertex *newSrc = nIter->second;
-          corrVtcs[tgt] = newSrc;
-        }
+        if(nIter != duplicates.end()) cvIter->second = nIter->second;
       }
     }
   }
@@ -2269,6 +2359,21 @@ int GModel::removeDuplicateMeshVertices(double tolerance)
   return num;
 }
 
+static MVertex *periodicCounterpart(GEntity *tgt, MVertex *v)
+{
+  // look in the correspondence of the entity, then in the one of the entity
+  // on which the node is classified
+  MVertexPairs::iterator it = tgt->correspondingVertices.find(v);
+  if(it != tgt->correspondingVertices.end() && it->second) return it->second;
+  GEntity *ge = v->onWhat();
+  it = ge->correspondingVertices.find(v);
+  if(it != ge->correspondingVertices.end() && it->second) return it->second;
+  Msg::Debug("Could not find periodic counterpart of node %d on entity %d "
+             "or on entity %d of dimension %d", v->getNum(), tgt->tag(),
+             ge->tag(), ge->dim());
+  return 0;
+}
+
 void GModel::alignPeriodicBoundaries()
 {
   // Is this still necessary/useful?
@@ -2286,7 +2391,8 @@ void GModel::alignPeriodicBoundaries()
     if(src != NULL && src != tgt) {
       // compose a search list on master edge
 
-      std::map<MEdge, MLine *, MEdgeLessThan> srcLines;
+      std::unordered_map<MEdge, MLine *, MEdgeHash, MEdgeEqual> srcLines;
+      srcLines.reserve(src->getNumMeshElements());
       for(std::size_t i = 0; i < src->getNumMeshElements(); i++) {
         MLine *srcLine = dynamic_cast<MLine *>(src->getMeshElement(i));
         if(!srcLine) {
@@ -2299,43 +2405,37 @@ void GModel::alignPeriodicBoundaries()
 
       // run through slave edge elements
       // - check whether we find a counterpart (if not, abort)
-      // - check orientation and reorient if necessary
+      // - check orientation and reorient if necessary (only once all the
+      //   counterparts have been found)
 
-      for(std::size_t i = 0; i < tgt->getNumMeshElements(); ++i) {
+      bool ok = true;
+      std::vector<char> reverse(tgt->getNumMeshElements(), 0);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) reduction(&& : ok)
+#endif
+      for(int i = 0; i < (int)tgt->getNumMeshElements(); ++i) {
+        if(!ok) continue;
         MLine *tgtLine = dynamic_cast<MLine *>(tgt->getMeshElement(i));
 
         if(!tgtLine) {
           Msg::Debug("Slave element %d is not a line",
                      tgt->getMeshElement(i)->getNum());
-          return;
+          ok = false;
+          continue;
         }
 
         MVertex *tgtVtcs[2];
-        for(int iVtx = 0; iVtx < 2; iVtx++) {
-          MVertex *tgtVtx = tgtLine->getVertex(iVtx);
-          GEntity *ge = tgtVtx->onWhat();
-          std::map<MVertex *, MVertex *> &geV2v = ge->correspondingVertices;
-          std::map<MVertex *, MVertex *> &v2v = tgt->correspondingVertices;
-          std::map<MVertex *, MVertex *>::iterator srcIter = v2v.find(tgtVtx);
-          if(srcIter == v2v.end() || !srcIter->second) {
-            srcIter = geV2v.find(tgtVtx);
-            if(srcIter == geV2v.end() || !srcIter->second) {
-              Msg::Debug("Could not find periodic counterpart of node %d on curve %d "
-                         "or on entity %d of dimension %d",
-                         tgtVtx->getNum(), tgt->tag(), ge->tag(), ge->dim());
-              return;
-            }
-            else
-              tgtVtcs[iVtx] = srcIter->second;
-          }
-          else
-            tgtVtcs[iVtx] = srcIter->second;
+        tgtVtcs[0] = periodicCounterpart(tgt, tgtLine->getVertex(0));
+        tgtVtcs[1] = periodicCounterpart(tgt, tgtLine->getVertex(1));
+        if(!tgtVtcs[0] || !tgtVtcs[1]) {
+          ok = false;
+          continue;
         }
 
         MEdge tgtEdge(tgtVtcs[0], tgtVtcs[1]);
 
-        std::map<MEdge, MLine *, MEdgeLessThan>::iterator sIter =
-          srcLines.find(tgtEdge);
+        std::unordered_map<MEdge, MLine *, MEdgeHash, MEdgeEqual>::iterator
+          sIter = srcLines.find(tgtEdge);
 
         if(sIter == srcLines.end() || !sIter->second) {
           Msg::Debug("Could not find periodic counterpart of mesh edge %d-%d on "
@@ -2343,14 +2443,17 @@ void GModel::alignPeriodicBoundaries()
                      tgtLine->getVertex(0)->getNum(),
                      tgtLine->getVertex(1)->getNum(), tgt->tag(),
                      tgtVtcs[0]->getNum(), tgtVtcs[1]->getNum(), src->tag());
-          return;
+          ok = false;
         }
         else {
           MLine *srcLine = sIter->second;
           MEdge srcEdge(srcLine->getVertex(0), srcLine->getVertex(1));
-          if(tgtEdge.computeCorrespondence(srcEdge) == -1) tgtLine->reverse();
+          if(tgtEdge.computeCorrespondence(srcEdge) == -1) reverse[i] = 1;
         }
       }
+      if(!ok) return;
+      for(std::size_t i = 0; i < reverse.size(); i++)
+        if(reverse[i]) tgt->getMeshElement(i)->reverse();
     }
   }
 
@@ -2360,7 +2463,8 @@ void GModel::alignPeriodicBoundaries()
     GFace *tgt = *it;
     GFace *src = dynamic_cast<GFace *>(tgt->getMeshMaster());
     if(src != NULL && src != tgt) {
-      std::map<MFace, MElement *, MFaceLessThan> srcElmts;
+      std::unordered_map<MFace, MElement *, MFaceHash, MFaceEqual> srcElmts;
+      srcElmts.reserve(src->getNumMeshElements());
 
       for(std::size_t i = 0; i < src->getNumMeshElements(); ++i) {
         MElement *srcElmt = src->getMeshElement(i);
@@ -2375,7 +2479,17 @@ void GModel::alignPeriodicBoundaries()
         srcElmts[MFace(vtcs)] = srcElmt;
       }
 
-      for(std::size_t i = 0; i < tgt->getNumMeshElements(); ++i) {
+      // each slave element is only reoriented with respect to its own
+      // counterpart, so that the correspondences can be computed in parallel;
+      // the elements are only reoriented if all the counterparts are found
+      bool ok = true;
+      std::vector<int> rotations(tgt->getNumMeshElements(), 0);
+      std::vector<char> swaps(tgt->getNumMeshElements(), 0);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) reduction(&& : ok)
+#endif
+      for(int i = 0; i < (int)tgt->getNumMeshElements(); ++i) {
+        if(!ok) continue;
         MElement *tgtElmt = tgt->getMeshElement(i);
         MTriangle *tgtTri = dynamic_cast<MTriangle *>(tgtElmt);
         MQuadrangle *tgtQua = dynamic_cast<MQuadrangle *>(tgtElmt);
@@ -2386,30 +2500,18 @@ void GModel::alignPeriodicBoundaries()
 
         std::vector<MVertex *> vtcs;
         for(int iVtx = 0; iVtx < nbVtcs; iVtx++) {
-          MVertex *vtx = tgtElmt->getVertex(iVtx);
-          GEntity *ge = vtx->onWhat();
-
-          std::map<MVertex *, MVertex *> &geV2v = ge->correspondingVertices;
-          std::map<MVertex *, MVertex *> &v2v = tgt->correspondingVertices;
-
-          std::map<MVertex *, MVertex *>::iterator vIter = v2v.find(vtx);
-          if(vIter == v2v.end() || !vIter->second) {
-            vIter = geV2v.find(vtx);
-            if(vIter == geV2v.end() || !vIter->second) {
-              Msg::Debug("Could not find periodic counterpart of node %d in "
-                         "surface %d or in entity %d of dimension %d",
-                         vtx->getNum(), tgt->tag(), ge->tag(), ge->dim());
-              return;
-            }
-            else
-              vtcs.push_back(vIter->second);
-          }
-          else
-            vtcs.push_back(vIter->second);
+          MVertex *vtx = periodicCounterpart(tgt, tgtElmt->getVertex(iVtx));
+          if(!vtx) break;
+          vtcs.push_back(vtx);
+        }
+        if((int)vtcs.size() != nbVtcs) {
+          ok = false;
+          continue;
         }
         MFace tgtFace(vtcs);
 
-        std::map<MFace, MElement *>::iterator mIter = srcElmts.find(tgtFace);
+        std::unordered_map<MFace, MElement *, MFaceHash, MFaceEqual>::iterator
+          mIter = srcElmts.find(tgtFace);
         if(mIter == srcElmts.end()) {
           std::ostringstream faceDef;
           for(int iVtx = 0; iVtx < nbVtcs; iVtx++) {
@@ -2418,31 +2520,44 @@ void GModel::alignPeriodicBoundaries()
           Msg::Debug("Could not find periodic counterpart of mesh face %s in "
                      "surface %d connected to surface %d",
                      faceDef.str().c_str(), tgt->tag(), src->tag());
-          return;
+          ok = false;
+          continue;
         }
-        else {
-          const MFace &srcFace = mIter->first;
-          MElement *srcElmt = mIter->second;
-          std::vector<MVertex *> srcVtcs;
-
-          if(tgtTri && !dynamic_cast<MTriangle *>(srcElmt)) throw;
-          if(tgtQua && !dynamic_cast<MQuadrangle *>(srcElmt)) throw;
-
-          int rotation = 0;
-          bool swap = false;
-
-          if(!tgtFace.computeCorrespondence(srcFace, rotation, swap)) {
-            Msg::Debug("Could not find correspondance between mesh face %d-%d-%d (slave) "
-                       "and %d-%d-%d (master)",
-                       tgtElmt->getVertex(0)->getNum(), tgtElmt->getVertex(1)->getNum(),
-                       tgtElmt->getVertex(2)->getNum(), srcElmt->getVertex(0)->getNum(),
-                       srcElmt->getVertex(1)->getNum(), srcElmt->getVertex(2)->getNum());
-            return;
-          }
 
-          if(tgtTri) tgtTri->reorient(rotation, swap);
-          if(tgtQua) tgtQua->reorient(rotation, swap);
+        const MFace &srcFace = mIter->first;
+        MElement *srcElmt = mIter->second;
+
+        if((tgtTri && !dynamic_cast<MTriangle *>(srcElmt)) ||
+           (tgtQua && !dynamic_cast<MQuadrangle *>(srcElmt))) {
+          Msg::Debug("Periodic counterpart of element %d is of a different "
+                     "type", tgtElmt->getNum());
+          ok = false;
+          continue;
         }
+
+        int rotation = 0;
+        bool swap = false;
+
+        if(!tgtFace.computeCorrespondence(srcFace, rotation, swap)) {
+          Msg::Debug("Could not find correspondance between mesh face %d-%d-%d (slave) "
+                     "and %d-%d-%d (master)",
+                     tgtElmt->getVertex(0)->getNum(), tgtElmt->getVertex(1)->getNum(),
+                     tgtElmt->getVertex(2)->getNum(), srcElmt->getVertex(0)->getNum(),
+                     srcElmt->getVertex(1)->getNum(), srcElmt->getVertex(2)->getNum());
+          ok = false;
+          continue;
+        }
+
+        rotations[i] = rotation;
+        swaps[i] = swap ? 1 : 0;
+      }
+      if(!ok) return;
+      for(std::size_t i = 0; i < rotations.size(); i++) {
+        MElement *tgtElmt = tgt->getMeshElement(i);
+        MTriangle *tgtTri = dynamic_cast<MTriangle *>(tgtElmt);
+        MQuadrangle *tgtQua = dynamic_cast<MQuadrangle *>(tgtElmt);
+        if(tgtTri) tgtTri->reorient(rotations[i], swaps[i] ? true : false);
+        if(tgtQua) tgtQua->reorient(rotations[i], swaps[i] ? true : false);
       }
     }
   }
@@ -241,6 +241,11 @@ public:
   int addMEdge(const MEdge &edge);
   //number the faces
   int addMFace(const MFace &face);
+  // number a list of edges (resp. faces) in parallel: num[i] is the number of
+  // edges[i], new edges being numbered in the order of their first occurrence,
+  // exactly as if addMEdge() was called on each edge in turn
+  void addMEdges(const std::vector<MEdge> &edges, std::vector<int> &num);
+  void addMFaces(const std::vector<MFace> &faces, std::vector<int> &num);
 
   // renumber mesh vertices and elements in a continuous sequence (this
   // invalidates the mesh caches)
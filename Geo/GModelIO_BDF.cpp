@@ -14,6 +14,7 @@
 #include "MHexahedron.h"
 #include "MPrism.h"
 #include "MPyramid.h"
+#include "TextBuffer.h"
 
 static int getFormatBDF(char *buffer, int &keySize)
 {
@@ -351,20 +352,44 @@ int GModel::writeBDF(const std::string &name, int format, int elementTagType,
   std::vector<GEntity *> entities;
   getEntities(entities);
 
-  // nodes
+  // nodes (chunks of entities are formatted in parallel and written in order)
+  std::vector<TextBufferChunk> chunks;
   for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeBDF(fp, format, scalingFactor);
+    addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->mesh_vertices[j]->writeBDF(buf, format, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
+  }
 
   // elements
+  chunks.clear();
   for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-      int numPhys = entities[i]->physicals.size();
-      if(saveAll || numPhys)
-        entities[i]->getMeshElement(j)->writeBDF(
-          fp, format, elementTagType, entities[i]->tag(),
-          numPhys ? entities[i]->physicals[0] : 0);
-    }
+    if(saveAll || entities[i]->physicals.size())
+      addTextBufferChunks(chunks, i, entities[i]->getNumMeshElements());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    int numPhys = ge->physicals.size();
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->getMeshElement(j)->writeBDF(buf, format, elementTagType, ge->tag(),
+                                      numPhys ? ge->physicals[0] : 0);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
+  }
 
   fprintf(fp, "ENDDATA\n");
 
@@ -13,24 +13,85 @@
 #include "MHexahedron.h"
 #include "MPrism.h"
 #include "MPyramid.h"
+#include "TextBuffer.h"
 
 template <class T>
-static void writeElementsINP(FILE *fp, GEntity *ge, std::vector<T *> &elements,
-                             bool saveAll)
+static void writeElementsINP(TextBuffer &buf, GEntity *ge,
+                             std::vector<T *> &elements, std::size_t begin,
+                             std::size_t end)
 {
-  if(elements.size() && (saveAll || ge->physicals.size())) {
-    const char *typ = elements[0]->getStringForINP();
-    if(typ) {
-      const char *str =
-        (ge->dim() == 3) ? "Volume" :
-        (ge->dim() == 2) ? "Surface" :
-        (ge->dim() == 1) ? "Line" :
-        "Point"; // currently unused
-      fprintf(fp, "*ELEMENT, type=%s, ELSET=%s%d\n", typ, str, ge->tag());
-      for(std::size_t i = 0; i < elements.size(); i++)
-        elements[i]->writeINP(fp, elements[i]->getNum());
+  if(begin >= end || end > elements.size()) return;
+  const char *typ = elements[0]->getStringForINP();
+  if(!typ) return;
+  if(!begin) {
+    const char *str =
+      (ge->dim() == 3) ? "Volume" :
+      (ge->dim() == 2) ? "Surface" :
+      (ge->dim() == 1) ? "Line" :
+      "Point"; // currently unused
+    buf.addString("*ELEMENT, type=");
+    buf.addString(typ);
+    buf.addString(", ELSET=");
+    buf.addString(str);
+    buf.addInt(ge->tag());
+    buf.addChar('\n');
+  }
+  for(std::size_t i = begin; i < end; i++)
+    elements[i]->writeINP(buf, elements[i]->getNum());
+}
+
+// the element vectors of an entity that are saved ("parts" of the entity);
+// calling with buf == 0 returns the size of the vector
+static std::size_t writeElementsINP(TextBuffer *buf, GEntity *ge, int part,
+                                    std::size_t begin = 0, std::size_t end = 0)
+{
+  switch(ge->dim()) {
+  case 0: {
+    GVertex *gv = static_cast<GVertex *>(ge);
+    if(part == 0) {
+      if(buf) writeElementsINP(*buf, ge, gv->points, begin, end);
+      return gv->points.size();
+    }
+  } break;
+  case 1: {
+    GEdge *ed = static_cast<GEdge *>(ge);
+    if(part == 0) {
+      if(buf) writeElementsINP(*buf, ge, ed->lines, begin, end);
+      return ed->lines.size();
+    }
+  } break;
+  case 2: {
+    GFace *gf = static_cast<GFace *>(ge);
+    if(part == 0) {
+      if(buf) writeElementsINP(*buf, ge, gf->triangles, begin, end);
+      return gf->triangles.size();
+    }
+    if(part == 1) {
+      if(buf) writeElementsINP(*buf, ge, gf->quadrangles, begin, end);
+      return gf->quadrangles.size();
     }
+  } break;
+  case 3: {
+    GRegion *gr = static_cast<GRegion *>(ge);
+    if(part == 0) {
+      if(buf) writeElementsINP(*buf, ge, gr->tetrahedra, begin, end);
+      return gr->tetrahedra.size();
+    }
+    if(part == 1) {
+      if(buf) writeElementsINP(*buf, ge, gr->hexahedra, begin, end);
+      return gr->hexahedra.size();
+    }
+    if(part == 2) {
+      if(buf) writeElementsINP(*buf, ge, gr->prisms, begin, end);
+      return gr->prisms.size();
+    }
+    if(part == 3) {
+      if(buf) writeElementsINP(*buf, ge, gr->pyramids, begin, end);
+      return gr->pyramids.size();
+    }
+  } break;
   }
+  return 0;
 }
 
 static std::string physicalName(GModel *m, int dim, int num)
@@ -69,27 +130,44 @@ int GModel::writeINP(const std::string &name, bool saveAll,
   fprintf(fp, "*Heading\n");
   fprintf(fp, " %s\n", name.c_str());
 
+  // format chunks of the entities in parallel, and write them in order
   fprintf(fp, "*NODE\n");
+  std::vector<TextBufferChunk> chunks;
   for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeINP(fp, scalingFactor);
+    addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->mesh_vertices[j]->writeINP(buf, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
+  }
 
   fprintf(fp, "******* E L E M E N T S *************\n");
-  for(viter it = firstVertex(); it != lastVertex(); ++it) {
-    writeElementsINP(fp, *it, (*it)->points, saveAll);
-  }
-  for(eiter it = firstEdge(); it != lastEdge(); ++it) {
-    writeElementsINP(fp, *it, (*it)->lines, saveAll);
-  }
-  for(fiter it = firstFace(); it != lastFace(); ++it) {
-    writeElementsINP(fp, *it, (*it)->triangles, saveAll);
-    writeElementsINP(fp, *it, (*it)->quadrangles, saveAll);
+  chunks.clear();
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    if(!saveAll && entities[i]->physicals.empty()) continue;
+    for(int part = 0; part < 4; part++)
+      addTextBufferChunks(chunks, i, writeElementsINP(0, entities[i], part),
+                          part);
   }
-  for(riter it = firstRegion(); it != lastRegion(); ++it) {
-    writeElementsINP(fp, *it, (*it)->tetrahedra, saveAll);
-    writeElementsINP(fp, *it, (*it)->hexahedra, saveAll);
-    writeElementsINP(fp, *it, (*it)->prisms, saveAll);
-    writeElementsINP(fp, *it, (*it)->pyramids, saveAll);
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    TextBuffer buf;
+    writeElementsINP(&buf, entities[chunks[c].entity], chunks[c].part,
+                     chunks[c].begin, chunks[c].end);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
   }
 
   std::map<int, std::vector<GEntity *> > groups[4];
@@ -103,16 +181,20 @@ int GModel::writeINP(const std::string &name, bool saveAll,
       std::vector<GEntity *> &entities = it->second;
       fprintf(fp, "*ELSET,ELSET=%s\n",
               physicalName(this, dim, it->first).c_str());
+      TextBuffer buf;
       int n = 0;
       for(std::size_t i = 0; i < entities.size(); i++) {
         for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
           MElement *e = entities[i]->getMeshElement(j);
-          if(n && !(n % 10)) fprintf(fp, "\n");
-          fprintf(fp, "%lu, ", e->getNum());
+          if(n && !(n % 10)) buf.addChar('\n');
+          buf.addUnsigned(e->getNum());
+          buf.addString(", ");
           n++;
+          if(buf.size() > (1 << 20)) buf.write(fp);
         }
       }
-      fprintf(fp, "\n");
+      buf.addChar('\n');
+      buf.write(fp);
     }
   }
 
@@ -133,14 +215,18 @@ int GModel::writeINP(const std::string &name, bool saveAll,
         }
         fprintf(fp, "*NSET,NSET=%s\n",
                 physicalName(this, dim, it->first).c_str());
+        TextBuffer buf;
         int n = 0;
         for(std::set<MVertex *>::iterator it2 = nodes.begin();
             it2 != nodes.end(); it2++) {
-          if(n && !(n % 10)) fprintf(fp, "\n");
-          fprintf(fp, "%ld, ", (*it2)->getIndex());
+          if(n && !(n % 10)) buf.addChar('\n');
+          buf.addInt((*it2)->getIndex());
+          buf.addString(", ");
           n++;
+          if(buf.size() > (1 << 20)) buf.write(fp);
         }
-        fprintf(fp, "\n");
+        buf.addChar('\n');
+        buf.write(fp);
       }
     }
   }
@@ -13,6 +13,7 @@
 #include "MTetrahedron.h"
 #include "MHexahedron.h"
 #include "Context.h"
+#include "TextBuffer.h"
 
 static bool getMeshVertices(int num, int *indices, std::vector<MVertex *> &vec,
                             std::vector<MVertex *> &vertices)
@@ -238,6 +239,21 @@ int GModel::readMESH(const std::string &name)
   return 1;
 }
 
+template <class T>
+static void writeElementsMESH(FILE *fp, TextBuffer &buf, GEntity *ge,
+                              std::vector<T *> &elements, int elementTagType,
+                              bool saveAll)
+{
+  int numPhys = ge->physicals.size();
+  if(saveAll || numPhys) {
+    for(std::size_t i = 0; i < elements.size(); i++) {
+      elements[i]->writeMESH(buf, elementTagType, ge->tag(),
+                             numPhys ? ge->physicals[0] : 0);
+      if(buf.size() > (1 << 20)) buf.write(fp);
+    }
+  }
+}
+
 int GModel::writeMESH(const std::string &name, int elementTagType, bool saveAll,
                       double scalingFactor)
 {
@@ -259,9 +275,23 @@ int GModel::writeMESH(const std::string &name, int elementTagType, bool saveAll,
   fprintf(fp, " %d\n", numVertices);
   std::vector<GEntity *> entities;
   getEntities(entities);
+  // (chunks of entities are formatted in parallel and written in order)
+  std::vector<TextBufferChunk> chunks;
   for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeMESH(fp, scalingFactor);
+    addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->mesh_vertices[j]->writeMESH(buf, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
+  }
 
   int numEdges = 0, numTriangles = 0, numQuadrangles = 0;
   int numTetrahedra = 0, numHexahedra = 0;
@@ -289,14 +319,10 @@ int GModel::writeMESH(const std::string &name, int elementTagType, bool saveAll,
     else
       fprintf(fp, " Edges\n");
     fprintf(fp, " %d\n", numEdges);
-    for(eiter it = firstEdge(); it != lastEdge(); ++it) {
-      int numPhys = (*it)->physicals.size();
-      if(saveAll || numPhys) {
-        for(std::size_t i = 0; i < (*it)->lines.size(); i++)
-          (*it)->lines[i]->writeMESH(fp, elementTagType, (*it)->tag(),
-                                     numPhys ? (*it)->physicals[0] : 0);
-      }
-    }
+    TextBuffer buf;
+    for(eiter it = firstEdge(); it != lastEdge(); ++it)
+      writeElementsMESH(fp, buf, *it, (*it)->lines, elementTagType, saveAll);
+    buf.write(fp);
   }
   if(numTriangles) {
     if(CTX::instance()->mesh.order == 2) // FIXME (check getPolynomialOrder())
@@ -304,26 +330,18 @@ int GModel::writeMESH(const std::string &name, int elementTagType, bool saveAll,
     else
       fprintf(fp, " Triangles\n");
     fprintf(fp, " %d\n", numTriangles);
-    for(fiter it = firstFace(); it != lastFace(); ++it) {
-      int numPhys = (*it)->physicals.size();
-      if(saveAll || numPhys) {
-        for(std::size_t i = 0; i < (*it)->triangles.size(); i++)
-          (*it)->triangles[i]->writeMESH(fp, elementTagType, (*it)->tag(),
-                                         numPhys ? (*it)->physicals[0] : 0);
-      }
-    }
+    TextBuffer buf;
+    for(fiter it = firstFace(); it != lastFace(); ++it)
+      writeElementsMESH(fp, buf, *it, (*it)->triangles, elementTagType, saveAll);
+    buf.write(fp);
   }
   if(numQuadrangles) {
     fprintf(fp, " Quadrilaterals\n");
     fprintf(fp, " %d\n", numQuadrangles);
-    for(fiter it = firstFace(); it != lastFace(); ++it) {
-      int numPhys = (*it)->physicals.size();
-      if(saveAll || numPhys) {
-        for(std::size_t i = 0; i < (*it)->quadrangles.size(); i++)
-          (*it)->quadrangles[i]->writeMESH(fp, elementTagType, (*it)->tag(),
-                                           numPhys ? (*it)->physicals[0] : 0);
-      }
-    }
+    TextBuffer buf;
+    for(fiter it = firstFace(); it != lastFace(); ++it)
+      writeElementsMESH(fp, buf, *it, (*it)->quadrangles, elementTagType, saveAll);
+    buf.write(fp);
   }
   if(numTetrahedra) {
     if(CTX::instance()->mesh.order == 2)
@@ -331,26 +349,18 @@ int GModel::writeMESH(const std::string &name, int elementTagType, bool saveAll,
     else
       fprintf(fp, " Tetrahedra\n");
     fprintf(fp, " %d\n", numTetrahedra);
-    for(riter it = firstRegion(); it != lastRegion(); ++it) {
-      int numPhys = (*it)->physicals.size();
-      if(saveAll || numPhys) {
-        for(std::size_t i = 0; i < (*it)->tetrahedra.size(); i++)
-          (*it)->tetrahedra[i]->writeMESH(fp, elementTagType, (*it)->tag(),
-                                          numPhys ? (*it)->physicals[0] : 0);
-      }
-    }
+    TextBuffer buf;
+    for(riter it = firstRegion(); it != lastRegion(); ++it)
+      writeElementsMESH(fp, buf, *it, (*it)->tetrahedra, elementTagType, saveAll);
+    buf.write(fp);
   }
   if(numHexahedra) {
     fprintf(fp, " Hexahedra\n");
     fprintf(fp, " %d\n", numHexahedra);
-    for(riter it = firstRegion(); it != lastRegion(); ++it) {
-      int numPhys = (*it)->physicals.size();
-      if(saveAll || numPhys) {
-        for(std::size_t i = 0; i < (*it)->hexahedra.size(); i++)
-          (*it)->hexahedra[i]->writeMESH(fp, elementTagType, (*it)->tag(),
-                                         numPhys ? (*it)->physicals[0] : 0);
-      }
-    }
+    TextBuffer buf;
+    for(riter it = firstRegion(); it != lastRegion(); ++it)
+      writeElementsMESH(fp, buf, *it, (*it)->hexahedra, elementTagType, saveAll);
+    buf.write(fp);
   }
 
   fprintf(fp, " End\n");
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <map>
+#include <unordered_map>
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <cassert>
@@ -29,6 +31,7 @@
 #include "ghostEdge.h"
 #include "ghostFace.h"
 #include "ghostRegion.h"
+#include "TextBuffer.h"
 
 // periodic nodes and entities backported from MSH3 format
 extern void writeMSHPeriodicNodes(FILE *fp, std::vector<GEntity *> &entities,
@@ -36,36 +39,81 @@ extern void writeMSHPeriodicNodes(FILE *fp, std::vector<GEntity *> &entities,
 extern void readMSHPeriodicNodes(FILE *fp, GModel *gm);
 extern void writeMSHEntities(FILE *fp, GModel *gm);
 
-static bool getMeshVertices(int num, int *indices,
-                            std::map<int, MVertex *> &map,
+// node tag -> node lookup: a vector indexed by tag for (fairly) dense
+// numberings, or a vector sorted by tag otherwise
+static bool getMeshVertices(int num, const int *indices,
+                            std::vector<MVertex *> &vec,
+                            std::vector<std::pair<int, MVertex *> > &sorted,
                             std::vector<MVertex *> &vertices)
 {
   for(int i = 0; i < num; i++) {
-    if(!map.count(indices[i])) {
+    MVertex *v = 0;
+    if(vec.size()) {
+      if(indices[i] >= 0 && indices[i] < (int)vec.size()) v = vec[indices[i]];
+    }
+    else {
+      std::vector<std::pair<int, MVertex *> >::iterator it = std::lower_bound(
+        sorted.begin(), sorted.end(), std::make_pair(indices[i], (MVertex *)0));
+      if(it != sorted.end() && it->first == indices[i]) v = it->second;
+    }
+    if(!v) {
       Msg::Error("Wrong node index %d", indices[i]);
       return false;
     }
-    else
-      vertices.push_back(map[indices[i]]);
+    vertices.push_back(v);
   }
   return true;
 }
 
-static bool getMeshVertices(int num, int *indices, std::vector<MVertex *> &vec,
-                            std::vector<MVertex *> &vertices, int minVertex = 0)
+static bool nodeTagLessThan(const std::pair<int, MVertex *> &a,
+                            const std::pair<int, MVertex *> &b)
 {
-  for(int i = 0; i < num; i++) {
-    if(indices[i] < minVertex ||
-       indices[i] > (int)(vec.size() - 1 + minVertex)) {
-      Msg::Error("Wrong node index %d", indices[i]);
-      return false;
-    }
-    else
-      vertices.push_back(vec[indices[i]]);
-  }
-  return true;
+  return a.first < b.first;
 }
 
+namespace {
+  struct elementMSH2 {
+    int num, elementary, physical;
+    bool parent, owned;
+    MElement *e;
+  };
+
+  // element tag -> position in the list of elements read so far: dense vector
+  // for (fairly) dense numberings, hash map otherwise
+  class elementIndexMSH2 {
+  private:
+    std::size_t _maxDense;
+    std::vector<int> _dense;
+    std::unordered_map<int, int> _sparse;
+
+  public:
+    elementIndexMSH2(int numElements) : _maxDense(10 * (numElements + 1)) {}
+    void set(int num, int i)
+    {
+      if(num >= 0 && (std::size_t)num < _maxDense) {
+        if((std::size_t)num >= _dense.size())
+          _dense.resize(std::max((std::size_t)num + 1, 2 * _dense.size()), -1);
+        _dense[num] = i;
+      }
+      else
+        _sparse[num] = i;
+    }
+    int get(int num) const
+    {
+      if(num >= 0 && (std::size_t)num < _maxDense)
+        return (std::size_t)num < _dense.size() ? _dense[num] : -1;
+      std::unordered_map<int, int>::const_iterator it = _sparse.find(num);
+      return (it == _sparse.end()) ? -1 : it->second;
+    }
+  };
+
+  struct elementMSH2NumLessThan {
+    const std::vector<elementMSH2> &elms;
+    elementMSH2NumLessThan(const std::vector<elementMSH2> &e) : elms(e) {}
+    bool operator()(int i, int j) const { return elms[i].num < elms[j].num; }
+  };
+} // namespace
+
 static MElement *
 createElementMSH2(GModel *m, int num, int typeMSH, int physical, int reg,
                   unsigned int part, std::vector<MVertex *> &v,
@@ -110,9 +158,8 @@ int GModel::_readMSH2(const std::string &name)
   bool binary = false, swap = false, postpro = false;
   std::map<int, std::vector<MElement *> > elements[10];
   std::map<int, std::map<int, std::string> > physicals[4];
-  std::map<int, MVertex *> vertexMap;
   std::vector<MVertex *> vertexVector;
-  int minVertex = 0;
+  std::vector<std::pair<int, MVertex *> > vertexSorted;
 
   while(1) {
     while(str[0] != '$') {
@@ -190,134 +237,164 @@ int GModel::_readMSH2(const std::string &name)
       Msg::Info("%d nodes", numVertices);
       Msg::StartProgressMeter(numVertices);
       vertexVector.clear();
-      vertexMap.clear();
-      minVertex = numVertices + 1;
-      int maxVertex = -1;
-      for(int i = 0; i < numVertices; i++) {
-        int num;
-        double xyz[3], uv[2];
-        MVertex *newVertex = 0;
-        if(!parametric) {
-          if(!binary) {
-            if(fscanf(fp, "%d %lf %lf %lf", &num, &xyz[0], &xyz[1], &xyz[2]) !=
-               4) {
-              fclose(fp);
-              return 0;
-            }
-          }
-          else {
-            if(fread(&num, sizeof(int), 1, fp) != 1) {
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)&num, sizeof(int), 1);
-            if(fread(xyz, sizeof(double), 3, fp) != 3) {
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)xyz, sizeof(double), 3);
-          }
-          newVertex = new MVertex(xyz[0], xyz[1], xyz[2], 0, num);
+      vertexSorted.clear();
+      std::vector<std::pair<int, MVertex *> > nodes;
+      nodes.reserve(std::max(numVertices, 0));
+      if(binary && !parametric) {
+        // read the tags and coordinates of all the nodes at once
+        const std::size_t rec = sizeof(int) + 3 * sizeof(double);
+        std::vector<char> buf(rec * std::max(numVertices, 0));
+        if(numVertices > 0 &&
+           fread(&buf[0], rec, numVertices, fp) != (std::size_t)numVertices) {
+          fclose(fp);
+          return 0;
         }
-        else {
-          int iClasDim, iClasTag;
-          if(!binary) {
-            if(fscanf(fp, "%d %lf %lf %lf %d %d", &num, &xyz[0], &xyz[1],
-                      &xyz[2], &iClasDim, &iClasTag) != 6) {
-              fclose(fp);
-              return 0;
-            }
-          }
-          else {
-            if(fread(&num, sizeof(int), 1, fp) != 1) {
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)&num, sizeof(int), 1);
-            if(fread(xyz, sizeof(double), 3, fp) != 3) {
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)xyz, sizeof(double), 3);
-            if(fread(&iClasDim, sizeof(int), 1, fp) != 1) {
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)&iClasDim, sizeof(int), 1);
-            if(fread(&iClasTag, sizeof(int), 1, fp) != 1) {
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)&iClasTag, sizeof(int), 1);
-          }
-          if(iClasDim == 0) {
-            GVertex *gv = getVertexByTag(iClasTag);
-            if(gv) gv->mesh_vertices.clear();
-            newVertex = new MVertex(xyz[0], xyz[1], xyz[2], gv, num);
+        for(int i = 0; i < numVertices; i++) {
+          int num;
+          double xyz[3];
+          memcpy(&num, &buf[rec * i], sizeof(int));
+          memcpy(xyz, &buf[rec * i + sizeof(int)], 3 * sizeof(double));
+          if(swap) {
+            SwapBytes((char *)&num, sizeof(int), 1);
+            SwapBytes((char *)xyz, sizeof(double), 3);
           }
-          else if(iClasDim == 1) {
-            GEdge *ge = getEdgeByTag(iClasTag);
+          nodes.push_back(
+            std::make_pair(num, new MVertex(xyz[0], xyz[1], xyz[2], 0, num)));
+        }
+      }
+      else {
+        for(int i = 0; i < numVertices; i++) {
+          int num;
+          double xyz[3], uv[2];
+          MVertex *newVertex = 0;
+          if(!parametric) {
             if(!binary) {
-              if(fscanf(fp, "%lf", &uv[0]) != 1) {
+              if(fscanf(fp, "%d %lf %lf %lf", &num, &xyz[0], &xyz[1], &xyz[2]) !=
+                 4) {
                 fclose(fp);
                 return 0;
               }
             }
             else {
-              if(fread(uv, sizeof(double), 1, fp) != 1) {
+              if(fread(&num, sizeof(int), 1, fp) != 1) {
+                fclose(fp);
+                return 0;
+              }
+              if(swap) SwapBytes((char *)&num, sizeof(int), 1);
+              if(fread(xyz, sizeof(double), 3, fp) != 3) {
                 fclose(fp);
                 return 0;
               }
-              if(swap) SwapBytes((char *)uv, sizeof(double), 1);
+              if(swap) SwapBytes((char *)xyz, sizeof(double), 3);
             }
-            newVertex = new MEdgeVertex(xyz[0], xyz[1], xyz[2], ge, uv[0], num);
+            newVertex = new MVertex(xyz[0], xyz[1], xyz[2], 0, num);
           }
-          else if(iClasDim == 2) {
-            GFace *gf = getFaceByTag(iClasTag);
+          else {
+            int iClasDim, iClasTag;
             if(!binary) {
-              if(fscanf(fp, "%lf %lf", &uv[0], &uv[1]) != 2) {
+              if(fscanf(fp, "%d %lf %lf %lf %d %d", &num, &xyz[0], &xyz[1],
+                        &xyz[2], &iClasDim, &iClasTag) != 6) {
                 fclose(fp);
                 return 0;
               }
             }
             else {
-              if(fread(uv, sizeof(double), 2, fp) != 2) {
+              if(fread(&num, sizeof(int), 1, fp) != 1) {
+                fclose(fp);
+                return 0;
+              }
+              if(swap) SwapBytes((char *)&num, sizeof(int), 1);
+              if(fread(xyz, sizeof(double), 3, fp) != 3) {
                 fclose(fp);
                 return 0;
               }
-              if(swap) SwapBytes((char *)uv, sizeof(double), 2);
+              if(swap) SwapBytes((char *)xyz, sizeof(double), 3);
+              if(fread(&iClasDim, sizeof(int), 1, fp) != 1) {
+                fclose(fp);
+                return 0;
+              }
+              if(swap) SwapBytes((char *)&iClasDim, sizeof(int), 1);
+              if(fread(&iClasTag, sizeof(int), 1, fp) != 1) {
+                fclose(fp);
+                return 0;
+              }
+              if(swap) SwapBytes((char *)&iClasTag, sizeof(int), 1);
+            }
+            if(iClasDim == 0) {
+              GVertex *gv = getVertexByTag(iClasTag);
+              if(gv) gv->mesh_vertices.clear();
+              newVertex = new MVertex(xyz[0], xyz[1], xyz[2], gv, num);
+            }
+            else if(iClasDim == 1) {
+              GEdge *ge = getEdgeByTag(iClasTag);
+              if(!binary) {
+                if(fscanf(fp, "%lf", &uv[0]) != 1) {
+                  fclose(fp);
+                  return 0;
+                }
+              }
+              else {
+                if(fread(uv, sizeof(double), 1, fp) != 1) {
+                  fclose(fp);
+                  return 0;
+                }
+                if(swap) SwapBytes((char *)uv, sizeof(double), 1);
+              }
+              newVertex = new MEdgeVertex(xyz[0], xyz[1], xyz[2], ge, uv[0], num);
+            }
+            else if(iClasDim == 2) {
+              GFace *gf = getFaceByTag(iClasTag);
+              if(!binary) {
+                if(fscanf(fp, "%lf %lf", &uv[0], &uv[1]) != 2) {
+                  fclose(fp);
+                  return 0;
+                }
+              }
+              else {
+                if(fread(uv, sizeof(double), 2, fp) != 2) {
+                  fclose(fp);
+                  return 0;
+                }
+                if(swap) SwapBytes((char *)uv, sizeof(double), 2);
+              }
+              newVertex =
+                new MFaceVertex(xyz[0], xyz[1], xyz[2], gf, uv[0], uv[1], num);
+            }
+            else if(iClasDim == 3) {
+              GRegion *gr = getRegionByTag(iClasTag);
+              newVertex = new MVertex(xyz[0], xyz[1], xyz[2], gr, num);
             }
-            newVertex =
-              new MFaceVertex(xyz[0], xyz[1], xyz[2], gf, uv[0], uv[1], num);
-          }
-          else if(iClasDim == 3) {
-            GRegion *gr = getRegionByTag(iClasTag);
-            newVertex = new MVertex(xyz[0], xyz[1], xyz[2], gr, num);
           }
+          nodes.push_back(std::make_pair(num, newVertex));
+          if(numVertices > 100000)
+            Msg::ProgressMeter(i + 1, true, "Reading nodes");
         }
-        minVertex = std::min(minVertex, num);
-        maxVertex = std::max(maxVertex, num);
-        if(vertexMap.count(num))
-          Msg::Warning("Skipping duplicate node %d", num);
-        vertexMap[num] = newVertex;
-        if(numVertices > 100000)
-          Msg::ProgressMeter(i + 1, true, "Reading nodes");
       }
       Msg::StopProgressMeter();
-      // If the vertex numbering is dense, transfer the map into a
-      // vector to speed up element creation
-      if((int)vertexMap.size() == numVertices &&
-         ((minVertex == 1 && maxVertex == numVertices) ||
-          (minVertex == 0 && maxVertex == numVertices - 1))) {
-        Msg::Debug("Vertex numbering is dense");
-        vertexVector.resize(vertexMap.size() + 1);
-        if(minVertex == 1)
-          vertexVector[0] = 0;
+      // sort the nodes by tag; for duplicate tags, the last node is kept
+      std::stable_sort(nodes.begin(), nodes.end(), nodeTagLessThan);
+      std::size_t numUnique = 0;
+      for(std::size_t i = 0; i < nodes.size(); i++) {
+        if(i + 1 < nodes.size() && nodes[i + 1].first == nodes[i].first) {
+          Msg::Warning("Skipping duplicate node %d", nodes[i].first);
+          delete nodes[i].second;
+        }
         else
-          vertexVector[numVertices] = 0;
-        std::map<int, MVertex *>::const_iterator it = vertexMap.begin();
-        for(; it != vertexMap.end(); ++it) vertexVector[it->first] = it->second;
-        vertexMap.clear();
+          nodes[numUnique++] = nodes[i];
+      }
+      nodes.resize(numUnique);
+      // if the node numbering is (fairly) dense, transfer the nodes into a
+      // vector indexed by tag to speed up element creation
+      if(nodes.size() && nodes.front().first >= 0 &&
+         nodes.back().first < 10 * (int)nodes.size()) {
+        Msg::Debug("Vertex numbering is dense");
+        vertexVector.resize(nodes.back().first + 1, (MVertex *)0);
+        for(std::size_t i = 0; i < nodes.size(); i++)
+          vertexVector[nodes[i].first] = nodes[i].second;
+      }
+      else {
+        Msg::Debug("Vertex numbering is not dense");
+        vertexSorted.swap(nodes);
       }
     }
     else if(!strncmp(&str[1], "ELM", 3) || !strncmp(&str[1], "Elements", 8)) {
@@ -325,19 +402,18 @@ int GModel::_readMSH2(const std::string &name)
         fclose(fp);
         return 0;
       }
-      int numElements;
-
-      std::map<int, MElement *> elems;
-      std::map<int, MElement *> parents;
-      std::map<int, MElement *> domains;
-      std::map<int, int> elemreg;
-      std::map<int, int> elemphy;
-
-      std::set<MElement *> parentsOwned;
+      int numElements = 0;
       sscanf(str, "%d", &numElements);
       Msg::Info("%d elements", numElements);
       Msg::StartProgressMeter(numElements);
+
+      std::vector<elementMSH2> elms;
+      elms.reserve(std::max(numElements, 0));
+      elementIndexMSH2 elmIndex(numElements);
+      std::vector<MVertex *> vertices;
+
       if(!binary) {
+        std::vector<int> indices;
         for(int i = 0; i < numElements; i++) {
           int num, type, physical = 0, elementary = 0, partition = 0,
                          parent = 0;
@@ -403,48 +479,36 @@ int GModel::_readMSH2(const std::string &name)
               }
             }
           }
-          int *indices = new int[numVertices];
+          indices.resize(numVertices);
           for(int j = 0; j < numVertices; j++) {
             if(fscanf(fp, "%d", &indices[j]) != 1) {
-              delete[] indices;
-              fclose(fp);
-              return 0;
-            }
-          }
-          std::vector<MVertex *> vertices;
-          if(vertexVector.size()) {
-            if(!getMeshVertices(numVertices, indices, vertexVector, vertices,
-                                minVertex)) {
-              delete[] indices;
               fclose(fp);
               return 0;
             }
           }
-          else {
-            if(!getMeshVertices(numVertices, indices, vertexMap, vertices)) {
-              delete[] indices;
-              fclose(fp);
-              return 0;
-            }
+          vertices.clear();
+          if(!getMeshVertices(numVertices, indices.data(), vertexVector,
+                              vertexSorted, vertices)) {
+            fclose(fp);
+            return 0;
           }
           MElement *p = NULL;
           bool own = false;
 
           // search parent element
           if(parent != 0) {
-            std::map<int, MElement *>::iterator ite = elems.find(parent);
-            if(ite == elems.end())
+            int ip = elmIndex.get(parent);
+            if(ip < 0)
               Msg::Error(
                 "Parent element (ascii) %d not found for element %d of type %d",
                 parent, num, type);
             else {
-              p = ite->second;
-              parents[parent] = p;
-            }
-            std::set<MElement *>::iterator itpo = parentsOwned.find(p);
-            if(itpo == parentsOwned.end()) {
-              own = true;
-              parentsOwned.insert(p);
+              p = elms[ip].e;
+              elms[ip].parent = true;
+              if(!elms[ip].owned) {
+                own = true;
+                elms[ip].owned = true;
+              }
             }
             assert(p != NULL);
           }
@@ -452,15 +516,10 @@ int GModel::_readMSH2(const std::string &name)
           // search domains
           MElement *doms[2] = {NULL, NULL};
           if(dom1) {
-            std::map<int, MElement *>::iterator ite = elems.find(dom1);
-            if(ite == elems.end())
-              Msg::Error("Domain element %d not found for element %d", dom1,
-                         num);
-            else
-              doms[0] = ite->second;
-
-            ite = elems.find(dom2);
-            if(ite != elems.end()) doms[1] = ite->second;
+            int id = elmIndex.get(dom1);
+            if(id >= 0) doms[0] = elms[id].e;
+            id = elmIndex.get(dom2);
+            if(id >= 0) doms[1] = elms[id].e;
 
             if(!doms[0])
               Msg::Error("Domain element %d not found for element %d", dom1,
@@ -469,15 +528,14 @@ int GModel::_readMSH2(const std::string &name)
               Msg::Error("Domain element %d not found for element %d", dom2,
                          num);
           }
-          delete[] indices;
 
           if(elementary < 0) continue;
           MElement *e = createElementMSH2(this, num, type, physical, elementary,
                                           partition, vertices, elements,
                                           physicals, own, p, doms[0], doms[1]);
-          elems[num] = e;
-          elemreg[num] = elementary;
-          elemphy[num] = physical;
+          elementMSH2 elm = {num, elementary, physical, false, false, e};
+          elmIndex.set(num, (int)elms.size());
+          elms.push_back(elm);
           for(std::size_t j = 0; j < ghosts.size(); j++)
             _ghostCells.insert(std::pair<MElement *, short>(e, ghosts[j]));
           if(numElements > 100000)
@@ -486,6 +544,7 @@ int GModel::_readMSH2(const std::string &name)
       }
       else {
         int numElementsPartial = 0;
+        std::vector<int> data;
         while(numElementsPartial < numElements) {
           int header[3];
           if(fread(header, sizeof(int), 3, fp) != 3) {
@@ -497,79 +556,68 @@ int GModel::_readMSH2(const std::string &name)
           int numElms = header[1];
           int numTags = header[2];
           int numVertices = MElement::getInfoMSH(type);
-          unsigned int n = 1 + numTags + numVertices;
-          int *data = new int[n];
+          std::size_t n = 1 + numTags + numVertices;
+          // read the whole block of elements of this type at once
+          data.resize(n * std::max(numElms, 0));
+          if(data.size() &&
+             fread(data.data(), sizeof(int), data.size(), fp) != data.size()) {
+            fclose(fp);
+            return 0;
+          }
+          if(swap) SwapBytes((char *)data.data(), sizeof(int), data.size());
           for(int i = 0; i < numElms; i++) {
-            if(fread(data, sizeof(int), n, fp) != n) {
-              delete[] data;
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char *)data, sizeof(int), n);
-            int num = data[0];
-            int physical = (numTags > 0) ? data[1] : 0;
-            int elementary = (numTags > 1) ? data[2] : 0;
-            int numPartitions = (version >= 2.2 && numTags > 3) ? data[3] : 0;
+            const int *d = &data[n * i];
+            int num = d[0];
+            int physical = (numTags > 0) ? d[1] : 0;
+            int elementary = (numTags > 1) ? d[2] : 0;
+            int numPartitions = (version >= 2.2 && numTags > 3) ? d[3] : 0;
             int partition = (version < 2.2 && numTags > 2) ?
-                              data[3] :
-                              (version >= 2.2 && numTags > 3) ? data[4] : 0;
+                              d[3] :
+                              (version >= 2.2 && numTags > 3) ? d[4] : 0;
             int parent = (version < 2.2 && numTags > 3) ||
                              (version >= 2.2 && numPartitions &&
                               numTags > 3 + numPartitions) ||
                              (version >= 2.2 && !numPartitions && numTags > 2) ?
-                           data[numTags] :
+                           d[numTags] :
                            0;
-            int *indices = &data[numTags + 1];
-            std::vector<MVertex *> vertices;
-            if(vertexVector.size()) {
-              if(!getMeshVertices(numVertices, indices, vertexVector, vertices,
-                                  minVertex)) {
-                delete[] data;
-                fclose(fp);
-                return 0;
-              }
-            }
-            else {
-              if(!getMeshVertices(numVertices, indices, vertexMap, vertices)) {
-                delete[] data;
-                fclose(fp);
-                return 0;
-              }
+            const int *indices = &d[numTags + 1];
+            vertices.clear();
+            if(!getMeshVertices(numVertices, indices, vertexVector,
+                                vertexSorted, vertices)) {
+              fclose(fp);
+              return 0;
             }
             MElement *p = NULL;
             bool own = false;
             if(parent) {
-              std::map<int, MElement *>::iterator ite = elems.find(parent);
-              if(ite == elems.end())
+              int ip = elmIndex.get(parent);
+              if(ip < 0)
                 Msg::Error(
                   "Parent (binary) element %d not found for element %d", parent,
                   num);
               else {
-                p = ite->second;
-                parents[parent] = p;
-              }
-              std::set<MElement *>::iterator itpo = parentsOwned.find(p);
-              if(itpo == parentsOwned.end()) {
-                own = true;
-                parentsOwned.insert(p);
+                p = elms[ip].e;
+                elms[ip].parent = true;
+                if(!elms[ip].owned) {
+                  own = true;
+                  elms[ip].owned = true;
+                }
               }
               assert(p != NULL);
             }
             MElement *e = createElementMSH2(this, num, type, physical,
                                             elementary, partition, vertices,
                                             elements, physicals, own, p);
-            elems[num] = e;
-            elemreg[num] = elementary;
-            elemphy[num] = physical;
+            elementMSH2 elm = {num, elementary, physical, false, false, e};
+            elmIndex.set(num, (int)elms.size());
+            elms.push_back(elm);
             if(numPartitions > 1)
               for(int j = 0; j < numPartitions - 1; j++)
-                _ghostCells.insert(
-                  std::pair<MElement *, short>(e, -data[5 + j]));
+                _ghostCells.insert(std::pair<MElement *, short>(e, -d[5 + j]));
             if(numElements > 100000)
               Msg::ProgressMeter(numElementsPartial + i + 1, true,
                                  "Reading elements");
           }
-          delete[] data;
           numElementsPartial += numElms;
         }
       }
@@ -577,34 +625,46 @@ int GModel::_readMSH2(const std::string &name)
 
       for(int i = 0; i < 10; i++) elements[i].clear();
 
-      std::map<int, MElement *>::iterator ite;
-      for(ite = elems.begin(); ite != elems.end(); ite++) {
-        int num = ite->first;
-        MElement *e = ite->second;
-        if(parents.find(num) == parents.end()) {
-          int reg;
-          if(CTX::instance()->mesh.switchElementTags) {
-            reg = elemphy[num];
-          }
-          else {
-            reg = elemreg[num];
-          }
-          switch(e->getType()) {
-          case TYPE_PNT: elements[0][reg].push_back(e); break;
-          case TYPE_LIN: elements[1][reg].push_back(e); break;
-          case TYPE_TRI: elements[2][reg].push_back(e); break;
-          case TYPE_QUA: elements[3][reg].push_back(e); break;
-          case TYPE_TET: elements[4][reg].push_back(e); break;
-          case TYPE_HEX: elements[5][reg].push_back(e); break;
-          case TYPE_PRI: elements[6][reg].push_back(e); break;
-          case TYPE_PYR: elements[7][reg].push_back(e); break;
-          case TYPE_POLYG: elements[8][reg].push_back(e); break;
-          case TYPE_POLYH: elements[9][reg].push_back(e); break;
-          default:
-            Msg::Error("Wrong type of element");
-            fclose(fp);
-            return 0;
-          }
+      // store the elements by increasing tag (elements with duplicate tags are
+      // skipped, except the last one), without the parent elements
+      std::vector<int> order(elms.size());
+      bool sorted = true;
+      for(std::size_t i = 0; i < elms.size(); i++) {
+        order[i] = (int)i;
+        if(i && elms[i].num <= elms[i - 1].num) sorted = false;
+      }
+      if(!sorted)
+        std::stable_sort(order.begin(), order.end(),
+                         elementMSH2NumLessThan(elms));
+      for(std::size_t k = 0; k < order.size(); k++) {
+        if(k + 1 < order.size() &&
+           elms[order[k + 1]].num == elms[order[k]].num)
+          continue;
+        const elementMSH2 &elm = elms[order[k]];
+        if(elm.parent || !elm.e) continue;
+        MElement *e = elm.e;
+        int reg;
+        if(CTX::instance()->mesh.switchElementTags) {
+          reg = elm.physical;
+        }
+        else {
+          reg = elm.elementary;
+        }
+        switch(e->getType()) {
+        case TYPE_PNT: elements[0][reg].push_back(e); break;
+        case TYPE_LIN: elements[1][reg].push_back(e); break;
+        case TYPE_TRI: elements[2][reg].push_back(e); break;
+        case TYPE_QUA: elements[3][reg].push_back(e); break;
+        case TYPE_TET: elements[4][reg].push_back(e); break;
+        case TYPE_HEX: elements[5][reg].push_back(e); break;
+        case TYPE_PRI: elements[6][reg].push_back(e); break;
+        case TYPE_PYR: elements[7][reg].push_back(e); break;
+        case TYPE_POLYG: elements[8][reg].push_back(e); break;
+        case TYPE_POLYH: elements[9][reg].push_back(e); break;
+        default:
+          Msg::Error("Wrong type of element");
+          fclose(fp);
+          return 0;
         }
       }
     }
@@ -614,7 +674,8 @@ int GModel::_readMSH2(const std::string &name)
       if(vertexVector.size())
         _vertexVectorCache = vertexVector;
       else
-        _vertexMapCache = vertexMap;
+        _vertexMapCache =
+          std::map<int, MVertex *>(vertexSorted.begin(), vertexSorted.end());
       postpro = true;
       break;
     }
@@ -641,8 +702,12 @@ int GModel::_readMSH2(const std::string &name)
   // store the vertices in their associated geometrical entity
   if(vertexVector.size())
     _storeVerticesInEntities(vertexVector);
-  else
-    _storeVerticesInEntities(vertexMap);
+  else {
+    std::vector<MVertex *> vertices(vertexSorted.size());
+    for(std::size_t i = 0; i < vertexSorted.size(); i++)
+      vertices[i] = vertexSorted[i].second;
+    _storeVerticesInEntities(vertices);
+  }
 
   // store the physical tags
   for(int i = 0; i < 4; i++) _storePhysicalTagsInEntities(i, physicals[i]);
@@ -677,8 +742,9 @@ int GModel::_readMSH2(const std::string &name)
 }
 
 template <class T>
-static void writeElementMSH(FILE *fp, GModel *model, GEntity *ge, T *ele,
-                            bool saveAll, double version, bool binary, int &num,
+static void writeElementMSH(FILE *fp, TextBuffer &buf, GModel *model,
+                            GEntity *ge, T *ele, bool saveAll, double version,
+                            bool binary, int &num,
                             int elementary, std::vector<int> &physicals,
                             int parentNum = 0, int dom1Num = 0, int dom2Num = 0)
 {
@@ -702,17 +768,27 @@ static void writeElementMSH(FILE *fp, GModel *model, GEntity *ge, T *ele,
       ghosts.push_back(it->second);
   }
 
-  if(saveAll)
-    ele->writeMSH2(fp, version, binary, ++num, elementary, 0, parentNum,
-                   dom1Num, dom2Num, &ghosts);
+  if(saveAll) {
+    if(binary)
+      ele->writeMSH2(fp, version, binary, ++num, elementary, 0, parentNum,
+                     dom1Num, dom2Num, &ghosts);
+    else
+      ele->writeMSH2(buf, version, ++num, elementary, 0, parentNum, dom1Num,
+                     dom2Num, &ghosts);
+  }
   else {
     if(parentNum) parentNum = parentNum - physicals.size() + 1;
     for(std::size_t j = 0; j < physicals.size(); j++) {
-      ele->writeMSH2(fp, version, binary, ++num, elementary, physicals[j],
-                     parentNum, dom1Num, dom2Num, &ghosts);
+      if(binary)
+        ele->writeMSH2(fp, version, binary, ++num, elementary, physicals[j],
+                       parentNum, dom1Num, dom2Num, &ghosts);
+      else
+        ele->writeMSH2(buf, version, ++num, elementary, physicals[j],
+                       parentNum, dom1Num, dom2Num, &ghosts);
       if(parentNum) parentNum++;
     }
   }
+  if(buf.size() > (1 << 20)) buf.write(fp);
 
   model->setMeshElementIndex(ele, num); // should really be a multimap...
 
@@ -721,8 +797,8 @@ static void writeElementMSH(FILE *fp, GModel *model, GEntity *ge, T *ele,
 }
 
 template <class T>
-static void writeElementsMSH(FILE *fp, GModel *model, GEntity *ge,
-                             std::vector<T *> &ele,
+static void writeElementsMSH(FILE *fp, TextBuffer &buf, GModel *model,
+                             GEntity *ge, std::vector<T *> &ele,
                              bool saveAll, int saveSinglePartition,
                              double version, bool binary, int &num,
                              int elementary, std::vector<int> &physicals)
@@ -755,7 +831,7 @@ static void writeElementsMSH(FILE *fp, GModel *model, GEntity *ge,
         newPhysicals.push_back((maxPhysical - elementary) * offset);
       }
       ele[i]->setPartition(0);
-      writeElementMSH(fp, model, ge, ele[i], saveAll, version, binary, num,
+      writeElementMSH(fp, buf, model, ge, ele[i], saveAll, version, binary, num,
                       newElementary, newPhysicals);
     }
     return;
@@ -768,7 +844,7 @@ static void writeElementsMSH(FILE *fp, GModel *model, GEntity *ge,
     int parentNum = 0;
     MElement *parent = ele[i]->getParent();
     if(parent) parentNum = model->getMeshElementIndex(parent);
-    writeElementMSH(fp, model, ge, ele[i], saveAll, version, binary, num,
+    writeElementMSH(fp, buf, model, ge, ele[i], saveAll, version, binary, num,
                     elementary, physicals, parentNum);
   }
 }
@@ -937,10 +1013,31 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
 
   std::vector<GEntity *> entities;
   getEntities(entities);
-  for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeMSH2(fp, binary, saveParametric,
-                                               scalingFactor);
+  if(binary) {
+    for(std::size_t i = 0; i < entities.size(); i++)
+      for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
+        entities[i]->mesh_vertices[j]->writeMSH2(fp, binary, saveParametric,
+                                                 scalingFactor);
+  }
+  else {
+    // format chunks of the entities in parallel, and write them in order
+    std::vector<TextBufferChunk> chunks;
+    for(std::size_t i = 0; i < entities.size(); i++)
+      addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+    for(int c = 0; c < (int)chunks.size(); c++) {
+      GEntity *ge = entities[chunks[c].entity];
+      TextBuffer buf;
+      for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+        ge->mesh_vertices[j]->writeMSH2(buf, saveParametric, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+      buf.write(fp);
+    }
+  }
 
   if(binary) fprintf(fp, "\n");
 
@@ -961,108 +1058,112 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
 
   _elementIndexCache.clear();
 
+  // element numbering is sequential: ASCII elements are formatted in a buffer,
+  // flushed regularly
+  TextBuffer buf;
+
   // parents
   if(!CTX::instance()->mesh.saveTri) {
     for(viter it = firstVertex(); it != lastVertex(); ++it) {
       for(std::size_t i = 0; i < (*it)->points.size(); i++)
         if((*it)->points[i]->ownsParent())
-          writeElementMSH(fp, this, *it, (*it)->points[i]->getParent(), saveAll,
+          writeElementMSH(fp, buf, this, *it, (*it)->points[i]->getParent(), saveAll,
                           version, binary, num, _getElementary(*it),
                           (*it)->physicals);
     }
     for(eiter it = firstEdge(); it != lastEdge(); ++it) {
       for(std::size_t i = 0; i < (*it)->lines.size(); i++)
         if((*it)->lines[i]->ownsParent())
-          writeElementMSH(fp, this, *it, (*it)->lines[i]->getParent(), saveAll,
+          writeElementMSH(fp, buf, this, *it, (*it)->lines[i]->getParent(), saveAll,
                           version, binary, num, _getElementary(*it),
                           (*it)->physicals);
     }
     for(fiter it = firstFace(); it != lastFace(); ++it) {
       for(std::size_t i = 0; i < (*it)->triangles.size(); i++)
         if((*it)->triangles[i]->ownsParent())
-          writeElementMSH(fp, this, *it, (*it)->triangles[i]->getParent(), saveAll,
+          writeElementMSH(fp, buf, this, *it, (*it)->triangles[i]->getParent(), saveAll,
                           version, binary, num, _getElementary(*it),
                           (*it)->physicals);
     }
     for(riter it = firstRegion(); it != lastRegion(); ++it) {
       for(std::size_t i = 0; i < (*it)->tetrahedra.size(); i++)
         if((*it)->tetrahedra[i]->ownsParent())
-          writeElementMSH(fp, this, *it, (*it)->tetrahedra[i]->getParent(), saveAll,
+          writeElementMSH(fp, buf, this, *it, (*it)->tetrahedra[i]->getParent(), saveAll,
                           version, binary, num, _getElementary(*it),
                           (*it)->physicals);
     }
     for(fiter it = firstFace(); it != lastFace(); ++it) {
       for(std::size_t i = 0; i < (*it)->polygons.size(); i++)
         if((*it)->polygons[i]->ownsParent())
-          writeElementMSH(fp, this, *it, (*it)->polygons[i]->getParent(), saveAll,
+          writeElementMSH(fp, buf, this, *it, (*it)->polygons[i]->getParent(), saveAll,
                           version, binary, num, _getElementary(*it),
                           (*it)->physicals);
     }
     for(riter it = firstRegion(); it != lastRegion(); ++it) {
       for(std::size_t i = 0; i < (*it)->polyhedra.size(); i++)
         if((*it)->polyhedra[i]->ownsParent())
-          writeElementMSH(fp, this, *it, (*it)->polyhedra[i]->getParent(), saveAll,
+          writeElementMSH(fp, buf, this, *it, (*it)->polyhedra[i]->getParent(), saveAll,
                           version, binary, num, _getElementary(*it),
                           (*it)->physicals);
     }
   }
   // points
   for(viter it = firstVertex(); it != lastVertex(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->points, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->points, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // lines
   for(eiter it = firstEdge(); it != lastEdge(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->lines, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->lines, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // triangles
   for(fiter it = firstFace(); it != lastFace(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->triangles, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->triangles, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // quads
   for(fiter it = firstFace(); it != lastFace(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->quadrangles, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->quadrangles, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // polygons
   for(fiter it = firstFace(); it != lastFace(); it++) {
-    writeElementsMSH(fp, this, *it, (*it)->polygons, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->polygons, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // tets
   for(riter it = firstRegion(); it != lastRegion(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->tetrahedra, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->tetrahedra, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // hexas
   for(riter it = firstRegion(); it != lastRegion(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->hexahedra, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->hexahedra, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // prisms
   for(riter it = firstRegion(); it != lastRegion(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->prisms, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->prisms, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // pyramids
   for(riter it = firstRegion(); it != lastRegion(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->pyramids, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->pyramids, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
   // polyhedra
   for(riter it = firstRegion(); it != lastRegion(); ++it) {
-    writeElementsMSH(fp, this, *it, (*it)->polyhedra, saveAll, saveSinglePartition,
+    writeElementsMSH(fp, buf, this, *it, (*it)->polyhedra, saveAll, saveSinglePartition,
                      version, binary, num, _getElementary(*it),
                      (*it)->physicals);
   }
@@ -1071,7 +1172,7 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     for(std::size_t i = 0; i < (*it)->triangles.size(); i++) {
       MTriangle *t = (*it)->triangles[i];
       if(t->getDomain(0))
-        writeElementMSH(fp, this, *it, t, saveAll, version, binary, num,
+        writeElementMSH(fp, buf, this, *it, t, saveAll, version, binary, num,
                         _getElementary(*it), (*it)->physicals, 0,
                         getMeshElementIndex(t->getDomain(0)),
                         getMeshElementIndex(t->getDomain(1)));
@@ -1079,7 +1180,7 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     for(std::size_t i = 0; i < (*it)->polygons.size(); i++) {
       MPolygon *p = (*it)->polygons[i];
       if(p->getDomain(0))
-        writeElementMSH(fp, this, *it, p, saveAll, version, binary, num,
+        writeElementMSH(fp, buf, this, *it, p, saveAll, version, binary, num,
                         _getElementary(*it), (*it)->physicals, 0,
                         getMeshElementIndex(p->getDomain(0)),
                         getMeshElementIndex(p->getDomain(1)));
@@ -1090,12 +1191,13 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     for(std::size_t i = 0; i < (*it)->lines.size(); i++) {
       MLine *l = (*it)->lines[i];
       if(l->getDomain(0))
-        writeElementMSH(fp, this, *it, l, saveAll, version, binary, num,
+        writeElementMSH(fp, buf, this, *it, l, saveAll, version, binary, num,
                         _getElementary(*it), (*it)->physicals, 0,
                         getMeshElementIndex(l->getDomain(0)),
                         getMeshElementIndex(l->getDomain(1)));
     }
   }
+  buf.write(fp);
 
   if(binary) fprintf(fp, "\n");
 
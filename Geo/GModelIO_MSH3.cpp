@@ -704,7 +704,7 @@ void writeMSHPeriodicNodes(FILE *fp, std::vector<GEntity *> &entities,
       }
 
       fprintf(fp, "%d\n", (int)g_slave->correspondingVertices.size());
-      for(std::map<MVertex *, MVertex *>::iterator it =
+      for(MVertexPairs::iterator it =
             g_slave->correspondingVertices.begin();
           it != g_slave->correspondingVertices.end(); it++) {
         MVertex *v1 = it->first;
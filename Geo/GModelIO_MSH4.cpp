@@ -2611,7 +2611,7 @@ static void writeMSH4PeriodicNodes(GModel *const model, FILE *fp,
         std::size_t corrVertSize = g_slave->correspondingVertices.size();
         fwrite(&corrVertSize, sizeof(std::size_t), 1, fp);
 
-        for(std::map<MVertex *, MVertex *>::iterator it =
+        for(MVertexPairs::iterator it =
               g_slave->correspondingVertices.begin();
             it != g_slave->correspondingVertices.end(); ++it) {
           std::size_t numFirst = it->first->getNum();
@@ -2646,7 +2646,7 @@ static void writeMSH4PeriodicNodes(GModel *const model, FILE *fp,
 
         fprintf(fp, "%lu\n", g_slave->correspondingVertices.size());
 
-        for(std::map<MVertex *, MVertex *>::iterator it =
+        for(MVertexPairs::iterator it =
               g_slave->correspondingVertices.begin();
             it != g_slave->correspondingVertices.end(); ++it) {
           fprintf(fp, "%lu %lu\n", it->first->getNum(), it->second->getNum());
@@ -15,6 +15,7 @@
 #include "MLine.h"
 #include "OpenFile.h"
 #include "StringUtils.h"
+#include "OS.h"
 #include "ExtrudeParams.h"
 
 #if defined(HAVE_OCC)
@@ -161,6 +162,8 @@ void OCC_Internals::reset()
   _shellTag.Clear();
   _tagWire.Clear();
   _tagShell.Clear();
+  _numParents.Clear();
+  for(int i = 0; i < 6; i++) _boundTags[i].clear();
   _changed = true;
 }
 
@@ -179,18 +182,37 @@ int OCC_Internals::getMaxTag(int dim) const
 void OCC_Internals::_recomputeMaxTag(int dim)
 {
   if(dim < -2 || dim > 3) return;
-  _maxTag[dim + 2] = 0;
-  TopTools_DataMapIteratorOfDataMapOfIntegerShape exp;
+  const std::set<int> &tags = _boundTags[dim + 2];
+  _maxTag[dim + 2] = tags.empty() ? 0 : *tags.rbegin();
+}
+
+void OCC_Internals::_updateNumParents(int dim, const TopoDS_Shape &shape,
+                                      int increment)
+{
+  TopTools_IndexedMapOfShape sub;
   switch(dim) {
-  case 0: exp.Initialize(_tagVertex); break;
-  case 1: exp.Initialize(_tagEdge); break;
-  case 2: exp.Initialize(_tagFace); break;
-  case 3: exp.Initialize(_tagSolid); break;
-  case -1: exp.Initialize(_tagWire); break;
-  case -2: exp.Initialize(_tagShell); break;
+  case 1: TopExp::MapShapes(shape, TopAbs_VERTEX, sub); break;
+  case 2:
+    TopExp::MapShapes(shape, TopAbs_WIRE, sub);
+    TopExp::MapShapes(shape, TopAbs_EDGE, sub);
+    break;
+  case 3:
+    TopExp::MapShapes(shape, TopAbs_SHELL, sub);
+    TopExp::MapShapes(shape, TopAbs_FACE, sub);
+    break;
+  default: return;
+  }
+  for(int i = 1; i <= sub.Extent(); i++) {
+    const TopoDS_Shape &s = sub.FindKey(i);
+    if(_numParents.IsBound(s)) {
+      int &n = _numParents.ChangeFind(s);
+      n += increment;
+      if(n <= 0) _numParents.UnBind(s);
+    }
+    else if(increment > 0) {
+      _numParents.Bind(s, increment);
+    }
   }
-  for(; exp.More(); exp.Next())
-    _maxTag[dim + 2] = std::max(_maxTag[dim + 2], exp.Key());
 }
 
 void OCC_Internals::bind(const TopoDS_Vertex &vertex, int tag, bool recursive)
@@ -209,6 +231,7 @@ void OCC_Internals::bind(const TopoDS_Vertex &vertex, int tag, bool recursive)
     }
     _vertexTag.Bind(vertex, tag);
     _tagVertex.Bind(tag, vertex);
+    _boundTags[2].insert(tag);
     setMaxTag(0, tag);
     _changed = true;
     _attributes->insert(new OCCAttributes(0, vertex));
@@ -228,9 +251,12 @@ void OCC_Internals::bind(const TopoDS_Edge &edge, int tag, bool recursive)
     if(_tagEdge.IsBound(tag)) {
       // this leaves the old edge bound in _edgeTag, but we cannot remove it
       Msg::Info("Rebinding OpenCASCADE curve %d", tag);
+      _updateNumParents(1, _tagEdge.Find(tag), -1);
     }
     _edgeTag.Bind(edge, tag);
     _tagEdge.Bind(tag, edge);
+    _boundTags[3].insert(tag);
+    _updateNumParents(1, edge, 1);
     setMaxTag(1, tag);
     _changed = true;
     _attributes->insert(new OCCAttributes(1, edge));
@@ -263,6 +289,7 @@ void OCC_Internals::bind(const TopoDS_Wire &wire, int tag, bool recursive)
     }
     _wireTag.Bind(wire, tag);
     _tagWire.Bind(tag, wire);
+    _boundTags[1].insert(tag);
     setMaxTag(-1, tag);
     _changed = true;
   }
@@ -291,9 +318,12 @@ void OCC_Internals::bind(const TopoDS_Face &face, int tag, bool recursive)
     if(_tagFace.IsBound(tag)) {
       // this leaves the old face bound in _faceTag, but we cannot remove it
       Msg::Info("Rebinding OpenCASCADE surface %d", tag);
+      _updateNumParents(2, _tagFace.Find(tag), -1);
     }
     _faceTag.Bind(face, tag);
     _tagFace.Bind(tag, face);
+    _boundTags[4].insert(tag);
+    _updateNumParents(2, face, 1);
     setMaxTag(2, tag);
     _changed = true;
     _attributes->insert(new OCCAttributes(2, face));
@@ -333,6 +363,7 @@ void OCC_Internals::bind(const TopoDS_Shell &shell, int tag, bool recursive)
     }
     _shellTag.Bind(shell, tag);
     _tagShell.Bind(tag, shell);
+    _boundTags[0].insert(tag);
     setMaxTag(-2, tag);
     _changed = true;
   }
@@ -361,9 +392,12 @@ void OCC_Internals::bind(const TopoDS_Solid &solid, int tag, bool recursive)
     if(_tagSolid.IsBound(tag)) {
       // this leaves the old solid bound in _faceTag, but we cannot remove it
       Msg::Info("Rebinding OpenCASCADE volume %d", tag);
+      _updateNumParents(3, _tagSolid.Find(tag), -1);
     }
     _solidTag.Bind(solid, tag);
     _tagSolid.Bind(tag, solid);
+    _boundTags[5].insert(tag);
+    _updateNumParents(3, solid, 1);
     setMaxTag(3, tag);
     _changed = true;
     _attributes->insert(new OCCAttributes(3, solid));
@@ -402,18 +436,13 @@ void OCC_Internals::bind(TopoDS_Shape shape, int dim, int tag, bool recursive)
 
 void OCC_Internals::unbind(const TopoDS_Vertex &vertex, int tag, bool recursive)
 {
-  TopTools_DataMapIteratorOfDataMapOfIntegerShape exp0(_tagEdge);
-  for(; exp0.More(); exp0.Next()) {
-    TopoDS_Edge edge = TopoDS::Edge(exp0.Value());
-    TopExp_Explorer exp1;
-    for(exp1.Init(edge, TopAbs_VERTEX); exp1.More(); exp1.Next()) {
-      if(exp1.Current().IsSame(vertex)) return;
-    }
-  }
+  // still used by a bound curve?
+  if(_numParents.IsBound(vertex)) return;
   std::pair<int, int> dimTag(0, tag);
   if(_toPreserve.find(dimTag) != _toPreserve.end()) return;
   _vertexTag.UnBind(vertex);
   _tagVertex.UnBind(tag);
+  _boundTags[2].erase(tag);
   _toRemove.insert(dimTag);
   _recomputeMaxTag(0);
   _changed = true;
@@ -421,18 +450,14 @@ void OCC_Internals::unbind(const TopoDS_Vertex &vertex, int tag, bool recursive)
 
 void OCC_Internals::unbind(const TopoDS_Edge &edge, int tag, bool recursive)
 {
-  TopTools_DataMapIteratorOfDataMapOfIntegerShape exp2(_tagFace);
-  for(; exp2.More(); exp2.Next()) {
-    TopoDS_Face face = TopoDS::Face(exp2.Value());
-    TopExp_Explorer exp1;
-    for(exp1.Init(face, TopAbs_EDGE); exp1.More(); exp1.Next()) {
-      if(exp1.Current().IsSame(edge)) return;
-    }
-  }
+  // still used by a bound surface?
+  if(_numParents.IsBound(edge)) return;
   std::pair<int, int> dimTag(1, tag);
   if(_toPreserve.find(dimTag) != _toPreserve.end()) return;
   _edgeTag.UnBind(edge);
+  if(_tagEdge.IsBound(tag)) _updateNumParents(1, _tagEdge.Find(tag), -1);
   _tagEdge.UnBind(tag);
+  _boundTags[3].erase(tag);
   _toRemove.insert(dimTag);
   _recomputeMaxTag(1);
   if(recursive) {
@@ -450,18 +475,13 @@ void OCC_Internals::unbind(const TopoDS_Edge &edge, int tag, bool recursive)
 
 void OCC_Internals::unbind(const TopoDS_Wire &wire, int tag, bool recursive)
 {
-  TopTools_DataMapIteratorOfDataMapOfIntegerShape exp0(_tagFace);
-  for(; exp0.More(); exp0.Next()) {
-    TopoDS_Face face = TopoDS::Face(exp0.Value());
-    TopExp_Explorer exp1;
-    for(exp1.Init(face, TopAbs_WIRE); exp1.More(); exp1.Next()) {
-      if(exp1.Current().IsSame(wire)) return;
-    }
-  }
+  // still used by a bound surface?
+  if(_numParents.IsBound(wire)) return;
   std::pair<int, int> dimTag(-1, tag);
   if(_toPreserve.find(dimTag) != _toPreserve.end()) return;
   _wireTag.UnBind(wire);
   _tagWire.UnBind(tag);
+  _boundTags[1].erase(tag);
   _toRemove.insert(dimTag);
   _recomputeMaxTag(-1);
   if(recursive) {
@@ -479,18 +499,14 @@ void OCC_Internals::unbind(const TopoDS_Wire &wire, int tag, bool recursive)
 
 void OCC_Internals::unbind(const TopoDS_Face &face, int tag, bool recursive)
 {
-  TopTools_DataMapIteratorOfDataMapOfIntegerShape exp2(_tagSolid);
-  for(; exp2.More(); exp2.Next()) {
-    TopoDS_Solid solid = TopoDS::Solid(exp2.Value());
-    TopExp_Explorer exp1;
-    for(exp1.Init(solid, TopAbs_FACE); exp1.More(); exp1.Next()) {
-      if(exp1.Current().IsSame(face)) return;
-    }
-  }
+  // still used by a bound volume?
+  if(_numParents.IsBound(face)) return;
   std::pair<int, int> dimTag(2, tag);
   if(_toPreserve.find(dimTag) != _toPreserve.end()) return;
   _faceTag.UnBind(face);
+  if(_tagFace.IsBound(tag)) _updateNumParents(2, _tagFace.Find(tag), -1);
   _tagFace.UnBind(tag);
+  _boundTags[4].erase(tag);
   _toRemove.insert(dimTag);
   _recomputeMaxTag(2);
   if(recursive) {
@@ -515,18 +531,13 @@ void OCC_Internals::unbind(const TopoDS_Face &face, int tag, bool recursive)
 
 void OCC_Internals::unbind(const TopoDS_Shell &shell, int tag, bool recursive)
 {
-  TopTools_DataMapIteratorOfDataMapOfIntegerShape exp0(_tagSolid);
-  for(; exp0.More(); exp0.Next()) {
-    TopoDS_Solid solid = TopoDS::Solid(exp0.Value());
-    TopExp_Explorer exp1;
-    for(exp1.Init(solid, TopAbs_SHELL); exp1.More(); exp1.Next()) {
-      if(exp1.Current().IsSame(shell)) return;
-    }
-  }
+  // still used by a bound volume?
+  if(_numParents.IsBound(shell)) return;
   std::pair<int, int> dimTag(-2, tag);
   if(_toPreserve.find(dimTag) != _toPreserve.end()) return;
   _shellTag.UnBind(shell);
   _tagShell.UnBind(tag);
+  _boundTags[0].erase(tag);
   _toRemove.insert(dimTag);
   _recomputeMaxTag(-2);
   if(recursive) {
@@ -547,7 +558,9 @@ void OCC_Internals::unbind(const TopoDS_Solid &solid, int tag, bool recursive)
   std::pair<int, int> dimTag(3, tag);
   if(_toPreserve.find(dimTag) != _toPreserve.end()) return;
   _solidTag.UnBind(solid);
+  if(_tagSolid.IsBound(tag)) _updateNumParents(3, _tagSolid.Find(tag), -1);
   _tagSolid.UnBind(tag);
+  _boundTags[5].erase(tag);
   _toRemove.insert(dimTag);
   _recomputeMaxTag(3);
   if(recursive) {
@@ -2747,6 +2760,8 @@ bool OCC_Internals::booleanOperator(
     minDim = std::min(minDim, dim);
   }
 
+  double t1 = TimeOfDay();
+
   TopoDS_Shape result;
   std::vector<TopoDS_Shape> mapOriginal;
   std::vector<TopTools_ListOfShape> mapModified, mapGenerated;
@@ -2871,6 +2886,8 @@ bool OCC_Internals::booleanOperator(
     return false;
   }
 
+  double t2 = TimeOfDay();
+
   std::vector<std::pair<int, int> > inDimTags;
   inDimTags.insert(inDimTags.end(), objectDimTags.begin(), objectDimTags.end());
   inDimTags.insert(inDimTags.end(), toolDimTags.begin(), toolDimTags.end());
@@ -2934,6 +2951,8 @@ bool OCC_Internals::booleanOperator(
     _toPreserve.clear();
   }
 
+  double t3 = TimeOfDay();
+
   // return input/output correspondance maps
   for(std::size_t i = 0; i < inDimTags.size(); i++) {
     int dim = inDimTags[i].first;
@@ -2969,6 +2988,10 @@ bool OCC_Internals::booleanOperator(
     outDimTagsMap.push_back(dimTags);
   }
 
+  double t4 = TimeOfDay();
+  Msg::Debug("Boolean operation: %g s (OpenCASCADE), %g s (unbinding and "
+             "binding), %g s (input/output maps)", t2 - t1, t3 - t2, t4 - t3);
+
   return true;
 }
 
@@ -58,6 +58,16 @@ private:
   TopTools_DataMapOfShapeInteger _wireTag, _shellTag;
   TopTools_DataMapOfIntegerShape _tagWire, _tagShell;
 
+  // number of bound parent entities using each sub-shape (edges for vertices,
+  // faces for edges and wires, solids for faces and shells), updated when
+  // entities are bound and unbound; sub-shapes without bound parents are not
+  // in the map
+  TopTools_DataMapOfShapeInteger _numParents;
+
+  // tags bound in _tagVertex, _tagEdge, ..., indexed by dim + 2, so that the
+  // maximum tags can be recomputed quickly after unbinding
+  std::set<int> _boundTags[6];
+
   // cache of <dim,tag> pairs corresponding to entities that will need to be
   // removed from the model at the next synchronization
   std::set<std::pair<int, int> > _toRemove;
@@ -73,9 +83,14 @@ private:
   // the actual shape is not found
   int _getFuzzyTag(int dim, const TopoDS_Shape &s);
 
-  // iterate on all bound entities and recompute the maximum tag
+  // recompute the maximum tag from the bound entities
   void _recomputeMaxTag(int dim);
 
+  // update the number of bound parents of the sub-shapes of a shape of
+  // dimension dim that is being bound (increment = 1) or unbound (increment =
+  // -1)
+  void _updateNumParents(int dim, const TopoDS_Shape &shape, int increment);
+
   // bind (potentially) mutliple entities in shape and return the tags in
   // outTags. If tag > 0 and a single entity if found, use that; if
   // highestDimOnly is true, only bind the entities (and sub-entities, if
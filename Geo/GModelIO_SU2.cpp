@@ -8,6 +8,7 @@
 #include "GModel.h"
 #include "OS.h"
 #include "MElement.h"
+#include "TextBuffer.h"
 
 static std::string physicalName(GModel *m, int dim, int num)
 {
@@ -48,44 +49,65 @@ int GModel::writeSU2(const std::string &name, bool saveAll,
 
   // all interior elements are printed in a single section; indices start at 0;
   // node ordering is the same as VTK
-  int nelem = 0;
+  std::vector<GEntity *> elements;
   if(ndime == 2) {
     for(fiter it = firstFace(); it != lastFace(); it++)
-      if(saveAll || (*it)->physicals.size())
-        nelem += (*it)->getNumMeshElements();
+      if(saveAll || (*it)->physicals.size()) elements.push_back(*it);
   }
   else {
     for(riter it = firstRegion(); it != lastRegion(); it++)
-      if(saveAll || (*it)->physicals.size())
-        nelem += (*it)->getNumMeshElements();
+      if(saveAll || (*it)->physicals.size()) elements.push_back(*it);
   }
+  // index of the first element of each entity
+  std::vector<int> offset(elements.size() + 1, 0);
+  for(std::size_t i = 0; i < elements.size(); i++)
+    offset[i + 1] = offset[i] + elements[i]->getNumMeshElements();
+  int nelem = offset.back();
   int npoin = indexMeshVertices(saveAll);
 
   Msg::Info("Writing %d elements and %d nodes", nelem, npoin);
 
   // elements
   fprintf(fp, "NELEM= %d\n", nelem);
-  int num = 0;
-  if(ndime == 2) {
-    for(fiter it = firstFace(); it != lastFace(); it++)
-      if(saveAll || (*it)->physicals.size())
-        for(std::size_t i = 0; i < (*it)->getNumMeshElements(); i++)
-          (*it)->getMeshElement(i)->writeSU2(fp, num++);
-  }
-  else {
-    for(riter it = firstRegion(); it != lastRegion(); it++)
-      if(saveAll || (*it)->physicals.size())
-        for(std::size_t i = 0; i < (*it)->getNumMeshElements(); i++)
-          (*it)->getMeshElement(i)->writeSU2(fp, num++);
+  // (chunks of entities are formatted in parallel and written in order)
+  std::vector<TextBufferChunk> chunks;
+  for(std::size_t i = 0; i < elements.size(); i++)
+    addTextBufferChunks(chunks, i, elements[i]->getNumMeshElements());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = elements[chunks[c].entity];
+    int off = offset[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->getMeshElement(j)->writeSU2(buf, off + (int)j);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
   }
 
   // vertices
   fprintf(fp, "NPOIN= %d\n", npoin);
   std::vector<GEntity *> entities;
   getEntities(entities);
+  chunks.clear();
   for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeSU2(fp, ndime, scalingFactor);
+    addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->mesh_vertices[j]->writeSU2(buf, ndime, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
+  }
 
   // markers for physical groups of dimension (ndime - 1)
   std::map<int, std::vector<GEntity *> > groups[4];
@@ -104,9 +126,13 @@ int GModel::writeSU2(const std::string &name, bool saveAll,
         fprintf(fp, "MARKER_TAG= %s\n",
                 physicalName(this, ndime - 1, it->first).c_str());
         fprintf(fp, "MARKER_ELEMS= %d\n", n);
+        TextBuffer buf;
         for(std::size_t i = 0; i < entities.size(); i++)
-          for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++)
-            entities[i]->getMeshElement(j)->writeSU2(fp, -1);
+          for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
+            entities[i]->getMeshElement(j)->writeSU2(buf, -1);
+            if(buf.size() > (1 << 20)) buf.write(fp);
+          }
+        buf.write(fp);
       }
     }
   }
@@ -16,6 +16,7 @@
 #include "MHexahedron.h"
 #include "MPrism.h"
 #include "Context.h"
+#include "TextBuffer.h"
 
 //#define COMPRESSED_UNV
 #if defined(COMPRESSED_UNV) && defined(HAVE_LIBZ)
@@ -304,22 +305,47 @@ int GModel::writeUNV(const std::string &name, bool saveAll,
   // nodes
   fprintf(fp, "%6d\n", -1);
   fprintf(fp, "%6d\n", 2411);
+  bool strict = CTX::instance()->mesh.unvStrictFormat ? true : false;
+  // format chunks of the entities in parallel, and write them in order
+  std::vector<TextBufferChunk> chunks;
   for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeUNV
-        (fp, CTX::instance()->mesh.unvStrictFormat ? true : false, scalingFactor);
+    addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+      ge->mesh_vertices[j]->writeUNV(buf, strict, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
+  }
   fprintf(fp, "%6d\n", -1);
 
   // elements
   fprintf(fp, "%6d\n", -1);
   fprintf(fp, "%6d\n", 2412);
-  for(std::size_t i = 0; i < entities.size(); i++) {
-    if(saveAll || entities[i]->physicals.size()) {
-      for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-        MElement *e = entities[i]->getMeshElement(j);
-        e->writeUNV(fp, e->getNum(), entities[i]->tag(), 0);
-      }
+  chunks.clear();
+  for(std::size_t i = 0; i < entities.size(); i++)
+    if(saveAll || entities[i]->physicals.size())
+      addTextBufferChunks(chunks, i, entities[i]->getNumMeshElements());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+  for(int c = 0; c < (int)chunks.size(); c++) {
+    GEntity *ge = entities[chunks[c].entity];
+    TextBuffer buf;
+    for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++) {
+      MElement *e = ge->getMeshElement(j);
+      e->writeUNV(buf, e->getNum(), ge->tag(), 0);
     }
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    buf.write(fp);
   }
   fprintf(fp, "%6d\n", -1);
 
@@ -355,18 +381,23 @@ int GModel::writeUNV(const std::string &name, bool saveAll,
               0, 0, (int)nodes.size() + nele);
       fprintf(fp, "%s\n", physicalName(this, dim, it->first).c_str());
 
+      TextBuffer buf;
       if(saveGroupsOfNodes) {
         int row = 0;
         for(std::set<MVertex *>::iterator it2 = nodes.begin();
             it2 != nodes.end(); it2++) {
           if(row == 2) {
-            fprintf(fp, "\n");
+            buf.addChar('\n');
             row = 0;
           }
-          fprintf(fp, "%10d%10ld%10d%10d", 7, (*it2)->getIndex(), 0, 0);
+          buf.addInt(7, 10);
+          buf.addInt((*it2)->getIndex(), 10);
+          buf.addInt(0, 10);
+          buf.addInt(0, 10);
           row++;
+          if(buf.size() > (1 << 20)) buf.write(fp);
         }
-        fprintf(fp, "\n");
+        buf.addChar('\n');
       }
 
       {
@@ -375,15 +406,20 @@ int GModel::writeUNV(const std::string &name, bool saveAll,
           for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
             MElement *e = entities[i]->getMeshElement(j);
             if(row == 2) {
-              fprintf(fp, "\n");
+              buf.addChar('\n');
               row = 0;
             }
-            fprintf(fp, "%10d%10lu%10d%10d", 8, e->getNum(), 0, 0);
+            buf.addInt(8, 10);
+            buf.addUnsigned(e->getNum(), 10);
+            buf.addInt(0, 10);
+            buf.addInt(0, 10);
             row++;
+            if(buf.size() > (1 << 20)) buf.write(fp);
           }
         }
-        fprintf(fp, "\n");
+        buf.addChar('\n');
       }
+      buf.write(fp);
     }
   }
   fprintf(fp, "%6d\n", -1);
@@ -14,6 +14,7 @@
 #include "MPrism.h"
 #include "MPyramid.h"
 #include "StringUtils.h"
+#include "TextBuffer.h"
 
 int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
                      double scalingFactor, bool bigEndian)
@@ -44,10 +45,31 @@ int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
 
   // write mesh vertices
   fprintf(fp, "POINTS %d double\n", numVertices);
-  for(std::size_t i = 0; i < entities.size(); i++)
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeVTK(fp, binary, scalingFactor,
-                                              bigEndian);
+  if(binary) {
+    for(std::size_t i = 0; i < entities.size(); i++)
+      for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
+        entities[i]->mesh_vertices[j]->writeVTK(fp, binary, scalingFactor,
+                                                bigEndian);
+  }
+  else {
+    // format chunks of the entities in parallel, and write them in order
+    std::vector<TextBufferChunk> chunks;
+    for(std::size_t i = 0; i < entities.size(); i++)
+      addTextBufferChunks(chunks, i, entities[i]->mesh_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+    for(int c = 0; c < (int)chunks.size(); c++) {
+      GEntity *ge = entities[chunks[c].entity];
+      TextBuffer buf;
+      for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+        ge->mesh_vertices[j]->writeVTK(buf, scalingFactor);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+      buf.write(fp);
+    }
+  }
   fprintf(fp, "\n");
 
   // loop over all elements we need to save and count vertices
@@ -65,18 +87,40 @@ int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
 
   // print vertex indices in ascii or binary
   fprintf(fp, "CELLS %d %d\n", numElements, totalNumInt);
-  for(std::size_t i = 0; i < entities.size(); i++) {
-    if(entities[i]->physicals.size() || saveAll) {
-      for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-        if(entities[i]->getMeshElement(j)->getTypeForVTK())
-          entities[i]->getMeshElement(j)->writeVTK(fp, binary, bigEndian);
+  if(binary) {
+    for(std::size_t i = 0; i < entities.size(); i++) {
+      if(entities[i]->physicals.size() || saveAll) {
+        for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
+          if(entities[i]->getMeshElement(j)->getTypeForVTK())
+            entities[i]->getMeshElement(j)->writeVTK(fp, binary, bigEndian);
+        }
       }
     }
   }
+  else {
+    std::vector<TextBufferChunk> chunks;
+    for(std::size_t i = 0; i < entities.size(); i++)
+      if(entities[i]->physicals.size() || saveAll)
+        addTextBufferChunks(chunks, i, entities[i]->getNumMeshElements());
+#if defined(_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+    for(int c = 0; c < (int)chunks.size(); c++) {
+      GEntity *ge = entities[chunks[c].entity];
+      TextBuffer buf;
+      for(std::size_t j = chunks[c].begin; j < chunks[c].end; j++)
+        ge->getMeshElement(j)->writeVTK(buf);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+      buf.write(fp);
+    }
+  }
   fprintf(fp, "\n");
 
   // print element types in ascii or binary
   fprintf(fp, "CELL_TYPES %d\n", numElements);
+  TextBuffer buf;
   for(std::size_t i = 0; i < entities.size(); i++) {
     if(entities[i]->physicals.size() || saveAll) {
       for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
@@ -87,13 +131,18 @@ int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
             if(!bigEndian) SwapBytes((char *)&type, sizeof(int), 1);
             fwrite(&type, sizeof(int), 1, fp);
           }
-          else
-            fprintf(fp, "%d\n", type);
+          else {
+            buf.addInt(type);
+            buf.addChar('\n');
+            if(buf.size() > (1 << 20)) buf.write(fp);
+          }
         }
       }
     }
   }
 
+  buf.write(fp);
+
   fclose(fp);
   return 1;
 }
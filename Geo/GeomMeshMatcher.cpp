@@ -627,10 +627,10 @@ static void copy_periodicity(std::vector<Pair<GEType *, GEType *> > &eCor,
       GEType *newSrc = tgtIter->second;
       newTgt->setMeshMaster(newSrc, oldTgt->affineTransform);
 
-      std::map<MVertex *, MVertex *> &oldV2v = oldTgt->correspondingVertices;
-      std::map<MVertex *, MVertex *> &newV2v = newTgt->correspondingVertices;
+      MVertexPairs &oldV2v = oldTgt->correspondingVertices;
+      MVertexPairs &newV2v = newTgt->correspondingVertices;
 
-      std::map<MVertex *, MVertex *>::iterator vIter = oldV2v.begin();
+      MVertexPairs::iterator vIter = oldV2v.begin();
       for(; vIter != oldV2v.end(); ++vIter) {
         MVertex *oldTgtV = vIter->first;
         MVertex *oldSrcV = vIter->second;
@@ -23,6 +23,7 @@
 #include "MSubElement.h"
 #include "GEntity.h"
 #include "StringUtils.h"
+#include "TextBuffer.h"
 #include "Numeric.h"
 #include "CondNumBasis.h"
 #include "Context.h"
@@ -1366,13 +1367,20 @@ void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
                          int elementary, int physical, int parentNum,
                          int dom1Num, int dom2Num, std::vector<short> *ghosts)
 {
+  if(!binary) {
+    TextBuffer &buf = getLocalTextBuffer();
+    writeMSH2(buf, version, num, elementary, physical, parentNum, dom1Num,
+              dom2Num, ghosts);
+    buf.write(fp);
+    return;
+  }
+
   int type = getTypeForMSH();
 
   if(!type) return;
 
   int n = getNumVerticesForMSH();
   int par = (parentNum) ? 1 : 0;
-  int dom = (dom1Num) ? 2 : 0;
   bool poly = (type == MSH_POLYG_ || type == MSH_POLYH_ || type == MSH_POLYG_B);
 
   // if polygon loop over children (triangles and tets)
@@ -1403,68 +1411,146 @@ void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
 
   if(CTX::instance()->mesh.preserveNumberingMsh2) num = (int)_num;
 
-  if(!binary) {
-    fprintf(fp, "%d %d", num ? num : (int)_num, type);
-    if(version < 2.0)
-      fprintf(fp, " %d %d %d", abs(physical), elementary, n);
-    else if(version < 2.2)
-      fprintf(fp, " %d %d %d", abs(physical), elementary, _partition);
-    else if(!_partition && !par && !dom)
-      fprintf(fp, " %d %d %d", 2 + par + dom, abs(physical), elementary);
-    else if(!ghosts)
-      fprintf(fp, " %d %d %d 1 %d", 4 + par + dom, abs(physical), elementary,
-              _partition);
-    else {
-      int numGhosts = ghosts->size();
-      fprintf(fp, " %d %d %d %d %d", 4 + numGhosts + par + dom, abs(physical),
-              elementary, 1 + numGhosts, _partition);
-      for(std::size_t i = 0; i < ghosts->size(); i++)
-        fprintf(fp, " %d", -(*ghosts)[i]);
-    }
-    if(version >= 2.0 && par) fprintf(fp, " %d", parentNum);
-    if(version >= 2.0 && dom) fprintf(fp, " %d %d", dom1Num, dom2Num);
-    if(version >= 2.0 && poly) fprintf(fp, " %d", n);
-  }
+  int numTags, numGhosts = 0;
+  if(!_partition)
+    numTags = 2;
+  else if(!ghosts)
+    numTags = 4;
   else {
-    int numTags, numGhosts = 0;
-    if(!_partition)
-      numTags = 2;
-    else if(!ghosts)
-      numTags = 4;
-    else {
-      numGhosts = ghosts->size();
-      numTags = 4 + numGhosts;
-    }
-    numTags += par;
-    // we write elements in blobs of single elements; this will lead
-    // to suboptimal reads, but it's much simpler when the number of
-    // tags change from element to element (third-party codes can
-    // still write MSH file optimized for reading speed, by grouping
-    // elements with the same number of tags in blobs)
-    int blob[60] = {
-      type,          1,          numTags,       num ? num : (int)_num,
-      abs(physical), elementary, 1 + numGhosts, _partition};
-    if(ghosts)
-      for(int i = 0; i < numGhosts; i++) blob[8 + i] = -(*ghosts)[i];
-    if(par) blob[8 + numGhosts] = parentNum;
-    if(poly) Msg::Error("Unable to write polygons/polyhedra in binary files.");
-    fwrite(blob, sizeof(int), 4 + numTags, fp);
-  }
+    numGhosts = ghosts->size();
+    numTags = 4 + numGhosts;
+  }
+  numTags += par;
+  // we write elements in blobs of single elements; this will lead
+  // to suboptimal reads, but it's much simpler when the number of
+  // tags change from element to element (third-party codes can
+  // still write MSH file optimized for reading speed, by grouping
+  // elements with the same number of tags in blobs)
+  int blob[60] = {
+    type,          1,          numTags,       num ? num : (int)_num,
+    abs(physical), elementary, 1 + numGhosts, _partition};
+  if(ghosts)
+    for(int i = 0; i < numGhosts; i++) blob[8 + i] = -(*ghosts)[i];
+  if(par) blob[8 + numGhosts] = parentNum;
+  if(poly) Msg::Error("Unable to write polygons/polyhedra in binary files.");
+  fwrite(blob, sizeof(int), 4 + numTags, fp);
 
   if(physical < 0) reverse();
 
   std::vector<int> verts;
   getVerticesIdForMSH(verts);
+  fwrite(&verts[0], sizeof(int), n, fp);
 
-  if(!binary) {
-    for(int i = 0; i < n; i++) fprintf(fp, " %d", verts[i]);
-    fprintf(fp, "\n");
+  if(physical < 0) reverse();
+}
+
+void MElement::writeMSH2(TextBuffer &buf, double version, int num,
+                         int elementary, int physical, int parentNum,
+                         int dom1Num, int dom2Num, std::vector<short> *ghosts)
+{
+  int type = getTypeForMSH();
+
+  if(!type) return;
+
+  int n = getNumVerticesForMSH();
+  int par = (parentNum) ? 1 : 0;
+  int dom = (dom1Num) ? 2 : 0;
+  bool poly = (type == MSH_POLYG_ || type == MSH_POLYH_ || type == MSH_POLYG_B);
+
+  // if polygon loop over children (triangles and tets)
+  if(CTX::instance()->mesh.saveTri) {
+    if(poly) {
+      for(int i = 0; i < getNumChildren(); i++) {
+        MElement *t = getChild(i);
+        t->writeMSH2(buf, version, num++, elementary, physical, 0, 0, 0,
+                     ghosts);
+      }
+      return;
+    }
+    if(type == MSH_TRI_B) {
+      MTriangle t(getVertex(0), getVertex(1), getVertex(2));
+      t.writeMSH2(buf, version, num++, elementary, physical, 0, 0, 0, ghosts);
+      return;
+    }
+    if(type == MSH_LIN_B || type == MSH_LIN_C) {
+      MLine l(getVertex(0), getVertex(1));
+      l.writeMSH2(buf, version, num++, elementary, physical, 0, 0, 0, ghosts);
+      return;
+    }
+  }
+
+  if(CTX::instance()->mesh.preserveNumberingMsh2) num = (int)_num;
+
+  buf.addInt(num ? num : (int)_num);
+  buf.addChar(' ');
+  buf.addInt(type);
+  int tags[5], numTags = 0;
+  if(version < 2.0) {
+    tags[numTags++] = abs(physical);
+    tags[numTags++] = elementary;
+    tags[numTags++] = n;
+  }
+  else if(version < 2.2) {
+    tags[numTags++] = abs(physical);
+    tags[numTags++] = elementary;
+    tags[numTags++] = _partition;
+  }
+  else if(!_partition && !par && !dom) {
+    tags[numTags++] = 2 + par + dom;
+    tags[numTags++] = abs(physical);
+    tags[numTags++] = elementary;
+  }
+  else if(!ghosts) {
+    tags[numTags++] = 4 + par + dom;
+    tags[numTags++] = abs(physical);
+    tags[numTags++] = elementary;
+    tags[numTags++] = 1;
+    tags[numTags++] = _partition;
   }
   else {
-    fwrite(&verts[0], sizeof(int), n, fp);
+    int numGhosts = ghosts->size();
+    tags[numTags++] = 4 + numGhosts + par + dom;
+    tags[numTags++] = abs(physical);
+    tags[numTags++] = elementary;
+    tags[numTags++] = 1 + numGhosts;
+    tags[numTags++] = _partition;
+  }
+  for(int i = 0; i < numTags; i++) {
+    buf.addChar(' ');
+    buf.addInt(tags[i]);
+  }
+  if(ghosts && version >= 2.2 && (_partition || par || dom)) {
+    for(std::size_t i = 0; i < ghosts->size(); i++) {
+      buf.addChar(' ');
+      buf.addInt(-(*ghosts)[i]);
+    }
+  }
+  if(version >= 2.0 && par) {
+    buf.addChar(' ');
+    buf.addInt(parentNum);
+  }
+  if(version >= 2.0 && dom) {
+    buf.addChar(' ');
+    buf.addInt(dom1Num);
+    buf.addChar(' ');
+    buf.addInt(dom2Num);
+  }
+  if(version >= 2.0 && poly) {
+    buf.addChar(' ');
+    buf.addInt(n);
   }
 
   if(physical < 0) reverse();
+
+  std::vector<int> verts;
+  getVerticesIdForMSH(verts);
+  for(int i = 0; i < n; i++) {
+    buf.addChar(' ');
+    buf.addInt(verts[i]);
+  }
+  buf.addChar('\n');
+
+  if(physical < 0) reverse();
 }
 
 void MElement::writeMSH3(FILE *fp, bool binary, int entity,
@@ -1687,8 +1773,8 @@ void MElement::writeVTK(FILE *fp, bool binary, bool bigEndian)
 {
   if(!getTypeForVTK()) return;
 
-  int n = getNumVertices();
   if(binary) {
+    int n = getNumVertices();
     int verts[60];
     verts[0] = n;
     for(int i = 0; i < n; i++)
@@ -1698,11 +1784,23 @@ void MElement::writeVTK(FILE *fp, bool binary, bool bigEndian)
     fwrite(verts, sizeof(int), n + 1, fp);
   }
   else {
-    fprintf(fp, "%d", n);
-    for(int i = 0; i < n; i++)
-      fprintf(fp, " %ld", getVertexVTK(i)->getIndex() - 1);
-    fprintf(fp, "\n");
+    TextBuffer &buf = getLocalTextBuffer();
+    writeVTK(buf);
+    buf.write(fp);
+  }
+}
+
+void MElement::writeVTK(TextBuffer &buf)
+{
+  if(!getTypeForVTK()) return;
+
+  int n = getNumVertices();
+  buf.addInt(n);
+  for(int i = 0; i < n; i++) {
+    buf.addChar(' ');
+    buf.addInt(getVertexVTK(i)->getIndex() - 1);
   }
+  buf.addChar('\n');
 }
 
 void MElement::writeMATLAB(FILE *fp, int filetype, int elementary, int physical,
@@ -1736,6 +1834,13 @@ void MElement::writeMATLAB(FILE *fp, int filetype, int elementary, int physical,
 }
 
 void MElement::writeUNV(FILE *fp, int num, int elementary, int physical)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeUNV(buf, num, elementary, physical);
+  buf.write(fp);
+}
+
+void MElement::writeUNV(TextBuffer &buf, int num, int elementary, int physical)
 {
   int type = getTypeForUNV();
   if(!type) {
@@ -1749,38 +1854,56 @@ void MElement::writeUNV(FILE *fp, int num, int elementary, int physical)
   int physical_property = elementary;
   int material_property = abs(physical);
   int color = 7;
-  fprintf(fp, "%10d%10d%10d%10d%10d%10d\n", num ? num : (int)_num, type,
-          physical_property, material_property, color, n);
-  if(type == 21 || type == 24) // linear beam or parabolic beam
-    fprintf(fp, "%10d%10d%10d\n", 0, 0, 0);
+  buf.addInt(num ? num : (int)_num, 10);
+  buf.addInt(type, 10);
+  buf.addInt(physical_property, 10);
+  buf.addInt(material_property, 10);
+  buf.addInt(color, 10);
+  buf.addInt(n, 10);
+  buf.addChar('\n');
+  if(type == 21 || type == 24) { // linear beam or parabolic beam
+    for(int i = 0; i < 3; i++) buf.addInt(0, 10);
+    buf.addChar('\n');
+  }
 
   if(physical < 0) reverse();
 
   for(int k = 0; k < n; k++) {
-    fprintf(fp, "%10ld", getVertexUNV(k)->getIndex());
-    if(k % 8 == 7) fprintf(fp, "\n");
+    buf.addInt(getVertexUNV(k)->getIndex(), 10);
+    if(k % 8 == 7) buf.addChar('\n');
   }
-  if(n - 1 % 8 != 7) fprintf(fp, "\n");
+  if(n - 1 % 8 != 7) buf.addChar('\n');
 
   if(physical < 0) reverse();
 }
 
 void MElement::writeMESH(FILE *fp, int elementTagType, int elementary,
                          int physical)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeMESH(buf, elementTagType, elementary, physical);
+  buf.write(fp);
+}
+
+void MElement::writeMESH(TextBuffer &buf, int elementTagType, int elementary,
+                         int physical)
 {
   if(physical < 0) reverse();
 
-  for(std::size_t i = 0; i < getNumVertices(); i++)
+  for(std::size_t i = 0; i < getNumVertices(); i++) {
+    buf.addChar(' ');
     if(getTypeForMSH() == MSH_TET_10 && i == 8)
-      fprintf(fp, " %ld", getVertex(9)->getIndex());
+      buf.addInt(getVertex(9)->getIndex());
     else if(getTypeForMSH() == MSH_TET_10 && i == 9)
-      fprintf(fp, " %ld", getVertex(8)->getIndex());
+      buf.addInt(getVertex(8)->getIndex());
     else
-      fprintf(fp, " %ld", getVertex(i)->getIndex());
-  fprintf(fp, " %d\n",
-          (elementTagType == 3) ?
-            _partition :
-            (elementTagType == 2) ? abs(physical) : elementary);
+      buf.addInt(getVertex(i)->getIndex());
+  }
+  buf.addChar(' ');
+  buf.addInt((elementTagType == 3) ?
+               _partition :
+               (elementTagType == 2) ? abs(physical) : elementary);
+  buf.addChar('\n');
 
   if(physical < 0) reverse();
 }
@@ -1818,6 +1941,14 @@ void MElement::writeIR3(FILE *fp, int elementTagType, int num, int elementary,
 
 void MElement::writeBDF(FILE *fp, int format, int elementTagType,
                         int elementary, int physical)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeBDF(buf, format, elementTagType, elementary, physical);
+  buf.write(fp);
+}
+
+void MElement::writeBDF(TextBuffer &buf, int format, int elementTagType,
+                        int elementary, int physical)
 {
   const char *str = getStringForBDF();
   if(!str) return;
@@ -1833,43 +1964,62 @@ void MElement::writeBDF(FILE *fp, int format, int elementTagType,
               (elementTagType == 2) ? abs(physical) : elementary;
 
   if(format == 0) { // free field format
-    fprintf(fp, "%s,%lu,%d", str, _num, tag);
+    buf.addString(str);
+    buf.addChar(',');
+    buf.addUnsigned(_num);
+    buf.addChar(',');
+    buf.addInt(tag);
     for(int i = 0; i < n; i++) {
-      fprintf(fp, ",%ld", getVertexBDF(i)->getIndex());
+      buf.addChar(',');
+      buf.addInt(getVertexBDF(i)->getIndex());
       if(i != n - 1 && !((i + 3) % 8)) {
-        fprintf(fp, ",+%s%lu\n+%s%lu", cont[ncont], _num, cont[ncont], _num);
+        buf.addString(",+");
+        buf.addString(cont[ncont]);
+        buf.addUnsigned(_num);
+        buf.addString("\n+");
+        buf.addString(cont[ncont]);
+        buf.addUnsigned(_num);
         ncont++;
       }
     }
     if(n == 2) // CBAR
-      fprintf(fp, ",0.,0.,0.");
-    fprintf(fp, "\n");
+      buf.addString(",0.,0.,0.");
+    buf.addChar('\n');
   }
   else if(format == 1) { // small field format
-    fprintf(fp, "%-8s%-8lu%-8d", str, _num, tag);
+    buf.addString(str, -8);
+    buf.addUnsigned(_num, -8);
+    buf.addInt(tag, -8);
     for(int i = 0; i < n; i++) {
-      fprintf(fp, "%-8ld", getVertexBDF(i)->getIndex());
+      buf.addInt(getVertexBDF(i)->getIndex(), -8);
       if(i != n - 1 && !((i + 3) % 8)) {
-        fprintf(fp, "+%s%-6lu\n+%s%-6lu", cont[ncont], _num, cont[ncont], _num);
+        buf.addChar('+');
+        buf.addString(cont[ncont]);
+        buf.addUnsigned(_num, -6);
+        buf.addString("\n+");
+        buf.addString(cont[ncont]);
+        buf.addUnsigned(_num, -6);
         ncont++;
       }
     }
     if(n == 2) // CBAR
-      fprintf(fp, "%-8s%-8s%-8s", "0.", "0.", "0.");
-    fprintf(fp, "\n");
+      for(int i = 0; i < 3; i++) buf.addString("0.", -8);
+    buf.addChar('\n');
   }
   else{ // large field format
-    fprintf(fp, "%-8s%-8lu%-8d", str, _num, tag);
+    buf.addString(str, -8);
+    buf.addUnsigned(_num, -8);
+    buf.addInt(tag, -8);
     for(int i = 0; i < n; i++) {
-      fprintf(fp, "%-8ld", getVertexBDF(i)->getIndex());
+      buf.addInt(getVertexBDF(i)->getIndex(), -8);
       if(i != n - 1 && !((i + 3) % 8)) {
-        fprintf(fp, "\n        ");
+        buf.addString("\n        ");
         ncont++;
       }
     }
     if(n == 2) // CBAR
-      fprintf(fp, "%-8s%-8s%-8s", "0.", "0.", "0.");
-    fprintf(fp, "\n");
+      for(int i = 0; i < 3; i++) buf.addString("0.", -8);
+    buf.addChar('\n');
   }
 
   if(physical < 0) reverse();
@@ -1898,16 +2048,24 @@ void MElement::writeDIFF(FILE *fp, int num, bool binary, int physical)
 
 void MElement::writeINP(FILE *fp, int num)
 {
-  fprintf(fp, "%d, ", num);
+  TextBuffer &buf = getLocalTextBuffer();
+  writeINP(buf, num);
+  buf.write(fp);
+}
+
+void MElement::writeINP(TextBuffer &buf, int num)
+{
+  buf.addInt(num);
+  buf.addString(", ");
   int n = getNumVertices();
   for(int i = 0; i < n; i++) {
-    fprintf(fp, "%ld", getVertexINP(i)->getIndex());
+    buf.addInt(getVertexINP(i)->getIndex());
     if(i != n - 1) {
-      fprintf(fp, ", ");
-      if(i && !((i + 2) % 16)) fprintf(fp, "\n");
+      buf.addString(", ");
+      if(i && !((i + 2) % 16)) buf.addChar('\n');
     }
   }
-  fprintf(fp, "\n");
+  buf.addChar('\n');
 }
 
 void MElement::writeKEY(FILE *fp, int pid, int num)
@@ -1959,13 +2117,21 @@ void MElement::writeKEY(FILE *fp, int pid, int num)
 
 void MElement::writeSU2(FILE *fp, int num)
 {
-  fprintf(fp, "%d ", getTypeForVTK());
-  for(std::size_t i = 0; i < getNumVertices(); i++)
-    fprintf(fp, "%ld ", getVertexVTK(i)->getIndex() - 1);
-  if(num >= 0)
-    fprintf(fp, "%d\n", num);
-  else
-    fprintf(fp, "\n");
+  TextBuffer &buf = getLocalTextBuffer();
+  writeSU2(buf, num);
+  buf.write(fp);
+}
+
+void MElement::writeSU2(TextBuffer &buf, int num)
+{
+  buf.addInt(getTypeForVTK());
+  buf.addChar(' ');
+  for(std::size_t i = 0; i < getNumVertices(); i++) {
+    buf.addInt(getVertexVTK(i)->getIndex() - 1);
+    buf.addChar(' ');
+  }
+  if(num >= 0) buf.addInt(num);
+  buf.addChar('\n');
 }
 
 unsigned int MElement::getInfoMSH(const int typeMSH, const char **const name)
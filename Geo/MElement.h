@@ -14,6 +14,7 @@
 #include "GmshMessage.h"
 #include "ElementType.h"
 #include "MVertex.h"
+#include "MemoryPool.h"
 #include "MEdge.h"
 #include "MFace.h"
 #include "nodalBasis.h"
@@ -23,6 +24,7 @@
 
 class GModel;
 class JacobianBasis;
+class TextBuffer;
 
 // A mesh element.
 class MElement {
@@ -57,6 +59,16 @@ protected:
 public:
   MElement(std::size_t num = 0, int part = 0);
   virtual ~MElement() {}
+
+  // elements are allocated in slabs, released in bulk with the mesh
+  static void *operator new(std::size_t size)
+  {
+    return MemoryPool::allocate(size);
+  }
+  static void operator delete(void *p, std::size_t size)
+  {
+    MemoryPool::deallocate(p, size);
+  }
   // set/get the tolerance for isInside() test
   static void setTolerance(const double tol);
   static double getTolerance();
@@ -478,6 +490,21 @@ public:
   virtual void writeKEY(FILE *fp, int pid, int num);
   virtual void writeSU2(FILE *fp, int num);
 
+  // ASCII IO routines formatting into a buffer (in ASCII mode the FILE
+  // versions above call these on the buffer of the calling thread)
+  virtual void writeMSH2(TextBuffer &buf, double version, int num,
+                         int elementary, int physical, int parentNum = 0,
+                         int dom1Num = 0, int dom2Num = 0,
+                         std::vector<short> *ghosts = 0);
+  virtual void writeUNV(TextBuffer &buf, int num, int elementary, int physical);
+  virtual void writeVTK(TextBuffer &buf);
+  virtual void writeMESH(TextBuffer &buf, int elementTagType, int elementary,
+                         int physical);
+  virtual void writeBDF(TextBuffer &buf, int format, int elementTagType,
+                        int elementary, int physical);
+  virtual void writeINP(TextBuffer &buf, int num);
+  virtual void writeSU2(TextBuffer &buf, int num);
+
   // info for specific IO formats (returning 0 means that the element is not
   // implemented in that format)
   virtual int getTypeForMSH() const { return 0; }
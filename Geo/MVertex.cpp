@@ -12,6 +12,7 @@
 #include "GFace.h"
 #include "GmshMessage.h"
 #include "StringUtils.h"
+#include "TextBuffer.h"
 
 double angle3Vertices(const MVertex *p1, const MVertex *p2, const MVertex *p3)
 {
@@ -143,6 +144,13 @@ void MVertex::writeMSH2(FILE *fp, bool binary, bool saveParametric,
 {
   if(_index < 0) return; // negative index vertices are never saved
 
+  if(!binary) {
+    TextBuffer &buf = getLocalTextBuffer();
+    writeMSH2(buf, saveParametric, scalingFactor);
+    buf.write(fp);
+    return;
+  }
+
   int myDim = 0, myTag = 0;
   if(saveParametric) {
     if(onWhat()) {
@@ -153,49 +161,73 @@ void MVertex::writeMSH2(FILE *fp, bool binary, bool saveParametric,
       saveParametric = false;
   }
 
-  if(!binary) {
-    if(!saveParametric)
-      fprintf(fp, "%ld %.16g %.16g %.16g\n", _index, x() * scalingFactor,
-              y() * scalingFactor, z() * scalingFactor);
-    else
-      fprintf(fp, "%ld %.16g %.16g %.16g %d %d", _index, x() * scalingFactor,
-              y() * scalingFactor, z() * scalingFactor, myDim, myTag);
+  int i = (int)_index;
+  fwrite(&i, sizeof(int), 1, fp);
+  double data[3] = {x() * scalingFactor, y() * scalingFactor,
+                    z() * scalingFactor};
+  fwrite(data, sizeof(double), 3, fp);
+  if(saveParametric) {
+    fwrite(&myDim, sizeof(int), 1, fp);
+    fwrite(&myTag, sizeof(int), 1, fp);
+    if(myDim == 1) {
+      double _u;
+      getParameter(0, _u);
+      fwrite(&_u, sizeof(double), 1, fp);
+    }
+    else if(myDim == 2) {
+      double _u, _v;
+      getParameter(0, _u);
+      getParameter(1, _v);
+      fwrite(&_u, sizeof(double), 1, fp);
+      fwrite(&_v, sizeof(double), 1, fp);
+    }
   }
-  else {
-    int i = (int)_index;
-    fwrite(&i, sizeof(int), 1, fp);
-    double data[3] = {x() * scalingFactor, y() * scalingFactor,
-                      z() * scalingFactor};
-    fwrite(data, sizeof(double), 3, fp);
-    if(saveParametric) {
-      fwrite(&myDim, sizeof(int), 1, fp);
-      fwrite(&myTag, sizeof(int), 1, fp);
+}
+
+void MVertex::writeMSH2(TextBuffer &buf, bool saveParametric,
+                        double scalingFactor)
+{
+  if(_index < 0) return; // negative index vertices are never saved
+
+  int myDim = 0, myTag = 0;
+  if(saveParametric) {
+    if(onWhat()) {
+      myDim = onWhat()->dim();
+      myTag = onWhat()->tag();
     }
+    else
+      saveParametric = false;
   }
 
+  buf.addInt(_index);
+  buf.addChar(' ');
+  buf.addDouble(x() * scalingFactor);
+  buf.addChar(' ');
+  buf.addDouble(y() * scalingFactor);
+  buf.addChar(' ');
+  buf.addDouble(z() * scalingFactor);
   if(saveParametric) {
+    buf.addChar(' ');
+    buf.addInt(myDim);
+    buf.addChar(' ');
+    buf.addInt(myTag);
     if(myDim == 1) {
       double _u;
       getParameter(0, _u);
-      if(!binary)
-        fprintf(fp, " %.16g\n", _u);
-      else
-        fwrite(&_u, sizeof(double), 1, fp);
+      buf.addChar(' ');
+      buf.addDouble(_u);
     }
     else if(myDim == 2) {
       double _u, _v;
       getParameter(0, _u);
       getParameter(1, _v);
-      if(!binary)
-        fprintf(fp, " %.16g %.16g\n", _u, _v);
-      else {
-        fwrite(&_u, sizeof(double), 1, fp);
-        fwrite(&_v, sizeof(double), 1, fp);
-      }
+      buf.addChar(' ');
+      buf.addDouble(_u);
+      buf.addChar(' ');
+      buf.addDouble(_v);
     }
-    else if(!binary)
-      fprintf(fp, "\n");
   }
+  buf.addChar('\n');
 }
 
 void MVertex::writePLY2(FILE *fp)
@@ -213,29 +245,36 @@ void MVertex::writeVRML(FILE *fp, double scalingFactor)
           z() * scalingFactor);
 }
 
-void MVertex::writeUNV(FILE *fp, bool officialExponentFormat, double scalingFactor)
+void MVertex::writeUNV(FILE *fp, bool officialExponentFormat,
+                       double scalingFactor)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeUNV(buf, officialExponentFormat, scalingFactor);
+  buf.write(fp);
+}
+
+void MVertex::writeUNV(TextBuffer &buf, bool officialExponentFormat,
+                       double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
 
   int coord_sys = 1;
   int displacement_coord_sys = 1;
   int color = 11;
-  fprintf(fp, "%10ld%10d%10d%10d\n", _index, coord_sys, displacement_coord_sys,
-          color);
-
-  if(officialExponentFormat){
+  buf.addInt(_index, 10);
+  buf.addInt(coord_sys, 10);
+  buf.addInt(displacement_coord_sys, 10);
+  buf.addInt(color, 10);
+  buf.addChar('\n');
+
+  for(int i = 0; i < 3; i++) {
+    double c = (i == 0 ? x() : i == 1 ? y() : z()) * scalingFactor;
+    std::size_t start = buf.size();
+    buf.addDouble(c, "%25.16E");
     // hack to print the numbers with "D+XX" exponents
-    char tmp[128];
-    sprintf(tmp, "%25.16E%25.16E%25.16E\n", x() * scalingFactor,
-            y() * scalingFactor, z() * scalingFactor);
-    for(std::size_t i = 0; i < strlen(tmp); i++)
-      if(tmp[i] == 'E') tmp[i] = 'D';
-    fprintf(fp, "%s", tmp);
-  }
-  else{
-    fprintf(fp, "%25.16E%25.16E%25.16E\n", x() * scalingFactor,
-            y() * scalingFactor, z() * scalingFactor);
+    if(officialExponentFormat) buf.replace(start, 'E', 'D');
   }
+  buf.addChar('\n');
 }
 
 void MVertex::writeVTK(FILE *fp, bool binary, double scalingFactor,
@@ -251,11 +290,24 @@ void MVertex::writeVTK(FILE *fp, bool binary, double scalingFactor,
     fwrite(data, sizeof(double), 3, fp);
   }
   else {
-    fprintf(fp, "%.16g %.16g %.16g\n", x() * scalingFactor, y() * scalingFactor,
-            z() * scalingFactor);
+    TextBuffer &buf = getLocalTextBuffer();
+    writeVTK(buf, scalingFactor);
+    buf.write(fp);
   }
 }
 
+void MVertex::writeVTK(TextBuffer &buf, double scalingFactor)
+{
+  if(_index < 0) return; // negative index vertices are never saved
+
+  buf.addDouble(x() * scalingFactor);
+  buf.addChar(' ');
+  buf.addDouble(y() * scalingFactor);
+  buf.addChar(' ');
+  buf.addDouble(z() * scalingFactor);
+  buf.addChar('\n');
+}
+
 void MVertex::writeMATLAB(FILE *fp, int filetype, bool binary,
                           double scalingFactor)
 {
@@ -288,12 +340,21 @@ void MVertex::writeTOCHNOG(FILE *fp, int dim, double scalingFactor)
 }
 
 void MVertex::writeMESH(FILE *fp, double scalingFactor)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeMESH(buf, scalingFactor);
+  buf.write(fp);
+}
+
+void MVertex::writeMESH(TextBuffer &buf, double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
 
-  fprintf(fp, " %20.14G      %20.14G      %20.14G      %d\n",
-          x() * scalingFactor, y() * scalingFactor, z() * scalingFactor,
-          _ge ? _ge->tag() : 0);
+  buf.addDouble(x() * scalingFactor, " %20.14G      ");
+  buf.addDouble(y() * scalingFactor, "%20.14G      ");
+  buf.addDouble(z() * scalingFactor, "%20.14G      ");
+  buf.addInt(_ge ? _ge->tag() : 0);
+  buf.addChar('\n');
 }
 
 void MVertex::writeNEU(FILE *fp, int dim, double scalingFactor)
@@ -341,6 +402,13 @@ static void double_to_char8(double val, char *str)
 }
 
 void MVertex::writeBDF(FILE *fp, int format, double scalingFactor)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeBDF(buf, format, scalingFactor);
+  buf.write(fp);
+}
+
+void MVertex::writeBDF(TextBuffer &buf, int format, double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
 
@@ -353,28 +421,61 @@ void MVertex::writeBDF(FILE *fp, int format, double scalingFactor)
     double_to_char8(x1, xs);
     double_to_char8(y1, ys);
     double_to_char8(z1, zs);
-    fprintf(fp, "GRID,%ld,%d,%s,%s,%s\n", _index, 0, xs, ys, zs);
+    buf.addString("GRID,");
+    buf.addInt(_index);
+    buf.addString(",0,");
+    buf.addString(xs);
+    buf.addChar(',');
+    buf.addString(ys);
+    buf.addChar(',');
+    buf.addString(zs);
+    buf.addChar('\n');
   }
   else if(format == 1) {
     // small field format (8 char par field, 10 per line)
     double_to_char8(x1, xs);
     double_to_char8(y1, ys);
     double_to_char8(z1, zs);
-    fprintf(fp, "GRID    %-8ld%-8d%-8s%-8s%-8s\n", _index, 0, xs, ys, zs);
+    buf.addString("GRID    ");
+    buf.addInt(_index, -8);
+    buf.addInt(0, -8);
+    buf.addString(xs, -8);
+    buf.addString(ys, -8);
+    buf.addString(zs, -8);
+    buf.addChar('\n');
   }
   else {
     // large field format (8 char first/last field, 16 char middle, 6 per line)
-    fprintf(fp, "GRID*   %-16ld%-16d%-16.9G%-16.9G\n", _index, 0, x1, y1);
-    fprintf(fp, "*       %-16.9G\n", z1);
+    buf.addString("GRID*   ");
+    buf.addInt(_index, -16);
+    buf.addInt(0, -16);
+    buf.addDouble(x1, "%-16.9G");
+    buf.addDouble(y1, "%-16.9G");
+    buf.addString("\n*       ");
+    buf.addDouble(z1, "%-16.9G");
+    buf.addChar('\n');
   }
 }
 
 void MVertex::writeINP(FILE *fp, double scalingFactor)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeINP(buf, scalingFactor);
+  buf.write(fp);
+}
+
+void MVertex::writeINP(TextBuffer &buf, double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
 
-  fprintf(fp, "%ld, %.14g, %.14g, %.14g\n", _index, x() * scalingFactor,
-          y() * scalingFactor, z() * scalingFactor);
+  buf.addInt(_index);
+  buf.addString(", ");
+  buf.addDouble(x() * scalingFactor, "%.14g");
+  buf.addString(", ");
+  buf.addDouble(y() * scalingFactor, "%.14g");
+  buf.addString(", ");
+  buf.addDouble(z() * scalingFactor, "%.14g");
+  buf.addChar('\n');
 }
 
 void MVertex::writeKEY(FILE *fp, double scalingFactor)
@@ -394,15 +495,26 @@ void MVertex::writeDIFF(FILE *fp, bool binary, double scalingFactor)
 }
 
 void MVertex::writeSU2(FILE *fp, int dim, double scalingFactor)
+{
+  TextBuffer &buf = getLocalTextBuffer();
+  writeSU2(buf, dim, scalingFactor);
+  buf.write(fp);
+}
+
+void MVertex::writeSU2(TextBuffer &buf, int dim, double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
 
-  if(dim == 2)
-    fprintf(fp, "%.16g %.16g %ld\n", x() * scalingFactor, y() * scalingFactor,
-            _index - 1);
-  else
-    fprintf(fp, "%.16g %.16g %.16g %ld\n", x() * scalingFactor,
-            y() * scalingFactor, z() * scalingFactor, _index - 1);
+  buf.addDouble(x() * scalingFactor);
+  buf.addChar(' ');
+  buf.addDouble(y() * scalingFactor);
+  buf.addChar(' ');
+  if(dim != 2) {
+    buf.addDouble(z() * scalingFactor);
+    buf.addChar(' ');
+  }
+  buf.addInt(_index - 1);
+  buf.addChar('\n');
 }
 
 double MVertexPtrLessThanLexicographic::tolerance = 1.e-6;
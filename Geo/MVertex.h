@@ -14,10 +14,12 @@
 #include "SPoint2.h"
 #include "SPoint3.h"
 #include "MVertexBoundaryLayerData.h"
+#include "MemoryPool.h"
 
 class GEntity;
 class GEdge;
 class GFace;
+class TextBuffer;
 class MVertex;
 
 // A mesh vertex (a "node").
@@ -45,6 +47,16 @@ protected:
 public:
   MVertex(double x, double y, double z, GEntity *ge = 0, std::size_t num = 0);
   virtual ~MVertex() {}
+
+  // vertices are allocated in slabs, released in bulk with the mesh
+  static void *operator new(std::size_t size)
+  {
+    return MemoryPool::allocate(size);
+  }
+  static void operator delete(void *p, std::size_t size)
+  {
+    MemoryPool::deallocate(p, size);
+  }
   void deleteLast();
 
   // get/set the visibility flag
@@ -123,6 +135,18 @@ public:
   void writeKEY(FILE *fp, double scalingFactor = 1.0);
   void writeDIFF(FILE *fp, bool binary, double scalingFactor = 1.0);
   void writeSU2(FILE *fp, int dim, double scalingFactor = 1.0);
+
+  // ASCII IO routines formatting into a buffer (in ASCII mode the FILE
+  // versions above call these on the buffer of the calling thread)
+  void writeMSH2(TextBuffer &buf, bool saveParametric = false,
+                 double scalingFactor = 1.0);
+  void writeUNV(TextBuffer &buf, bool officialExponentFormat,
+                double scalingFactor = 1.0);
+  void writeVTK(TextBuffer &buf, double scalingFactor = 1.0);
+  void writeMESH(TextBuffer &buf, double scalingFactor = 1.0);
+  void writeBDF(TextBuffer &buf, int format = 0, double scalingFactor = 1.0);
+  void writeINP(TextBuffer &buf, double scalingFactor = 1.0);
+  void writeSU2(TextBuffer &buf, int dim, double scalingFactor = 1.0);
 };
 
 class MEdgeVertex : public MVertex {
@@ -0,0 +1,79 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MVERTEX_PAIRS_H
+#define MVERTEX_PAIRS_H
+
+#include <vector>
+#include <unordered_map>
+
+class MVertex;
+
+// Correspondence between mesh nodes (e.g. periodic nodes, from the target to
+// the source entity), stored as a contiguous array of pairs in insertion
+// order, with a hashed index on the first node of each pair. The interface is
+// the subset of the one of std::map<MVertex *, MVertex *> used for periodic
+// meshes; iteration follows the insertion order, which does not depend on
+// the memory addresses of the nodes.
+class MVertexPairs {
+public:
+  typedef std::pair<MVertex *, MVertex *> value_type;
+  typedef std::vector<value_type>::iterator iterator;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+private:
+  std::vector<value_type> _pairs;
+  std::unordered_map<MVertex *, std::size_t> _index;
+
+public:
+  std::size_t size() const { return _pairs.size(); }
+  bool empty() const { return _pairs.empty(); }
+  void clear()
+  {
+    _pairs.clear();
+    _index.clear();
+  }
+  void reserve(std::size_t n)
+  {
+    _pairs.reserve(n);
+    _index.reserve(n);
+  }
+  iterator begin() { return _pairs.begin(); }
+  iterator end() { return _pairs.end(); }
+  const_iterator begin() const { return _pairs.begin(); }
+  const_iterator end() const { return _pairs.end(); }
+  iterator find(MVertex *v)
+  {
+    std::unordered_map<MVertex *, std::size_t>::const_iterator it =
+      _index.find(v);
+    return (it == _index.end()) ? _pairs.end() : _pairs.begin() + it->second;
+  }
+  const_iterator find(MVertex *v) const
+  {
+    std::unordered_map<MVertex *, std::size_t>::const_iterator it =
+      _index.find(v);
+    return (it == _index.end()) ? _pairs.end() : _pairs.begin() + it->second;
+  }
+  std::size_t count(MVertex *v) const { return _index.count(v); }
+  // counterpart of v, inserted (null) if v is not yet in the correspondence
+  MVertex *&operator[](MVertex *v)
+  {
+    std::pair<std::unordered_map<MVertex *, std::size_t>::iterator, bool> it =
+      _index.insert(std::make_pair(v, _pairs.size()));
+    if(it.second) _pairs.push_back(value_type(v, (MVertex *)0));
+    return _pairs[it.first->second].second;
+  }
+  // remove a pair, keeping the insertion order of the others (linear in the
+  // number of pairs after it)
+  void erase(iterator it)
+  {
+    const std::size_t i = it - _pairs.begin();
+    _index.erase(it->first);
+    _pairs.erase(it);
+    for(std::size_t j = i; j < _pairs.size(); j++) _index[_pairs[j].first] = j;
+  }
+};
+
+#endif
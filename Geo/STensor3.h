@@ -8,6 +8,7 @@
 
 #include "SVector3.h"
 #include "fullMatrix.h"
+#include "smallMatrix.h"
 #include "Numeric.h"
 
 // concrete class for symmetric positive definite 3x3 matrix
@@ -36,6 +37,16 @@ public:
     for(int i = 0; i < 3; i++)
       for(int j = 0; j < 3; j++) _val[getIndex(i, j)] = mat(i, j);
   }
+  void getMat(smallMatrix<3, 3> &mat) const
+  {
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 3; j++) mat(i, j) = _val[getIndex(i, j)];
+  }
+  void setMat(const smallMatrix<3, 3> &mat)
+  {
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 3; j++) _val[getIndex(i, j)] = mat(i, j);
+  }
   SMetric3(const SMetric3 &m)
   {
     for(int i = 0; i < 6; i++) _val[i] = m._val[i];
@@ -54,7 +65,7 @@ public:
     // where the elements of diag are l_i = h_i^-2
     // and the rows of e are the UNIT and ORTHOGONAL directions
 
-    fullMatrix<double> e(3, 3);
+    smallMatrix<3, 3> e;
     e(0, 0) = t1(0);
     e(0, 1) = t1(1);
     e(0, 2) = t1(2);
@@ -64,21 +75,19 @@ public:
     e(2, 0) = t3(0);
     e(2, 1) = t3(1);
     e(2, 2) = t3(2);
-    e.transposeInPlace();
 
-    fullMatrix<double> tmp(3, 3);
+    // tmp = e^t * diag
+    smallMatrix<3, 3> tmp;
     tmp(0, 0) = l1 * e(0, 0);
-    tmp(0, 1) = l2 * e(0, 1);
-    tmp(0, 2) = l3 * e(0, 2);
-    tmp(1, 0) = l1 * e(1, 0);
+    tmp(0, 1) = l2 * e(1, 0);
+    tmp(0, 2) = l3 * e(2, 0);
+    tmp(1, 0) = l1 * e(0, 1);
     tmp(1, 1) = l2 * e(1, 1);
-    tmp(1, 2) = l3 * e(1, 2);
-    tmp(2, 0) = l1 * e(2, 0);
-    tmp(2, 1) = l2 * e(2, 1);
+    tmp(1, 2) = l3 * e(2, 1);
+    tmp(2, 0) = l1 * e(0, 2);
+    tmp(2, 1) = l2 * e(1, 2);
     tmp(2, 2) = l3 * e(2, 2);
 
-    e.transposeInPlace();
-
     _val[0] = tmp(0, 0) * e(0, 0) + tmp(0, 1) * e(1, 0) + tmp(0, 2) * e(2, 0);
     _val[1] = tmp(1, 0) * e(0, 0) + tmp(1, 1) * e(1, 0) + tmp(1, 2) * e(2, 0);
     _val[2] = tmp(1, 0) * e(0, 1) + tmp(1, 1) * e(1, 1) + tmp(1, 2) * e(2, 1);
@@ -90,19 +99,18 @@ public:
   inline double operator()(int i, int j) const { return _val[getIndex(i, j)]; }
   SMetric3 invert() const
   {
-    fullMatrix<double> m(3, 3);
+    smallMatrix<3, 3> m, im;
     getMat(m);
-    m.invertInPlace();
+    if(!m.invert(im)) Msg::Warning("Singular matrix in metric inversion");
     SMetric3 ithis;
-    ithis.setMat(m);
+    ithis.setMat(im);
     return ithis;
   }
   double determinant() const
   {
-    fullMatrix<double> m(3, 3);
+    smallMatrix<3, 3> m;
     getMat(m);
-    double det = m.determinant();
-    return det;
+    return m.determinant();
   }
   SMetric3 operator+(const SMetric3 &other) const
   {
@@ -122,7 +130,7 @@ public:
   }
   SMetric3 &operator*=(const SMetric3 &other)
   {
-    fullMatrix<double> m1(3, 3), m2(3, 3), m3(3, 3);
+    smallMatrix<3, 3> m1, m2, m3;
     getMat(m1);
     other.getMat(m2);
     m1.mult(m2, m3);
@@ -131,11 +139,12 @@ public:
   }
   SMetric3 transform(fullMatrix<double> &V)
   {
-    fullMatrix<double> m(3, 3);
+    smallMatrix<3, 3> m, v, result, temp;
     getMat(m);
-    fullMatrix<double> result(3, 3), temp(3, 3);
-    V.transpose().mult(m, temp);
-    temp.mult(V, result);
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 3; j++) v(i, j) = V(i, j);
+    v.transpose().mult(m, temp);
+    temp.mult(v, result);
     SMetric3 a;
     a.setMat(result);
     return a;
@@ -143,8 +152,10 @@ public:
   // s: true if eigenvalues are sorted (from min to max of the REAL part)
   void eig(fullMatrix<double> &V, fullVector<double> &S, bool s = false) const
   {
-    fullMatrix<double> me(3, 3), right(3, 3);
-    fullVector<double> im(3);
+    // work arrays on the stack
+    double meData[9], rightData[9], imData[3];
+    fullMatrix<double> me(meData, 3, 3), right(rightData, 3, 3);
+    fullVector<double> im(imData, 3);
     getMat(me);
     me.eig(S, im, V, right, s);
   }
@@ -382,8 +393,9 @@ public:
   }
   void eig(fullMatrix<double> &V, fullVector<double> &S, bool s = false) const
   {
-    fullMatrix<double> me(3, 3), left(3, 3);
-    fullVector<double> im(3);
+    double meData[9], leftData[9], imData[3];
+    fullMatrix<double> me(meData, 3, 3), left(leftData, 3, 3);
+    fullVector<double> im(imData, 3);
     this->getMat(me);
     me.eig(S, im, left, V, s);
   }
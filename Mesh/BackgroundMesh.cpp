@@ -113,8 +113,6 @@ backgroundMesh::backgroundMesh(GFace *_gf, bool cfd)
   }
 
 #if defined(HAVE_ANN)
-  index = new ANNidx[2];
-  dist = new ANNdist[2];
   nodes = annAllocPts(myBCNodes.size(), 3);
   std::set<SPoint2>::iterator itp = myBCNodes.begin();
   int ind = 0;
@@ -162,8 +160,6 @@ backgroundMesh::~backgroundMesh()
   if(angle_kdtree) delete angle_kdtree;
   if(nodes) annDeallocPts(nodes);
   if(angle_nodes) annDeallocPts(angle_nodes);
-  delete[] index;
-  delete[] dist;
 #endif
 }
 
@@ -178,7 +174,7 @@ static void propagateValuesOnFace(GFace *_gf,
 #elif defined(HAVE_GMM)
   linearSystemCSRGmm<double> *_lsys = new linearSystemCSRGmm<double>;
 #else
-  linearSystemFull<double> *_lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *_lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   dofManager<double> myAssembler(_lsys);
@@ -334,8 +330,6 @@ void backgroundMesh::propagateCrossFieldByDistance(GFace *_gf)
   }
 
 #if defined(HAVE_ANN)
-  index = new ANNidx[NBANN];
-  dist = new ANNdist[NBANN];
   angle_nodes = annAllocPts(_cosines4.size(), 3);
   std::map<MVertex *, double>::iterator itp = _cosines4.begin();
   int ind = 0;
@@ -574,8 +568,10 @@ double backgroundMesh::operator()(double u, double v, double w) const
 #if defined(HAVE_ANN)
     if(uv_kdtree->nPoints() < 2) return -1000.;
     double pt[3] = {u, v, 0.0};
+    ANNidx index[2];
+    ANNdist dist[2];
 #if defined(_OPENMP)
-#pragma omp critical // just to avoid crash (still incorrect) - should use nanoflann
+#pragma omp critical // the ANN search is not reentrant
 #endif
     uv_kdtree->annkSearch(pt, 2, index, dist);
     SPoint3 p1(nodes[index[0]][0], nodes[index[0]][1], nodes[index[0]][2]);
@@ -610,8 +606,10 @@ double backgroundMesh::getAngle(double u, double v, double w) const
     double angle = 0.;
     if(angle_kdtree->nPoints() >= NBANN) {
       double pt[3] = {u, v, 0.0};
+      ANNidx index[NBANN];
+      ANNdist dist[NBANN];
 #if defined(_OPENMP)
-#pragma omp critical // just to avoid crash (still incorrect) - should use nanoflann
+#pragma omp critical // the ANN search is not reentrant
 #endif
       angle_kdtree->annkSearch(pt, NBANN, index, dist);
       double SINE = 0.0, COSINE = 0.0;
@@ -643,8 +641,10 @@ double backgroundMesh::getAngle(double u, double v, double w) const
 #if defined(HAVE_ANN)
     if(uv_kdtree->nPoints() < 2) return -1000.0;
     double pt[3] = {u, v, 0.0};
+    ANNidx index[2];
+    ANNdist dist[2];
 #if defined(_OPENMP)
-#pragma omp critical // just to avoid crash (still incorrect) - should use nanoflann
+#pragma omp critical // the ANN search is not reentrant
 #endif
     uv_kdtree->annkSearch(pt, 2, index, dist);
     SPoint3 p1(nodes[index[0]][0], nodes[index[0]][1], nodes[index[0]][2]);
@@ -52,8 +52,6 @@ class backgroundMesh : public simpleFunction<double> {
 #if defined(HAVE_ANN)
   mutable ANNkd_tree *uv_kdtree;
   mutable ANNpointArray nodes;
-  ANNidxArray index;
-  ANNdistArray dist;
   mutable ANNpointArray angle_nodes;
   mutable ANNkd_tree *angle_kdtree;
   std::vector<double> _cos, _sin;
@@ -3,6 +3,7 @@
 // See the LICENSE.txt file for license information. Please report all
 // issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include "GModel.h"
 #include "MLine.h"
 #include "MTriangle.h"
@@ -47,76 +48,100 @@ static void addExtrudeNormals(std::vector<T *> &elements, int invert,
     return;
   }
 
-  if(octree && !gouraud) { // get extrusion direction from post-processing view
-    std::set<MVertex *> verts;
-    for(std::size_t i = 0; i < elements.size(); i++) {
-      if(!ExtrudeParams::calcLayerScaleFactor[index]) {
-        for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++)
-          verts.insert(elements[i]->getVertex(j));
-      }
-      else {
-        std::vector<MVertex *> elem_verts;
-        elements[i]->getVertices(elem_verts);
-
-        double aveLength = skipScaleCalc ? 1.0 : GetAveEdgeLength(elem_verts);
-
-        for(std::size_t j = 0; j < elem_verts.size(); j++) {
-          verts.insert(elem_verts[j]);
-          // if scaleLastLayer selection, but not doing gouraud, then still
-          // scale the last layer...  This might create weird behavior for the
-          // unprepared...
-          if(aveLength != 0.0)
-            ExtrudeParams::normals[index]->add_scale(
-              elem_verts[j]->x(), elem_verts[j]->y(), elem_verts[j]->z(),
-              aveLength);
-        }
-      }
-    }
-    for(std::set<MVertex *>::iterator it = verts.begin(); it != verts.end();
-        it++) {
-      MVertex *v = *it;
-      double nn[3] = {0., 0., 0.};
-#if defined(HAVE_POST)
-      octree->searchVector(v->x(), v->y(), v->z(), nn, 0);
+  // number the nodes of the elements densely, so that the contributions of
+  // the elements can be accumulated in flat arrays: the (tolerance-based)
+  // coordinate lookup in the smooth_data is then only performed once per node,
+  // and only merges values for nodes that are genuinely duplicated (e.g. on
+  // the boundary between two source entities)
+  std::vector<std::size_t> offsets(elements.size() + 1, 0);
+  for(std::size_t i = 0; i < elements.size(); i++)
+    offsets[i + 1] = offsets[i] + elements[i]->getNumVertices();
+  std::vector<MVertex *> verts(offsets.back());
+  for(std::size_t i = 0; i < elements.size(); i++)
+    for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++)
+      verts[offsets[i] + j] = elements[i]->getVertex(j);
+  std::vector<MVertex *> nodes(verts);
+  // (sort by node tag, so that the order of the accumulation does not depend
+  // on the memory layout)
+  std::sort(nodes.begin(), nodes.end(), MVertexPtrLessThan());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  const std::size_t nbNodes = nodes.size();
+
+  const bool calcScale = ExtrudeParams::calcLayerScaleFactor[index];
+  const std::size_t nbElements = elements.size();
+
+  // compute the element contributions (normal, average edge length) and the
+  // node numbering in parallel
+  std::vector<double> elmNormals(3 * nbElements, 0.);
+  std::vector<double> elmScales(nbElements, 0.);
+  std::vector<std::size_t> elmNodes(verts.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
 #endif
-      ExtrudeParams::normals[index]->add(v->x(), v->y(), v->z(), 3, nn);
-    }
-  }
-  else { // get extrusion direction from Gouraud-shaded element normals
-    for(std::size_t i = 0; i < elements.size(); i++) {
-      MElement *ele = elements[i];
+  for(std::size_t i = 0; i < nbElements; i++) {
+    MElement *ele = elements[i];
+    for(std::size_t j = offsets[i]; j < offsets[i + 1]; j++)
+      elmNodes[j] = std::lower_bound(nodes.begin(), nodes.end(), verts[j],
+                                     MVertexPtrLessThan()) -
+                    nodes.begin();
+    if(!octree || gouraud) {
       SVector3 n(0, 0, 0);
       if(ele->getDim() == 2)
         n = ele->getFace(0).normal();
       else if(ele->getDim() == 1) // FIXME: generalize this!
         n = crossprod(ele->getEdge(0).tangent(), SVector3(0., 0., 1.));
       if(invert) n *= -1.;
-      double nn[3] = {n[0], n[1], n[2]};
-      if(!ExtrudeParams::calcLayerScaleFactor[index]) {
-        for(std::size_t k = 0; k < ele->getNumVertices(); k++) {
-          MVertex *v = ele->getVertex(k);
-          ExtrudeParams::normals[index]->add(v->x(), v->y(), v->z(), 3, nn);
-        }
+      for(int k = 0; k < 3; k++) elmNormals[3 * i + k] = n[k];
+    }
+    if(calcScale) {
+      std::vector<MVertex *> elem_verts(verts.begin() + offsets[i],
+                                        verts.begin() + offsets[i + 1]);
+      elmScales[i] = skipScaleCalc ? 1.0 : GetAveEdgeLength(elem_verts);
+    }
+  }
+
+  // accumulate the contributions on the nodes
+  std::vector<double> normals(3 * nbNodes, 0.), scales(nbNodes, 0.);
+  std::vector<int> numNormals(nbNodes, 0), numScales(nbNodes, 0);
+  for(std::size_t i = 0; i < nbElements; i++) {
+    for(std::size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+      std::size_t n = elmNodes[j];
+      if(!octree || gouraud) {
+        for(int k = 0; k < 3; k++) normals[3 * n + k] += elmNormals[3 * i + k];
+        numNormals[n]++;
       }
-      else {
-        std::vector<MVertex *> elem_verts;
-        double aveLength = 0.0;
-        elements[i]->getVertices(elem_verts);
-        if(skipScaleCalc)
-          aveLength = 1.0;
-        else
-          aveLength = GetAveEdgeLength(elem_verts);
-        for(std::size_t j = 0; j < elem_verts.size(); j++) {
-          ExtrudeParams::normals[index]->add(
-            elem_verts[j]->x(), elem_verts[j]->y(), elem_verts[j]->z(), 3, nn);
-          if(aveLength != 0.0)
-            ExtrudeParams::normals[index]->add_scale(
-              elem_verts[j]->x(), elem_verts[j]->y(), elem_verts[j]->z(),
-              aveLength);
-        }
+      // if scaleLastLayer selection, but not doing gouraud, then still scale
+      // the last layer...  This might create weird behavior for the
+      // unprepared...
+      if(calcScale && elmScales[i] != 0.0) {
+        scales[n] += elmScales[i];
+        numScales[n]++;
       }
     }
   }
+
+  if(octree && !gouraud) { // get extrusion direction from post-processing view
+    for(std::size_t n = 0; n < nbNodes; n++) {
+      MVertex *v = nodes[n];
+#if defined(HAVE_POST)
+      octree->searchVector(v->x(), v->y(), v->z(), &normals[3 * n], 0);
+#endif
+      numNormals[n] = 1;
+    }
+  }
+
+  for(std::size_t n = 0; n < nbNodes; n++) {
+    MVertex *v = nodes[n];
+    if(numScales[n])
+      ExtrudeParams::normals[index]->add_scale(
+        v->x(), v->y(), v->z(), scales[n] / numScales[n], numScales[n]);
+    if(numNormals[n]) {
+      double nn[3];
+      for(int k = 0; k < 3; k++) nn[k] = normals[3 * n + k] / numNormals[n];
+      ExtrudeParams::normals[index]->add(v->x(), v->y(), v->z(), 3, nn,
+                                         numNormals[n]);
+    }
+  }
 }
 
 typedef std::set<std::pair<bool, std::pair<int, int> > > infoset;
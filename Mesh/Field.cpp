@@ -16,6 +16,7 @@
 #include <string.h>
 #include <sstream>
 #include <algorithm>
+#include <iterator>
 #include "GmshConfig.h"
 #include "Context.h"
 #include "Field.h"
@@ -23,6 +24,8 @@
 #include "GModelIO_GEO.h"
 #include "GmshMessage.h"
 #include "Numeric.h"
+#include "OS.h"
+#include "Hash.h"
 #include "mathEvaluator.h"
 #include "BackgroundMeshTools.h"
 #include "STensor3.h"
@@ -42,7 +45,9 @@
 #include <io.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
+#include <sys/stat.h>
 
 #if defined(HAVE_ANN)
 #include "ANN/ANN.h"
@@ -2249,125 +2254,249 @@ public:
 #endif // ANN
 
 class OctreeField : public Field {
-  // octree field
-  class Cell {
-    void *_data;
-    bool _isleaf;
+  // octree field, stored as a flat array of cells (the 8 children of a cell
+  // are consecutive), so that it can be saved to disk and mapped back in memory
+  // without any conversion
+  struct Cell {
+    int64_t child; // index of the first child, or -1 for a leaf
+    double value;
+  };
+  std::vector<Cell> _cells;
+  // the cells in use: either &_cells[0], or the cells mapped from the cache
+  const Cell *_data;
+  void *_map;
+  std::size_t _mapSize;
+  int _inFieldId;
+  Field *_inField;
+  SBoundingBox3d bounds;
+  double _l0;
+  std::string _cacheFileName;
 
-  public:
-    double evaluate(double x, double y, double z) const
-    {
-      if(_isleaf) return *(double *)_data;
-      Cell *sub = (Cell *)_data;
-      int i = x > 0.5 ? 1 : 0;
-      int j = y > 0.5 ? 1 : 0;
-      int k = z > 0.5 ? 1 : 0;
-      return sub[i * 4 + j * 2 + k].evaluate(2 * x - i, 2 * y - j, 2 * z - k);
-    }
-    Cell(){};
-    void init(double x0, double y0, double z0, double l, Field &field,
-              int level)
-    {
-#if 0
-      double v[8] = {
-        field(x0,y0,z0),field(x0,y0,z0+l),field(x0,y0+l,z0),field(x0,y0+l,z0+l),
-        field(x0+l,y0,z0),field(x0+l,y0,z0+l),field(x0+l,y0+l,z0),field(x0+l,y0+l,z0+l)
-      };
-      double dmax = 0;
-      double vmin = v[0];
-      double vc = field(x0+l/2,y0+l/2,z0+l/2);
-      for (int i = 0; i < 8; ++i){
-        dmax = std::max(dmax, std::abs(vc-v[i]));
-        vmin = std::min(vmin, v[i]);
-      }
-#else
-      double dmax = 0;
-      double vc = field(x0 + l / 2, y0 + l / 2, z0 + l / 2);
-      double vmin = vc;
-      bool split = level > 0;
-      if(level > -4) {
+  void _init(std::size_t c, double x0, double y0, double z0, double l,
+             Field &field, int level)
+  {
+    double dmax = 0;
+    double vc = field(x0 + l / 2, y0 + l / 2, z0 + l / 2);
+    double vmin = vc;
+    bool split = level > 0;
+    if(level > -4) {
 #define NSAMPLE 2
-        double dl = l / NSAMPLE;
-        for(int i = 0; i <= NSAMPLE; ++i) {
-          for(int j = 0; j <= NSAMPLE; ++j) {
-            for(int k = 0; k <= NSAMPLE; ++k) {
-              double w = field(x0 + i * dl, y0 + j * dl, z0 + k * dl);
-              dmax = std::max(dmax, std::abs(vc - w));
-              vmin = std::min(vmin, w);
-              split |= (dmax / vmin > 0.2 && vmin < l);
-              if(split) break;
-            }
+      double dl = l / NSAMPLE;
+      for(int i = 0; i <= NSAMPLE; ++i) {
+        for(int j = 0; j <= NSAMPLE; ++j) {
+          for(int k = 0; k <= NSAMPLE; ++k) {
+            double w = field(x0 + i * dl, y0 + j * dl, z0 + k * dl);
+            dmax = std::max(dmax, std::abs(vc - w));
+            vmin = std::min(vmin, w);
+            split |= (dmax / vmin > 0.2 && vmin < l);
+            if(split) break;
           }
         }
-#endif
       }
-      if(split) {
-        _isleaf = false;
-        Cell *sub = new Cell[8];
-        double l2 = l / 2;
-        sub[0].init(x0, y0, z0, l2, field, level - 1);
-        sub[1].init(x0, y0, z0 + l2, l2, field, level - 1);
-        sub[2].init(x0, y0 + l2, z0, l2, field, level - 1);
-        sub[3].init(x0, y0 + l2, z0 + l2, l2, field, level - 1);
-        sub[4].init(x0 + l2, y0, z0, l2, field, level - 1);
-        sub[5].init(x0 + l2, y0, z0 + l2, l2, field, level - 1);
-        sub[6].init(x0 + l2, y0 + l2, z0, l2, field, level - 1);
-        sub[7].init(x0 + l2, y0 + l2, z0 + l2, l2, field, level - 1);
-        _data = (void *)sub;
-      }
-      else {
-        _isleaf = true;
-        _data = (void *)new double;
-        *(double *)_data = vc;
+    }
+    if(split) {
+      std::size_t sub = _cells.size();
+      _cells[c].child = sub;
+      _cells.resize(sub + 8);
+      double l2 = l / 2;
+      _init(sub + 0, x0, y0, z0, l2, field, level - 1);
+      _init(sub + 1, x0, y0, z0 + l2, l2, field, level - 1);
+      _init(sub + 2, x0, y0 + l2, z0, l2, field, level - 1);
+      _init(sub + 3, x0, y0 + l2, z0 + l2, l2, field, level - 1);
+      _init(sub + 4, x0 + l2, y0, z0, l2, field, level - 1);
+      _init(sub + 5, x0 + l2, y0, z0 + l2, l2, field, level - 1);
+      _init(sub + 6, x0 + l2, y0 + l2, z0, l2, field, level - 1);
+      _init(sub + 7, x0 + l2, y0 + l2, z0 + l2, l2, field, level - 1);
+    }
+    else {
+      _cells[c].child = -1;
+      _cells[c].value = vc;
+    }
+  }
+  void _clear()
+  {
+    _cells.clear();
+    _data = NULL;
+#if !defined(WIN32) || defined(__CYGWIN__)
+    if(_map) munmap(_map, _mapSize);
+#endif
+    _map = NULL;
+    _mapSize = 0;
+  }
+#if defined(HAVE_POST)
+  static std::size_t _hashBytes(std::size_t hash, const void *key, int len)
+  {
+    const unsigned char *p = static_cast<const unsigned char *>(key);
+    for(int n = len; n--;) hash = (hash ^ static_cast<size_t>(*p++)) * FNV_PRIME;
+    return hash;
+  }
+  // hash of the node coordinates and of the values of a view
+  static std::size_t _viewHash(PViewData *d)
+  {
+    std::size_t hash = FNV_OFFSET_BASIS;
+    for(int step = 0; step < d->getNumTimeSteps(); step++) {
+      for(int ent = 0; ent < d->getNumEntities(step); ent++) {
+        for(int ele = 0; ele < d->getNumElements(step, ent); ele++) {
+          for(int nod = 0; nod < d->getNumNodes(step, ent, ele); nod++) {
+            double xyz[3];
+            d->getNode(step, ent, ele, nod, xyz[0], xyz[1], xyz[2]);
+            hash = _hashBytes(hash, xyz, sizeof(xyz));
+          }
+          for(int idx = 0; idx < d->getNumValues(step, ent, ele); idx++) {
+            double val;
+            d->getValue(step, ent, ele, idx, val);
+            hash = _hashBytes(hash, &val, sizeof(double));
+          }
+        }
       }
     }
-    ~Cell()
-    {
-      if(_isleaf) {
-        delete(double *)_data;
+    return hash;
+  }
+#endif
+  // key identifying the compiled octree: hash of the definition of all the
+  // fields (including the content of the files they read) and of the bounding
+  // box of the model
+  std::string _cacheKey()
+  {
+    std::ostringstream sstream;
+    sstream.precision(16);
+    FieldManager *fields = GModel::current()->getFields();
+    for(FieldManager::iterator it = fields->begin(); it != fields->end();
+        ++it) {
+      sstream << it->first << " " << it->second->getName() << "\n";
+      for(std::map<std::string, FieldOption *>::iterator io =
+            it->second->options.begin();
+          io != it->second->options.end(); ++io) {
+        std::string v;
+        io->second->getTextRepresentation(v);
+        sstream << io->first << " " << v << "\n";
+        if(io->second->getType() == FIELD_OPTION_PATH) {
+          std::ifstream f(io->second->string().c_str(), std::ios::binary);
+          if(f.is_open()) {
+            std::string content((std::istreambuf_iterator<char>(f)),
+                                std::istreambuf_iterator<char>());
+            sstream << content << "\n";
+          }
+        }
       }
-      else {
-        Cell *sub = (Cell *)_data;
-        delete[] sub;
+#if defined(HAVE_POST)
+      // the views used by a field are identified by their content, not by
+      // their tag
+      PostViewField *pvf = dynamic_cast<PostViewField *>(it->second);
+      if(pvf) {
+        PView *v = pvf->getView();
+        if(v) sstream << "view " << _viewHash(v->getData()) << "\n";
       }
+#endif
     }
-    void print(double x0, double y0, double z0, double l, FILE *f)
-    {
-      if(_isleaf) {
-        fprintf(f, "SP(%g, %g, %g) {%g};\n", x0 + l / 2, y0 + l / 2, z0 + l / 2,
-                *(double *)_data);
-      }
-      else {
-        Cell *sub = (Cell *)_data;
-        double l2 = l / 2;
-        sub[0].print(x0, y0, z0, l2, f);
-        sub[1].print(x0, y0, z0 + l2, l2, f);
-        sub[2].print(x0, y0 + l2, z0, l2, f);
-        sub[3].print(x0, y0 + l2, z0 + l2, l2, f);
-        sub[4].print(x0 + l2, y0, z0, l2, f);
-        sub[5].print(x0 + l2, y0, z0 + l2, l2, f);
-        sub[6].print(x0 + l2, y0 + l2, z0, l2, f);
-        sub[7].print(x0 + l2, y0 + l2, z0 + l2, l2, f);
+    sstream << bounds.min().x() << " " << bounds.min().y() << " "
+            << bounds.min().z() << " " << bounds.max().x() << " "
+            << bounds.max().y() << " " << bounds.max().z() << "\n";
+    std::string str = sstream.str();
+    char key[64];
+    sprintf(key, "%016llx",
+            (unsigned long long)hash_FNV1a(str.c_str(), (int)str.size()));
+    return key;
+  }
+  // the cache file starts with a 64 byte text header, followed by the binary
+  // octree (the cells are thus 8-byte aligned in the file)
+  bool _readCache(const std::string &key)
+  {
+    FILE *fp = Fopen(_cacheFileName.c_str(), "rb");
+    if(!fp) return false;
+    char header[65];
+    int version = 0;
+    char fileKey[64] = "";
+    uint64_t numCells = 0;
+    bool ok = fread(header, 1, 64, fp) == 64;
+    if(ok) {
+      header[64] = '\0';
+      ok = sscanf(header, "$OctreeFieldCache %d %63s", &version, fileKey) ==
+             2 &&
+           version == 1 && key == fileKey && fread(&_l0, sizeof(double), 1, fp) &&
+           fread(&numCells, sizeof(uint64_t), 1, fp) && numCells;
+    }
+    std::size_t offset = 64 + sizeof(double) + sizeof(uint64_t);
+    if(ok) {
+      // the file must contain all the cells (accessing the memory mapped
+      // beyond the end of a truncated file would give a bus error)
+      struct stat st;
+      ok = !fstat(fileno(fp), &st) && (uint64_t)st.st_size >= offset &&
+           numCells <= ((uint64_t)st.st_size - offset) / sizeof(Cell);
+    }
+    if(ok) {
+#if !defined(WIN32) || defined(__CYGWIN__)
+      _mapSize = offset + numCells * sizeof(Cell);
+      _map = mmap(NULL, _mapSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+      if(_map == MAP_FAILED) {
+        _map = NULL;
+        ok = false;
       }
+      else
+        _data = (const Cell *)((const char *)_map + offset);
+#else
+      _cells.resize(numCells);
+      ok = fread(&_cells[0], sizeof(Cell), numCells, fp) == numCells;
+      _data = &_cells[0];
+#endif
     }
-  };
-  Cell *_root;
-  int _inFieldId;
-  Field *_inField;
-  SBoundingBox3d bounds;
-  double _l0;
+    fclose(fp);
+    // the children of a cell are stored after it
+    for(uint64_t i = 0; ok && i < numCells; i++) {
+      const int64_t child = _data[i].child;
+      if(child != -1 && (child <= (int64_t)i || (uint64_t)child + 8 > numCells))
+        ok = false;
+    }
+    if(!ok) {
+      Msg::Info("Field %d: ignoring invalid cache file '%s'", id,
+                _cacheFileName.c_str());
+      _clear();
+      return false;
+    }
+    Msg::Info("Field %d: using octree with %lu cells from cache '%s'", id,
+              (unsigned long)numCells, _cacheFileName.c_str());
+    return true;
+  }
+  void _writeCache(const std::string &key)
+  {
+    FILE *fp = Fopen(_cacheFileName.c_str(), "wb");
+    if(!fp) {
+      Msg::Error("Field %d: could not open cache file '%s'", id,
+                 _cacheFileName.c_str());
+      return;
+    }
+    char header[65];
+    snprintf(header, sizeof(header), "$OctreeFieldCache 1 %s", key.c_str());
+    std::size_t len = strlen(header);
+    memset(header + len, ' ', 64 - len);
+    header[63] = '\n';
+    uint64_t numCells = _cells.size();
+    fwrite(header, 1, 64, fp);
+    fwrite(&_l0, sizeof(double), 1, fp);
+    fwrite(&numCells, sizeof(uint64_t), 1, fp);
+    fwrite(&_cells[0], sizeof(Cell), numCells, fp);
+    fclose(fp);
+  }
 
 public:
   OctreeField()
   {
     options["InField"] = new FieldOptionInt
       (_inFieldId, "Id of the field to use as x coordinate.", &update_needed);
-    _root = NULL;
-  }
-  ~OctreeField()
-  {
-    if(_root) delete _root;
+    options["CacheFile"] = new FieldOptionPath(
+      _cacheFileName,
+      "Binary file used to cache the octree between runs: the cache is only "
+      "used if the definitions of the fields (and the content of the files "
+      "they read, or the data of the post-processing views they use) and the "
+      "bounding box of the model did not change",
+      &update_needed);
+    _data = NULL;
+    _map = NULL;
+    _mapSize = 0;
+    _inField = NULL;
+    _l0 = 0.;
   }
+  ~OctreeField() { _clear(); }
   const char *getName() { return "Octree"; }
   std::string getDescription()
   {
@@ -2377,32 +2506,47 @@ public:
   {
     if(update_needed) {
       update_needed = false;
-      if(_root) {
-        delete _root;
-        _root = NULL;
-      }
+      _clear();
     }
-    if(!_root) {
+    if(!_data) {
       _inField = _inFieldId >= 0 ?
         (GModel::current()->getFields()->get(_inFieldId)) :
         NULL;
       if(!_inField) return;
-      GModel::current()->getFields()->get(_inFieldId)->update();
       bounds = GModel::current()->bounds();
-      _root = new Cell;
+      std::string key;
+      if(!_cacheFileName.empty()) {
+        key = _cacheKey();
+        if(_readCache(key)) return;
+      }
+      GModel::current()->getFields()->get(_inFieldId)->update();
       SVector3 d = bounds.max() - bounds.min();
       _l0 = std::max(std::max(d.x(), d.y()), d.z());
-      _root->init(bounds.min().x(), bounds.min().y(), bounds.min().z(), _l0,
-                  *_inField, 4);
+      _cells.resize(1);
+      _init(0, bounds.min().x(), bounds.min().y(), bounds.min().z(), _l0,
+            *_inField, 4);
+      _data = &_cells[0];
+      if(!_cacheFileName.empty()) _writeCache(key);
     }
   }
   using Field::operator();
   virtual double operator()(double X, double Y, double Z, GEntity *ge = 0)
   {
     SPoint3 xmin = bounds.min();
-    SVector3 d = bounds.max() - xmin;
-    return _root->evaluate((X - xmin.x()) / _l0, (Y - xmin.y()) / _l0,
-                           (Z - xmin.z()) / _l0);
+    double x = (X - xmin.x()) / _l0;
+    double y = (Y - xmin.y()) / _l0;
+    double z = (Z - xmin.z()) / _l0;
+    const Cell *c = _data;
+    while(c->child >= 0) {
+      int i = x > 0.5 ? 1 : 0;
+      int j = y > 0.5 ? 1 : 0;
+      int k = z > 0.5 ? 1 : 0;
+      c = &_data[c->child + i * 4 + j * 2 + k];
+      x = 2 * x - i;
+      y = 2 * y - j;
+      z = 2 * z - k;
+    }
+    return c->value;
   }
 };
 
@@ -314,6 +314,7 @@ static bool TooManyElements(GModel *m, int dim)
 
 static void Mesh0D(GModel *m)
 {
+  MsgProfile profile("Mesh 0D");
   m->getFields()->initialize();
 
   for(GModel::viter it = m->firstVertex(); it != m->lastVertex(); ++it) {
@@ -338,6 +339,7 @@ static void Mesh0D(GModel *m)
 
 static void Mesh1D(GModel *m)
 {
+  MsgProfile profile("Mesh 1D");
   m->getFields()->initialize();
 
   if(TooManyElements(m, 1)) return;
@@ -469,6 +471,7 @@ static void PrintMesh2dStatistics(GModel *m)
 
 static void Mesh2D(GModel *m)
 {
+  MsgProfile profile("Mesh 2D");
   m->getFields()->initialize();
 
   if(TooManyElements(m, 2)) return;
@@ -484,6 +487,9 @@ static void Mesh2D(GModel *m)
   if(m->getFields()->getNumBoundaryLayerFields())
     Msg::SetNumThreads(1);
 
+#if defined(_OPENMP)
+  bool serialFaces = false;
+#endif
   for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it) {
     // STL remeshing is not yet thread-safe
     //    if((*it)->geomType() == GEntity::DiscreteSurface){
@@ -492,9 +498,14 @@ static void Mesh2D(GModel *m)
     //    }
     // Frontal-Delaunay for quads and co are not yet thread-safe
     if((*it)->getMeshingAlgo() == ALGO_2D_FRONTAL_QUAD ||
-       (*it)->getMeshingAlgo() == ALGO_2D_PACK_PRLGRMS ||
        (*it)->getMeshingAlgo() == ALGO_2D_PACK_PRLGRMS_CSTR)
       Msg::SetNumThreads(1);
+    // The background mesh of the packing of parallelograms is not built in a
+    // thread-safe way: surfaces are then meshed one at a time, and the threads
+    // are used by the packing within each surface
+#if defined(_OPENMP)
+    if((*it)->getMeshingAlgo() == ALGO_2D_PACK_PRLGRMS) serialFaces = true;
+#endif
     // Periodic meshing is not yet thread-safe
     if((*it)->getMeshMaster() != *it)
       Msg::SetNumThreads(1);
@@ -524,7 +535,7 @@ static void Mesh2D(GModel *m)
       std::vector<GFace *> temp;
       temp.insert(temp.begin(), f.begin(), f.end());
 #if defined(_OPENMP)
-#pragma omp parallel for schedule(dynamic)
+#pragma omp parallel for schedule(dynamic) if(!serialFaces)
 #endif
       for(size_t K = 0; K < temp.size(); K++) {
         if(temp[K]->meshStatistics.status == GFace::PENDING) {
@@ -813,6 +824,7 @@ static void TestConformity(GModel *gm)
 
 static void Mesh3D(GModel *m)
 {
+  MsgProfile profile("Mesh 3D");
   m->getFields()->initialize();
 
   if(TooManyElements(m, 3)) return;
@@ -979,6 +991,7 @@ static void Mesh3D(GModel *m)
 
 void OptimizeMesh(GModel *m, const std::string &how, bool force, int niter)
 {
+  MsgProfile profile(how.empty() ? "Optimization" : "Optimization " + how);
   if(how != "" && how != "Gmsh" && how != "Optimize" &&
      how != "Netgen" &&
      how != "HighOrder" &&
@@ -1088,13 +1101,39 @@ void RecombineMesh(GModel *m)
   Msg::StatusBar(true, "Recombining 2D mesh...");
   double t1 = Cpu();
 
-  for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it) {
-    GFace *gf = *it;
-    bool blossom = (CTX::instance()->mesh.algoRecombine == 1 ||
-                    CTX::instance()->mesh.algoRecombine == 3);
-    int topo = CTX::instance()->mesh.recombineOptimizeTopology;
-    recombineIntoQuads(gf, blossom, topo, true, .01);
+  int prevNumThreads = Msg::GetMaxThreads();
+  if(CTX::instance()->mesh.maxNumThreads2D > 0 &&
+     CTX::instance()->mesh.maxNumThreads2D <= Msg::GetMaxThreads())
+    Msg::SetNumThreads(CTX::instance()->mesh.maxNumThreads2D);
+
+  // surfaces are recombined independently (only their interior nodes are
+  // moved or removed)
+  std::vector<GFace *> faces(m->firstFace(), m->lastFace());
+  for(std::size_t i = 0; i < faces.size(); i++) {
+    // periodic meshes are not yet thread-safe
+    if(faces[i]->getMeshMaster() != faces[i]) Msg::SetNumThreads(1);
+  }
+
+  bool blossom = (CTX::instance()->mesh.algoRecombine == 1 ||
+                  CTX::instance()->mesh.algoRecombine == 3);
+  int topo = CTX::instance()->mesh.recombineOptimizeTopology;
+  // the topological optimization removes nodes: check once for the whole
+  // model, before any surface is modified, that no quad references nodes
+  // owned by another surface
+  if(topo > 0 && !isModelOkForTopologicalOpti(m)) {
+    Msg::Info("Skipping topological optimization - mesh topology is not "
+              "complete");
+    topo = 0;
   }
+  // the Blossom perfect matching code uses static global state: surfaces are
+  // then recombined serially
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(!blossom)
+#endif
+  for(int i = 0; i < (int)faces.size(); i++)
+    recombineIntoQuads(faces[i], blossom, topo, true, .01, false);
+
+  Msg::SetNumThreads(prevNumThreads);
 
   double t2 = Cpu();
   Msg::StatusBar(true, "Done recombining 2D mesh (%g s)", t2 - t1);
@@ -1110,6 +1149,7 @@ void GenerateMesh(GModel *m, int ask)
     return;
   }
   CTX::instance()->lock = 1;
+  MsgProfile profile("Mesh generation");
 
   Msg::ResetErrorCounter();
 
@@ -1254,14 +1254,15 @@ void FixPeriodicMesh(GModel *m)
     GEdge *src = dynamic_cast<GEdge *>(tgt->getMeshMaster());
 
     if(src != NULL && src != tgt) {
-      std::map<MVertex *, MVertex *> &v2v = tgt->correspondingVertices;
-      std::map<MVertex *, MVertex *> &p2p = tgt->correspondingHOPoints;
+      MVertexPairs &v2v = tgt->correspondingVertices;
+      MVertexPairs &p2p = tgt->correspondingHOPoints;
       p2p.clear();
 
       Msg::Info("Reconstructing periodicity for curve connection %d - %d",
                 tgt->tag(), src->tag());
 
-      std::map<MEdge, MLine *, MEdgeLessThan> srcEdges;
+      std::unordered_map<MEdge, MLine *, MEdgeHash, MEdgeEqual> srcEdges;
+      srcEdges.reserve(src->getNumMeshElements());
       for(std::size_t i = 0; i < src->getNumMeshElements(); i++) {
         MLine *srcLine = dynamic_cast<MLine *>(src->getMeshElement(i));
         if(!srcLine) {
@@ -1282,7 +1283,7 @@ void FixPeriodicMesh(GModel *m)
         }
         for(int iVtx = 0; iVtx < 2; iVtx++) {
           MVertex *vtx = tgtLine->getVertex(iVtx);
-          std::map<MVertex *, MVertex *>::iterator tIter = v2v.find(vtx);
+          MVertexPairs::iterator tIter = v2v.find(vtx);
           if(tIter == v2v.end()) {
             Msg::Error("Cannot find periodic counterpart of node %d"
                        " of curve %d on curve %d", vtx->getNum(), tgt->tag(),
@@ -1293,8 +1294,8 @@ void FixPeriodicMesh(GModel *m)
             vtcs[iVtx] = tIter->second;
         }
 
-        std::map<MEdge, MLine *, MEdgeLessThan>::iterator srcIter =
-          srcEdges.find(MEdge(vtcs[0], vtcs[1]));
+        std::unordered_map<MEdge, MLine *, MEdgeHash, MEdgeEqual>::iterator
+          srcIter = srcEdges.find(MEdge(vtcs[0], vtcs[1]));
         if(srcIter == srcEdges.end()) {
           Msg::Error("Can't find periodic counterpart of mesh edge %d-%d "
                      "on curve %d, connected to mesh edge %d-%d on curve %d",
@@ -1334,8 +1335,8 @@ void FixPeriodicMesh(GModel *m)
       Msg::Info("Reconstructing periodicity for surface connection %d - %d",
                 tgt->tag(), src->tag());
 
-      std::map<MVertex *, MVertex *> &v2v = tgt->correspondingVertices;
-      std::map<MVertex *, MVertex *> &p2p = tgt->correspondingHOPoints;
+      MVertexPairs &v2v = tgt->correspondingVertices;
+      MVertexPairs &p2p = tgt->correspondingHOPoints;
       p2p.clear();
 
       if(tgt->getNumMeshElements() && v2v.empty()){
@@ -1345,7 +1346,8 @@ void FixPeriodicMesh(GModel *m)
         continue;
       }
 
-      std::map<MFace, MElement *, MFaceLessThan> srcFaces;
+      std::unordered_map<MFace, MElement *, MFaceHash, MFaceEqual> srcFaces;
+      srcFaces.reserve(src->getNumMeshElements());
 
       for(std::size_t i = 0; i < src->getNumMeshElements(); ++i) {
         MElement *srcElmt = src->getMeshElement(i);
@@ -1369,7 +1371,7 @@ void FixPeriodicMesh(GModel *m)
         for(int iVtx = 0; iVtx < nbVtcs; iVtx++) {
           MVertex *vtx = tgtElmt->getVertex(iVtx);
 
-          std::map<MVertex *, MVertex *>::iterator tIter = v2v.find(vtx);
+          MVertexPairs::iterator tIter = v2v.find(vtx);
           if(tIter == v2v.end()) {
             Msg::Error("Cannot find periodic counterpart of node %d "
                        "of surface %d on surface %d",
@@ -1381,8 +1383,8 @@ void FixPeriodicMesh(GModel *m)
         }
 
         MFace tgtFace(vtcs);
-        std::map<MFace, MElement *, MFaceLessThan>::iterator srcIter =
-          srcFaces.find(tgtFace);
+        std::unordered_map<MFace, MElement *, MFaceHash, MFaceEqual>::iterator
+          srcIter = srcFaces.find(tgtFace);
         if(srcIter == srcFaces.end()) {
           std::ostringstream faceDef;
           for(int iVtx = 0; iVtx < nbVtcs; iVtx++)
@@ -1567,6 +1569,8 @@ void getMeshInfoForHighOrder(GModel *gm, int &meshOrder, bool &complete,
 void SetOrderN(GModel *m, int order, bool linear, bool incomplete,
                bool onlyVisible)
 {
+  MsgProfile profile("High order");
+
   // replace all the elements in the mesh with second order elements
   // by creating unique vertices on the edges/faces of the mesh:
   //
@@ -1,7 +1,11 @@
+#include <stdio.h>
+#include <math.h>
 #include "automaticMeshSizeField.h"
 #include "GModel.h"
 #include "GRegion.h"
 #include "MVertex.h"
+#include "GmshMessage.h"
+#include "OS.h"
 
 #ifdef HAVE_HXT
 extern "C" {
@@ -11,18 +15,152 @@ extern "C" {
 }
 #endif
 
-double automaticMeshSizeField:: operator()(double X, double Y, double Z, GEntity *ge)
+// finest level of the linear octree (3 * 19 bits fit in the Morton keys)
+static const int MAX_OCTREE_LEVEL = 19;
+
+static uint64_t spreadBits(uint64_t v)
 {
-  double val = 1.e22;
-#if defined(HAVE_HXT) && defined(HAVE_P4EST)
-  HXTStatus s = hxtOctreeSearchOne(forest, X, Y, Z, &val);
-  if (s == HXT_STATUS_OK){
-    return val;
+  v &= 0x1fffff;
+  v = (v | v << 32) & 0x1f00000000ffffULL;
+  v = (v | v << 16) & 0x1f0000ff0000ffULL;
+  v = (v | v << 8) & 0x100f00f00f00f00fULL;
+  v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+  v = (v | v << 2) & 0x1249249249249249ULL;
+  return v;
+}
+
+static uint64_t mortonKey(uint64_t i, uint64_t j, uint64_t k)
+{
+  return spreadBits(i) | (spreadBits(j) << 1) | (spreadBits(k) << 2);
+}
+
+void automaticMeshSizeField::_buildLinearOctree(
+  const std::vector<double> &leaves)
+{
+  std::size_t n = leaves.size() / 5;
+  _leafKeys.clear();
+  _leafSizes.clear();
+  if(!n) return;
+
+  double max[3];
+  for(int k = 0; k < 3; k++) _octreeMin[k] = max[k] = leaves[k];
+  for(std::size_t i = 0; i < n; i++) {
+    for(int k = 0; k < 3; k++) {
+      _octreeMin[k] = std::min(_octreeMin[k], leaves[5 * i + k]);
+      max[k] = std::max(max[k], leaves[5 * i + k] + leaves[5 * i + 3]);
+    }
   }
-  else Msg::Error ("Cannot find point %g %g %g in the octree",X,Y,Z);
-#else
-  Msg::Error ("Gmsh has to be compiled with HXT and P4EST for using automaticMeshSizeField");
+  _octreeLength =
+    std::max(max[0] - _octreeMin[0],
+             std::max(max[1] - _octreeMin[1], max[2] - _octreeMin[2]));
+
+  const double scale = (double)(1 << MAX_OCTREE_LEVEL) / _octreeLength;
+  std::vector<std::pair<uint64_t, double> > sorted(n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(std::size_t i = 0; i < n; i++) {
+    uint64_t c[3];
+    for(int k = 0; k < 3; k++)
+      c[k] = (uint64_t)((leaves[5 * i + k] - _octreeMin[k]) * scale + 0.5);
+    sorted[i] = std::make_pair(mortonKey(c[0], c[1], c[2]), leaves[5 * i + 4]);
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  _leafKeys.resize(n);
+  _leafSizes.resize(n);
+  for(std::size_t i = 0; i < n; i++) {
+    _leafKeys[i] = sorted[i].first;
+    _leafSizes[i] = sorted[i].second;
+  }
+}
+
+bool automaticMeshSizeField::_readOctree(const std::string &fileName)
+{
+  FILE *fp = Fopen(fileName.c_str(), "rb");
+  if(!fp) return false;
+  char header[64];
+  int version = 0;
+  uint64_t n = 0;
+  bool ok = fgets(header, sizeof(header), fp) &&
+            sscanf(header, "$AutomaticMeshSizeFieldOctree %d", &version) == 1 &&
+            version == 1 && fread(_octreeMin, sizeof(double), 3, fp) == 3 &&
+            fread(&_octreeLength, sizeof(double), 1, fp) == 1 &&
+            fread(&n, sizeof(uint64_t), 1, fp) == 1;
+  if(ok) {
+    _leafKeys.resize(n);
+    _leafSizes.resize(n);
+    ok = fread(&_leafKeys[0], sizeof(uint64_t), n, fp) == n &&
+         fread(&_leafSizes[0], sizeof(double), n, fp) == n;
+  }
+  fclose(fp);
+  if(!ok) {
+    Msg::Error("Could not read octree from file '%s'", fileName.c_str());
+    _leafKeys.clear();
+    _leafSizes.clear();
+    return false;
+  }
+  Msg::Info("Read octree with %lu leaves from file '%s'", (unsigned long)n,
+            fileName.c_str());
+  return true;
+}
+
+bool automaticMeshSizeField::_writeOctree(const std::string &fileName) const
+{
+  FILE *fp = Fopen(fileName.c_str(), "wb");
+  if(!fp) {
+    Msg::Error("Could not open file '%s'", fileName.c_str());
+    return false;
+  }
+  uint64_t n = _leafKeys.size();
+  fprintf(fp, "$AutomaticMeshSizeFieldOctree 1\n");
+  fwrite(_octreeMin, sizeof(double), 3, fp);
+  fwrite(&_octreeLength, sizeof(double), 1, fp);
+  fwrite(&n, sizeof(uint64_t), 1, fp);
+  if(n) {
+    fwrite(&_leafKeys[0], sizeof(uint64_t), n, fp);
+    fwrite(&_leafSizes[0], sizeof(double), n, fp);
+  }
+  fclose(fp);
+  Msg::Info("Wrote octree with %lu leaves in file '%s'", (unsigned long)n,
+            fileName.c_str());
+  return true;
+}
+
+void automaticMeshSizeField::operator()(std::size_t n, const double *xyz,
+                                        double *val)
+{
+  if(_leafKeys.empty()) {
+    for(std::size_t i = 0; i < n; i++) val[i] = 1.e22;
+    Msg::Error("Empty octree in automaticMeshSizeField");
+    return;
+  }
+  const int64_t nmax = (1 << MAX_OCTREE_LEVEL) - 1;
+  const double scale = (double)(1 << MAX_OCTREE_LEVEL) / _octreeLength;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
 #endif
+  for(std::size_t i = 0; i < n; i++) {
+    // points outside the bounding cube get the size of the closest leaf
+    uint64_t c[3];
+    for(int k = 0; k < 3; k++) {
+      int64_t ck = (int64_t)floor((xyz[3 * i + k] - _octreeMin[k]) * scale);
+      c[k] = (uint64_t)std::max((int64_t)0, std::min(ck, nmax));
+    }
+    // the leaves tile the cube in Morton order: the leaf containing the point
+    // is the last one starting before the point
+    std::vector<uint64_t>::const_iterator it = std::upper_bound(
+      _leafKeys.begin(), _leafKeys.end(), mortonKey(c[0], c[1], c[2]));
+    if(it != _leafKeys.begin()) it--;
+    val[i] = _leafSizes[it - _leafKeys.begin()];
+  }
+}
+
+double automaticMeshSizeField::operator()(double X, double Y, double Z,
+                                          GEntity *ge)
+{
+  double xyz[3] = {X, Y, Z}, val;
+  (*this)(1, xyz, &val);
   return val;
 }
 
@@ -45,24 +183,21 @@ HXTStatus automaticMeshSizeField:: updateHXT(){
 
   //  printf("%d points per circle\n",_nPointsPerCircle);
 
-  if (!update_needed)return HXT_STATUS_OK;
-
   if (forest)hxtForestDelete(&forest);
   if (forestOptions)hxtForestOptionsDelete(&forestOptions);
 
-  update_needed = false;
   // --------------------------------------------------------
   // Soit on charge un fichier avec l'octree (ma préférence)
   // Soit on calcule "en live" l'octree ici
 
-
-  // verify that only one region exists in the model
-  if (GModel::current()->getNumRegions() != 1){
-    Msg::Error ("automaticMeshSizeField can only work for now on models with one region");
+  // merge the surface meshes of all the regions (shared surfaces are only
+  // taken once)
+  std::vector<GRegion*> regions(GModel::current()->firstRegion(),
+                                GModel::current()->lastRegion());
+  if (regions.empty()){
+    Msg::Error ("automaticMeshSizeField requires a model with at least one region");
     return HXT_STATUS_ERROR;
   }
-  std::vector<GRegion*> regions;
-  regions.push_back(*(GModel::current()->firstRegion()));
 
   // create HXT mesh structure
   HXTMesh *mesh;
@@ -80,11 +215,16 @@ HXTStatus automaticMeshSizeField:: updateHXT(){
   HXT_CHECK(hxtEdgesCreate(mesh,&edges));
   HXT_CHECK(hxtCurvatureRusinkiewicz(mesh,&nodalCurvature,&curvatureCrossfield,edges,1));
 
-  // compute rtree
+  // compute rtree (the bounding boxes of the triangles are computed in
+  // parallel, the insertion in the tree is sequential)
   RTree<int , double,3> triRTree;
-  HXTBbox          bbox_triangle;
-
-  for(uint64_t i = 0; i < mesh->triangles.num; ++i){
+  const int64_t ntri = (int64_t)mesh->triangles.num;
+  std::vector<double> triBbox(6 * ntri);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int64_t i = 0; i < ntri; ++i){
+    HXTBbox bbox_triangle;
     hxtBboxInit(&bbox_triangle);
     // Noeuds
     for(int j = 0; j < 3; ++j){
@@ -94,8 +234,14 @@ HXTStatus automaticMeshSizeField:: updateHXT(){
       for(int k = 0; k < 3; ++k){ coord[k] = mesh->vertices.coord[(size_t) 4*node+k]; }
       hxtBboxAddOne(&bbox_triangle, coord);
     }
+    for(int k = 0; k < 3; ++k){
+      triBbox[6 * i + k] = bbox_triangle.min[k];
+      triBbox[6 * i + 3 + k] = bbox_triangle.max[k];
+    }
+  }
+  for(int64_t i = 0; i < ntri; ++i){
     int K = (int)i;
-    triRTree.Insert(bbox_triangle.min,bbox_triangle.max,K);
+    triRTree.Insert(&triBbox[6 * i], &triBbox[6 * i + 3], K);
   }
 
   // compute bbox of the mesh
@@ -120,14 +266,11 @@ HXTStatus automaticMeshSizeField:: updateHXT(){
 
   // --------------------------------------------------------
   HXT_CHECK(hxtForestCreate(0, NULL, &forest, NULL, forestOptions));
-  //  return HXT_STATUS_OK;
-  // ---------------------------------------------------------
-  // aller --> niveau 3 par exemple, serait une option ...
-  HXT_CHECK(hxtOctreeRefineToLevel(forest, 3/*_nRefine*/));
+  HXT_CHECK(hxtOctreeRefineToLevel(forest, _initialLevel));
   // idéalement --> convergence
   int ITER = 0;
   if (forestOptions->nodePerTwoPi > 0){
-    HXT_CHECK(hxtOctreeCurvatureRefine(forest, 3/*_nRefine*/));
+    HXT_CHECK(hxtOctreeCurvatureRefine(forest, _initialLevel));
     // ensuite lissage du gradient
     while (ITER++ < 4*_nRefine) {
       HXT_CHECK(hxtOctreeComputeLaplacian(forest));
@@ -135,7 +278,6 @@ HXTStatus automaticMeshSizeField:: updateHXT(){
     }
   }
   forestOptions->nodePerGap = _nPointsPerGap;
-  printf("coucou\n");
   HXT_CHECK(hxtOctreeSurfacesProches(forest));
   ITER = 0;
   //  while (ITER++ < 4*_nRefine) {
@@ -143,19 +285,38 @@ HXTStatus automaticMeshSizeField:: updateHXT(){
   //    HXT_CHECK(hxtOctreeSetMaxGradient(forest));
   //  }
 
+  std::vector<double> leaves;
+  HXT_CHECK(hxtOctreeGetLeaves(forest, &leaves));
+  _buildLinearOctree(leaves);
+
+  // the forest options point to local data
+  forestOptions->bbox = NULL;
+  forestOptions->nodalCurvature = NULL;
+  forestOptions->triRTree = NULL;
+  forestOptions->mesh = NULL;
+
   HXT_CHECK(hxtEdgesDelete(&edges)       );
   HXT_CHECK(hxtFree(&curvatureCrossfield));
   HXT_CHECK(hxtFree(&nodalCurvature)              );
   HXT_CHECK(hxtMeshDelete(&mesh)                  );
   HXT_CHECK(hxtContextDelete(&context)            );
+  return HXT_STATUS_OK;
 }
 
 #endif
 
 void automaticMeshSizeField:: update(){
+  if (!update_needed) return;
+  update_needed = false;
+
+  if (!_octreeFileName.empty() && StatFile(_octreeFileName) == 0 &&
+      _readOctree(_octreeFileName))
+    return;
+
 #if defined(HAVE_HXT) && defined(HAVE_P4EST)
   HXTStatus s = updateHXT();
   if (s != HXT_STATUS_OK)Msg::Error ("Something went wrong when computing the octree");
+  else if (!_octreeFileName.empty()) _writeOctree(_octreeFileName);
 #else
   Msg::Error ("Gmsh has to be compiled with HXT and P4EST for using automaticMeshSizeField");
 #endif
@@ -7,6 +7,7 @@
 #include "hxt_octree.h"
 #endif
 
+#include <stdint.h>
 #include "Field.h"
 
 class automaticMeshSizeField : public Field {
@@ -23,6 +24,19 @@ class automaticMeshSizeField : public Field {
   double _hbulk;
   double _gradientMax;
   int _nRefine;
+  int _initialLevel;
+  std::string _octreeFileName;
+
+  // linear octree extracted from the forest: the leaves are stored with their
+  // Morton key (computed on the finest level of the bounding cube), sorted, so
+  // that queries are simple (thread-safe) binary searches that do not depend
+  // on p4est, and the octree can be saved and reloaded
+  double _octreeMin[3], _octreeLength;
+  std::vector<uint64_t> _leafKeys;
+  std::vector<double> _leafSizes;
+  void _buildLinearOctree(const std::vector<double> &leaves);
+  bool _readOctree(const std::string &fileName);
+  bool _writeOctree(const std::string &fileName) const;
 
  public:
   ~automaticMeshSizeField();
@@ -38,6 +52,8 @@ class automaticMeshSizeField : public Field {
     _hbulk = 0.1; // update needed
     _gradientMax =1.4;
     _nRefine = 5;
+    _initialLevel = 3;
+    _octreeLength = 0.;
 
     options["nPointsPerCircle"] = new FieldOptionInt(_nPointsPerCircle,
 						     "Number of points per circle (adapt to curvature of surfaces)",&update_needed);
@@ -53,6 +69,12 @@ class automaticMeshSizeField : public Field {
 
     options["NRefine"] = new FieldOptionInt(_nRefine,
 					    "Initial refinement level for the octree",&update_needed);
+
+    options["InitialLevel"] = new FieldOptionInt(_initialLevel,
+						 "Uniform refinement level of the octree before curvature refinement",&update_needed);
+
+    options["OctreeFile"] = new FieldOptionPath(_octreeFileName,
+						"File used to store the octree: if the file exists, the octree is read from it; otherwise the computed octree is saved in it",&update_needed);
   }
   const char *getName() { return "AutomaticMeshSizeField"; }
 
@@ -63,7 +85,11 @@ class automaticMeshSizeField : public Field {
   }
 
   void update();
+  using Field::operator();
   virtual double operator()(double X, double Y, double Z, GEntity *ge = 0);
+  // evaluate the field at n points (xyz contains 3 * n coordinates); this is
+  // thread-safe and can be called concurrently once the field is updated
+  void operator()(std::size_t n, const double *xyz, double *val);
 };
 
 #endif
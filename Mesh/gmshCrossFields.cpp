@@ -1008,7 +1008,7 @@ static void computePotential(
   linearSystemGmm<double> *_lsys = new linearSystemGmm<double>;
   ///  _lsys->setPrec(2.e-7);
 #else
-  linearSystemFull<double> *_lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *_lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   dofManager<double> myAssembler(_lsys);
@@ -1775,7 +1775,7 @@ static dofManager<double> *computeH(GModel *gm, std::vector<GFace *> &f,
   // MUMPS !!!
   linearSystemGmm<double> *_lsys = new linearSystemGmm<double>;
 #else
-  linearSystemFull<double> *_lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *_lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   dofManager<double> *myAssembler = new dofManager<double>(_lsys);
@@ -2767,7 +2767,7 @@ public:
 #elif defined(HAVE_GMM)
     linearSystemGmm<double> *_lsys = new linearSystemGmm<double>;
 #else
-    linearSystemFull<double> *_lsys = new linearSystemFull<double>;
+    linearSystemCSRBuiltin<double> *_lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
     dofManager<double> *dof = new dofManager<double>(_lsys);
@@ -2914,7 +2914,7 @@ public:
 #elif defined(HAVE_GMM)
     linearSystemGmm<double> *_lsys = new linearSystemGmm<double>;
 #else
-    linearSystemFull<double> *_lsys = new linearSystemFull<double>;
+    linearSystemCSRBuiltin<double> *_lsys = new linearSystemCSRBuiltin<double>;
 #endif
     dofManager<double> *theta = new dofManager<double>(_lsys);
 
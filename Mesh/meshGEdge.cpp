@@ -3,6 +3,7 @@
 // See the LICENSE.txt file for license information. Please report all
 // issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include "GmshConfig.h"
 #include "GModel.h"
 #include "discreteEdge.h"
@@ -85,9 +86,13 @@ struct F_LcB {
   }
 };
 
+// The integrands below compute the value of the function (lc) and the norm of
+// the tangent vector (xp) at the parameter P.t
+
 struct F_Lc {
-  double operator()(GEdge *ge, double t)
+  void operator()(GEdge *ge, IntPoint &P)
   {
+    double t = P.t;
     GPoint p = ge->point(t);
     Range<double> bounds = ge->parBounds(0);
     double t_begin = bounds.low();
@@ -100,13 +105,15 @@ struct F_Lc {
     else
       lc_here = BGM_MeshSize(ge, t, 0, p.x(), p.y(), p.z());
     SVector3 der = ge->firstDer(t);
-    return norm(der) / lc_here;
+    P.xp = norm(der);
+    P.lc = P.xp / lc_here;
   }
 };
 
 struct F_Lc_aniso {
-  double operator()(GEdge *ge, double t)
+  void operator()(GEdge *ge, IntPoint &P)
   {
+    double t = P.t;
     GPoint p = ge->point(t);
     SMetric3 lc_here;
 
@@ -133,21 +140,27 @@ struct F_Lc_aniso {
     }
 
     SVector3 der = ge->firstDer(t);
-    return std::sqrt(dot(der, lc_here, der));
+    P.xp = norm(der);
+    P.lc = std::sqrt(dot(der, lc_here, der));
   }
 };
 
 struct F_Transfinite {
-  double operator()(GEdge *ge, double t_)
+  void operator()(GEdge *ge, IntPoint &P)
   {
+    P.lc = value(ge, P.t, P.xp);
+  }
+  double value(GEdge *ge, double t_, double &d)
+  {
+    SVector3 der = ge->firstDer(t_);
+    d = norm(der);
+
     double length = ge->length();
     if(length == 0.0) {
       Msg::Error("Zero-length curve %d in transfinite mesh", ge->tag());
       return 1.;
     }
 
-    SVector3 der = ge->firstDer(t_);
-    double d = norm(der);
     double coef = ge->meshAttributes.coeffTransfinite;
     int type = ge->meshAttributes.typeTransfinite;
     int nbpt = ge->meshAttributes.nbPointsTransfinite;
@@ -206,10 +219,10 @@ struct F_Transfinite {
 };
 
 struct F_One {
-  double operator()(GEdge *ge, double t)
+  void operator()(GEdge *ge, IntPoint &P)
   {
-    SVector3 der = ge->firstDer(t);
-    return norm(der);
+    SVector3 der = ge->firstDer(P.t);
+    P.xp = P.lc = norm(der);
   }
 };
 
@@ -228,7 +241,7 @@ static void RecursiveIntegration(GEdge *ge, IntPoint *from, IntPoint *to,
   (*depth)++;
 
   P.t = 0.5 * (from->t + to->t);
-  P.lc = f(ge, P.t);
+  f(ge, P);
 
   double const val1 = trapezoidal(from, to);
   double const val2 = trapezoidal(from, &P);
@@ -261,12 +274,12 @@ static double Integration(GEdge *ge, double t1, double t2, function f,
   int depth = 0;
 
   from.t = t1;
-  from.lc = f(ge, from.t);
+  f(ge, from);
   from.p = 0.0;
   Points.push_back(from);
 
   to.t = t2;
-  to.lc = f(ge, to.t);
+  f(ge, to);
 
   RecursiveIntegration(ge, &from, &to, f, Points, Prec, &depth);
 
@@ -529,6 +542,8 @@ static void addBoundaryLayerPoints(GEdge *ge, double &t_begin, double &t_end,
 
 void meshGEdge::operator()(GEdge *ge)
 {
+  MsgProfile profile("Curve", ge->tag());
+
   // debug stuff
   if(CTX::instance()->debugSurface > 0){
     std::vector<GFace *> f = ge->faces();
@@ -632,12 +647,8 @@ void meshGEdge::operator()(GEdge *ge)
                       CTX::instance()->mesh.lcIntegrationPrecision);
     }
 
-    // we should maybe provide an option to disable the smoothing
-    for(std::size_t i = 0; i < Points.size(); i++) {
-      IntPoint &pt = Points[i];
-      SVector3 der = ge->firstDer(pt.t);
-      pt.xp = der.norm();
-    }
+    // we should maybe provide an option to disable the smoothing (the norm
+    // of the tangent vector xp has been computed during the integration)
     if(CTX::instance()->mesh.algo2d != ALGO_2D_BAMG)
       a = smoothPrimitive(ge, std::sqrt(CTX::instance()->mesh.smoothRatio),
 			  Points);
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <stdlib.h>
 #include <map>
+#include <unordered_map>
 #include "GmshMessage.h"
 #include "GModel.h"
 #include "GFace.h"
@@ -321,7 +322,7 @@ public:
 
 static void copyMesh(GFace *source, GFace *target)
 {
-  std::map<MVertex *, MVertex *> vs2vt;
+  std::unordered_map<MVertex *, MVertex *> vs2vt;
 
   // add principal GVertex pairs
 
@@ -434,23 +435,33 @@ static void copyMesh(GFace *source, GFace *target)
     }
   }
 
-  // transform interior nodes
+  // transform interior nodes: the projections on the target surface are
+  // computed first, then the nodes are created in one pass (this is serial:
+  // faces with a mesh master are meshed on a single thread, and parFromPoint()
+  // is not thread-safe for all geometry kernels)
   std::vector<double> &tfo = target->affineTransform;
 
-  for(std::size_t i = 0; i < source->mesh_vertices.size(); i++) {
+  const int numInterior = (int)source->mesh_vertices.size();
+  std::vector<GPoint> gps(numInterior);
+  for(int i = 0; i < numInterior; i++) {
     MVertex *vs = source->mesh_vertices[i];
-    SPoint2 XXX;
 
     double ps[4] = {vs->x(), vs->y(), vs->z(), 1.};
     double res[4] = {0., 0., 0., 0.};
     int idx = 0;
-    for(int i = 0; i < 4; i++)
-      for(int j = 0; j < 4; j++) res[i] += tfo[idx++] * ps[j];
+    for(int j = 0; j < 4; j++)
+      for(int k = 0; k < 4; k++) res[j] += tfo[idx++] * ps[k];
 
     SPoint3 tp(res[0], res[1], res[2]);
-    XXX = target->parFromPoint(tp);
+    gps[i] = target->point(target->parFromPoint(tp));
+  }
 
-    GPoint gp = target->point(XXX);
+  target->mesh_vertices.reserve(target->mesh_vertices.size() + numInterior);
+  target->correspondingVertices.reserve(
+    target->correspondingVertices.size() + numInterior);
+  for(int i = 0; i < numInterior; i++) {
+    MVertex *vs = source->mesh_vertices[i];
+    const GPoint &gp = gps[i];
     MVertex *vt =
       new MFaceVertex(gp.x(), gp.y(), gp.z(), target, gp.u(), gp.v());
     target->mesh_vertices.push_back(vt);
@@ -2900,6 +2911,7 @@ int debugSurface = -1; //-100;
 
 void meshGFace::operator()(GFace *gf, bool print)
 {
+  MsgProfile profile("Surface", gf->tag());
   gf->model()->setCurrentMeshEntity(gf);
 
   if(gf->meshAttributes.method == MESH_NONE) return;
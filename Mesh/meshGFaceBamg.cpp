@@ -14,6 +14,7 @@
 #include "GmshConfig.h"
 #include "Context.h"
 #include <map>
+#include <unordered_map>
 #include "BackgroundMeshTools.h"
 #include "meshGFaceDelaunayInsertion.h"
 #include "Options.h"
@@ -39,89 +40,83 @@ static void computeMeshMetricsForBamg(GFace *gf, int numV,
   //    backgroundMesh::current()->print(name, 0);
   //  }
 
-  fullMatrix<double> J(2, 3), JT(3, 2), M(3, 3), R(2, 2), W(2, 3);
-  for(int i = 0; i < numV; ++i) {
-    double u = bamgVertices[i][0];
-    double v = bamgVertices[i][1];
-    GPoint gp = gf->point(SPoint2(u, v));
-    SMetric3 m = BGM_MeshMetric(gf, u, v, gp.x(), gp.y(), gp.z());
-
-    // compute the derivatives of the parametrization
-    Pair<SVector3, SVector3> der = gf->firstDer(SPoint2(u, v));
-
-    J(0, 0) = JT(0, 0) = der.first().x();
-    J(0, 1) = JT(1, 0) = der.first().y();
-    J(0, 2) = JT(2, 0) = der.first().z();
-    J(1, 0) = JT(0, 1) = der.second().x();
-    J(1, 1) = JT(1, 1) = der.second().y();
-    J(1, 2) = JT(2, 1) = der.second().z();
-
-    m.getMat(M);
-    J.mult(M, W);
-    W.mult(JT, R);
-    bamg::Metric M1(R(0, 0), R(1, 0), R(1, 1));
-    mm11[i] = M1.a11;
-    mm12[i] = M1.a21;
-    mm22[i] = M1.a22;
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+  {
+    fullMatrix<double> J(2, 3), JT(3, 2), M(3, 3), R(2, 2), W(2, 3);
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 64)
+#endif
+    for(int i = 0; i < numV; ++i) {
+      double u = bamgVertices[i][0];
+      double v = bamgVertices[i][1];
+      GPoint gp = gf->point(SPoint2(u, v));
+      SMetric3 m = BGM_MeshMetric(gf, u, v, gp.x(), gp.y(), gp.z());
+
+      // compute the derivatives of the parametrization
+      Pair<SVector3, SVector3> der = gf->firstDer(SPoint2(u, v));
+
+      J(0, 0) = JT(0, 0) = der.first().x();
+      J(0, 1) = JT(1, 0) = der.first().y();
+      J(0, 2) = JT(2, 0) = der.first().z();
+      J(1, 0) = JT(0, 1) = der.second().x();
+      J(1, 1) = JT(1, 1) = der.second().y();
+      J(1, 2) = JT(2, 1) = der.second().z();
+
+      m.getMat(M);
+      J.mult(M, W);
+      W.mult(JT, R);
+      bamg::Metric M1(R(0, 0), R(1, 0), R(1, 1));
+      mm11[i] = M1.a11;
+      mm12[i] = M1.a21;
+      mm22[i] = M1.a22;
+    }
   }
 }
 
 void meshGFaceBamg(GFace *gf)
 {
   std::vector<GEdge *> const &edges = gf->edges();
-  std::set<MVertex *> bcVertex;
-  for(std::vector<GEdge *>::const_iterator it = edges.begin();
-      it != edges.end(); it++) {
-    for(std::size_t i = 0; i < (*it)->lines.size(); i++) {
-      bcVertex.insert((*it)->lines[i]->getVertex(0));
-      bcVertex.insert((*it)->lines[i]->getVertex(1));
+
+  // number the nodes of the triangulation, the nodes on the boundary first
+  // (bamg keeps them at the beginning of the adapted meshes); a local index
+  // is used, as the nodes on the boundary are shared with other surfaces
+  std::unordered_map<MVertex *, int> index;
+  index.reserve(gf->triangles.size());
+  std::vector<MVertex *> meshNodes;
+  meshNodes.reserve(gf->triangles.size());
+  for(int pass = 0; pass < 2; pass++) {
+    for(std::size_t i = 0; i < gf->triangles.size(); i++) {
+      for(std::size_t j = 0; j < 3; j++) {
+        MVertex *v = gf->triangles[i]->getVertex(j);
+        // FIXME : SEAMS should have to be taken into account here !!!
+        if((v->onWhat()->dim() <= 1) == (pass == 0) &&
+           index.insert(std::make_pair(v, (int)meshNodes.size())).second)
+          meshNodes.push_back(v);
+      }
     }
   }
 
   // fill mesh data fo bamg (bamgVertices, bamgTriangles, bamgBoundary)
-  std::set<MVertex *> all;
-  std::map<int, MVertex *> recover;
-  for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-    for(std::size_t j = 0; j < 3; j++)
-      all.insert(gf->triangles[i]->getVertex(j));
-  }
-
-  Vertex2 *bamgVertices = new Vertex2[all.size()];
-  int index = 0;
-  for(std::set<MVertex *>::iterator it = all.begin(); it != all.end(); ++it) {
-    if((*it)->onWhat()->dim() <= 1) {
-      // for(std::set<MVertex*>::iterator it = bcVertex.begin();
-      // it!=bcVertex.end(); ++it){
-      SPoint2 p;
-      reparamMeshVertexOnFace(*it, gf, p);
-      bamgVertices[index][0] = p.x();
-      bamgVertices[index][1] = p.y();
-      bamgVertices[index].lab = index;
-      recover[index] = *it;
-      (*it)->setIndex(index++);
-    }
-  }
-  // exit(1);
-  int nbFixedVertices = index;
-  for(std::set<MVertex *>::iterator it = all.begin(); it != all.end(); ++it) {
-    // FIXME : SEAMS should have to be taken into account here !!!
-    if((*it)->onWhat()->dim() >= 2) {
-      SPoint2 p;
-      reparamMeshVertexOnFace(*it, gf, p);
-      bamgVertices[index][0] = p.x();
-      bamgVertices[index][1] = p.y();
-      recover[index] = *it;
-      (*it)->setIndex(index++);
+  Vertex2 *bamgVertices = new Vertex2[meshNodes.size()];
+  int nbFixedVertices = 0;
+  for(std::size_t i = 0; i < meshNodes.size(); i++) {
+    SPoint2 p;
+    reparamMeshVertexOnFace(meshNodes[i], gf, p);
+    bamgVertices[i][0] = p.x();
+    bamgVertices[i][1] = p.y();
+    if(meshNodes[i]->onWhat()->dim() <= 1) {
+      bamgVertices[i].lab = i;
+      nbFixedVertices++;
     }
   }
 
-  std::vector<MElement *> myParamElems;
-  std::vector<MVertex *> newVert;
   Triangle2 *bamgTriangles = new Triangle2[gf->triangles.size()];
   for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-    int nodes[3] = {(int)gf->triangles[i]->getVertex(0)->getIndex(),
-                    (int)gf->triangles[i]->getVertex(1)->getIndex(),
-                    (int)gf->triangles[i]->getVertex(2)->getIndex()};
+    int nodes[3] = {index[gf->triangles[i]->getVertex(0)],
+                    index[gf->triangles[i]->getVertex(1)],
+                    index[gf->triangles[i]->getVertex(2)]};
     double u1(bamgVertices[nodes[0]][0]);
     double u2(bamgVertices[nodes[1]][0]);
     double u3(bamgVertices[nodes[2]][0]);
@@ -149,45 +144,45 @@ void meshGFaceBamg(GFace *gf)
   for(std::vector<GEdge *>::const_iterator it = edges.begin();
       it != edges.end(); ++it) {
     for(std::size_t i = 0; i < (*it)->lines.size(); ++i) {
-      int nodes[2] = {(int)(*it)->lines[i]->getVertex(0)->getIndex(),
-                      (int)(*it)->lines[i]->getVertex(1)->getIndex()};
+      int nodes[2] = {index[(*it)->lines[i]->getVertex(0)],
+                      index[(*it)->lines[i]->getVertex(1)]};
       bamgBoundary[count].init(bamgVertices, nodes, (*it)->tag());
       bamgBoundary[count].lab = count;
       count++;
     }
   }
 
-  Mesh2 *bamgMesh = new Mesh2(all.size(), gf->triangles.size(), numEdges,
+  Mesh2 *bamgMesh = new Mesh2(meshNodes.size(), gf->triangles.size(), numEdges,
                               bamgVertices, bamgTriangles, bamgBoundary);
 
-  MElementOctree *_octree = NULL;
-
+  // the adapted mesh of an iteration is directly the background mesh of the
+  // next one; the metric arrays are reused
+  std::vector<double> mm11, mm12, mm22;
   Mesh2 *refinedBamgMesh = 0;
   int iterMax = 41;
   for(int k = 0; k < iterMax; k++) {
     int nbVert = bamgMesh->nv;
 
-    double *mm11 = new double[nbVert];
-    double *mm12 = new double[nbVert];
-    double *mm22 = new double[nbVert];
+    mm11.resize(nbVert);
+    mm12.resize(nbVert);
+    mm22.resize(nbVert);
     double args[256];
     for(int i = 0; i < 256; i++) args[i] = -1.1e100;
     args[16] = CTX::instance()->mesh.anisoMax;
     args[7] = CTX::instance()->mesh.smoothRatio;
     // args[ 21] = 90.0;//cutoffrad = 90 degree
-    computeMeshMetricsForBamg(gf, nbVert, bamgMesh->vertices, mm11, mm12, mm22);
+    computeMeshMetricsForBamg(gf, nbVert, bamgMesh->vertices, &mm11[0],
+                              &mm12[0], &mm22[0]);
 
     try {
-      refinedBamgMesh = Bamg(bamgMesh, args, mm11, mm12, mm22, false);
+      refinedBamgMesh =
+        Bamg(bamgMesh, args, &mm11[0], &mm12[0], &mm22[0], false);
       Msg::Info("bamg succeeded %d vertices %d triangles", refinedBamgMesh->nv,
                 refinedBamgMesh->nt);
     } catch(...) {
       Msg::Error("bamg failed");
       return;
     }
-    delete[] mm11;
-    delete[] mm12;
-    delete[] mm22;
 
     int nT = bamgMesh->nt;
     int nTnow = refinedBamgMesh->nt;
@@ -197,24 +192,33 @@ void meshGFaceBamg(GFace *gf)
     if(fabs((double)(nTnow - nT)) < 0.01 * nT) break;
   }
 
-  std::map<int, MVertex *> yetAnother;
-  for(int i = 0; i < refinedBamgMesh->nv; i++) {
+  // create the new nodes: the (costly) evaluations of the surface are computed
+  // in parallel; the nodes are then created in order, so that their numbering
+  // does not depend on the number of threads
+  const int nv = refinedBamgMesh->nv;
+  std::vector<GPoint> gps(std::max(nv - nbFixedVertices, 0));
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for(int i = nbFixedVertices; i < nv; i++) {
     Vertex2 &v = refinedBamgMesh->vertices[i];
+    gps[i - nbFixedVertices] = gf->point(SPoint2(v[0], v[1]));
+  }
+
+  std::vector<MVertex *> newNodes(nv);
+  gf->mesh_vertices.reserve(gf->mesh_vertices.size() + gps.size());
+  for(int i = 0; i < nv; i++) {
     if(i >= nbFixedVertices) {
-      GPoint gp = gf->point(SPoint2(v[0], v[1]));
-      // if (gp.x() > 2.){
-      //  printf("wrong vertex index=%d %g %g %g (%g %g)\n",
-      //         i, gp.x(), gp.y(), gp.z(), v[0], v[1]);
-      // }
+      Vertex2 &v = refinedBamgMesh->vertices[i];
+      const GPoint &gp = gps[i - nbFixedVertices];
       // If point not found because compound edges have been remeshed and
       // boundary triangles have changed then we call our new octree
       MFaceVertex *x = new MFaceVertex(gp.x(), gp.y(), gp.z(), gf, v[0], v[1]);
-      yetAnother[i] = x;
+      newNodes[i] = x;
       gf->mesh_vertices.push_back(x);
     }
     else {
-      MVertex *v = recover[i];
-      yetAnother[i] = v;
+      newNodes[i] = meshNodes[i];
     }
   }
 
@@ -222,25 +226,19 @@ void meshGFaceBamg(GFace *gf)
     delete gf->triangles[i];
   }
   gf->triangles.clear();
+  gf->triangles.reserve(refinedBamgMesh->nt);
   for(int i = 0; i < refinedBamgMesh->nt; i++) {
     Triangle2 &t = refinedBamgMesh->triangles[i];
     Vertex2 &v1 = t[0];
     Vertex2 &v2 = t[1];
     Vertex2 &v3 = t[2];
-    gf->triangles.push_back(new MTriangle(yetAnother[(*refinedBamgMesh)(v1)],
-                                          yetAnother[(*refinedBamgMesh)(v2)],
-                                          yetAnother[(*refinedBamgMesh)(v3)]));
+    gf->triangles.push_back(new MTriangle(newNodes[(*refinedBamgMesh)(v1)],
+                                          newNodes[(*refinedBamgMesh)(v2)],
+                                          newNodes[(*refinedBamgMesh)(v3)]));
   }
 
   // delete pointers
   if(refinedBamgMesh) delete refinedBamgMesh;
-  if(_octree) delete _octree;
-  for(std::vector<MElement *>::iterator it = myParamElems.begin();
-      it != myParamElems.end(); it++)
-    delete *it;
-  for(std::vector<MVertex *>::iterator it = newVert.begin();
-      it != newVert.end(); it++)
-    delete *it;
 }
 
 #else
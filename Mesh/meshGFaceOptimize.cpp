@@ -4,6 +4,7 @@
 // issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <stack>
+#include <algorithm>
 #include "GmshConfig.h"
 #include "meshGFaceOptimize.h"
 #include "qualityMeasures.h"
@@ -910,6 +911,86 @@ static void _relocate(GFace *gf, MVertex *ver,
   }
 }
 
+namespace {
+  struct vertexElementPair {
+    MVertex *v;
+    std::size_t e, k;
+    bool operator<(const vertexElementPair &other) const
+    {
+      if(v->getNum() != other.v->getNum())
+        return v->getNum() < other.v->getNum();
+      return e < other.e;
+    }
+  };
+} // namespace
+
+void v2t_coloring::build()
+{
+  _vertices.clear();
+  _v2eOffset.clear();
+  _v2e.clear();
+  _colorOffset.clear();
+  _byColor.clear();
+
+  // (vertex, element) incidences, sorted by vertex number then element order,
+  // i.e. in the same order as buildVertexToElement()
+  std::vector<std::size_t> e2vOffset(_elements.size() + 1, 0);
+  for(std::size_t e = 0; e < _elements.size(); e++)
+    e2vOffset[e + 1] = e2vOffset[e] + _elements[e]->getNumVertices();
+  std::vector<vertexElementPair> pairs(e2vOffset.back());
+  for(std::size_t e = 0; e < _elements.size(); e++) {
+    for(std::size_t k = 0; k < _elements[e]->getNumVertices(); k++) {
+      vertexElementPair &p = pairs[e2vOffset[e] + k];
+      p.v = _elements[e]->getVertex(k);
+      p.e = e;
+      p.k = k;
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+
+  std::vector<std::size_t> e2v(pairs.size());
+  _v2e.resize(pairs.size());
+  for(std::size_t i = 0; i < pairs.size(); i++) {
+    if(!i || pairs[i].v != pairs[i - 1].v) {
+      _vertices.push_back(pairs[i].v);
+      _v2eOffset.push_back(i);
+    }
+    _v2e[i] = _elements[pairs[i].e];
+    e2v[e2vOffset[pairs[i].e] + pairs[i].k] = _vertices.size() - 1;
+  }
+  _v2eOffset.push_back(pairs.size());
+
+  // greedy colouring: smallest colour not used by a vertex sharing an element
+  const std::size_t nv = _vertices.size();
+  std::vector<int> color(nv, -1);
+  std::vector<std::size_t> stamp;
+  std::vector<std::size_t> count;
+  for(std::size_t i = 0; i < nv; i++) {
+    for(std::size_t j = _v2eOffset[i]; j < _v2eOffset[i + 1]; j++) {
+      const std::size_t e = pairs[j].e;
+      for(std::size_t l = e2vOffset[e]; l < e2vOffset[e + 1]; l++) {
+        const int c = color[e2v[l]];
+        if(c >= 0) stamp[c] = i + 1;
+      }
+    }
+    std::size_t c = 0;
+    while(c < stamp.size() && stamp[c] == i + 1) c++;
+    if(c == stamp.size()) {
+      stamp.push_back(0);
+      count.push_back(0);
+    }
+    color[i] = (int)c;
+    count[c]++;
+  }
+
+  _colorOffset.resize(count.size() + 1, 0);
+  for(std::size_t c = 0; c < count.size(); c++)
+    _colorOffset[c + 1] = _colorOffset[c] + count[c];
+  _byColor.resize(nv);
+  std::vector<std::size_t> pos(_colorOffset.begin(), _colorOffset.end() - 1);
+  for(std::size_t i = 0; i < nv; i++) _byColor[pos[color[i]]++] = i;
+}
+
 void getAllBoundaryLayerVertices(GFace *gf, std::set<MVertex *> &vs)
 {
   vs.clear();
@@ -923,6 +1004,21 @@ void getAllBoundaryLayerVertices(GFace *gf, std::set<MVertex *> &vs)
   }
 }
 
+namespace {
+  struct laplaceRelocator {
+    GFace *gf;
+    const std::set<MVertex *> &frozen;
+    laplaceRelocator(GFace *f, const std::set<MVertex *> &vs)
+      : gf(f), frozen(vs)
+    {
+    }
+    void operator()(MVertex *v, const std::vector<MElement *> &lt) const
+    {
+      if(frozen.find(v) == frozen.end()) _relocate(gf, v, lt);
+    }
+  };
+} // namespace
+
 void laplaceSmoothing(GFace *gf, int niter, bool infinity_norm)
 {
   if((gf->triangles.size() > 0 && gf->triangles[0]->getPolynomialOrder() > 1) ||
@@ -935,25 +1031,54 @@ void laplaceSmoothing(GFace *gf, int niter, bool infinity_norm)
   if(!niter) return;
   std::set<MVertex *> vs;
   getAllBoundaryLayerVertices(gf, vs);
-  v2t_cont adj;
-  buildVertexToElement(gf->triangles, adj);
-  buildVertexToElement(gf->quadrangles, adj);
-  for(int i = 0; i < niter; i++) {
-    v2t_cont::iterator it = adj.begin();
-    while(it != adj.end()) {
-      if(vs.find(it->first) == vs.end()) {
-        _relocate(gf, it->first, it->second);
-      }
-      ++it;
-    }
-  }
+  v2t_coloring adj;
+  adj.add(gf->triangles);
+  adj.add(gf->quadrangles);
+  adj.build();
+  laplaceRelocator relocate(gf, vs);
+  // OpenCASCADE surface queries are not thread-safe
+  const bool parallel = (gf->getNativeType() != GEntity::OpenCascadeModel);
+  for(int i = 0; i < niter; i++) adj.sweep(relocate, parallel);
 }
 
-static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
+namespace {
+  struct triangleEdge {
+    std::size_t v0, v1; // sorted vertex numbers
+    std::size_t t; // triangle index
+    int e; // local edge index
+    bool operator<(const triangleEdge &other) const
+    {
+      if(v0 != other.v0) return v0 < other.v0;
+      if(v1 != other.v1) return v1 < other.v1;
+      return t < other.t;
+    }
+  };
+
+  struct boundaryVertex {
+    std::size_t v, seq, t;
+    bool operator<(const boundaryVertex &other) const
+    {
+      if(v != other.v) return v < other.v;
+      return seq < other.seq;
+    }
+  };
+
+  struct recombinePair {
+    RecombineTriangle rt;
+    std::size_t i1, i2; // triangle indices
+    bool operator<(const recombinePair &other) const { return rt < other.rt; }
+  };
+} // namespace
+
+static void _recombineIntoQuads(GFace *gf, bool blossom, double *times = 0,
+                                bool cubicGraph = 1)
 {
+  if(times) times[0] = times[1] = times[2] = 0.;
   if(gf->triangles.empty()) return;
   if(gf->compound.size()) return;
 
+  const double tic = Cpu();
+
   std::vector<MVertex *> emb_edgeverts;
   {
     std::vector<GEdge *> emb_edges = gf->getEmbeddedEdges();
@@ -1003,48 +1128,101 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
   emb_edgeverts.erase(std::unique(emb_edgeverts.begin(), emb_edgeverts.end()),
                       emb_edgeverts.end());
 
-  e2t_cont adj;
-  buildEdgeToElement(gf->triangles, adj);
-
-  std::vector<RecombineTriangle> pairs;
-
-  std::map<MVertex *, std::pair<MElement *, MElement *> > makeGraphPeriodic;
-
-  for(e2t_cont::iterator it = adj.begin(); it != adj.end(); ++it) {
-    if(it->second.second && it->second.first->getNumVertices() == 3 &&
-       it->second.second->getNumVertices() == 3 &&
-       (!std::binary_search(emb_edgeverts.begin(), emb_edgeverts.end(),
-                            it->first.getVertex(0)) ||
-        !std::binary_search(emb_edgeverts.begin(), emb_edgeverts.end(),
-                            it->first.getVertex(1)))) {
-      pairs.push_back(
-        RecombineTriangle(it->first, it->second.first, it->second.second));
+  // edge-to-triangle adjacency: triangle edges sorted by vertex numbers (then
+  // by triangle index, i.e. in the same order as buildEdgeToElement)
+  const std::size_t nt = gf->triangles.size();
+  std::vector<triangleEdge> edges(3 * nt);
+  for(std::size_t i = 0; i < nt; i++) {
+    for(int j = 0; j < 3; j++) {
+      MEdge e = gf->triangles[i]->getEdge(j);
+      triangleEdge &te = edges[3 * i + j];
+      te.v0 = e.getMinVertex()->getNum();
+      te.v1 = e.getMaxVertex()->getNum();
+      te.t = i;
+      te.e = j;
     }
-    else if(!it->second.second && it->second.first->getNumVertices() == 3) {
+  }
+  std::sort(edges.begin(), edges.end());
+
+  // internal edges give the candidate pairs; each vertex on a closed boundary
+  // loop connects the two boundary triangles it belongs to
+  std::vector<std::pair<std::size_t, std::size_t> > candidates;
+  std::vector<std::size_t> candidateEdges;
+  std::vector<boundaryVertex> bnd;
+  for(std::size_t a = 0, b = 0; a < edges.size(); a = b) {
+    b = a + 1;
+    while(b < edges.size() && edges[b].v0 == edges[a].v0 &&
+          edges[b].v1 == edges[a].v1)
+      b++;
+    MElement *t1 = gf->triangles[edges[a].t];
+    MEdge e = t1->getEdge(edges[a].e);
+    if(b - a > 1) {
+      MElement *t2 = gf->triangles[edges[b - 1].t];
+      if(t1->getNumVertices() == 3 && t2->getNumVertices() == 3 &&
+         (!std::binary_search(emb_edgeverts.begin(), emb_edgeverts.end(),
+                              e.getVertex(0)) ||
+          !std::binary_search(emb_edgeverts.begin(), emb_edgeverts.end(),
+                              e.getVertex(1)))) {
+        candidates.push_back(std::make_pair(edges[a].t, edges[b - 1].t));
+        candidateEdges.push_back(a);
+      }
+    }
+    else if(t1->getNumVertices() == 3) {
       for(int i = 0; i < 2; i++) {
-        MVertex *const v = it->first.getVertex(i);
-        std::map<MVertex *, std::pair<MElement *, MElement *> >::iterator itv =
-          makeGraphPeriodic.find(v);
-        if(itv == makeGraphPeriodic.end()) {
-          makeGraphPeriodic[v] =
-            std::make_pair(it->second.first, static_cast<MElement *>(NULL));
-        }
-        else {
-          if(itv->second.first != it->second.first)
-            itv->second.second = it->second.first;
-          else
-            makeGraphPeriodic.erase(itv);
-        }
+        boundaryVertex bv;
+        bv.v = e.getVertex(i)->getNum();
+        bv.seq = bnd.size();
+        bv.t = edges[a].t;
+        bnd.push_back(bv);
       }
     }
   }
 
+  std::sort(bnd.begin(), bnd.end());
+  std::vector<std::pair<std::size_t, std::size_t> > makeGraphPeriodic;
+  for(std::size_t a = 0, b = 0; a < bnd.size(); a = b) {
+    b = a + 1;
+    while(b < bnd.size() && bnd[b].v == bnd[a].v) b++;
+    bool open = false;
+    std::size_t first = 0, second = nt;
+    for(std::size_t k = a; k < b; k++) {
+      if(!open) {
+        open = true;
+        first = bnd[k].t;
+        second = nt;
+      }
+      else if(first != bnd[k].t)
+        second = bnd[k].t;
+      else
+        open = false;
+    }
+    if(open && second != nt)
+      makeGraphPeriodic.push_back(std::make_pair(first, second));
+  }
+
+  std::vector<recombinePair> pairs(candidates.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for(int i = 0; i < (int)candidates.size(); i++) {
+    const triangleEdge &te = edges[candidateEdges[i]];
+    pairs[i].rt =
+      RecombineTriangle(gf->triangles[te.t]->getEdge(te.e),
+                        gf->triangles[candidates[i].first],
+                        gf->triangles[candidates[i].second]);
+    pairs[i].i1 = candidates[i].first;
+    pairs[i].i2 = candidates[i].second;
+  }
+
   std::sort(pairs.begin(), pairs.end());
-  std::set<MElement *> touched;
+  std::vector<char> touched(nt, 0);
+
+  const double tGraph = Cpu();
+  if(times) times[0] = tGraph - tic;
 
   if(blossom) {
 #if defined(HAVE_BLOSSOM)
-    int ncount = gf->triangles.size();
+    int ncount = nt;
     if(ncount % 2 != 0) {
       Msg::Warning("Cannot apply Blossom: odd number of triangles (%d) in "
                    "surface %d", ncount, gf->tag());
@@ -1055,26 +1233,21 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
       Msg::Info("Blossom: %d internal %d closed", (int)pairs.size(),
                 (int)makeGraphPeriodic.size());
       Msg::Debug("Perfect Match Starts %d edges %d nodes", ecount, ncount);
-      std::map<MElement *, int> t2n;
-      std::map<int, MElement *> n2t;
-      for(std::size_t i = 0; i < gf->triangles.size(); ++i) {
-        t2n[gf->triangles[i]] = i;
-        n2t[i] = gf->triangles[i];
-      }
       // do not use new[] here, blossom will free it with free() and not with
       // delete
       int *elist = (int *)malloc(sizeof(int) * 2 * ecount);
       int *elen = (int *)malloc(sizeof(int) * ecount);
 
       for(std::size_t i = 0; i < pairs.size(); ++i) {
-        elist[2 * i] = t2n[pairs[i].t1];
-        elist[2 * i + 1] = t2n[pairs[i].t2];
-        elen[i] = (int)1000 * std::exp(-pairs[i].angle);
+        const RecombineTriangle &rt = pairs[i].rt;
+        elist[2 * i] = (int)pairs[i].i1;
+        elist[2 * i + 1] = (int)pairs[i].i2;
+        elen[i] = (int)1000 * std::exp(-rt.angle);
         int NB = 0;
-        if(pairs[i].n1->onWhat()->dim() < 2) NB++;
-        if(pairs[i].n2->onWhat()->dim() < 2) NB++;
-        if(pairs[i].n3->onWhat()->dim() < 2) NB++;
-        if(pairs[i].n4->onWhat()->dim() < 2) NB++;
+        if(rt.n1->onWhat()->dim() < 2) NB++;
+        if(rt.n2->onWhat()->dim() < 2) NB++;
+        if(rt.n3->onWhat()->dim() < 2) NB++;
+        if(rt.n4->onWhat()->dim() < 2) NB++;
         if(elen[i] > static_cast<int>(1000 * std::exp(0.1)) && NB > 2) {
           elen[i] = 5000;
         }
@@ -1084,12 +1257,10 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
       }
 
       if(cubicGraph) {
-        std::map<MVertex *, std::pair<MElement *, MElement *> >::iterator itv =
-          makeGraphPeriodic.begin();
         std::size_t CC = pairs.size();
-        for(; itv != makeGraphPeriodic.end(); ++itv) {
-          elist[2 * CC] = t2n[itv->second.first];
-          elist[2 * CC + 1] = t2n[itv->second.second];
+        for(std::size_t i = 0; i < makeGraphPeriodic.size(); i++) {
+          elist[2 * CC] = (int)makeGraphPeriodic[i].first;
+          elist[2 * CC + 1] = (int)makeGraphPeriodic[i].second;
           elen[CC++] = 100000;
         }
       }
@@ -1115,10 +1286,10 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
             //              "will be required");
           }
           else {
-            MElement *t1 = n2t[i1];
-            MElement *t2 = n2t[i2];
-            touched.insert(t1);
-            touched.insert(t2);
+            MElement *t1 = gf->triangles[i1];
+            MElement *t2 = gf->triangles[i2];
+            touched[i1] = 1;
+            touched[i2] = 1;
             MVertex *other = NULL;
             for(int i = 0; i < 3; i++) {
               if(t1->getVertex(0) != t2->getVertex(i) &&
@@ -1155,20 +1326,20 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
 #endif
   }
 
+  const double tMatch = Cpu();
+  if(times) times[1] = tMatch - tGraph;
+
   // simple greedy recombination
-  std::vector<RecombineTriangle>::iterator itp = pairs.begin();
-  while(itp != pairs.end()) {
-    if(itp->angle < gf->meshAttributes.recombineAngle) {
-      MElement *t1 = itp->t1;
-      MElement *t2 = itp->t2;
-      if(touched.find(t1) == touched.end() &&
-         touched.find(t2) == touched.end()) {
-        touched.insert(t1);
-        touched.insert(t2);
+  for(std::size_t i = 0; i < pairs.size(); i++) {
+    const RecombineTriangle &rt = pairs[i].rt;
+    if(rt.angle < gf->meshAttributes.recombineAngle) {
+      if(!touched[pairs[i].i1] && !touched[pairs[i].i2]) {
+        touched[pairs[i].i1] = 1;
+        touched[pairs[i].i2] = 1;
         int orientation = 0;
-        for(int i = 0; i < 3; i++) {
-          if(t1->getVertex(i) == itp->n1) {
-            if(t1->getVertex((i + 1) % 3) == itp->n2)
+        for(int j = 0; j < 3; j++) {
+          if(rt.t1->getVertex(j) == rt.n1) {
+            if(rt.t1->getVertex((j + 1) % 3) == rt.n2)
               orientation = 1;
             else
               orientation = -1;
@@ -1176,17 +1347,16 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
           }
         }
         gf->quadrangles.push_back
-          (new MQuadrangle(itp->n1, orientation < 0 ? itp->n3 : itp->n4, itp->n2,
-                           orientation < 0 ? itp->n4 : itp->n3));
+          (new MQuadrangle(rt.n1, orientation < 0 ? rt.n3 : rt.n4, rt.n2,
+                           orientation < 0 ? rt.n4 : rt.n3));
       }
     }
-    ++itp;
   }
 
   std::vector<MTriangle *> triangles2;
-  triangles2.reserve(gf->triangles.size());
-  for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-    if(touched.find(gf->triangles[i]) == touched.end()) {
+  triangles2.reserve(nt);
+  for(std::size_t i = 0; i < nt; i++) {
+    if(!touched[i]) {
       triangles2.push_back(gf->triangles[i]);
     }
     else {
@@ -1194,6 +1364,8 @@ static void _recombineIntoQuads(GFace *gf, bool blossom, bool cubicGraph = 1)
     }
   }
   gf->triangles = triangles2;
+
+  if(times) times[2] = Cpu() - tMatch;
 }
 
 static double printStats(GFace *gf, const char *message)
@@ -1221,7 +1393,7 @@ static double printStats(GFace *gf, const char *message)
 // CreateTopology or ReclassifySurfaces is not called, quads can have nodes
 // owned by an adjacent surface. Since the topological optimization routines
 // remove nodes, this will produce an invalide model mesh (and crash).
-static bool _isModelOkForTopologicalOpti(GModel *m)
+bool isModelOkForTopologicalOpti(GModel *m)
 {
   for(GModel::fiter it = m->firstFace(); it != m->lastFace(); it++){
     GFace *gf = *it;
@@ -1238,7 +1410,8 @@ static bool _isModelOkForTopologicalOpti(GModel *m)
 }
 
 void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
-                        bool nodeRepositioning, double minqual)
+                        bool nodeRepositioning, double minqual,
+                        bool checkModelTopology)
 {
   double t1 = Cpu();
 
@@ -1248,7 +1421,8 @@ void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
   if(debug)
     gf->model()->writeMSH("recombine_0before.msh");
 
-  _recombineIntoQuads(gf, blossom);
+  double times[3];
+  _recombineIntoQuads(gf, blossom, times);
 
   if(debug)
     gf->model()->writeMSH("recombine_1raw.msh");
@@ -1260,7 +1434,7 @@ void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
   }
 
   if(topologicalOptiPasses > 0) {
-    if(!_isModelOkForTopologicalOpti(gf->model())){
+    if(checkModelTopology && !isModelOkForTopologicalOpti(gf->model())){
       Msg::Info("Skipping topological optimization - mesh topology is not complete");
     }
     else{
@@ -1292,8 +1466,9 @@ void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
   double t2 = Cpu();
 
   char name[256];
-  sprintf(name, "%s recombination completed (%g s)", blossom ? "Blossom" :
-          "Simple", t2 - t1);
+  sprintf(name, "%s recombination completed (%g s: graph %g s, matching %g s, "
+          "quads %g s)", blossom ? "Blossom" : "Simple", t2 - t1, times[0],
+          times[1], times[2]);
   printStats(gf, name);
 
   if(debug)
@@ -14,6 +14,7 @@
 #include "meshGFaceDelaunayInsertion.h"
 #include "STensor3.h"
 
+class GModel;
 class GFace;
 class GVertex;
 class MVertex;
@@ -45,6 +46,64 @@ void buildVertexToElement(std::vector<T *> const &elements, v2t_cont &adj)
   }
 }
 
+// Contiguous vertex-to-element adjacency, together with a greedy colouring of
+// the vertices such that two vertices sharing an element never have the same
+// colour. All the vertices of a colour can thus be relocated concurrently
+// (Gauss-Seidel sweep over colours), and the result does not depend on the
+// number of threads.
+class v2t_coloring {
+private:
+  std::vector<MElement *> _elements;
+  std::vector<MVertex *> _vertices;
+  // elements adjacent to _vertices[i]: _v2e[_v2eOffset[i] ... ]
+  std::vector<std::size_t> _v2eOffset;
+  std::vector<MElement *> _v2e;
+  // vertex indices grouped by colour: _byColor[_colorOffset[c] ... ]
+  std::vector<std::size_t> _colorOffset;
+  std::vector<std::size_t> _byColor;
+
+public:
+  template <class T> void add(std::vector<T *> const &elements)
+  {
+    _elements.insert(_elements.end(), elements.begin(), elements.end());
+  }
+  // build the adjacency and the colouring from the elements added so far;
+  // vertices are ordered as in v2t_cont
+  void build();
+  std::size_t getNumVertices() const { return _vertices.size(); }
+  std::size_t getNumColors() const
+  {
+    return _colorOffset.empty() ? 0 : _colorOffset.size() - 1;
+  }
+  MVertex *getVertex(std::size_t i) const { return _vertices[i]; }
+  // apply f(vertex, adjacent elements) to all vertices, colour by colour,
+  // vertices of the same colour being processed in parallel if "parallel" is
+  // set (f must then be thread-safe, including the CAD queries it makes); f
+  // may only move the vertex it receives
+  template <class F> void sweep(F &f, bool parallel = true) const
+  {
+#if defined(_OPENMP)
+#pragma omp parallel if(parallel)
+#endif
+    {
+      std::vector<MElement *> lt;
+      for(std::size_t c = 0; c < getNumColors(); c++) {
+        const int start = (int)_colorOffset[c];
+        const int end = (int)_colorOffset[c + 1];
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 64)
+#endif
+        for(int k = start; k < end; k++) {
+          const std::size_t i = _byColor[k];
+          lt.assign(_v2e.begin() + _v2eOffset[i],
+                    _v2e.begin() + _v2eOffset[i + 1]);
+          f(_vertices[i], lt);
+        }
+      }
+    }
+  }
+};
+
 template <class T>
 void buildEdgeToElement(std::vector<T *> &eles, e2t_cont &adj);
 
@@ -61,8 +120,12 @@ void transferDataStructure(GFace *gf,
                            std::set<MTri3 *, compareTri3Ptr> &AllTris,
                            bidimMeshData &DATA);
 void computeEquivalences(GFace *gf, bidimMeshData &DATA);
+bool isModelOkForTopologicalOpti(GModel *m);
+// if checkModelTopology is false, the caller has already checked that the
+// model is ok for the topological optimization
 void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
-                        bool nodeRepositioning, double minqual);
+                        bool nodeRepositioning, double minqual,
+                        bool checkModelTopology = true);
 
 // used for meshGFaceRecombine development
 void quadsToTriangles(GFace *gf, double minqual);
@@ -108,6 +171,10 @@ struct RecombineTriangle {
   double quality;
   MVertex *n1, *n2, *n3, *n4;
 
+  RecombineTriangle()
+    : t1(0), t2(0), angle(0.), quality(0.), n1(0), n2(0), n3(0), n4(0)
+  {
+  }
   RecombineTriangle(const MEdge &me, MElement *_t1, MElement *_t2)
     : t1(_t1), t2(_t2)
   {
@@ -210,6 +210,7 @@ void deMeshGRegion::operator()(GRegion *gr)
 
 void meshGRegion::operator()(GRegion *gr)
 {
+  MsgProfile profile("Volume", gr->tag());
   gr->model()->setCurrentMeshEntity(gr);
 
   if(gr->geomType() == GEntity::DiscreteVolume) return;
@@ -130,8 +130,9 @@ namespace tetgenBR {
   {
     return 0.;
   }
-  static int clock() { return 0; }
-#define clock_t int
+  // the "clock" time stamps taken by tetgen between its stages are CPU times
+  static double clock() { return Cpu(); }
+#define clock_t double
 #if !defined(TETLIBRARY)
 #define TETLIBRARY
 #endif
@@ -666,20 +667,42 @@ namespace tetgenBR {
 
     // Boundary recovery.
 
+    // recoverboundary() sets t to the time at which facet recovery starts
     clock_t t;
     Msg::Info(" - Recovering boundary");
+    double t_segments = Cpu();
     recoverboundary(t);
-
+    double t_facets = Cpu() - t;
+    t_segments = t - t_segments;
+    Msg::Info(" - Recovered boundary with %ld segments (%g s) and %ld facets "
+              "(%g s), adding %ld Steiner points on segments, %ld on facets "
+              "and %ld in volume",
+              insegments, t_segments, subfaces->items, t_facets,
+              st_segref_count, st_facref_count, st_volref_count);
+
+    double t1 = Cpu();
     carveholes();
+    double t_carve = Cpu() - t1;
 
+    t1 = Cpu();
+    long st_kept = subvertstack->objects;
     if(subvertstack->objects > 0l) {
       suppresssteinerpoints();
     }
+    double t_suppress = Cpu() - t1;
 
+    t1 = Cpu();
     recoverdelaunay();
+    double t_delaunay = Cpu() - t1;
 
     // let's try
+    t1 = Cpu();
     optimizemesh();
+    double t_optimize = Cpu() - t1;
+
+    Msg::Info(" - Carved holes (%g s), suppressed Steiner points (%ld "
+              "candidates, %g s), recovered Delaunay (%g s), optimized (%g s)",
+              t_carve, st_kept, t_suppress, t_delaunay, t_optimize);
 
     if((dupverts > 0l) || (unuverts > 0l)) {
       // Remove hanging nodes.
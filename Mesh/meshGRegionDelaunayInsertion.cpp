@@ -111,8 +111,7 @@ struct edgeContainerB {
   }
 };
 
-static void createAllEmbeddedEdges(GRegion *gr,
-                                   std::set<MEdge, MEdgeLessThan> &allEmbeddedEdges)
+static void createAllEmbeddedEdges(GRegion *gr, hashsetMEdge &allEmbeddedEdges)
 {
   std::vector<GEdge *> const &e = gr->embeddedEdges();
   for(std::vector<GEdge *>::const_iterator it = e.begin(); it != e.end();
@@ -136,8 +135,7 @@ static void createAllEmbeddedEdges(GRegion *gr, edgeContainerB &embedded)
   }
 }
 
-static void createAllEmbeddedFaces(GRegion *gr,
-                                   std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+static void createAllEmbeddedFaces(GRegion *gr, hashsetMFace &allEmbeddedFaces)
 {
   std::vector<GFace *> const &f = gr->embeddedFaces();
   for(std::vector<GFace *>::const_iterator it = f.begin(); it != f.end();
@@ -249,7 +247,7 @@ void connectTets_vector2_templ(std::size_t _size, ITER beg, ITER end,
 
 template <class ITER>
 void connectTets(ITER beg, ITER end,
-                 const std::set<MFace, MFaceLessThan> *allEmbeddedFaces = 0)
+                 const hashsetMFace *allEmbeddedFaces = 0)
 {
   std::set<faceXtet> conn;
   while(beg != end) {
@@ -275,13 +273,13 @@ void connectTets(ITER beg, ITER end,
 }
 
 void connectTets(std::list<MTet4 *> &l,
-                 const std::set<MFace, MFaceLessThan> *embeddedFaces)
+                 const hashsetMFace *embeddedFaces)
 {
   connectTets(l.begin(), l.end(), embeddedFaces);
 }
 
 void connectTets(std::vector<MTet4 *> &l,
-                 const std::set<MFace, MFaceLessThan> *embeddedFaces)
+                 const hashsetMFace *embeddedFaces)
 {
   connectTets(l.begin(), l.end(), embeddedFaces);
 }
@@ -464,7 +462,7 @@ bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
                    std::vector<double> &vSizes, std::vector<double> &vSizesBGM,
                    MTet4 *t, MTet4Factory &myFactory,
                    std::set<MTet4 *, compareTet4Ptr> &allTets,
-                   const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+                   const hashsetMFace &allEmbeddedFaces)
 {
   std::vector<MTet4 *> new_cavity;
   new_cavity.reserve(shell.size());
@@ -695,16 +693,17 @@ void adaptMeshGRegion::operator()(GRegion *gr)
 {
   const qmTetrahedron::Measures qm = qmTetrahedron::QMTET_GAMMA;
 
-  typedef std::list<MTet4 *> CONTAINER;
+  typedef std::vector<MTet4 *> CONTAINER;
   CONTAINER allTets;
+  allTets.reserve(gr->tetrahedra.size());
   for(std::size_t i = 0; i < gr->tetrahedra.size(); i++) {
     allTets.push_back(new MTet4(gr->tetrahedra[i], qm));
   }
   gr->tetrahedra.clear();
 
-  std::set<MFace, MFaceLessThan> allEmbeddedFaces;
+  hashsetMFace allEmbeddedFaces;
   createAllEmbeddedFaces(gr, allEmbeddedFaces);
-  std::set<MEdge, MEdgeLessThan> allEmbeddedEdges;
+  hashsetMEdge allEmbeddedEdges;
   createAllEmbeddedEdges(gr, allEmbeddedEdges);
 
   connectTets(allTets.begin(), allTets.end(), &allEmbeddedFaces);
@@ -895,10 +894,10 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
   }
   gr->tetrahedra.clear();
 
-  std::set<MFace, MFaceLessThan> allEmbeddedFaces;
+  hashsetMFace allEmbeddedFaces;
   createAllEmbeddedFaces(gr, allEmbeddedFaces);
 
-  std::set<MEdge, MEdgeLessThan> allEmbeddedEdges;
+  hashsetMEdge allEmbeddedEdges;
   createAllEmbeddedEdges(gr, allEmbeddedEdges);
 
   if(allEmbeddedFaces.empty()) {
@@ -1172,7 +1171,7 @@ static int isCavityCompatibleWithEmbeddedEdges(std::vector<MTet4 *> &cavity,
 
 static int isCavityCompatibleWithEmbeddedFace(
   const std::vector<MTet4 *> &cavity, const std::vector<faceXtet> &shell,
-  const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+  const hashsetMFace &allEmbeddedFaces)
 {
   if (allEmbeddedFaces.empty())return 1;
   std::vector<MFace> shellFaces;
@@ -1370,7 +1369,7 @@ void insertVerticesInRegion(GRegion *gr, int maxIter, double worstTetRadiusTarge
     (*it)->setNeigh(3, 0);
   }
   // store all embedded faces
-  std::set<MFace, MFaceLessThan> allEmbeddedFaces;
+  hashsetMFace allEmbeddedFaces;
   edgeContainerB allEmbeddedEdges;
   for(GModel::riter it = gr->model()->firstRegion();
       it != gr->model()->lastRegion(); ++it) {
@@ -10,7 +10,10 @@
 #include <set>
 #include <map>
 #include <stack>
+#include <unordered_set>
 #include "MTetrahedron.h"
+#include "MFaceHash.h"
+#include "MEdgeHash.h"
 #include "Numeric.h"
 #include "BackgroundMeshTools.h"
 #include "qualityMeasures.h"
@@ -28,6 +31,11 @@ double tetcircumcenter(double a[3], double b[3], double c[3], double d[3],
 
 class MTet4Factory;
 
+// hashed sets of mesh faces and edges, used e.g. for the embedded faces and
+// edges that constrain the local mesh modifications
+typedef std::unordered_set<MFace, MFaceHash, MFaceEqual> hashsetMFace;
+typedef std::unordered_set<MEdge, MEdgeHash, MEdgeEqual> hashsetMEdge;
+
 // Memory usage for 1 million tets:
 //
 // * sizeof(MTet4) = 36 Bytes and sizeof(MTetrahedron) = 28 Bytes
@@ -215,8 +223,8 @@ public:
   }
 };
 
-void connectTets(std::list<MTet4 *> &, const std::set<MFace, MFaceLessThan> * = 0);
-void connectTets(std::vector<MTet4 *> &, const std::set<MFace, MFaceLessThan> * = 0);
+void connectTets(std::list<MTet4 *> &, const hashsetMFace * = 0);
+void connectTets(std::vector<MTet4 *> &, const hashsetMFace * = 0);
 void delaunayMeshIn3D(std::vector<MVertex *> &, std::vector<MTetrahedron *> &);
 void insertVerticesInRegion(GRegion *gr, int maxIter, double worstTetRadiusTarget,
                             bool _classify = true, splitQuadRecovery *sqr = 0);
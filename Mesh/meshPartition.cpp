@@ -2330,6 +2330,7 @@ int PartitionFace(GFace *gf, int np, int *p)
 int PartitionMesh(GModel *const model)
 {
   if(CTX::instance()->mesh.numPartitions <= 0) return 0;
+  MsgProfile profile("Partitioning");
 
   Msg::StatusBar(true, "Partitioning mesh...");
   double t1 = Cpu();
@@ -465,6 +465,7 @@ static void Subdivide(GRegion *gr, bool splitIntoHexas,
 void RefineMesh(GModel *m, bool linear, bool splitIntoQuads,
                 bool splitIntoHexas)
 {
+  MsgProfile profile("Refinement");
   Msg::StatusBar(true, "Refining mesh...");
   double t1 = Cpu();
 
@@ -412,6 +412,40 @@ static double _relocateVertex(GFace *gf, MVertex *ver,
 
 void getAllBoundaryLayerVertices(GFace *gf, std::set<MVertex *> &vs);
 
+namespace {
+  struct faceRelocator {
+    GFace *gf;
+    const std::set<MVertex *> &frozen;
+    double tol;
+    faceRelocator(GFace *f, const std::set<MVertex *> &vs, double t)
+      : gf(f), frozen(vs), tol(t)
+    {
+    }
+    void operator()(MVertex *v, const std::vector<MElement *> &lt) const
+    {
+      if(frozen.find(v) == frozen.end()) _relocateVertex(gf, v, lt, tol);
+    }
+  };
+
+  struct goldenRelocator {
+    double relax, tol;
+    goldenRelocator(double r, double t) : relax(r), tol(t) {}
+    void operator()(MVertex *v, const std::vector<MElement *> &lt) const
+    {
+      _relocateVertexGolden(v, lt, relax, tol);
+    }
+  };
+
+  struct pyramidRelocator {
+    double relax;
+    pyramidRelocator(double r) : relax(r) {}
+    void operator()(MVertex *v, const std::vector<MElement *> &lt) const
+    {
+      _relocateVertexOfPyramid(v, lt, relax);
+    }
+  };
+} // namespace
+
 void RelocateVertices(GFace *gf, int niter, double tol)
 {
   if(!niter) return;
@@ -419,36 +453,30 @@ void RelocateVertices(GFace *gf, int niter, double tol)
   std::set<MVertex *> vs;
   getAllBoundaryLayerVertices(gf, vs);
 
-  v2t_cont adj;
-  buildVertexToElement(gf->triangles, adj);
-  buildVertexToElement(gf->quadrangles, adj);
-  for(int i = 0; i < niter; i++) {
-    v2t_cont::iterator it = adj.begin();
-    while(it != adj.end()) {
-      if(vs.find(it->first) == vs.end()) {
-        _relocateVertex(gf, it->first, it->second, tol);
-      }
-      ++it;
-    }
-  }
+  v2t_coloring adj;
+  adj.add(gf->triangles);
+  adj.add(gf->quadrangles);
+  adj.build();
+  faceRelocator relocate(gf, vs, tol);
+  // OpenCASCADE surface queries are not thread-safe
+  const bool parallel = (gf->getNativeType() != GEntity::OpenCascadeModel);
+  for(int i = 0; i < niter; i++) adj.sweep(relocate, parallel);
 }
 
 void RelocateVertices(GRegion *region, int niter, double tol)
 {
   if(!niter) return;
 
-  v2t_cont adj;
-  buildVertexToElement(region->tetrahedra, adj);
-  buildVertexToElement(region->pyramids, adj);
-  buildVertexToElement(region->prisms, adj);
-  buildVertexToElement(region->hexahedra, adj);
+  v2t_coloring adj;
+  adj.add(region->tetrahedra);
+  adj.add(region->pyramids);
+  adj.add(region->prisms);
+  adj.add(region->hexahedra);
+  adj.build();
   for(int i = 0; i < niter + 2; i++) {
-    v2t_cont::iterator it = adj.begin();
     double relax = std::min((double)(i + 1) / niter, 1.0);
-    while(it != adj.end()) {
-      _relocateVertexGolden(it->first, it->second, relax, tol);
-      ++it;
-    }
+    goldenRelocator relocate(relax, tol);
+    adj.sweep(relocate);
   }
 }
 
@@ -492,29 +520,22 @@ void RelocateVerticesOfPyramids(GRegion *region, int niter, double tol)
     }
   }
 
-  v2t_cont adj;
-  // buildVertexToElement(region->tetrahedra, adj);
-  buildVertexToElement(_tets, adj);
-  buildVertexToElement(region->pyramids, adj);
-  buildVertexToElement(region->prisms, adj);
-  buildVertexToElement(region->hexahedra, adj);
+  v2t_coloring adj;
+  adj.add(_tets);
+  adj.add(region->pyramids);
+  adj.add(region->prisms);
+  adj.add(region->hexahedra);
+  adj.build();
 
   for(int i = 0; i < 10; i++) {
     double X = (double)(i + 1) / 10.;
-    v2t_cont::iterator it = adj.begin();
-    while(it != adj.end()) {
-      _relocateVertexOfPyramid(it->first, it->second, X);
-      ++it;
-    }
+    pyramidRelocator relocate(X);
+    adj.sweep(relocate);
   }
-  //  return;
   for(int i = 0; i < niter + 2; i++) {
-    v2t_cont::iterator it = adj.begin();
     double relax = std::min((double)(i + 1) / niter, 1.0);
-    while(it != adj.end()) {
-      _relocateVertexGolden(it->first, it->second, relax, tol);
-      ++it;
-    }
+    goldenRelocator relocate(relax, tol);
+    adj.sweep(relocate);
   }
 }
 
@@ -3,269 +3,216 @@
 // See the LICENSE.txt file for license information. Please report all
 // issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
-#include "SBoundingBox3d.h"
-#include "MVertex.h"
-
-struct HilbertSort {
-  // The code for generating table transgc
-  // from: http://graphics.stanford.edu/~seander/bithacks.html.
-  int transgc[8][3][8];
-  int tsb1mod3[8];
-  int maxDepth;
-  int Limit;
-  SBoundingBox3d bbox;
-  void ComputeGrayCode(int n);
-  int Split(MVertex **vertices, int arraysize, int GrayCode0, int GrayCode1,
-            double BoundingBoxXmin, double BoundingBoxXmax,
-            double BoundingBoxYmin, double BoundingBoxYmax,
-            double BoundingBoxZmin, double BoundingBoxZmax);
-  void Sort(MVertex **vertices, int arraysize, int e, int d,
-            double BoundingBoxXmin, double BoundingBoxXmax,
-            double BoundingBoxYmin, double BoundingBoxYmax,
-            double BoundingBoxZmin, double BoundingBoxZmax, int depth);
-  HilbertSort(int m = 0, int l = 2) : maxDepth(m), Limit(l)
-  {
-    ComputeGrayCode(3);
-  }
-  void MultiscaleSortHilbert(MVertex **vertices, int arraysize, int threshold,
-                             double ratio, int *depth)
-  {
-    int middle;
-
-    middle = 0;
-    if(arraysize >= threshold) {
-      (*depth)++;
-      middle = (int)(arraysize * ratio);
-      MultiscaleSortHilbert(vertices, middle, threshold, ratio, depth);
-    }
-    Sort(&(vertices[middle]), arraysize - middle, 0, 0, bbox.min().x(),
-         bbox.max().x(), bbox.min().y(), bbox.max().y(), bbox.min().z(),
-         bbox.max().z(), 0);
-  }
-  void Apply(std::vector<MVertex *> &v)
-  {
-    for(size_t i = 0; i < v.size(); i++) {
-      MVertex *pv = v[i];
-      bbox += SPoint3(pv->x(), pv->y(), pv->z());
+#include <algorithm>
+#include <cfloat>
+#include "GmshMessage.h"
+#include "HilbertCurve.h"
+
+namespace {
+
+  // Hilbert curve state machine. The state of the curve in an octree cell is
+  // given by its entry point e and its direction d; for each state, the 8
+  // children of the cell are visited in the order given by transgc, and each
+  // child has its own state. The tables are the ones of the recursive
+  // partitioning of Tetgen 1.5.
+  struct HilbertTables {
+    int transgc[8][3][8];
+    int tsb1mod3[8];
+    // rank along the curve of the child with octant bits c (x: 1, y: 2, z: 4)
+    unsigned char rank[8][3][8];
+    // state of the w-th child
+    unsigned char nextE[8][3][8], nextD[8][3][8];
+    HilbertTables()
+    {
+      // The code for generating table transgc
+      // from: http://graphics.stanford.edu/~seander/bithacks.html.
+      const int n = 3, N = 8, mask = 7;
+      int gc[8];
+      for(int i = 0; i < N; i++) gc[i] = i ^ (i >> 1);
+      for(int e = 0; e < N; e++) {
+        for(int d = 0; d < n; d++) {
+          const int f = e ^ (1 << d);
+          const int travel_bit = e ^ f;
+          for(int i = 0; i < N; i++) {
+            const int k = gc[i] * (travel_bit * 2);
+            const int g = ((k | (k / N)) & mask);
+            transgc[e][d][i] = (g ^ e);
+          }
+        }
+      }
+      // count the consecutive '1' bits (trailing) on the right
+      tsb1mod3[0] = 0;
+      for(int i = 1; i < N; i++) {
+        int v = ~i;
+        v = (v ^ (v - 1)) >> 1;
+        int c;
+        for(c = 0; v; c++) { v >>= 1; }
+        tsb1mod3[i] = c % n;
+      }
+      for(int e = 0; e < N; e++) {
+        for(int d = 0; d < n; d++) {
+          for(int w = 0; w < N; w++) {
+            rank[e][d][transgc[e][d][w]] = w;
+            int e_w, k;
+            if(w == 0) { e_w = 0; }
+            else {
+              k = 2 * ((w - 1) / 2);
+              e_w = k ^ (k >> 1);
+            }
+            k = e_w;
+            e_w = ((k << (d + 1)) & mask) | ((k >> (n - d - 1)) & mask);
+            int d_w;
+            if(w == 0) { d_w = 0; }
+            else {
+              d_w = ((w % 2) == 0) ? tsb1mod3[w - 1] : tsb1mod3[w];
+            }
+            nextE[e][d][w] = e ^ e_w;
+            nextD[e][d][w] = (d + d_w + 1) % n;
+          }
+        }
+      }
     }
-    bbox *= 1.01;
-    MVertex **pv = &v[0];
-    int depth;
-    MultiscaleSortHilbert(pv, (int)v.size(), 10, 0.125, &depth);
-  }
-};
+  };
 
-void HilbertSort::ComputeGrayCode(int n)
-{
-  int gc[8], N, mask, travel_bit;
-  int e, d, f, k, g;
-  int v, c;
-  int i;
+  const int numLevels = 21;
 
-  N = (n == 2) ? 4 : 8;
-  mask = (n == 2) ? 3 : 7;
+} // namespace
 
-  // Generate the Gray code sequence.
-  for(i = 0; i < N; i++) { gc[i] = i ^ (i >> 1); }
-
-  for(e = 0; e < N; e++) {
-    for(d = 0; d < n; d++) {
-      // Calculate the end point (f).
-      f = e ^ (1 << d); // Toggle the d-th bit of 'e'.
-      // travel_bit = 2**p, the bit we want to travel.
-      travel_bit = e ^ f;
-      for(i = 0; i < N; i++) {
-        // // Rotate gc[i] left by (p + 1) % n bits.
-        k = gc[i] * (travel_bit * 2);
-        g = ((k | (k / N)) & mask);
-        // Calculate the permuted Gray code by xor with the start point (e).
-        transgc[e][d][i] = (g ^ e);
-      }
-      //      assert(transgc[e][d][0] == e);
-      //      assert(transgc[e][d][N - 1] == f);
-    } // d
-  } // e
-
-  // Count the consecutive '1' bits (trailing) on the right.
-  tsb1mod3[0] = 0;
-  for(i = 1; i < N; i++) {
-    v = ~i; // Count the 0s.
-    v = (v ^ (v - 1)) >> 1; // Set v's trailing 0s to 1s and zero rest
-    for(c = 0; v; c++) { v >>= 1; }
-    tsb1mod3[i] = c % n;
-  }
-}
-
-int HilbertSort::Split(MVertex **vertices, int arraysize, int GrayCode0,
-                       int GrayCode1, double BoundingBoxXmin,
-                       double BoundingBoxXmax, double BoundingBoxYmin,
-                       double BoundingBoxYmax, double BoundingBoxZmin,
-                       double BoundingBoxZmax)
+void HilbertCurve::computeKeys(std::size_t n, const double *xyz,
+                               uint64_t *keys)
 {
-  MVertex *swapvert;
-  int axis, d;
-  double split;
-  int i, j;
-
-  // Find the current splitting axis. 'axis' is a value 0, or 1, or 2, which
-  //   correspoding to x-, or y- or z-axis.
-  axis = (GrayCode0 ^ GrayCode1) >> 1;
-
-  // Calulate the split position along the axis.
-  if(axis == 0) { split = 0.5 * (BoundingBoxXmin + BoundingBoxXmax); }
-  else if(axis == 1) {
-    split = 0.5 * (BoundingBoxYmin + BoundingBoxYmax);
-  }
-  else { // == 2
-    split = 0.5 * (BoundingBoxZmin + BoundingBoxZmax);
-  }
-
-  // Find the direction (+1 or -1) of the axis. If 'd' is +1, the direction
-  //   of the axis is to the positive of the axis, otherwise, it is -1.
-  d = ((GrayCode0 & (1 << axis)) == 0) ? 1 : -1;
-
-  // Partition the vertices into left- and right-arrays such that left points
-  //   have Hilbert indices lower than the right points.
-  i = 0;
-  j = arraysize - 1;
+  static const HilbertTables tables;
 
-  // Partition the vertices into left- and right-arrays.
-  if(d > 0) {
-    do {
-      for(; i < arraysize; i++) {
-        if(vertices[i]->point()[axis] >= split) break;
+  double bmin[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+  double bmax[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+  {
+    double lmin[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+    double lmax[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for(int i = 0; i < (int)n; i++) {
+      for(int j = 0; j < 3; j++) {
+        lmin[j] = std::min(lmin[j], xyz[3 * i + j]);
+        lmax[j] = std::max(lmax[j], xyz[3 * i + j]);
       }
-      for(; j >= 0; j--) {
-        if(vertices[j]->point()[axis] < split) break;
+    }
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+    {
+      for(int j = 0; j < 3; j++) {
+        bmin[j] = std::min(bmin[j], lmin[j]);
+        bmax[j] = std::max(bmax[j], lmax[j]);
       }
-      // Is the partition finished?
-      if(i >= (j + 1)) break;
-      // Swap i-th and j-th vertices.
-      swapvert = vertices[i];
-      vertices[i] = vertices[j];
-      vertices[j] = swapvert;
-      // Continue patitioning the array;
-    } while(true);
+    }
   }
-  else {
-    do {
-      for(; i < arraysize; i++) {
-        if(vertices[i]->point()[axis] <= split) break;
-      }
-      for(; j >= 0; j--) {
-        if(vertices[j]->point()[axis] > split) break;
-      }
-      // Is the partition finished?
-      if(i >= (j + 1)) break;
-      // Swap i-th and j-th vertices.
-      swapvert = vertices[i];
-      vertices[i] = vertices[j];
-      vertices[j] = swapvert;
-      // Continue patitioning the array;
-    } while(true);
+
+  // enlarge the box by 1% and map it on [0, 2^numLevels)
+  double scale[3];
+  const double cells = (double)(1 << numLevels);
+  for(int j = 0; j < 3; j++) {
+    const double c = 0.5 * (bmin[j] + bmax[j]);
+    const double h = 0.5 * 1.01 * (bmax[j] - bmin[j]);
+    bmin[j] = c - h;
+    scale[j] = (h > 0.) ? cells / (2. * h) : 0.;
   }
 
-  return i;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < (int)n; i++) {
+    unsigned int q[3];
+    for(int j = 0; j < 3; j++) {
+      const double s = (xyz[3 * i + j] - bmin[j]) * scale[j];
+      q[j] = (s <= 0.) ? 0 : std::min((unsigned int)s, (1u << numLevels) - 1);
+    }
+    uint64_t key = 0;
+    int e = 0, d = 0;
+    for(int l = numLevels - 1; l >= 0; l--) {
+      const int c = ((q[0] >> l) & 1) | (((q[1] >> l) & 1) << 1) |
+                    (((q[2] >> l) & 1) << 2);
+      const int w = tables.rank[e][d][c];
+      key = (key << 3) | (uint64_t)w;
+      const int ei = tables.nextE[e][d][w];
+      d = tables.nextD[e][d][w];
+      e = ei;
+    }
+    keys[i] = key;
+  }
 }
 
-// The sorting code is inspired by Tetgen 1.5
-
-void HilbertSort::Sort(MVertex **vertices, int arraysize, int e, int d,
-                       double BoundingBoxXmin, double BoundingBoxXmax,
-                       double BoundingBoxYmin, double BoundingBoxYmax,
-                       double BoundingBoxZmin, double BoundingBoxZmax,
-                       int depth)
+void HilbertCurve::sortKeys(std::size_t n, uint64_t *keys, std::size_t *values)
 {
-  double x1, x2, y1, y2, z1, z2;
-  int p[9], w, e_w, d_w, k, ei, di;
-  int n = 3, mask = 7;
-
-  p[0] = 0;
-  p[8] = arraysize;
-
-  p[4] = Split(vertices, p[8], transgc[e][d][3], transgc[e][d][4],
-               BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin,
-               BoundingBoxYmax, BoundingBoxZmin, BoundingBoxZmax);
-  p[2] = Split(vertices, p[4], transgc[e][d][1], transgc[e][d][2],
-               BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin,
-               BoundingBoxYmax, BoundingBoxZmin, BoundingBoxZmax);
-  p[1] = Split(vertices, p[2], transgc[e][d][0], transgc[e][d][1],
-               BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin,
-               BoundingBoxYmax, BoundingBoxZmin, BoundingBoxZmax);
-  p[3] =
-    Split(&(vertices[p[2]]), p[4] - p[2], transgc[e][d][2], transgc[e][d][3],
-          BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin, BoundingBoxYmax,
-          BoundingBoxZmin, BoundingBoxZmax) +
-    p[2];
-  p[6] =
-    Split(&(vertices[p[4]]), p[8] - p[4], transgc[e][d][5], transgc[e][d][6],
-          BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin, BoundingBoxYmax,
-          BoundingBoxZmin, BoundingBoxZmax) +
-    p[4];
-  p[5] =
-    Split(&(vertices[p[4]]), p[6] - p[4], transgc[e][d][4], transgc[e][d][5],
-          BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin, BoundingBoxYmax,
-          BoundingBoxZmin, BoundingBoxZmax) +
-    p[4];
-  p[7] =
-    Split(&(vertices[p[6]]), p[8] - p[6], transgc[e][d][6], transgc[e][d][7],
-          BoundingBoxXmin, BoundingBoxXmax, BoundingBoxYmin, BoundingBoxYmax,
-          BoundingBoxZmin, BoundingBoxZmax) +
-    p[6];
-
-  if(maxDepth > 0) {
-    if((depth + 1) == maxDepth) { return; }
-  }
-
-  // Recursively sort the points in sub-boxes.
-  for(w = 0; w < 8; w++) {
-    if((p[w + 1] - p[w]) > Limit) {
-      if(w == 0) { e_w = 0; }
-      else {
-        k = 2 * ((w - 1) / 2);
-        e_w = k ^ (k >> 1);
-      }
-      k = e_w;
-      e_w = ((k << (d + 1)) & mask) | ((k >> (n - d - 1)) & mask);
-      ei = e ^ e_w;
-      if(w == 0) { d_w = 0; }
-      else {
-        d_w = ((w % 2) == 0) ? tsb1mod3[w - 1] : tsb1mod3[w];
-      }
-      di = (d + d_w + 1) % n;
-      if(transgc[e][d][w] & 1) {
-        x1 = 0.5 * (BoundingBoxXmin + BoundingBoxXmax);
-        x2 = BoundingBoxXmax;
-      }
-      else {
-        x1 = BoundingBoxXmin;
-        x2 = 0.5 * (BoundingBoxXmin + BoundingBoxXmax);
-      }
-      if(transgc[e][d][w] & 2) { // y-axis
-        y1 = 0.5 * (BoundingBoxYmin + BoundingBoxYmax);
-        y2 = BoundingBoxYmax;
-      }
-      else {
-        y1 = BoundingBoxYmin;
-        y2 = 0.5 * (BoundingBoxYmin + BoundingBoxYmax);
+  if(n < 2) return;
+
+  // least significant digit radix sort, 8 bits at a time: each thread counts
+  // the digits of its chunk of the array, and scatters its chunk at the
+  // offsets computed from all the counts, which keeps the sort stable
+  const int radix = 256;
+  const int maxThreads = (n < 65536) ? 1 : Msg::GetMaxThreads();
+  std::vector<std::size_t> count(maxThreads * radix);
+  std::vector<uint64_t> keys2(n);
+  std::vector<std::size_t> values2(n);
+  uint64_t *k0 = keys, *k1 = &keys2[0];
+  std::size_t *v0 = values, *v1 = &values2[0];
+  bool skip = false;
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(maxThreads)
+#endif
+  {
+    const int nt = Msg::GetNumThreads();
+    const int t = Msg::GetThreadNum();
+    const std::size_t b = n * t / nt, e = n * (t + 1) / nt;
+    std::size_t *c = &count[t * radix];
+    for(int shift = 0; shift < 3 * numLevels; shift += 8) {
+      for(int i = 0; i < radix; i++) c[i] = 0;
+      for(std::size_t i = b; i < e; i++) c[(k0[i] >> shift) & (radix - 1)]++;
+#if defined(_OPENMP)
+#pragma omp barrier
+#pragma omp single
+#endif
+      {
+        // skip the pass if all the keys have the same digit
+        skip = false;
+        std::size_t offset = 0;
+        for(int i = 0; i < radix; i++) {
+          std::size_t total = 0;
+          for(int j = 0; j < nt; j++) {
+            const std::size_t cnt = count[j * radix + i];
+            count[j * radix + i] = offset;
+            offset += cnt;
+            total += cnt;
+          }
+          if(total == n) skip = true;
+        }
       }
-      if(transgc[e][d][w] & 4) { // z-axis
-        z1 = 0.5 * (BoundingBoxZmin + BoundingBoxZmax);
-        z2 = BoundingBoxZmax;
+      if(!skip) {
+        for(std::size_t i = b; i < e; i++) {
+          const std::size_t dst = c[(k0[i] >> shift) & (radix - 1)]++;
+          k1[dst] = k0[i];
+          v1[dst] = v0[i];
+        }
       }
-      else {
-        z1 = BoundingBoxZmin;
-        z2 = 0.5 * (BoundingBoxZmin + BoundingBoxZmax);
+#if defined(_OPENMP)
+#pragma omp barrier
+#pragma omp single
+#endif
+      {
+        if(!skip) {
+          std::swap(k0, k1);
+          std::swap(v0, v1);
+        }
       }
-      Sort(&(vertices[p[w]]), p[w + 1] - p[w], ei, di, x1, x2, y1, y2, z1, z2,
-           depth + 1);
     }
   }
-}
 
-void SortHilbert(std::vector<MVertex *> &v)
-{
-  HilbertSort h(1000);
-  // HilbertSort h;
-  h.Apply(v);
+  if(k0 != keys) {
+    std::copy(k0, k0 + n, keys);
+    std::copy(v0, v0 + n, values);
+  }
 }
@@ -6,6 +6,71 @@
 #ifndef HILBERT_CURVE
 #define HILBERT_CURVE
 
-void SortHilbert(std::vector<MVertex *> &);
+#include <vector>
+#include <stdint.h>
+
+// Spatial sort of point sets along a Hilbert curve, used to order the points
+// before Delaunay insertion. A 63-bit Hilbert key (21 levels of octree
+// subdivision of the bounding box) is computed independently for each point,
+// and the keys are then sorted with a radix sort; both steps are done in
+// parallel. The curve is the same as the one of the recursive partitioning
+// used in Tetgen 1.5.
+
+namespace HilbertCurve {
+  // compute the Hilbert keys of the n points xyz[3 * i], xyz[3 * i + 1],
+  // xyz[3 * i + 2], relative to their (slightly enlarged) bounding box
+  void computeKeys(std::size_t n, const double *xyz, uint64_t *keys);
+  // sort the n keys in increasing order, applying the same permutation to
+  // values; the sort is stable
+  void sortKeys(std::size_t n, uint64_t *keys, std::size_t *values);
+} // namespace HilbertCurve
+
+// Sort the vertices (any type with x(), y() and z() members) with the
+// multiscale "biased randomized insertion order" (BRIO): the array is split
+// into rounds of increasing size (each round being 8 times larger than the
+// previous one, the first one having less than threshold vertices), and each
+// round is sorted along the Hilbert curve. If rounds is provided, it is filled
+// with the start index of each round, followed by v.size().
+template <class T>
+void SortHilbert(std::vector<T *> &v, std::vector<int> *rounds = 0,
+                 int threshold = 10)
+{
+  if(rounds) rounds->clear();
+  if(v.empty()) return;
+  const std::size_t n = v.size();
+
+  std::vector<double> xyz(3 * n);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < (int)n; i++) {
+    xyz[3 * i] = v[i]->x();
+    xyz[3 * i + 1] = v[i]->y();
+    xyz[3 * i + 2] = v[i]->z();
+  }
+  std::vector<uint64_t> keys(n);
+  HilbertCurve::computeKeys(n, &xyz[0], &keys[0]);
+
+  // start indices of the rounds
+  std::vector<std::size_t> start(1, n);
+  std::size_t size = n;
+  while(size >= (std::size_t)threshold) {
+    size = (std::size_t)(size * 0.125);
+    start.push_back(size);
+  }
+  start.push_back(0);
+
+  std::vector<std::size_t> perm(n);
+  for(std::size_t i = 0; i < n; i++) perm[i] = i;
+  for(std::size_t r = start.size() - 1; r > 0; r--) {
+    const std::size_t b = start[r], e = start[r - 1];
+    if(rounds) rounds->push_back((int)b);
+    if(e > b) HilbertCurve::sortKeys(e - b, &keys[b], &perm[b]);
+  }
+  if(rounds) rounds->push_back((int)n);
+
+  std::vector<T *> tmp(v);
+  for(std::size_t i = 0; i < n; i++) v[i] = tmp[perm[i]];
+}
 
 #endif
@@ -130,10 +130,16 @@ template <> void fullMatrix<std::complex<double> >::scale(const double s)
   F77NAME(zscal)(&N, &ss, _data, &stride);
 }
 
+// BLAS calls have a significant overhead for very small matrices: those are
+// handled by the fixed-size kernels from smallMatrix.h
+
 template <>
 void fullMatrix<double>::mult(const fullMatrix<double> &b,
                               fullMatrix<double> &c) const
 {
+  if(_r == _c && _c == b._c &&
+     smallMatrixKernels::gemmSquare(_r, _data, b._data, c._data, 1., 0.))
+    return;
   int M = c.size1(), N = c.size2(), K = _c;
   int LDA = _r, LDB = b.size1(), LDC = c.size1();
   double alpha = 1., beta = 0.;
@@ -160,6 +166,10 @@ void fullMatrix<double>::gemm(const fullMatrix<double> &a,
                               const fullMatrix<double> &b, double alpha,
                               double beta, bool transposeA, bool transposeB)
 {
+  if(a._r == a._c && b._r == b._c && a._r == b._r && _r == a._r &&
+     smallMatrixKernels::gemmSquare(_r, a._data, b._data, _data, alpha, beta,
+                                    transposeA, transposeB))
+    return;
   int M = size1(), N = size2(), K = transposeA ? a.size1() : a.size2();
   int LDA = a.size1(), LDB = b.size1(), LDC = size1();
   F77NAME(dgemm)
@@ -376,7 +386,6 @@ bool fullMatrix<double>::luSubstitute(const fullVector<double> &rhs,
 template <> bool fullMatrix<double>::invert(fullMatrix<double> &result) const
 {
   int M = size1(), N = size2(), lda = size1(), info;
-  int *ipiv = new int[std::min(M, N)];
   if(result.size2() != M || result.size1() != N) {
     if(result._own_data || !result._data)
       result.resize(M, N, false);
@@ -385,6 +394,12 @@ template <> bool fullMatrix<double>::invert(fullMatrix<double> &result) const
       return false;
     }
   }
+  bool ok = false;
+  if(M == N && smallMatrixKernels::invertSquare(M, _data, result._data, ok)) {
+    if(!ok) Msg::Warning("Singular matrix in matrix inversion");
+    return ok;
+  }
+  int *ipiv = new int[std::min(M, N)];
   result.setAll(*this);
   F77NAME(dgetrf)(&M, &N, result._data, &lda, ipiv, &info);
   if(info == 0) {
@@ -406,6 +421,17 @@ template <> bool fullMatrix<double>::invert(fullMatrix<double> &result) const
 template <> bool fullMatrix<double>::invertInPlace()
 {
   int N = size1(), nrhs = N, lda = N, ldb = N, info;
+  double tmp[16];
+  bool ok = false;
+  if(N == size2() && N <= 4 &&
+     smallMatrixKernels::invertSquare(N, _data, tmp, ok)) {
+    if(!ok) {
+      Msg::Warning("Singular matrix in matrix in place inversion");
+      return false;
+    }
+    memcpy(_data, tmp, N * N * sizeof(double));
+    return true;
+  }
   int *ipiv = new int[N];
   double *invA = new double[N * N];
 
@@ -428,11 +454,15 @@ template <> bool fullMatrix<double>::invertInPlace()
 
 template <> double fullMatrix<double>::determinant() const
 {
+  double det;
+  if(size1() == size2() &&
+     smallMatrixKernels::determinantSquare(size1(), _data, det))
+    return det;
   fullMatrix<double> tmp(*this);
   int M = size1(), N = size2(), lda = size1(), info;
   int *ipiv = new int[std::min(M, N)];
   F77NAME(dgetrf)(&M, &N, tmp._data, &lda, ipiv, &info);
-  double det = 1.;
+  det = 1.;
   if(info == 0) {
     for(int i = 0; i < size1(); i++) {
       det *= tmp(i, i);
@@ -468,134 +498,39 @@ bool fullMatrix<double>::svd(fullMatrix<double> &V, fullVector<double> &S)
 
 #else
 
-// Provide a default implementation of the matrix inversion
-// Bad algorithms but it allows to use
-// the polynomial basis without having lapack
+// Default implementation of the determinant and of the matrix inversion,
+// through the LU factorization with partial pivoting from fullMatrix.h
 template <> double fullMatrix<double>::determinant() const
 {
-  if(_r == 2)
-    return (*this)(0, 0) * (*this)(1, 1) - (*this)(0, 1) * (*this)(1, 0);
-  else if(_r == 3) {
-    double det = ((*this)(0, 0) * (*this)(1, 1) * (*this)(2, 2) +
-                  (*this)(0, 1) * (*this)(1, 2) * (*this)(2, 0) +
-                  (*this)(0, 2) * (*this)(1, 0) * (*this)(2, 1));
-    det -= (*this)(0, 0) * (*this)(1, 2) * (*this)(2, 1);
-    det -= (*this)(0, 1) * (*this)(1, 0) * (*this)(2, 2);
-    det -= (*this)(0, 2) * (*this)(1, 1) * (*this)(2, 0);
-    return det;
-  }
-  else if(_r == 4) {
-    std::vector<fullMatrix<double> > temp(4, fullMatrix<double>(3, 3));
-    for(int k = 0; k < 4; k++) {
-      for(int i = 1; i < 4; i++) {
-        int j1 = 0;
-        for(int j = 0; j < 4; j++) {
-          if(k != j) temp[k](i - 1, j1++) = (*this)(i, j);
-        }
-      }
-    }
-    return ((*this)(0, 0) * temp[0].determinant() -
-            (*this)(0, 1) * temp[1].determinant() +
-            (*this)(0, 2) * temp[2].determinant() -
-            (*this)(0, 3) * temp[3].determinant());
-  }
-  else if(_r == 5) {
-    std::vector<fullMatrix<double> > temp(5, fullMatrix<double>(4, 4));
-    for(int k = 0; k < 5; k++) {
-      for(int i = 1; i < 5; i++) {
-        int j1 = 0;
-        for(int j = 0; j < 5; j++) {
-          if(k != j) temp[k](i - 1, j1++) = (*this)(i, j);
-        }
-      }
-    }
-    return ((*this)(0, 0) * temp[0].determinant() -
-            (*this)(0, 1) * temp[1].determinant() +
-            (*this)(0, 2) * temp[2].determinant() -
-            (*this)(0, 3) * temp[3].determinant() +
-            (*this)(0, 4) * temp[4].determinant());
-  }
-  else {
-    std::vector<fullMatrix<double> > temp(_r,
-                                          fullMatrix<double>(_r - 1, _r - 1));
-    for(int k = 0; k < _r; k++) {
-      for(int i = 1; i < _r; i++) {
-        int j1 = 0;
-        for(int j = 0; j < _r; j++) {
-          if(k != j) temp[k](i - 1, j1++) = (*this)(i, j);
-        }
-      }
-    }
-    double det = 0;
-    for(int k = 0; k < _r; k += 2) {
-      det += (*this)(0, k) * temp[k].determinant();
-    }
-    for(int k = 1; k < _r; k += 2) {
-      det -= (*this)(0, k) * temp[k].determinant();
-    }
-    return det;
+  double det;
+  if(_r != _c) return 0.;
+  if(smallMatrixKernels::determinantSquare(_r, _data, det)) return det;
+  fullMatrix<double> lu(*this);
+  fullVector<int> ipiv(_r);
+  if(!lu._luFactorNaive(ipiv.getDataPtr())) return 0.;
+  det = 1.;
+  for(int i = 0; i < _r; i++) {
+    det *= lu(i, i);
+    if(ipiv(i) != i + 1) det = -det;
   }
-  return (*this)(0, 0); // 1x1 matrix
+  return det;
 }
 
 template <> bool fullMatrix<double>::invert(fullMatrix<double> &result) const
 {
   if(_r != _c) return false;
-
-  // Copy the matrix
-  result.resize(_r, _c);
-
-  // to find out Determinant
-  double det = this->determinant();
-
-  if(det == 0) return false;
-
-  // Matrix of cofactor put this in a function?
-  fullMatrix<double> cofactor(_r, _c);
-  if(_r == 2) {
-    cofactor(0, 0) = (*this)(1, 1);
-    cofactor(0, 1) = -(*this)(1, 0);
-    cofactor(1, 0) = -(*this)(0, 1);
-    cofactor(1, 1) = (*this)(0, 0);
-  }
-  else if(_r >= 3) {
-    std::vector<std::vector<fullMatrix<double> > > temp(
-      _r,
-      std::vector<fullMatrix<double> >(_r, fullMatrix<double>(_r - 1, _r - 1)));
-    for(int k1 = 0; k1 < _r; k1++) {
-      for(int k2 = 0; k2 < _r; k2++) {
-        int i1 = 0;
-        for(int i = 0; i < _r; i++) {
-          int j1 = 0;
-          for(int j = 0; j < _r; j++) {
-            if(k1 != i && k2 != j) temp[k1][k2](i1, j1++) = (*this)(i, j);
-          }
-          if(k1 != i) i1++;
-        }
-      }
-    }
-    bool flagPositive;
-    for(int k1 = 0; k1 < _r; k1++) {
-      flagPositive = (k1 % 2) == 0 ? true : false;
-      for(int k2 = 0; k2 < _r; k2++) {
-        if(flagPositive) {
-          cofactor(k1, k2) = temp[k1][k2].determinant();
-          flagPositive = false;
-        }
-        else {
-          cofactor(k1, k2) = -temp[k1][k2].determinant();
-          flagPositive = true;
-        }
-      }
+  if(result.size1() != _r || result.size2() != _c) {
+    if(result._own_data || !result._data)
+      result.resize(_r, _c, false);
+    else {
+      Msg::Error("FullMatrix: Bad dimension, I cannot write in proxy");
+      return false;
     }
   }
-  // end cofactor
-
-  // inv = transpose of cofactor / Determinant
-  for(int i = 0; i < _r; i++) {
-    for(int j = 0; j < _c; j++) { result(j, i) = cofactor(i, j) / det; }
-  }
-  return true;
+  bool ok = false;
+  if(smallMatrixKernels::invertSquare(_r, _data, result._data, ok)) return ok;
+  result.setAll(*this);
+  return result.invertInPlace();
 }
 
 #endif
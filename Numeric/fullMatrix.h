@@ -11,6 +11,8 @@
 #include <cmath>
 #include <cstdio>
 #include <complex>
+#include <algorithm>
+#include "smallMatrix.h"
 
 template <class scalar> class fullMatrix;
 
@@ -420,6 +422,41 @@ private:
   scalar *_data; // pointer on the first element
   friend class fullVector<scalar>;
 
+  // in-place LU factorization with partial pivoting and the corresponding
+  // substitution, used when Lapack is not available (ipiv follows the Lapack
+  // convention, i.e. is 1-based)
+  bool _luFactorNaive(int *ipiv)
+  {
+    for(int k = 0; k < std::min(_r, _c); k++) {
+      int p = k;
+      for(int i = k + 1; i < _r; i++)
+        if(std::abs((*this)(i, k)) > std::abs((*this)(p, k))) p = i;
+      ipiv[k] = p + 1;
+      if((*this)(p, k) == scalar(0.)) return false;
+      if(p != k)
+        for(int j = 0; j < _c; j++) std::swap((*this)(k, j), (*this)(p, j));
+      const scalar d = scalar(1.) / (*this)(k, k);
+      for(int i = k + 1; i < _r; i++) (*this)(i, k) *= d;
+      for(int j = k + 1; j < _c; j++) {
+        const scalar f = (*this)(k, j);
+        if(f == scalar(0.)) continue;
+        for(int i = k + 1; i < _r; i++) (*this)(i, j) -= (*this)(i, k) * f;
+      }
+    }
+    return true;
+  }
+  void _luSubstituteNaive(const int *ipiv, scalar *x) const
+  {
+    for(int i = 0; i < _r; i++)
+      if(ipiv[i] - 1 != i) std::swap(x[i], x[ipiv[i] - 1]);
+    for(int j = 0; j < _r; j++)
+      for(int i = j + 1; i < _r; i++) x[i] -= (*this)(i, j) * x[j];
+    for(int j = _r - 1; j >= 0; j--) {
+      x[j] /= (*this)(j, j);
+      for(int i = 0; i < j; i++) x[i] -= (*this)(i, j) * x[j];
+    }
+  }
+
 public:
   // constructor and destructor
   fullMatrix(scalar *original, int r, int c)
@@ -609,11 +646,17 @@ public:
   }
   void mult_naive(const fullMatrix<scalar> &b, fullMatrix<scalar> &c) const
   {
+    if(_r == _c && _c == b._c &&
+       smallMatrixKernels::gemmSquare(_r, _data, b._data, c._data, scalar(1.),
+                                      scalar(0.)))
+      return;
     c.scale(scalar(0.));
-    for(int i = 0; i < _r; i++)
-      for(int j = 0; j < b.size2(); j++)
-        for(int k = 0; k < _c; k++)
-          c._data[i + _r * j] += (*this)(i, k) * b(k, j);
+    for(int j = 0; j < b.size2(); j++)
+      for(int k = 0; k < _c; k++) {
+        const scalar bkj = b(k, j);
+        for(int i = 0; i < _r; i++)
+          c._data[i + _r * j] += _data[i + _r * k] * bkj;
+      }
   }
   void mult(const fullMatrix<scalar> &b, fullMatrix<scalar> &c) const
 #if !defined(HAVE_BLAS)
@@ -637,17 +680,31 @@ public:
   void gemm_naive(const fullMatrix<scalar> &a, const fullMatrix<scalar> &b,
                   scalar alpha = 1., scalar beta = 1.)
   {
-    fullMatrix<scalar> temp(a.size1(), b.size2());
-    a.mult_naive(b, temp);
-    temp.scale(alpha);
-    scale(beta);
-    add(temp);
+    if(a._r == a._c && a._c == b._c && _r == a._r &&
+       smallMatrixKernels::gemmSquare(_r, a._data, b._data, _data, alpha, beta))
+      return;
+    for(int j = 0; j < _c; j++) {
+      scalar *cj = _data + _r * j;
+      if(beta == scalar(0.))
+        for(int i = 0; i < _r; i++) cj[i] = scalar(0.);
+      else if(beta != scalar(1.))
+        for(int i = 0; i < _r; i++) cj[i] *= beta;
+      for(int k = 0; k < a._c; k++) {
+        const scalar f = alpha * b(k, j);
+        const scalar *ak = a._data + a._r * k;
+        for(int i = 0; i < _r; i++) cj[i] += ak[i] * f;
+      }
+    }
   }
   void gemm(const fullMatrix<scalar> &a, const fullMatrix<scalar> &b,
             scalar alpha = 1., scalar beta = 1., bool transposeA = false,
             bool transposeB = false)
 #if !defined(HAVE_BLAS)
   {
+    if(a._r == a._c && b._r == b._c && a._r == b._r && _r == a._r &&
+       smallMatrixKernels::gemmSquare(_r, a._data, b._data, _data, alpha, beta,
+                                      transposeA, transposeB))
+      return;
     gemm_naive(transposeA ? a.transpose() : a, transposeB ? b.transpose() : b,
                alpha, beta);
   }
@@ -697,16 +754,16 @@ public:
 #if !defined(HAVE_BLAS)
   {
     y.scale(scalar(0.));
-    for(int i = 0; i < _r; i++)
-      for(int j = 0; j < _c; j++) y._data[i] += (*this)(i, j) * x(j);
+    for(int j = 0; j < _c; j++)
+      for(int i = 0; i < _r; i++) y._data[i] += _data[i + _r * j] * x(j);
   }
 #endif
   ;
   void multAddy(const fullVector<scalar> &x, fullVector<scalar> &y) const
 #if !defined(HAVE_BLAS)
   {
-    for(int i = 0; i < _r; i++)
-      for(int j = 0; j < _c; j++) y._data[i] += (*this)(i, j) * x(j);
+    for(int j = 0; j < _c; j++)
+      for(int i = 0; i < _r; i++) y._data[i] += _data[i + _r * j] * x(j);
   }
 #endif
   ;
@@ -735,16 +792,19 @@ public:
   bool luSolve(const fullVector<scalar> &rhs, fullVector<scalar> &result)
 #if !defined(HAVE_LAPACK)
   {
-    Msg::Error("LU factorization and substitution requires LAPACK");
-    return false;
+    fullVector<int> ipiv(_r);
+    if(!_luFactorNaive(ipiv.getDataPtr())) return false;
+    for(int i = 0; i < _r; i++) result(i) = rhs(i);
+    _luSubstituteNaive(ipiv.getDataPtr(), result.getDataPtr());
+    return true;
   }
 #endif
   ;
   bool luFactor(fullVector<int> &ipiv)
 #if !defined(HAVE_LAPACK)
   {
-    Msg::Error("LU factorization requires LAPACK");
-    return false;
+    ipiv.resize(std::min(_r, _c));
+    return _luFactorNaive(ipiv.getDataPtr());
   }
 #endif
   ;
@@ -752,16 +812,26 @@ public:
                     fullVector<scalar> &result)
 #if !defined(HAVE_LAPACK)
   {
-    Msg::Error("LU substitution requires LAPACK");
-    return false;
+    for(int i = 0; i < _r; i++) result(i) = rhs(i);
+    _luSubstituteNaive(ipiv.getDataPtr(), result.getDataPtr());
+    return true;
   }
 #endif
   ;
   bool invertInPlace()
 #if !defined(HAVE_LAPACK)
   {
-    Msg::Error("Matrix inversion requires LAPACK");
-    return false;
+    fullMatrix<scalar> lu(*this);
+    fullVector<int> ipiv(_r);
+    if(_r != _c || !lu._luFactorNaive(ipiv.getDataPtr())) {
+      Msg::Warning("Singular matrix in matrix in place inversion");
+      return false;
+    }
+    for(int j = 0; j < _c; j++) {
+      for(int i = 0; i < _r; i++) (*this)(i, j) = scalar(i == j ? 1. : 0.);
+      lu._luSubstituteNaive(ipiv.getDataPtr(), _data + _r * j);
+    }
+    return true;
   }
 #endif
   ;
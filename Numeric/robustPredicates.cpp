@@ -4846,4 +4846,75 @@ REAL orient4d(REAL* pa, REAL* pb, REAL* pc, REAL* pd, REAL* pe,
                        aheight, bheight, cheight, dheight, eheight, permanent);
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  Batched orient3d (added for Gmsh).                                       */
+/*                                                                           */
+/*  Query i is evaluated on the points pa[i], pb[i], pc[i] and on the point  */
+/*  pd shared by all the queries. The floating-point filter of the adaptive  */
+/*  predicate is first evaluated on a whole block of queries, in straight-   */
+/*  line code; the adaptive exact evaluation is then only called for the     */
+/*  queries whose sign is uncertain. Signs are identical to those of the     */
+/*  single-query predicate.                                                  */
+/*                                                                           */
+/*  When the static filter is enabled (as in Gmsh's 3D Delaunay kernel), it  */
+/*  is used alone in the first pass, which avoids computing the permanent.   */
+/*                                                                           */
+/*****************************************************************************/
+
+#define BATCH_SIZE 64
+
+static inline REAL orient3ddet(REAL *a, REAL *b, REAL *c, REAL *d)
+{
+  REAL adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+  REAL ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+  REAL adz = a[2] - d[2], bdz = b[2] - d[2], cdz = c[2] - d[2];
+  return adz * (bdx * cdy - cdx * bdy)
+       + bdz * (cdx * ady - adx * cdy)
+       + cdz * (adx * bdy - bdx * ady);
+}
+
+void orient3d(int n, REAL **pa, REAL **pb, REAL **pc, REAL *pd, REAL *result)
+{
+  int uncertain[BATCH_SIZE];
+  for (int start = 0; start < n; start += BATCH_SIZE) {
+    int end = (n < start + BATCH_SIZE) ? n : start + BATCH_SIZE;
+    int nu = 0;
+    if (_use_static_filter) {
+      for (int i = start; i < end; i++) {
+        REAL det = orient3ddet(pa[i], pb[i], pc[i], pd);
+        result[i] = det;
+        uncertain[nu] = i;
+        nu += (Absolute(det) <= o3dstaticfilter);
+      }
+    }
+    else {
+      for (int i = start; i < end; i++) {
+        REAL *a = pa[i], *b = pb[i], *c = pc[i], *d = pd;
+        REAL adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+        REAL ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+        REAL adz = a[2] - d[2], bdz = b[2] - d[2], cdz = c[2] - d[2];
+        REAL bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        REAL cdxady = cdx * ady, adxcdy = adx * cdy;
+        REAL adxbdy = adx * bdy, bdxady = bdx * ady;
+        REAL det = adz * (bdxcdy - cdxbdy)
+                 + bdz * (cdxady - adxcdy)
+                 + cdz * (adxbdy - bdxady);
+        REAL permanent = (Absolute(bdxcdy) + Absolute(cdxbdy)) * Absolute(adz)
+                       + (Absolute(cdxady) + Absolute(adxcdy)) * Absolute(bdz)
+                       + (Absolute(adxbdy) + Absolute(bdxady)) * Absolute(cdz);
+        result[i] = det;
+        uncertain[nu] = i;
+        nu += (Absolute(det) <= o3derrboundA * permanent);
+      }
+    }
+    for (int k = 0; k < nu; k++) {
+      int i = uncertain[k];
+      result[i] = orient3d(pa[i], pb[i], pc[i], pd);
+    }
+  }
+}
+
+#undef BATCH_SIZE
+
 } // end namespace
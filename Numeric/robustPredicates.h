@@ -13,6 +13,11 @@ namespace robustPredicates {
   double insphere(double *pa, double *pb, double *pc, double *pd, double *pe);
   double orient2d(double *pa, double *pb, double *pc);
   double orient3d(double *pa, double *pb, double *pc, double *pd);
+
+  // batched version: result[i] = orient3d(pa[i], pb[i], pc[i], pd), where
+  // only the uncertain queries go through the adaptive exact evaluation
+  void orient3d(int n, double **pa, double **pb, double **pc, double *pd,
+                double *result);
 } // namespace robustPredicates
 
 #endif
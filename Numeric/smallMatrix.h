@@ -0,0 +1,270 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef SMALL_MATRIX_H
+#define SMALL_MATRIX_H
+
+#include <cmath>
+
+// Kernels for dense matrices whose dimensions are known at compile time
+// (Jacobians, metrics, small element matrices). Matrices are stored
+// column-major, as in fullMatrix: the kernels can thus be applied directly on
+// the data of a fullMatrix, and a fullMatrix proxy can be built on the data of
+// a smallMatrix. All the loops have constant bounds and are fully unrolled by
+// the compiler; there is no heap allocation.
+
+namespace smallMatrixKernels {
+
+  // c = alpha * op(a) * op(b) + beta * c, with op(a) (M x K), op(b) (K x N)
+  // and c (M x N); c is not read if beta == 0
+  template <int M, int N, int K, class scalar>
+  inline void gemm(const scalar *a, const scalar *b, scalar *c, scalar alpha,
+                   scalar beta, bool transposeA = false,
+                   bool transposeB = false)
+  {
+    for(int j = 0; j < N; j++) {
+      scalar s[M];
+      for(int i = 0; i < M; i++) s[i] = scalar(0.);
+      for(int k = 0; k < K; k++) {
+        const scalar bkj = transposeB ? b[j + N * k] : b[k + K * j];
+        if(transposeA)
+          for(int i = 0; i < M; i++) s[i] += a[k + K * i] * bkj;
+        else
+          for(int i = 0; i < M; i++) s[i] += a[i + M * k] * bkj;
+      }
+      if(beta == scalar(0.))
+        for(int i = 0; i < M; i++) c[i + M * j] = alpha * s[i];
+      else
+        for(int i = 0; i < M; i++)
+          c[i + M * j] = alpha * s[i] + beta * c[i + M * j];
+    }
+  }
+
+  // y = alpha * a * x + beta * y, with a (M x N); y is not read if beta == 0
+  template <int M, int N, class scalar>
+  inline void gemv(const scalar *a, const scalar *x, scalar *y, scalar alpha,
+                   scalar beta)
+  {
+    scalar s[M];
+    for(int i = 0; i < M; i++) s[i] = scalar(0.);
+    for(int j = 0; j < N; j++)
+      for(int i = 0; i < M; i++) s[i] += a[i + M * j] * x[j];
+    if(beta == scalar(0.))
+      for(int i = 0; i < M; i++) y[i] = alpha * s[i];
+    else
+      for(int i = 0; i < M; i++) y[i] = alpha * s[i] + beta * y[i];
+  }
+
+  // determinant of a (N x N)
+  template <int N, class scalar> inline scalar determinant(const scalar *a)
+  {
+    // Gaussian elimination with partial pivoting on a copy
+    scalar lu[N * N];
+    for(int i = 0; i < N * N; i++) lu[i] = a[i];
+    scalar det = scalar(1.);
+    for(int k = 0; k < N; k++) {
+      int p = k;
+      for(int i = k + 1; i < N; i++)
+        if(std::abs(lu[i + N * k]) > std::abs(lu[p + N * k])) p = i;
+      if(lu[p + N * k] == scalar(0.)) return scalar(0.);
+      if(p != k) {
+        for(int j = k; j < N; j++) {
+          scalar t = lu[k + N * j];
+          lu[k + N * j] = lu[p + N * j];
+          lu[p + N * j] = t;
+        }
+        det = -det;
+      }
+      det *= lu[k + N * k];
+      for(int i = k + 1; i < N; i++) {
+        const scalar f = lu[i + N * k] / lu[k + N * k];
+        for(int j = k + 1; j < N; j++) lu[i + N * j] -= f * lu[k + N * j];
+      }
+    }
+    return det;
+  }
+  template <> inline double determinant<1, double>(const double *a)
+  {
+    return a[0];
+  }
+  template <> inline double determinant<2, double>(const double *a)
+  {
+    return a[0] * a[3] - a[2] * a[1];
+  }
+  template <> inline double determinant<3, double>(const double *a)
+  {
+    return a[0] * (a[4] * a[8] - a[7] * a[5]) -
+           a[3] * (a[1] * a[8] - a[7] * a[2]) +
+           a[6] * (a[1] * a[5] - a[4] * a[2]);
+  }
+
+  // inverse of a (N x N); returns false if a is singular
+  template <int N, class scalar> inline bool invert(const scalar *a, scalar *inv)
+  {
+    // Gauss-Jordan elimination with partial pivoting
+    scalar m[N * N];
+    for(int i = 0; i < N * N; i++) {
+      m[i] = a[i];
+      inv[i] = scalar(0.);
+    }
+    for(int i = 0; i < N; i++) inv[i + N * i] = scalar(1.);
+    for(int k = 0; k < N; k++) {
+      int p = k;
+      for(int i = k + 1; i < N; i++)
+        if(std::abs(m[i + N * k]) > std::abs(m[p + N * k])) p = i;
+      if(m[p + N * k] == scalar(0.)) return false;
+      if(p != k) {
+        for(int j = 0; j < N; j++) {
+          scalar t = m[k + N * j];
+          m[k + N * j] = m[p + N * j];
+          m[p + N * j] = t;
+          t = inv[k + N * j];
+          inv[k + N * j] = inv[p + N * j];
+          inv[p + N * j] = t;
+        }
+      }
+      const scalar d = scalar(1.) / m[k + N * k];
+      for(int j = 0; j < N; j++) {
+        m[k + N * j] *= d;
+        inv[k + N * j] *= d;
+      }
+      for(int i = 0; i < N; i++) {
+        if(i == k) continue;
+        const scalar f = m[i + N * k];
+        if(f == scalar(0.)) continue;
+        for(int j = 0; j < N; j++) {
+          m[i + N * j] -= f * m[k + N * j];
+          inv[i + N * j] -= f * inv[k + N * j];
+        }
+      }
+    }
+    return true;
+  }
+  template <> inline bool invert<1, double>(const double *a, double *inv)
+  {
+    if(a[0] == 0.) return false;
+    inv[0] = 1. / a[0];
+    return true;
+  }
+  template <> inline bool invert<2, double>(const double *a, double *inv)
+  {
+    const double det = determinant<2>(a);
+    if(det == 0.) return false;
+    const double ud = 1. / det;
+    inv[0] = a[3] * ud;
+    inv[1] = -a[1] * ud;
+    inv[2] = -a[2] * ud;
+    inv[3] = a[0] * ud;
+    return true;
+  }
+  template <> inline bool invert<3, double>(const double *a, double *inv)
+  {
+    const double det = determinant<3>(a);
+    if(det == 0.) return false;
+    const double ud = 1. / det;
+    inv[0] = (a[4] * a[8] - a[7] * a[5]) * ud;
+    inv[1] = -(a[1] * a[8] - a[7] * a[2]) * ud;
+    inv[2] = (a[1] * a[5] - a[4] * a[2]) * ud;
+    inv[3] = -(a[3] * a[8] - a[6] * a[5]) * ud;
+    inv[4] = (a[0] * a[8] - a[6] * a[2]) * ud;
+    inv[5] = -(a[0] * a[5] - a[3] * a[2]) * ud;
+    inv[6] = (a[3] * a[7] - a[6] * a[4]) * ud;
+    inv[7] = -(a[0] * a[7] - a[6] * a[1]) * ud;
+    inv[8] = (a[0] * a[4] - a[3] * a[1]) * ud;
+    return true;
+  }
+
+  // runtime dispatch on the size of square matrices, used by fullMatrix;
+  // these return false if there is no specialized kernel for n
+  template <class scalar>
+  inline bool gemmSquare(int n, const scalar *a, const scalar *b, scalar *c,
+                         scalar alpha, scalar beta, bool transposeA = false,
+                         bool transposeB = false)
+  {
+    switch(n) {
+    case 1: gemm<1, 1, 1>(a, b, c, alpha, beta, transposeA, transposeB); break;
+    case 2: gemm<2, 2, 2>(a, b, c, alpha, beta, transposeA, transposeB); break;
+    case 3: gemm<3, 3, 3>(a, b, c, alpha, beta, transposeA, transposeB); break;
+    case 4: gemm<4, 4, 4>(a, b, c, alpha, beta, transposeA, transposeB); break;
+    default: return false;
+    }
+    return true;
+  }
+  template <class scalar>
+  inline bool determinantSquare(int n, const scalar *a, scalar &det)
+  {
+    switch(n) {
+    case 1: det = determinant<1>(a); break;
+    case 2: det = determinant<2>(a); break;
+    case 3: det = determinant<3>(a); break;
+    case 4: det = determinant<4>(a); break;
+    default: return false;
+    }
+    return true;
+  }
+  // ok is set to false if the matrix is singular
+  template <class scalar>
+  inline bool invertSquare(int n, const scalar *a, scalar *inv, bool &ok)
+  {
+    switch(n) {
+    case 1: ok = invert<1>(a, inv); break;
+    case 2: ok = invert<2>(a, inv); break;
+    case 3: ok = invert<3>(a, inv); break;
+    case 4: ok = invert<4>(a, inv); break;
+    default: return false;
+    }
+    return true;
+  }
+
+} // namespace smallMatrixKernels
+
+// A dense R x C matrix of scalar stored on the stack.
+template <int R, int C, class scalar = double> class smallMatrix {
+private:
+  scalar _data[R * C];
+
+public:
+  smallMatrix() { setAll(scalar(0.)); }
+  inline int size1() const { return R; }
+  inline int size2() const { return C; }
+  inline scalar operator()(int i, int j) const { return _data[i + R * j]; }
+  inline scalar &operator()(int i, int j) { return _data[i + R * j]; }
+  inline const scalar *getDataPtr() const { return _data; }
+  inline scalar *getDataPtr() { return _data; }
+  inline void setAll(const scalar &m)
+  {
+    for(int i = 0; i < R * C; i++) _data[i] = m;
+  }
+  // c = this * b
+  template <int N>
+  inline void mult(const smallMatrix<C, N, scalar> &b,
+                   smallMatrix<R, N, scalar> &c) const
+  {
+    smallMatrixKernels::gemm<R, N, C>(_data, b.getDataPtr(), c.getDataPtr(),
+                                      scalar(1.), scalar(0.));
+  }
+  // y = this * x
+  inline void mult(const scalar *x, scalar *y) const
+  {
+    smallMatrixKernels::gemv<R, C>(_data, x, y, scalar(1.), scalar(0.));
+  }
+  inline smallMatrix<C, R, scalar> transpose() const
+  {
+    smallMatrix<C, R, scalar> t;
+    for(int i = 0; i < R; i++)
+      for(int j = 0; j < C; j++) t(j, i) = (*this)(i, j);
+    return t;
+  }
+  inline scalar determinant() const
+  {
+    return smallMatrixKernels::determinant<R>(_data);
+  }
+  inline bool invert(smallMatrix<R, C, scalar> &inv) const
+  {
+    return smallMatrixKernels::invert<R>(_data, inv.getDataPtr());
+  }
+};
+
+#endif
@@ -7562,11 +7562,14 @@ yyreduce:
   case 87:
 #line 809 "Gmsh.y"
     {
-      if(!gmsh_yysymbols.count((yyvsp[(1) - (4)].c)) && (yyvsp[(2) - (4)].i) && List_Nbr((yyvsp[(3) - (4)].l)) == 1){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find((yyvsp[(1) - (4)].c));
+      if(it == gmsh_yysymbols.end() && (yyvsp[(2) - (4)].i) && List_Nbr((yyvsp[(3) - (4)].l)) == 1){
         yymsg(0, "Unknown variable '%s'", (yyvsp[(1) - (4)].c));
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(1) - (4)].c)]);
+        if(it == gmsh_yysymbols.end())
+          it = gmsh_yysymbols.insert(std::make_pair(std::string((yyvsp[(1) - (4)].c)), gmsh_yysymbol())).first;
+        gmsh_yysymbol &s(it->second);
         if(!(yyvsp[(2) - (4)].i)) s.list = (List_Nbr((yyvsp[(3) - (4)].l)) != 1); // list if 0 or > 1 elements
         if(!s.list){ // single expression
           if(List_Nbr((yyvsp[(3) - (4)].l)) != 1){
@@ -7625,12 +7628,13 @@ yyreduce:
     break;
 
   case 88:
-#line 871 "Gmsh.y"
+#line 874 "Gmsh.y"
     {
-      if(!gmsh_yysymbols.count((yyvsp[(1) - (3)].c)))
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find((yyvsp[(1) - (3)].c));
+      if(it == gmsh_yysymbols.end())
 	yymsg(0, "Unknown variable '%s'", (yyvsp[(1) - (3)].c));
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(1) - (3)].c)]);
+        gmsh_yysymbol &s(it->second);
         if(!s.list && s.value.empty())
           yymsg(0, "Uninitialized variable '%s'", (yyvsp[(1) - (3)].c));
         else if(!s.list)
@@ -7643,7 +7647,7 @@ yyreduce:
     break;
 
   case 89:
-#line 886 "Gmsh.y"
+#line 890 "Gmsh.y"
     {
       gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(1) - (6)].c)]);
       s.list = true;
@@ -7675,7 +7679,7 @@ yyreduce:
     break;
 
   case 90:
-#line 915 "Gmsh.y"
+#line 919 "Gmsh.y"
     {
       assignVariables((yyvsp[(1) - (9)].c), (yyvsp[(4) - (9)].l), (yyvsp[(7) - (9)].i), (yyvsp[(8) - (9)].l));
       Free((yyvsp[(1) - (9)].c));
@@ -7685,7 +7689,7 @@ yyreduce:
     break;
 
   case 91:
-#line 925 "Gmsh.y"
+#line 929 "Gmsh.y"
     {
       assignVariable((yyvsp[(1) - (7)].c), (int)(yyvsp[(3) - (7)].d), (yyvsp[(5) - (7)].i), (yyvsp[(6) - (7)].d));
       Free((yyvsp[(1) - (7)].c));
@@ -7693,7 +7697,7 @@ yyreduce:
     break;
 
   case 92:
-#line 930 "Gmsh.y"
+#line 934 "Gmsh.y"
     {
       incrementVariable((yyvsp[(1) - (6)].c), (int)(yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].i));
       Free((yyvsp[(1) - (6)].c));
@@ -7701,7 +7705,7 @@ yyreduce:
     break;
 
   case 93:
-#line 938 "Gmsh.y"
+#line 942 "Gmsh.y"
     {
       assignVariable((yyvsp[(1) - (7)].c), (int)(yyvsp[(3) - (7)].d), (yyvsp[(5) - (7)].i), (yyvsp[(6) - (7)].d));
       Free((yyvsp[(1) - (7)].c));
@@ -7709,7 +7713,7 @@ yyreduce:
     break;
 
   case 94:
-#line 943 "Gmsh.y"
+#line 947 "Gmsh.y"
     {
       incrementVariable((yyvsp[(1) - (6)].c), (yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].i));
       Free((yyvsp[(1) - (6)].c));
@@ -7717,7 +7721,7 @@ yyreduce:
     break;
 
   case 95:
-#line 951 "Gmsh.y"
+#line 955 "Gmsh.y"
     {
       gmsh_yystringsymbols[(yyvsp[(1) - (4)].c)] = std::vector<std::string>(1, (yyvsp[(3) - (4)].c));
       Free((yyvsp[(1) - (4)].c));
@@ -7726,7 +7730,7 @@ yyreduce:
     break;
 
   case 96:
-#line 960 "Gmsh.y"
+#line 964 "Gmsh.y"
     {
       gmsh_yystringsymbols[(yyvsp[(1) - (8)].c)] = std::vector<std::string>();
       Free((yyvsp[(1) - (8)].c));
@@ -7734,7 +7738,7 @@ yyreduce:
     break;
 
   case 97:
-#line 965 "Gmsh.y"
+#line 969 "Gmsh.y"
     {
       std::vector<std::string> s;
       for(int i = 0; i < List_Nbr((yyvsp[(7) - (9)].l)); i++){
@@ -7749,7 +7753,7 @@ yyreduce:
     break;
 
   case 98:
-#line 977 "Gmsh.y"
+#line 981 "Gmsh.y"
     {
       if(gmsh_yystringsymbols.count((yyvsp[(1) - (9)].c))){
         for(int i = 0; i < List_Nbr((yyvsp[(7) - (9)].l)); i++){
@@ -7766,7 +7770,7 @@ yyreduce:
     break;
 
   case 99:
-#line 994 "Gmsh.y"
+#line 998 "Gmsh.y"
     {
       std::string tmp((yyvsp[(5) - (6)].c));
       StringOption(GMSH_SET|GMSH_GUI, (yyvsp[(1) - (6)].c), 0, (yyvsp[(3) - (6)].c), tmp);
@@ -7775,7 +7779,7 @@ yyreduce:
     break;
 
   case 100:
-#line 1000 "Gmsh.y"
+#line 1004 "Gmsh.y"
     {
       std::string tmp((yyvsp[(8) - (9)].c));
       StringOption(GMSH_SET|GMSH_GUI, (yyvsp[(1) - (9)].c), (int)(yyvsp[(3) - (9)].d), (yyvsp[(6) - (9)].c), tmp);
@@ -7784,7 +7788,7 @@ yyreduce:
     break;
 
   case 101:
-#line 1009 "Gmsh.y"
+#line 1013 "Gmsh.y"
     {
       double d = 0.;
       if(NumberOption(GMSH_GET, (yyvsp[(1) - (6)].c), 0, (yyvsp[(3) - (6)].c), d)){
@@ -7805,7 +7809,7 @@ yyreduce:
     break;
 
   case 102:
-#line 1027 "Gmsh.y"
+#line 1031 "Gmsh.y"
     {
       double d = 0.;
       if(NumberOption(GMSH_GET, (yyvsp[(1) - (9)].c), (int)(yyvsp[(3) - (9)].d), (yyvsp[(6) - (9)].c), d)){
@@ -7826,7 +7830,7 @@ yyreduce:
     break;
 
   case 103:
-#line 1045 "Gmsh.y"
+#line 1049 "Gmsh.y"
     {
       double d = 0.;
       if(NumberOption(GMSH_GET, (yyvsp[(1) - (5)].c), 0, (yyvsp[(3) - (5)].c), d)){
@@ -7838,7 +7842,7 @@ yyreduce:
     break;
 
   case 104:
-#line 1054 "Gmsh.y"
+#line 1058 "Gmsh.y"
     {
       double d = 0.;
       if(NumberOption(GMSH_GET, (yyvsp[(1) - (8)].c), (int)(yyvsp[(3) - (8)].d), (yyvsp[(6) - (8)].c), d)){
@@ -7850,7 +7854,7 @@ yyreduce:
     break;
 
   case 105:
-#line 1066 "Gmsh.y"
+#line 1070 "Gmsh.y"
     {
       ColorOption(GMSH_SET|GMSH_GUI, (yyvsp[(1) - (8)].c), 0, (yyvsp[(5) - (8)].c), (yyvsp[(7) - (8)].u));
       Free((yyvsp[(1) - (8)].c)); Free((yyvsp[(5) - (8)].c));
@@ -7858,7 +7862,7 @@ yyreduce:
     break;
 
   case 106:
-#line 1071 "Gmsh.y"
+#line 1075 "Gmsh.y"
     {
       ColorOption(GMSH_SET|GMSH_GUI, (yyvsp[(1) - (11)].c), (int)(yyvsp[(3) - (11)].d), (yyvsp[(8) - (11)].c), (yyvsp[(10) - (11)].u));
       Free((yyvsp[(1) - (11)].c)); Free((yyvsp[(8) - (11)].c));
@@ -7866,7 +7870,7 @@ yyreduce:
     break;
 
   case 107:
-#line 1079 "Gmsh.y"
+#line 1083 "Gmsh.y"
     {
       GmshColorTable *ct = GetColorTable(0);
       if(!ct)
@@ -7889,7 +7893,7 @@ yyreduce:
     break;
 
   case 108:
-#line 1099 "Gmsh.y"
+#line 1103 "Gmsh.y"
     {
       GmshColorTable *ct = GetColorTable((int)(yyvsp[(3) - (9)].d));
       if(!ct)
@@ -7912,7 +7916,7 @@ yyreduce:
     break;
 
   case 109:
-#line 1122 "Gmsh.y"
+#line 1126 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(4) - (5)].l), tags);
@@ -7935,7 +7939,7 @@ yyreduce:
     break;
 
   case 110:
-#line 1142 "Gmsh.y"
+#line 1146 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       if(!GModel::current()->getFields()->newField((int)(yyvsp[(3) - (7)].d), (yyvsp[(6) - (7)].c)))
@@ -7946,7 +7950,7 @@ yyreduce:
     break;
 
   case 111:
-#line 1150 "Gmsh.y"
+#line 1154 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       Field *field = GModel::current()->getFields()->get((int)(yyvsp[(3) - (9)].d));
@@ -7971,7 +7975,7 @@ yyreduce:
     break;
 
   case 112:
-#line 1172 "Gmsh.y"
+#line 1176 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       Field *field = GModel::current()->getFields()->get((int)(yyvsp[(3) - (9)].d));
@@ -7997,7 +8001,7 @@ yyreduce:
     break;
 
   case 113:
-#line 1195 "Gmsh.y"
+#line 1199 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       Field *field = GModel::current()->getFields()->get((int)(yyvsp[(3) - (11)].d));
@@ -8038,7 +8042,7 @@ yyreduce:
     break;
 
   case 114:
-#line 1233 "Gmsh.y"
+#line 1237 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       Field *field = GModel::current()->getFields()->get((int)(yyvsp[(3) - (7)].d));
@@ -8059,7 +8063,7 @@ yyreduce:
     break;
 
   case 115:
-#line 1254 "Gmsh.y"
+#line 1258 "Gmsh.y"
     {
 #if defined(HAVE_PLUGINS)
       try {
@@ -8074,7 +8078,7 @@ yyreduce:
     break;
 
   case 116:
-#line 1266 "Gmsh.y"
+#line 1270 "Gmsh.y"
     {
 #if defined(HAVE_PLUGINS)
       try {
@@ -8089,7 +8093,7 @@ yyreduce:
     break;
 
   case 120:
-#line 1284 "Gmsh.y"
+#line 1288 "Gmsh.y"
     {
       std::string key((yyvsp[(3) - (3)].c));
       std::vector<double> val(1, 0.);
@@ -8101,7 +8105,7 @@ yyreduce:
     break;
 
   case 121:
-#line 1293 "Gmsh.y"
+#line 1297 "Gmsh.y"
     {
       std::string key((yyvsp[(3) - (5)].c));
       std::vector<double> val(1, (yyvsp[(5) - (5)].d));
@@ -8113,12 +8117,12 @@ yyreduce:
     break;
 
   case 122:
-#line 1302 "Gmsh.y"
+#line 1306 "Gmsh.y"
     { init_options(); ;}
     break;
 
   case 123:
-#line 1304 "Gmsh.y"
+#line 1308 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(6) - (9)].l)) != 1)
 	yymsg(1, "List notation should be used to define list '%s[]'", (yyvsp[(3) - (9)].c));
@@ -8139,12 +8143,12 @@ yyreduce:
     break;
 
   case 124:
-#line 1322 "Gmsh.y"
+#line 1326 "Gmsh.y"
     { init_options(); ;}
     break;
 
   case 125:
-#line 1324 "Gmsh.y"
+#line 1328 "Gmsh.y"
     {
       std::string key((yyvsp[(3) - (11)].c));
       std::vector<double> val;
@@ -8163,7 +8167,7 @@ yyreduce:
     break;
 
   case 126:
-#line 1340 "Gmsh.y"
+#line 1344 "Gmsh.y"
     {
       std::string key((yyvsp[(3) - (5)].c)), val((yyvsp[(5) - (5)].c));
       if(!gmsh_yystringsymbols.count(key)){
@@ -8175,12 +8179,12 @@ yyreduce:
     break;
 
   case 127:
-#line 1349 "Gmsh.y"
+#line 1353 "Gmsh.y"
     { init_options(); ;}
     break;
 
   case 128:
-#line 1351 "Gmsh.y"
+#line 1355 "Gmsh.y"
     {
       std::string key((yyvsp[(3) - (9)].c)), val((yyvsp[(6) - (9)].c));
       if(!gmsh_yystringsymbols.count(key)){
@@ -8193,7 +8197,7 @@ yyreduce:
     break;
 
   case 130:
-#line 1365 "Gmsh.y"
+#line 1369 "Gmsh.y"
     {
       std::string name((yyvsp[(3) - (3)].c));
       Msg::UndefineOnelabParameter(name);
@@ -8202,7 +8206,7 @@ yyreduce:
     break;
 
   case 131:
-#line 1373 "Gmsh.y"
+#line 1377 "Gmsh.y"
     {
       (yyval.l) = List_Create(20,20,sizeof(doubleXstring));
       doubleXstring v = {(yyvsp[(1) - (3)].d), (yyvsp[(3) - (3)].c)};
@@ -8211,7 +8215,7 @@ yyreduce:
     break;
 
   case 132:
-#line 1379 "Gmsh.y"
+#line 1383 "Gmsh.y"
     {
       doubleXstring v = {(yyvsp[(3) - (5)].d), (yyvsp[(5) - (5)].c)};
       List_Add((yyval.l), &v);
@@ -8219,7 +8223,7 @@ yyreduce:
     break;
 
   case 133:
-#line 1384 "Gmsh.y"
+#line 1388 "Gmsh.y"
     {
       (yyval.l) = List_Create(20,20,sizeof(doubleXstring));
       int n = List_Nbr((yyvsp[(1) - (5)].l));
@@ -8247,7 +8251,7 @@ yyreduce:
     break;
 
   case 140:
-#line 1427 "Gmsh.y"
+#line 1431 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       for(int i = 0; i < List_Nbr((yyvsp[(2) - (2)].l)); i++){
@@ -8262,21 +8266,21 @@ yyreduce:
     break;
 
   case 141:
-#line 1439 "Gmsh.y"
+#line 1443 "Gmsh.y"
     {
       floatOptions["Min"].push_back((yyvsp[(2) - (2)].d));
     ;}
     break;
 
   case 142:
-#line 1443 "Gmsh.y"
+#line 1447 "Gmsh.y"
     {
       floatOptions["Max"].push_back((yyvsp[(2) - (2)].d));
     ;}
     break;
 
   case 143:
-#line 1447 "Gmsh.y"
+#line 1451 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (1)].c));
       double v;
@@ -8292,7 +8296,7 @@ yyreduce:
     break;
 
   case 144:
-#line 1460 "Gmsh.y"
+#line 1464 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (4)].c));
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (4)].l)); i++){
@@ -8309,7 +8313,7 @@ yyreduce:
     break;
 
   case 145:
-#line 1474 "Gmsh.y"
+#line 1478 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       std::string val((yyvsp[(2) - (2)].c));
@@ -8320,7 +8324,7 @@ yyreduce:
     break;
 
   case 146:
-#line 1482 "Gmsh.y"
+#line 1486 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       for(int i = 0; i < List_Nbr((yyvsp[(2) - (2)].l)); i++){
@@ -8334,7 +8338,7 @@ yyreduce:
     break;
 
   case 151:
-#line 1507 "Gmsh.y"
+#line 1511 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       double val = (yyvsp[(2) - (2)].d);
@@ -8344,7 +8348,7 @@ yyreduce:
     break;
 
   case 152:
-#line 1515 "Gmsh.y"
+#line 1519 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       std::string val((yyvsp[(2) - (2)].c));
@@ -8355,7 +8359,7 @@ yyreduce:
     break;
 
   case 153:
-#line 1524 "Gmsh.y"
+#line 1528 "Gmsh.y"
     {
       std::string key("Macro");
       std::string val((yyvsp[(2) - (2)].c));
@@ -8365,7 +8369,7 @@ yyreduce:
     break;
 
   case 154:
-#line 1532 "Gmsh.y"
+#line 1536 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       for(int i = 0; i < List_Nbr((yyvsp[(2) - (2)].l)); i++){
@@ -8381,7 +8385,7 @@ yyreduce:
     break;
 
   case 155:
-#line 1546 "Gmsh.y"
+#line 1550 "Gmsh.y"
     {
       std::string key((yyvsp[(1) - (2)].c));
       for(int i = 0; i < List_Nbr((yyvsp[(2) - (2)].l)); i++){
@@ -8397,14 +8401,14 @@ yyreduce:
     break;
 
   case 156:
-#line 1564 "Gmsh.y"
+#line 1568 "Gmsh.y"
     {
       (yyval.i) = (int)(yyvsp[(1) - (1)].d);
     ;}
     break;
 
   case 157:
-#line 1568 "Gmsh.y"
+#line 1572 "Gmsh.y"
     {
       int t = GModel::current()->getGEOInternals()->getMaxPhysicalTag();
       GModel::current()->getGEOInternals()->setMaxPhysicalTag(t + 1);
@@ -8414,7 +8418,7 @@ yyreduce:
     break;
 
   case 158:
-#line 1575 "Gmsh.y"
+#line 1579 "Gmsh.y"
     {
       (yyval.i) = GModel::current()->setPhysicalName(std::string((yyvsp[(1) - (3)].c)), dim_entity, (yyvsp[(3) - (3)].d));
       Free((yyvsp[(1) - (3)].c));
@@ -8422,14 +8426,14 @@ yyreduce:
     break;
 
   case 159:
-#line 1583 "Gmsh.y"
+#line 1587 "Gmsh.y"
     {
       (yyval.l) = 0;
     ;}
     break;
 
   case 160:
-#line 1587 "Gmsh.y"
+#line 1591 "Gmsh.y"
     {
       (yyval.l) = List_Create(1, 1, sizeof(double));
       double p = (yyvsp[(4) - (5)].d);
@@ -8438,14 +8442,14 @@ yyreduce:
     break;
 
   case 161:
-#line 1593 "Gmsh.y"
+#line 1597 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(4) - (5)].l);
     ;}
     break;
 
   case 162:
-#line 1597 "Gmsh.y"
+#line 1601 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       double flag = -1;
@@ -8457,35 +8461,35 @@ yyreduce:
     break;
 
   case 163:
-#line 1608 "Gmsh.y"
+#line 1612 "Gmsh.y"
     {
       for(int i = 0; i < 4; i++) (yyval.v)[i] = 0.;
     ;}
     break;
 
   case 164:
-#line 1612 "Gmsh.y"
+#line 1616 "Gmsh.y"
     {
       for(int i = 0; i < 4; i++) (yyval.v)[i] = (yyvsp[(2) - (2)].v)[i];
     ;}
     break;
 
   case 165:
-#line 1618 "Gmsh.y"
+#line 1622 "Gmsh.y"
     {
       (yyval.d) = 0;
     ;}
     break;
 
   case 166:
-#line 1622 "Gmsh.y"
+#line 1626 "Gmsh.y"
     {
       (yyval.d) = 1;
     ;}
     break;
 
   case 167:
-#line 1628 "Gmsh.y"
+#line 1632 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       double x = CTX::instance()->geom.scalingFactor * (yyvsp[(6) - (7)].v)[0];
@@ -8511,7 +8515,7 @@ yyreduce:
     break;
 
   case 168:
-#line 1651 "Gmsh.y"
+#line 1655 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8530,7 +8534,7 @@ yyreduce:
     break;
 
   case 169:
-#line 1667 "Gmsh.y"
+#line 1671 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8549,7 +8553,7 @@ yyreduce:
     break;
 
   case 170:
-#line 1683 "Gmsh.y"
+#line 1687 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (10)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(7) - (10)].l), tags);
@@ -8569,7 +8573,7 @@ yyreduce:
     break;
 
   case 171:
-#line 1700 "Gmsh.y"
+#line 1704 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (10)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(7) - (10)].l), tags);
@@ -8589,7 +8593,7 @@ yyreduce:
     break;
 
   case 172:
-#line 1717 "Gmsh.y"
+#line 1721 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (8)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (8)].l), tags);
@@ -8629,7 +8633,7 @@ yyreduce:
     break;
 
   case 173:
-#line 1754 "Gmsh.y"
+#line 1758 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (8)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (8)].l), tags);
@@ -8676,7 +8680,7 @@ yyreduce:
     break;
 
   case 174:
-#line 1798 "Gmsh.y"
+#line 1802 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8695,7 +8699,7 @@ yyreduce:
     break;
 
   case 175:
-#line 1814 "Gmsh.y"
+#line 1818 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8714,7 +8718,7 @@ yyreduce:
     break;
 
   case 176:
-#line 1831 "Gmsh.y"
+#line 1835 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (11)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (11)].l), tags);
@@ -8748,7 +8752,7 @@ yyreduce:
     break;
 
   case 177:
-#line 1862 "Gmsh.y"
+#line 1866 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8767,7 +8771,7 @@ yyreduce:
     break;
 
   case 178:
-#line 1878 "Gmsh.y"
+#line 1882 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (8)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(7) - (8)].l), tags);
@@ -8787,7 +8791,7 @@ yyreduce:
     break;
 
   case 179:
-#line 1895 "Gmsh.y"
+#line 1899 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (8)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(7) - (8)].l), tags);
@@ -8806,7 +8810,7 @@ yyreduce:
     break;
 
   case 180:
-#line 1911 "Gmsh.y"
+#line 1915 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (8)].d);
       std::vector<int> wires; ListOfDouble2Vector((yyvsp[(6) - (8)].l), wires);
@@ -8859,7 +8863,7 @@ yyreduce:
     break;
 
   case 181:
-#line 1961 "Gmsh.y"
+#line 1965 "Gmsh.y"
     {
       yymsg(2, "'Ruled Surface' command is deprecated: use 'Surface' instead");
       int num = (int)(yyvsp[(4) - (9)].d);
@@ -8880,7 +8884,7 @@ yyreduce:
     break;
 
   case 182:
-#line 1979 "Gmsh.y"
+#line 1983 "Gmsh.y"
     {
       myGmshSurface = 0;
       (yyval.s).Type = 0;
@@ -8889,7 +8893,7 @@ yyreduce:
     break;
 
   case 183:
-#line 1985 "Gmsh.y"
+#line 1989 "Gmsh.y"
     {
       myGmshSurface = gmshSurface::getSurface((int)(yyvsp[(3) - (4)].d));
       (yyval.s).Type = 0;
@@ -8898,7 +8902,7 @@ yyreduce:
     break;
 
   case 184:
-#line 1991 "Gmsh.y"
+#line 1995 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (10)].d);
       myGmshSurface = gmshParametricSurface::NewParametricSurface(num, (yyvsp[(7) - (10)].c), (yyvsp[(8) - (10)].c), (yyvsp[(9) - (10)].c));
@@ -8908,7 +8912,7 @@ yyreduce:
     break;
 
   case 185:
-#line 1998 "Gmsh.y"
+#line 2002 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8942,7 +8946,7 @@ yyreduce:
     break;
 
   case 186:
-#line 2029 "Gmsh.y"
+#line 2033 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -8960,7 +8964,7 @@ yyreduce:
     break;
 
   case 187:
-#line 2044 "Gmsh.y"
+#line 2048 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -8985,7 +8989,7 @@ yyreduce:
     break;
 
   case 188:
-#line 2066 "Gmsh.y"
+#line 2070 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9011,7 +9015,7 @@ yyreduce:
     break;
 
   case 189:
-#line 2089 "Gmsh.y"
+#line 2093 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9037,7 +9041,7 @@ yyreduce:
     break;
 
   case 190:
-#line 2112 "Gmsh.y"
+#line 2116 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9063,7 +9067,7 @@ yyreduce:
     break;
 
   case 191:
-#line 2135 "Gmsh.y"
+#line 2139 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9090,7 +9094,7 @@ yyreduce:
     break;
 
   case 192:
-#line 2159 "Gmsh.y"
+#line 2163 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9117,7 +9121,7 @@ yyreduce:
     break;
 
   case 193:
-#line 2183 "Gmsh.y"
+#line 2187 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9144,7 +9148,7 @@ yyreduce:
     break;
 
   case 194:
-#line 2207 "Gmsh.y"
+#line 2211 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<double> param; ListOfDouble2Vector((yyvsp[(6) - (7)].l), param);
@@ -9173,7 +9177,7 @@ yyreduce:
     break;
 
   case 195:
-#line 2233 "Gmsh.y"
+#line 2237 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (9)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(7) - (9)].l), tags);
@@ -9193,7 +9197,7 @@ yyreduce:
     break;
 
   case 196:
-#line 2250 "Gmsh.y"
+#line 2254 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (7)].l), tags);
@@ -9212,7 +9216,7 @@ yyreduce:
     break;
 
   case 197:
-#line 2266 "Gmsh.y"
+#line 2270 "Gmsh.y"
     {
       int num = (int)(yyvsp[(3) - (7)].d);
       std::vector<int> wires; ListOfDouble2Vector((yyvsp[(6) - (7)].l), wires);
@@ -9233,7 +9237,7 @@ yyreduce:
     break;
 
   case 198:
-#line 2284 "Gmsh.y"
+#line 2288 "Gmsh.y"
     {
       int num = (int)(yyvsp[(4) - (8)].d);
       std::vector<int> wires; ListOfDouble2Vector((yyvsp[(7) - (8)].l), wires);
@@ -9254,7 +9258,7 @@ yyreduce:
     break;
 
   case 199:
-#line 2302 "Gmsh.y"
+#line 2306 "Gmsh.y"
     {
       if((yyvsp[(2) - (8)].i) == 1)
         yymsg(0, "`Compound Line (...) = {...};' is deprecated: use `Compound "
@@ -9269,7 +9273,7 @@ yyreduce:
     break;
 
   case 200:
-#line 2315 "Gmsh.y"
+#line 2319 "Gmsh.y"
     {
       if((yyvsp[(2) - (12)].i) == 1)
         yymsg(0, "`Compound Line (...) = {...};' is deprecated: use `Compound "
@@ -9284,14 +9288,14 @@ yyreduce:
     break;
 
   case 201:
-#line 2327 "Gmsh.y"
+#line 2331 "Gmsh.y"
     {
       dim_entity = (yyvsp[(2) - (2)].i);
     ;}
     break;
 
   case 202:
-#line 2331 "Gmsh.y"
+#line 2335 "Gmsh.y"
     {
       int num = (int)(yyvsp[(5) - (9)].i);
       int op = (yyvsp[(7) - (9)].i);
@@ -9317,27 +9321,27 @@ yyreduce:
     break;
 
   case 203:
-#line 2357 "Gmsh.y"
+#line 2361 "Gmsh.y"
     { (yyval.i) = 0; ;}
     break;
 
   case 204:
-#line 2359 "Gmsh.y"
+#line 2363 "Gmsh.y"
     { (yyval.i) = 1; ;}
     break;
 
   case 205:
-#line 2361 "Gmsh.y"
+#line 2365 "Gmsh.y"
     { (yyval.i) = 2; ;}
     break;
 
   case 206:
-#line 2363 "Gmsh.y"
+#line 2367 "Gmsh.y"
     { (yyval.i) = 3; ;}
     break;
 
   case 207:
-#line 2365 "Gmsh.y"
+#line 2369 "Gmsh.y"
     {
       (yyval.i) = (int)(yyvsp[(3) - (4)].d);
       if ((yyval.i)<0 || (yyval.i)>3) yymsg(0, "GeoEntity dim out of range [0,3]");
@@ -9345,22 +9349,22 @@ yyreduce:
     break;
 
   case 208:
-#line 2373 "Gmsh.y"
+#line 2377 "Gmsh.y"
     { (yyval.i) = 1; ;}
     break;
 
   case 209:
-#line 2375 "Gmsh.y"
+#line 2379 "Gmsh.y"
     { (yyval.i) = 2; ;}
     break;
 
   case 210:
-#line 2377 "Gmsh.y"
+#line 2381 "Gmsh.y"
     { (yyval.i) = 3; ;}
     break;
 
   case 211:
-#line 2379 "Gmsh.y"
+#line 2383 "Gmsh.y"
     {
       (yyval.i) = (int)(yyvsp[(3) - (4)].d);
       if ((yyval.i)<1 || (yyval.i)>3) yymsg(0, "GeoEntity dim out of range [1,3]");
@@ -9368,17 +9372,17 @@ yyreduce:
     break;
 
   case 212:
-#line 2387 "Gmsh.y"
+#line 2391 "Gmsh.y"
     { (yyval.i) = 1; ;}
     break;
 
   case 213:
-#line 2389 "Gmsh.y"
+#line 2393 "Gmsh.y"
     { (yyval.i) = 2; ;}
     break;
 
   case 214:
-#line 2391 "Gmsh.y"
+#line 2395 "Gmsh.y"
     {
       (yyval.i) = (int)(yyvsp[(3) - (4)].d);
       if ((yyval.i)<1 || (yyval.i)>2) yymsg(0, "GeoEntity dim out of range [1,2]");
@@ -9386,22 +9390,22 @@ yyreduce:
     break;
 
   case 215:
-#line 2399 "Gmsh.y"
+#line 2403 "Gmsh.y"
     { (yyval.i) = 0; ;}
     break;
 
   case 216:
-#line 2401 "Gmsh.y"
+#line 2405 "Gmsh.y"
     { (yyval.i) = 1; ;}
     break;
 
   case 217:
-#line 2403 "Gmsh.y"
+#line 2407 "Gmsh.y"
     { (yyval.i) = 2; ;}
     break;
 
   case 218:
-#line 2405 "Gmsh.y"
+#line 2409 "Gmsh.y"
     {
       (yyval.i) = (int)(yyvsp[(3) - (4)].d);
       if ((yyval.i)<0 || (yyval.i)>2) yymsg(0, "GeoEntity dim out of range [0,2]");
@@ -9409,7 +9413,7 @@ yyreduce:
     break;
 
   case 219:
-#line 2415 "Gmsh.y"
+#line 2419 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -9428,7 +9432,7 @@ yyreduce:
     break;
 
   case 220:
-#line 2431 "Gmsh.y"
+#line 2435 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(10) - (11)].l), dimTags);
@@ -9447,7 +9451,7 @@ yyreduce:
     break;
 
   case 221:
-#line 2447 "Gmsh.y"
+#line 2451 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -9466,7 +9470,7 @@ yyreduce:
     break;
 
   case 222:
-#line 2463 "Gmsh.y"
+#line 2467 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(8) - (9)].l), dimTags);
@@ -9485,7 +9489,7 @@ yyreduce:
     break;
 
   case 223:
-#line 2479 "Gmsh.y"
+#line 2483 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(8) - (9)].l), dimTags);
@@ -9504,7 +9508,7 @@ yyreduce:
     break;
 
   case 224:
-#line 2495 "Gmsh.y"
+#line 2499 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(6) - (7)].l), dimTags);
@@ -9524,7 +9528,7 @@ yyreduce:
     break;
 
   case 225:
-#line 2512 "Gmsh.y"
+#line 2516 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(3) - (4)].l), inDimTags);
@@ -9564,7 +9568,7 @@ yyreduce:
     break;
 
   case 226:
-#line 2549 "Gmsh.y"
+#line 2553 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -9588,7 +9592,7 @@ yyreduce:
     break;
 
   case 227:
-#line 2571 "Gmsh.y"
+#line 2575 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -9612,31 +9616,31 @@ yyreduce:
     break;
 
   case 228:
-#line 2594 "Gmsh.y"
+#line 2598 "Gmsh.y"
     { (yyval.l) = (yyvsp[(1) - (1)].l); ;}
     break;
 
   case 229:
-#line 2595 "Gmsh.y"
+#line 2599 "Gmsh.y"
     { (yyval.l) = (yyvsp[(1) - (1)].l); ;}
     break;
 
   case 230:
-#line 2600 "Gmsh.y"
+#line 2604 "Gmsh.y"
     {
       (yyval.l) = List_Create(3, 3, sizeof(Shape));
     ;}
     break;
 
   case 231:
-#line 2604 "Gmsh.y"
+#line 2608 "Gmsh.y"
     {
       List_Add((yyval.l), &(yyvsp[(2) - (2)].s));
     ;}
     break;
 
   case 232:
-#line 2608 "Gmsh.y"
+#line 2612 "Gmsh.y"
     {
       for(int i = 0; i < List_Nbr((yyvsp[(4) - (6)].l)); i++){
 	double d;
@@ -9656,7 +9660,7 @@ yyreduce:
     break;
 
   case 233:
-#line 2625 "Gmsh.y"
+#line 2629 "Gmsh.y"
     {
       List_T *tmp = List_Create(10, 10, sizeof(double));
       getElementaryTagsForPhysicalGroups((yyvsp[(3) - (7)].i), (yyvsp[(5) - (7)].l), tmp);
@@ -9679,7 +9683,7 @@ yyreduce:
     break;
 
   case 234:
-#line 2645 "Gmsh.y"
+#line 2649 "Gmsh.y"
     {
       List_T *tmp = List_Create(10, 10, sizeof(double));
       getParentTags((yyvsp[(3) - (7)].i), (yyvsp[(5) - (7)].l), tmp);
@@ -9702,7 +9706,7 @@ yyreduce:
     break;
 
   case 235:
-#line 2665 "Gmsh.y"
+#line 2669 "Gmsh.y"
     {
       List_T *tmp = List_Create(10, 10, sizeof(double));
       getAllElementaryTags((yyvsp[(2) - (6)].i), tmp);
@@ -9724,7 +9728,7 @@ yyreduce:
     break;
 
   case 236:
-#line 2684 "Gmsh.y"
+#line 2688 "Gmsh.y"
     {
       List_T *tmp = List_Create(10, 10, sizeof(double));
       List_T *tmp2 = List_Create(10, 10, sizeof(double));
@@ -9749,7 +9753,7 @@ yyreduce:
     break;
 
   case 237:
-#line 2711 "Gmsh.y"
+#line 2715 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(7) - (8)].l)) == 4){
         int t = (int)(yyvsp[(4) - (8)].d);
@@ -9771,7 +9775,7 @@ yyreduce:
     break;
 
   case 238:
-#line 2730 "Gmsh.y"
+#line 2734 "Gmsh.y"
     {
       int t = (int)(yyvsp[(4) - (10)].d);
       if(gLevelset::find(t)){
@@ -9795,7 +9799,7 @@ yyreduce:
     break;
 
   case 239:
-#line 2752 "Gmsh.y"
+#line 2756 "Gmsh.y"
     {
       int t = (int)(yyvsp[(4) - (14)].d);
       if(gLevelset::find(t)){
@@ -9812,7 +9816,7 @@ yyreduce:
     break;
 
   case 240:
-#line 2767 "Gmsh.y"
+#line 2771 "Gmsh.y"
     {
       int t = (int)(yyvsp[(4) - (16)].d);
       if(gLevelset::find(t)){
@@ -9830,7 +9834,7 @@ yyreduce:
     break;
 
   case 241:
-#line 2782 "Gmsh.y"
+#line 2786 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(10) - (12)].l)) == 1){
         int t = (int)(yyvsp[(4) - (12)].d);
@@ -9851,7 +9855,7 @@ yyreduce:
     break;
 
   case 242:
-#line 2801 "Gmsh.y"
+#line 2805 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(12) - (14)].l)) == 1){
         int t = (int)(yyvsp[(4) - (14)].d);
@@ -9904,7 +9908,7 @@ yyreduce:
     break;
 
   case 243:
-#line 2852 "Gmsh.y"
+#line 2856 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(12) - (14)].l)) == 1){
         int t = (int)(yyvsp[(4) - (14)].d);
@@ -9927,7 +9931,7 @@ yyreduce:
     break;
 
   case 244:
-#line 2873 "Gmsh.y"
+#line 2877 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(12) - (14)].l)) == 3){
         int t = (int)(yyvsp[(4) - (14)].d);
@@ -9951,7 +9955,7 @@ yyreduce:
     break;
 
   case 245:
-#line 2895 "Gmsh.y"
+#line 2899 "Gmsh.y"
     {
       if(List_Nbr((yyvsp[(12) - (14)].l)) == 5){
         int t = (int)(yyvsp[(4) - (14)].d);
@@ -9976,7 +9980,7 @@ yyreduce:
     break;
 
   case 246:
-#line 2917 "Gmsh.y"
+#line 2921 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (8)].c), "Union")){
         int t = (int)(yyvsp[(4) - (8)].d);
@@ -10084,7 +10088,7 @@ yyreduce:
     break;
 
   case 247:
-#line 3022 "Gmsh.y"
+#line 3026 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (8)].c), "MathEval")){
         int t = (int)(yyvsp[(4) - (8)].d);
@@ -10103,7 +10107,7 @@ yyreduce:
     break;
 
   case 248:
-#line 3038 "Gmsh.y"
+#line 3042 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (6)].c), "CutMesh")){
         int t = (int)(yyvsp[(4) - (6)].d);
@@ -10136,7 +10140,7 @@ yyreduce:
     break;
 
   case 249:
-#line 3073 "Gmsh.y"
+#line 3077 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(3) - (4)].l), dimTags);
@@ -10161,7 +10165,7 @@ yyreduce:
     break;
 
   case 250:
-#line 3095 "Gmsh.y"
+#line 3099 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -10186,7 +10190,7 @@ yyreduce:
     break;
 
   case 251:
-#line 3117 "Gmsh.y"
+#line 3121 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -10201,7 +10205,7 @@ yyreduce:
     break;
 
   case 252:
-#line 3129 "Gmsh.y"
+#line 3133 "Gmsh.y"
     {
 #if defined(HAVE_MESH)
       GModel::current()->getFields()->deleteField((int)(yyvsp[(4) - (6)].d));
@@ -10210,7 +10214,7 @@ yyreduce:
     break;
 
   case 253:
-#line 3135 "Gmsh.y"
+#line 3139 "Gmsh.y"
     {
 #if defined(HAVE_POST)
       if(!strcmp((yyvsp[(2) - (6)].c), "View")){
@@ -10228,7 +10232,7 @@ yyreduce:
     break;
 
   case 254:
-#line 3150 "Gmsh.y"
+#line 3154 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (3)].c), "Meshes") || !strcmp((yyvsp[(2) - (3)].c), "All")){
         ClearProject();
@@ -10259,7 +10263,7 @@ yyreduce:
     break;
 
   case 255:
-#line 3178 "Gmsh.y"
+#line 3182 "Gmsh.y"
     {
 #if defined(HAVE_POST)
       if(!strcmp((yyvsp[(2) - (4)].c), "Empty") && !strcmp((yyvsp[(3) - (4)].c), "Views")){
@@ -10274,14 +10278,14 @@ yyreduce:
     break;
 
   case 256:
-#line 3190 "Gmsh.y"
+#line 3194 "Gmsh.y"
     {
       gmsh_yynamespaces.clear();
     ;}
     break;
 
   case 257:
-#line 3199 "Gmsh.y"
+#line 3203 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -10291,7 +10295,7 @@ yyreduce:
     break;
 
   case 258:
-#line 3206 "Gmsh.y"
+#line 3210 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(5) - (6)].l), dimTags);
@@ -10301,7 +10305,7 @@ yyreduce:
     break;
 
   case 259:
-#line 3218 "Gmsh.y"
+#line 3222 "Gmsh.y"
     {
       yymsg(2, "'SetPartition' command is deprecated");
       std::vector<std::pair<int, int> > dimTags;
@@ -10319,14 +10323,14 @@ yyreduce:
     break;
 
   case 260:
-#line 3238 "Gmsh.y"
+#line 3242 "Gmsh.y"
     {
       setVisibility(-1, 1, false);
     ;}
     break;
 
   case 261:
-#line 3242 "Gmsh.y"
+#line 3246 "Gmsh.y"
     {
       setVisibility(-1, 1, false);
       Free((yyvsp[(2) - (3)].c));
@@ -10334,14 +10338,14 @@ yyreduce:
     break;
 
   case 262:
-#line 3247 "Gmsh.y"
+#line 3251 "Gmsh.y"
     {
       setVisibility(-1, 0, false);
     ;}
     break;
 
   case 263:
-#line 3251 "Gmsh.y"
+#line 3255 "Gmsh.y"
     {
       setVisibility(-1, 0, false);
       Free((yyvsp[(2) - (3)].c));
@@ -10349,7 +10353,7 @@ yyreduce:
     break;
 
   case 264:
-#line 3256 "Gmsh.y"
+#line 3260 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(3) - (4)].l), dimTags);
@@ -10359,7 +10363,7 @@ yyreduce:
     break;
 
   case 265:
-#line 3263 "Gmsh.y"
+#line 3267 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -10369,7 +10373,7 @@ yyreduce:
     break;
 
   case 266:
-#line 3270 "Gmsh.y"
+#line 3274 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(3) - (4)].l), dimTags);
@@ -10379,7 +10383,7 @@ yyreduce:
     break;
 
   case 267:
-#line 3277 "Gmsh.y"
+#line 3281 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > dimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), dimTags);
@@ -10389,7 +10393,7 @@ yyreduce:
     break;
 
   case 268:
-#line 3289 "Gmsh.y"
+#line 3293 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(1) - (3)].c), "Include")){
         std::string tmp = FixRelativePath(gmsh_yyname, (yyvsp[(2) - (3)].c));
@@ -10465,7 +10469,7 @@ yyreduce:
     break;
 
   case 269:
-#line 3362 "Gmsh.y"
+#line 3366 "Gmsh.y"
     {
       int n = List_Nbr((yyvsp[(3) - (5)].l));
       if(n == 1){
@@ -10486,7 +10490,7 @@ yyreduce:
     break;
 
   case 270:
-#line 3380 "Gmsh.y"
+#line 3384 "Gmsh.y"
     {
 #if defined(HAVE_POST)
       if(!strcmp((yyvsp[(2) - (7)].c), "View")){
@@ -10514,7 +10518,7 @@ yyreduce:
     break;
 
   case 271:
-#line 3405 "Gmsh.y"
+#line 3409 "Gmsh.y"
     {
 #if defined(HAVE_POST) && defined(HAVE_MESH)
       if(!strcmp((yyvsp[(1) - (7)].c), "Background") && !strcmp((yyvsp[(2) - (7)].c), "Mesh")  && !strcmp((yyvsp[(3) - (7)].c), "View")){
@@ -10532,7 +10536,7 @@ yyreduce:
     break;
 
   case 272:
-#line 3420 "Gmsh.y"
+#line 3424 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(1) - (3)].c), "Sleep")){
 	SleepInSeconds((yyvsp[(2) - (3)].d));
@@ -10568,7 +10572,7 @@ yyreduce:
     break;
 
   case 273:
-#line 3453 "Gmsh.y"
+#line 3457 "Gmsh.y"
     {
 #if defined(HAVE_PLUGINS)
        try {
@@ -10583,7 +10587,7 @@ yyreduce:
     break;
 
   case 274:
-#line 3465 "Gmsh.y"
+#line 3469 "Gmsh.y"
     {
 #if defined(HAVE_POST)
       if(!strcmp((yyvsp[(2) - (3)].c), "ElementsFromAllViews"))
@@ -10618,14 +10622,14 @@ yyreduce:
     break;
 
   case 275:
-#line 3497 "Gmsh.y"
+#line 3501 "Gmsh.y"
     {
       Msg::Exit(0);
     ;}
     break;
 
   case 276:
-#line 3501 "Gmsh.y"
+#line 3505 "Gmsh.y"
     {
       gmsh_yyerrorstate = 999; // this will be checked when yyparse returns
       YYABORT;
@@ -10633,7 +10637,7 @@ yyreduce:
     break;
 
   case 277:
-#line 3506 "Gmsh.y"
+#line 3510 "Gmsh.y"
     {
       // force sync
       if(GModel::current()->getOCCInternals())
@@ -10643,7 +10647,7 @@ yyreduce:
     break;
 
   case 278:
-#line 3513 "Gmsh.y"
+#line 3517 "Gmsh.y"
     {
       new GModel();
       GModel::current(GModel::list.size() - 1);
@@ -10651,7 +10655,7 @@ yyreduce:
     break;
 
   case 279:
-#line 3518 "Gmsh.y"
+#line 3522 "Gmsh.y"
     {
       CTX::instance()->forcedBBox = 0;
       if(GModel::current()->getOCCInternals() &&
@@ -10664,7 +10668,7 @@ yyreduce:
     break;
 
   case 280:
-#line 3528 "Gmsh.y"
+#line 3532 "Gmsh.y"
     {
       CTX::instance()->forcedBBox = 1;
       SetBoundingBox((yyvsp[(3) - (15)].d), (yyvsp[(5) - (15)].d), (yyvsp[(7) - (15)].d), (yyvsp[(9) - (15)].d), (yyvsp[(11) - (15)].d), (yyvsp[(13) - (15)].d));
@@ -10672,7 +10676,7 @@ yyreduce:
     break;
 
   case 281:
-#line 3533 "Gmsh.y"
+#line 3537 "Gmsh.y"
     {
 #if defined(HAVE_OPENGL)
       drawContext::global()->draw();
@@ -10681,7 +10685,7 @@ yyreduce:
     break;
 
   case 282:
-#line 3539 "Gmsh.y"
+#line 3543 "Gmsh.y"
     {
 #if defined(HAVE_OPENGL)
      CTX::instance()->mesh.changed = ENT_ALL;
@@ -10692,49 +10696,49 @@ yyreduce:
     break;
 
   case 283:
-#line 3547 "Gmsh.y"
+#line 3551 "Gmsh.y"
     {
       GModel::current()->createTopologyFromMesh();
     ;}
     break;
 
   case 284:
-#line 3551 "Gmsh.y"
+#line 3555 "Gmsh.y"
     {
       GModel::current()->classifySurfaces((yyvsp[(3) - (9)].d), (yyvsp[(5) - (9)].d), (yyvsp[(7) - (9)].d), M_PI);
     ;}
     break;
 
   case 285:
-#line 3555 "Gmsh.y"
+#line 3559 "Gmsh.y"
     {
       GModel::current()->classifySurfaces((yyvsp[(3) - (11)].d), (yyvsp[(5) - (11)].d), (yyvsp[(7) - (11)].d), (yyvsp[(9) - (11)].d));
     ;}
     break;
 
   case 286:
-#line 3559 "Gmsh.y"
+#line 3563 "Gmsh.y"
     {
       GModel::current()->createGeometryOfDiscreteEntities();
     ;}
     break;
 
   case 287:
-#line 3563 "Gmsh.y"
+#line 3567 "Gmsh.y"
     {
       GModel::current()->renumberMeshVertices();
     ;}
     break;
 
   case 288:
-#line 3567 "Gmsh.y"
+#line 3571 "Gmsh.y"
     {
       GModel::current()->renumberMeshElements();
     ;}
     break;
 
   case 289:
-#line 3571 "Gmsh.y"
+#line 3575 "Gmsh.y"
     {
       if(GModel::current()->getOCCInternals() &&
          GModel::current()->getOCCInternals()->getChanged())
@@ -10746,7 +10750,7 @@ yyreduce:
     break;
 
   case 290:
-#line 3581 "Gmsh.y"
+#line 3585 "Gmsh.y"
     {
       int lock = CTX::instance()->lock;
       CTX::instance()->lock = 0;
@@ -10807,7 +10811,7 @@ yyreduce:
     break;
 
   case 291:
-#line 3644 "Gmsh.y"
+#line 3648 "Gmsh.y"
     {
 #if defined(HAVE_POPPLER)
        std::vector<int> is;
@@ -10822,7 +10826,7 @@ yyreduce:
     break;
 
   case 292:
-#line 3660 "Gmsh.y"
+#line 3664 "Gmsh.y"
     {
       LoopControlVariablesTab[ImbricatedLoop][0] = (yyvsp[(3) - (6)].d);
       LoopControlVariablesTab[ImbricatedLoop][1] = (yyvsp[(5) - (6)].d);
@@ -10832,8 +10836,10 @@ yyreduce:
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if((yyvsp[(3) - (6)].d) > (yyvsp[(5) - (6)].d))
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -10842,7 +10848,7 @@ yyreduce:
     break;
 
   case 293:
-#line 3677 "Gmsh.y"
+#line 3683 "Gmsh.y"
     {
       LoopControlVariablesTab[ImbricatedLoop][0] = (yyvsp[(3) - (8)].d);
       LoopControlVariablesTab[ImbricatedLoop][1] = (yyvsp[(5) - (8)].d);
@@ -10852,8 +10858,10 @@ yyreduce:
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if(((yyvsp[(7) - (8)].d) > 0. && (yyvsp[(3) - (8)].d) > (yyvsp[(5) - (8)].d)) || ((yyvsp[(7) - (8)].d) < 0. && (yyvsp[(3) - (8)].d) < (yyvsp[(5) - (8)].d)))
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -10862,7 +10870,7 @@ yyreduce:
     break;
 
   case 294:
-#line 3694 "Gmsh.y"
+#line 3702 "Gmsh.y"
     {
       LoopControlVariablesTab[ImbricatedLoop][0] = (yyvsp[(5) - (8)].d);
       LoopControlVariablesTab[ImbricatedLoop][1] = (yyvsp[(7) - (8)].d);
@@ -10876,8 +10884,10 @@ yyreduce:
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if((yyvsp[(5) - (8)].d) > (yyvsp[(7) - (8)].d))
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -10887,7 +10897,7 @@ yyreduce:
     break;
 
   case 295:
-#line 3716 "Gmsh.y"
+#line 3726 "Gmsh.y"
     {
       LoopControlVariablesTab[ImbricatedLoop][0] = (yyvsp[(5) - (10)].d);
       LoopControlVariablesTab[ImbricatedLoop][1] = (yyvsp[(7) - (10)].d);
@@ -10901,8 +10911,10 @@ yyreduce:
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if(((yyvsp[(9) - (10)].d) > 0. && (yyvsp[(5) - (10)].d) > (yyvsp[(7) - (10)].d)) || ((yyvsp[(9) - (10)].d) < 0. && (yyvsp[(5) - (10)].d) < (yyvsp[(7) - (10)].d)))
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -10912,7 +10924,7 @@ yyreduce:
     break;
 
   case 296:
-#line 3738 "Gmsh.y"
+#line 3750 "Gmsh.y"
     {
       if(ImbricatedLoop <= 0){
 	yymsg(0, "Invalid For/EndFor loop");
@@ -10940,17 +10952,23 @@ yyreduce:
 	double x0 = LoopControlVariablesTab[ImbricatedLoop - 1][0];
 	double x1 = LoopControlVariablesTab[ImbricatedLoop - 1][1];
         if((step > 0. && x0 <= x1) || (step < 0. && x0 >= x1)){
-	  fsetpos(gmsh_yyin, &yyposImbricatedLoopsTab[ImbricatedLoop - 1]);
-	  gmsh_yylineno = yylinenoImbricatedLoopsTab[ImbricatedLoop - 1];
+          // replay the cached tokens of the body, or rewind the file if the
+          // body could not be cached
+          if(!gmsh_yyrepeatloop(ImbricatedLoop - 1)){
+	    fsetpos(gmsh_yyin, &yyposImbricatedLoopsTab[ImbricatedLoop - 1]);
+	    gmsh_yylineno = yylinenoImbricatedLoopsTab[ImbricatedLoop - 1];
+          }
 	}
-	else
+	else{
 	  ImbricatedLoop--;
+          gmsh_yyendloop(ImbricatedLoop);
+        }
       }
     ;}
     break;
 
   case 297:
-#line 3773 "Gmsh.y"
+#line 3791 "Gmsh.y"
     {
       if(!FunctionManager::Instance()->createFunction
          (std::string((yyvsp[(2) - (2)].c)), gmsh_yyin, gmsh_yyname, gmsh_yylineno))
@@ -10961,7 +10979,7 @@ yyreduce:
     break;
 
   case 298:
-#line 3781 "Gmsh.y"
+#line 3799 "Gmsh.y"
     {
       if(!FunctionManager::Instance()->createFunction
          (std::string((yyvsp[(2) - (2)].c)), gmsh_yyin, gmsh_yyname, gmsh_yylineno))
@@ -10972,36 +10990,42 @@ yyreduce:
     break;
 
   case 299:
-#line 3789 "Gmsh.y"
+#line 3807 "Gmsh.y"
     {
       if(!FunctionManager::Instance()->leaveFunction
          (&gmsh_yyin, gmsh_yyname, gmsh_yylineno))
 	yymsg(0, "Error while exiting function");
+      else
+        gmsh_yypoptokens();
     ;}
     break;
 
   case 300:
-#line 3795 "Gmsh.y"
+#line 3815 "Gmsh.y"
     {
       if(!FunctionManager::Instance()->enterFunction
          (std::string((yyvsp[(2) - (3)].c)), &gmsh_yyin, gmsh_yyname, gmsh_yylineno))
 	yymsg(0, "Unknown function '%s'", (yyvsp[(2) - (3)].c));
+      else
+        gmsh_yypushtokens();
       Free((yyvsp[(2) - (3)].c));
     ;}
     break;
 
   case 301:
-#line 3802 "Gmsh.y"
+#line 3824 "Gmsh.y"
     {
       if(!FunctionManager::Instance()->enterFunction
          (std::string((yyvsp[(2) - (3)].c)), &gmsh_yyin, gmsh_yyname, gmsh_yylineno))
 	yymsg(0, "Unknown function '%s'", (yyvsp[(2) - (3)].c));
+      else
+        gmsh_yypushtokens();
       Free((yyvsp[(2) - (3)].c));
     ;}
     break;
 
   case 302:
-#line 3809 "Gmsh.y"
+#line 3833 "Gmsh.y"
     {
       ImbricatedTest++;
       if(ImbricatedTest > MAX_RECUR_TESTS-1){
@@ -11024,7 +11048,7 @@ yyreduce:
     break;
 
   case 303:
-#line 3829 "Gmsh.y"
+#line 3853 "Gmsh.y"
     {
       if(ImbricatedTest > 0){
         if (statusImbricatedTests[ImbricatedTest]){
@@ -11053,7 +11077,7 @@ yyreduce:
     break;
 
   case 304:
-#line 3855 "Gmsh.y"
+#line 3879 "Gmsh.y"
     {
       if(ImbricatedTest > 0){
         if(statusImbricatedTests[ImbricatedTest]){
@@ -11068,7 +11092,7 @@ yyreduce:
     break;
 
   case 305:
-#line 3867 "Gmsh.y"
+#line 3891 "Gmsh.y"
     {
       ImbricatedTest--;
       if(ImbricatedTest < 0)
@@ -11077,7 +11101,7 @@ yyreduce:
     break;
 
   case 306:
-#line 3878 "Gmsh.y"
+#line 3902 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (5)].l), inDimTags);
@@ -11098,7 +11122,7 @@ yyreduce:
     break;
 
   case 307:
-#line 3896 "Gmsh.y"
+#line 3920 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(10) - (11)].l), inDimTags);
@@ -11119,7 +11143,7 @@ yyreduce:
     break;
 
   case 308:
-#line 3914 "Gmsh.y"
+#line 3938 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(12) - (13)].l), inDimTags);
@@ -11140,7 +11164,7 @@ yyreduce:
     break;
 
   case 309:
-#line 3932 "Gmsh.y"
+#line 3956 "Gmsh.y"
     {
       extr.mesh.ExtrudeMesh = extr.mesh.Recombine = false;
       extr.mesh.QuadToTri = NO_QUADTRI;
@@ -11149,7 +11173,7 @@ yyreduce:
     break;
 
   case 310:
-#line 3938 "Gmsh.y"
+#line 3962 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(4) - (7)].l), inDimTags);
@@ -11170,7 +11194,7 @@ yyreduce:
     break;
 
   case 311:
-#line 3956 "Gmsh.y"
+#line 3980 "Gmsh.y"
     {
       extr.mesh.ExtrudeMesh = extr.mesh.Recombine = false;
       extr.mesh.QuadToTri = NO_QUADTRI;
@@ -11179,7 +11203,7 @@ yyreduce:
     break;
 
   case 312:
-#line 3962 "Gmsh.y"
+#line 3986 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(10) - (13)].l), inDimTags);
@@ -11202,7 +11226,7 @@ yyreduce:
     break;
 
   case 313:
-#line 3982 "Gmsh.y"
+#line 4006 "Gmsh.y"
     {
       extr.mesh.ExtrudeMesh = extr.mesh.Recombine = false;
       extr.mesh.QuadToTri = NO_QUADTRI;
@@ -11211,7 +11235,7 @@ yyreduce:
     break;
 
   case 314:
-#line 3988 "Gmsh.y"
+#line 4012 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(12) - (15)].l), inDimTags);
@@ -11232,7 +11256,7 @@ yyreduce:
     break;
 
   case 315:
-#line 4006 "Gmsh.y"
+#line 4030 "Gmsh.y"
     {
       extr.mesh.ExtrudeMesh = extr.mesh.Recombine = false;
       extr.mesh.QuadToTri = NO_QUADTRI;
@@ -11241,7 +11265,7 @@ yyreduce:
     break;
 
   case 316:
-#line 4012 "Gmsh.y"
+#line 4036 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(3) - (6)].l), inDimTags);
@@ -11261,7 +11285,7 @@ yyreduce:
     break;
 
   case 317:
-#line 4029 "Gmsh.y"
+#line 4053 "Gmsh.y"
     {
       std::vector<std::pair<int, int> > inDimTags, outDimTags;
       ListOfShapes2VectorOfPairs((yyvsp[(3) - (9)].l), inDimTags);
@@ -11280,7 +11304,7 @@ yyreduce:
     break;
 
   case 318:
-#line 4045 "Gmsh.y"
+#line 4069 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -11300,7 +11324,7 @@ yyreduce:
     break;
 
   case 319:
-#line 4062 "Gmsh.y"
+#line 4086 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -11320,7 +11344,7 @@ yyreduce:
     break;
 
   case 320:
-#line 4080 "Gmsh.y"
+#line 4104 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -11345,7 +11369,7 @@ yyreduce:
     break;
 
   case 321:
-#line 4103 "Gmsh.y"
+#line 4127 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -11372,19 +11396,19 @@ yyreduce:
     break;
 
   case 322:
-#line 4130 "Gmsh.y"
+#line 4154 "Gmsh.y"
     {
     ;}
     break;
 
   case 323:
-#line 4133 "Gmsh.y"
+#line 4157 "Gmsh.y"
     {
     ;}
     break;
 
   case 324:
-#line 4139 "Gmsh.y"
+#line 4163 "Gmsh.y"
     {
       int n = (int)fabs((yyvsp[(3) - (5)].d));
       if(n){ // we accept n==0 to easily disable layers
@@ -11399,7 +11423,7 @@ yyreduce:
     break;
 
   case 325:
-#line 4151 "Gmsh.y"
+#line 4175 "Gmsh.y"
     {
       extr.mesh.ExtrudeMesh = true;
       extr.mesh.NbLayer = List_Nbr((yyvsp[(3) - (7)].l));
@@ -11422,56 +11446,56 @@ yyreduce:
     break;
 
   case 326:
-#line 4171 "Gmsh.y"
+#line 4195 "Gmsh.y"
     {
       extr.mesh.ScaleLast = true;
     ;}
     break;
 
   case 327:
-#line 4175 "Gmsh.y"
+#line 4199 "Gmsh.y"
     {
       extr.mesh.Recombine = true;
     ;}
     break;
 
   case 328:
-#line 4179 "Gmsh.y"
+#line 4203 "Gmsh.y"
     {
       extr.mesh.Recombine = (yyvsp[(2) - (3)].d) ? true : false;
     ;}
     break;
 
   case 329:
-#line 4183 "Gmsh.y"
+#line 4207 "Gmsh.y"
     {
       extr.mesh.QuadToTri = QUADTRI_ADDVERTS_1;
     ;}
     break;
 
   case 330:
-#line 4187 "Gmsh.y"
+#line 4211 "Gmsh.y"
     {
       extr.mesh.QuadToTri = QUADTRI_ADDVERTS_1_RECOMB;
     ;}
     break;
 
   case 331:
-#line 4191 "Gmsh.y"
+#line 4215 "Gmsh.y"
     {
       extr.mesh.QuadToTri = QUADTRI_NOVERTS_1;
     ;}
     break;
 
   case 332:
-#line 4195 "Gmsh.y"
+#line 4219 "Gmsh.y"
     {
       extr.mesh.QuadToTri = QUADTRI_NOVERTS_1_RECOMB;
     ;}
     break;
 
   case 333:
-#line 4199 "Gmsh.y"
+#line 4223 "Gmsh.y"
     {
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(6) - (9)].l), tags);
       int num = (int)(yyvsp[(3) - (9)].d);
@@ -11483,7 +11507,7 @@ yyreduce:
     break;
 
   case 334:
-#line 4208 "Gmsh.y"
+#line 4232 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (6)].c), "Index"))
         extr.mesh.BoundaryLayerIndex = (yyvsp[(4) - (6)].d);
@@ -11494,57 +11518,57 @@ yyreduce:
     break;
 
   case 335:
-#line 4220 "Gmsh.y"
+#line 4244 "Gmsh.y"
     { (yyval.i) = OCC_Internals::Union; ;}
     break;
 
   case 336:
-#line 4221 "Gmsh.y"
+#line 4245 "Gmsh.y"
     { (yyval.i) = OCC_Internals::Intersection; ;}
     break;
 
   case 337:
-#line 4222 "Gmsh.y"
+#line 4246 "Gmsh.y"
     { (yyval.i) = OCC_Internals::Difference; ;}
     break;
 
   case 338:
-#line 4223 "Gmsh.y"
+#line 4247 "Gmsh.y"
     { (yyval.i) = OCC_Internals::Section; ;}
     break;
 
   case 339:
-#line 4224 "Gmsh.y"
+#line 4248 "Gmsh.y"
     { (yyval.i) = OCC_Internals::Fragments; ;}
     break;
 
   case 340:
-#line 4228 "Gmsh.y"
+#line 4252 "Gmsh.y"
     { (yyval.i) = 0; ;}
     break;
 
   case 341:
-#line 4229 "Gmsh.y"
+#line 4253 "Gmsh.y"
     { (yyval.i) = 1; ;}
     break;
 
   case 342:
-#line 4230 "Gmsh.y"
+#line 4254 "Gmsh.y"
     { (yyval.i) = 2; ;}
     break;
 
   case 343:
-#line 4231 "Gmsh.y"
+#line 4255 "Gmsh.y"
     { (yyval.i) = (yyvsp[(2) - (3)].d) ? 1 : 0; ;}
     break;
 
   case 344:
-#line 4232 "Gmsh.y"
+#line 4256 "Gmsh.y"
     { (yyval.i) = (yyvsp[(3) - (4)].d) ? 2 : 0; ;}
     break;
 
   case 345:
-#line 4237 "Gmsh.y"
+#line 4261 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -11570,7 +11594,7 @@ yyreduce:
     break;
 
   case 346:
-#line 4260 "Gmsh.y"
+#line 4284 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(Shape));
       bool r = true;
@@ -11589,7 +11613,7 @@ yyreduce:
     break;
 
   case 347:
-#line 4280 "Gmsh.y"
+#line 4304 "Gmsh.y"
     {
       bool r = true;
       if(gmsh_yyfactory == "OpenCASCADE" && GModel::current()->getOCCInternals()){
@@ -11610,14 +11634,14 @@ yyreduce:
     break;
 
   case 348:
-#line 4301 "Gmsh.y"
+#line 4325 "Gmsh.y"
     {
       (yyval.v)[0] = (yyval.v)[1] = 1.;
     ;}
     break;
 
   case 349:
-#line 4305 "Gmsh.y"
+#line 4329 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (3)].c), "Progression") || !strcmp((yyvsp[(2) - (3)].c), "Power"))
         (yyval.v)[0] = 1.;
@@ -11633,14 +11657,14 @@ yyreduce:
     break;
 
   case 350:
-#line 4320 "Gmsh.y"
+#line 4344 "Gmsh.y"
     {
       (yyval.i) = -1; // left
     ;}
     break;
 
   case 351:
-#line 4324 "Gmsh.y"
+#line 4348 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(1) - (1)].c), "Right"))
         (yyval.i) = 1;
@@ -11657,49 +11681,49 @@ yyreduce:
     break;
 
   case 352:
-#line 4340 "Gmsh.y"
+#line 4364 "Gmsh.y"
     {
      (yyval.l) = List_Create(1, 1, sizeof(double));
    ;}
     break;
 
   case 353:
-#line 4344 "Gmsh.y"
+#line 4368 "Gmsh.y"
     {
      (yyval.l) = (yyvsp[(2) - (2)].l);
    ;}
     break;
 
   case 354:
-#line 4349 "Gmsh.y"
+#line 4373 "Gmsh.y"
     {
       (yyval.i) = 45;
     ;}
     break;
 
   case 355:
-#line 4353 "Gmsh.y"
+#line 4377 "Gmsh.y"
     {
       (yyval.i) = (int)(yyvsp[(2) - (2)].d);
     ;}
     break;
 
   case 356:
-#line 4359 "Gmsh.y"
+#line 4383 "Gmsh.y"
     {
       (yyval.l) = List_Create(1, 1, sizeof(double));
     ;}
     break;
 
   case 357:
-#line 4363 "Gmsh.y"
+#line 4387 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(2) - (2)].l);
     ;}
     break;
 
   case 358:
-#line 4370 "Gmsh.y"
+#line 4394 "Gmsh.y"
     {
       // mesh sizes at vertices are stored in internal CAD data, as they can be
       // specified during vertex creation and copied around during CAD
@@ -11724,7 +11748,7 @@ yyreduce:
     break;
 
   case 359:
-#line 4392 "Gmsh.y"
+#line 4416 "Gmsh.y"
     {
       // transfinite constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -11768,7 +11792,7 @@ yyreduce:
     break;
 
   case 360:
-#line 4433 "Gmsh.y"
+#line 4457 "Gmsh.y"
     {
       // transfinite constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -11815,7 +11839,7 @@ yyreduce:
     break;
 
   case 361:
-#line 4477 "Gmsh.y"
+#line 4501 "Gmsh.y"
     {
       // transfinite constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -11857,7 +11881,7 @@ yyreduce:
     break;
 
   case 362:
-#line 4516 "Gmsh.y"
+#line 4540 "Gmsh.y"
     {
       // transfinite constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -11885,7 +11909,7 @@ yyreduce:
     break;
 
   case 363:
-#line 4541 "Gmsh.y"
+#line 4565 "Gmsh.y"
     {
       int tag = (int)(yyvsp[(4) - (8)].d);
       GVertex *gf = GModel::current()->getVertexByTag(tag);
@@ -11900,7 +11924,7 @@ yyreduce:
     break;
 
   case 364:
-#line 4553 "Gmsh.y"
+#line 4577 "Gmsh.y"
     {
       int tag = (int)(yyvsp[(4) - (8)].d);
       GEdge *gf = GModel::current()->getEdgeByTag(tag);
@@ -11915,7 +11939,7 @@ yyreduce:
     break;
 
   case 365:
-#line 4565 "Gmsh.y"
+#line 4589 "Gmsh.y"
     {
       int tag = (int)(yyvsp[(4) - (8)].d);
       GFace *gf = GModel::current()->getFaceByTag(tag);
@@ -11930,7 +11954,7 @@ yyreduce:
     break;
 
   case 366:
-#line 4577 "Gmsh.y"
+#line 4601 "Gmsh.y"
     {
       int tag = (int)(yyvsp[(4) - (8)].d);
       GRegion *gf = GModel::current()->getRegionByTag(tag);
@@ -11945,7 +11969,7 @@ yyreduce:
     break;
 
   case 367:
-#line 4589 "Gmsh.y"
+#line 4613 "Gmsh.y"
     {
       // mesh algorithm constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -11965,7 +11989,7 @@ yyreduce:
     break;
 
   case 368:
-#line 4606 "Gmsh.y"
+#line 4630 "Gmsh.y"
     {
       // lcExtendFromBoundary onstraints are stored in GEO internals in addition
       // to GModel, as they can be copied around during GEO operations
@@ -11985,7 +12009,7 @@ yyreduce:
     break;
 
   case 369:
-#line 4623 "Gmsh.y"
+#line 4647 "Gmsh.y"
     {
       // recombine constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -12018,7 +12042,7 @@ yyreduce:
     break;
 
   case 370:
-#line 4653 "Gmsh.y"
+#line 4677 "Gmsh.y"
     {
       // recombine constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -12047,7 +12071,7 @@ yyreduce:
     break;
 
   case 371:
-#line 4679 "Gmsh.y"
+#line 4703 "Gmsh.y"
     {
       // smoothing constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -12076,7 +12100,7 @@ yyreduce:
     break;
 
   case 372:
-#line 4706 "Gmsh.y"
+#line 4730 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(4) - (11)].l)) != List_Nbr((yyvsp[(8) - (11)].l))){
         yymsg(0, "Number of master lines (%d) different from number of "
@@ -12110,7 +12134,7 @@ yyreduce:
     break;
 
   case 373:
-#line 4738 "Gmsh.y"
+#line 4762 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(4) - (11)].l)) != List_Nbr((yyvsp[(8) - (11)].l))){
         yymsg(0, "Number of master surfaces (%d) different from number of "
@@ -12139,7 +12163,7 @@ yyreduce:
     break;
 
   case 374:
-#line 4765 "Gmsh.y"
+#line 4789 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(4) - (18)].l)) != List_Nbr((yyvsp[(8) - (18)].l))){
         yymsg(0, "Number of master curves (%d) different from number of "
@@ -12167,7 +12191,7 @@ yyreduce:
     break;
 
   case 375:
-#line 4791 "Gmsh.y"
+#line 4815 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(4) - (18)].l)) != List_Nbr((yyvsp[(8) - (18)].l))){
         yymsg(0, "Number of master surfaces (%d) different from number of "
@@ -12195,7 +12219,7 @@ yyreduce:
     break;
 
   case 376:
-#line 4817 "Gmsh.y"
+#line 4841 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(4) - (12)].l)) != List_Nbr((yyvsp[(8) - (12)].l))){
         yymsg(0, "Number of master curves (%d) different from number of "
@@ -12223,7 +12247,7 @@ yyreduce:
     break;
 
   case 377:
-#line 4843 "Gmsh.y"
+#line 4867 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(4) - (12)].l)) != List_Nbr((yyvsp[(8) - (12)].l))){
         yymsg(0, "Number of master surfaces (%d) different from number of "
@@ -12251,7 +12275,7 @@ yyreduce:
     break;
 
   case 378:
-#line 4869 "Gmsh.y"
+#line 4893 "Gmsh.y"
     {
       if (List_Nbr((yyvsp[(5) - (12)].l)) != List_Nbr((yyvsp[(10) - (12)].l))){
         yymsg(0, "Number of master surface curves (%d) different from number of "
@@ -12275,7 +12299,7 @@ yyreduce:
     break;
 
   case 379:
-#line 4890 "Gmsh.y"
+#line 4914 "Gmsh.y"
     {
       if (((yyvsp[(6) - (10)].i)==2 || (yyvsp[(6) - (10)].i)==3) && (yyvsp[(1) - (10)].i)<(yyvsp[(6) - (10)].i) ) {
         std::vector<int> tags; ListOfDouble2Vector((yyvsp[(3) - (10)].l), tags);
@@ -12289,7 +12313,7 @@ yyreduce:
     break;
 
   case 380:
-#line 4901 "Gmsh.y"
+#line 4925 "Gmsh.y"
     {
       // reverse mesh constraints are stored in GEO internals in addition to
       // GModel, as they can be copied around during GEO operations
@@ -12340,7 +12364,7 @@ yyreduce:
     break;
 
   case 381:
-#line 4949 "Gmsh.y"
+#line 4973 "Gmsh.y"
     {
       if(GModel::current()->getOCCInternals() &&
          GModel::current()->getOCCInternals()->getChanged())
@@ -12397,7 +12421,7 @@ yyreduce:
     break;
 
   case 382:
-#line 5003 "Gmsh.y"
+#line 5027 "Gmsh.y"
     {
       if(GModel::current()->getOCCInternals() &&
          GModel::current()->getOCCInternals()->getChanged())
@@ -12415,7 +12439,7 @@ yyreduce:
     break;
 
   case 383:
-#line 5018 "Gmsh.y"
+#line 5042 "Gmsh.y"
     {
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (4)].l)); i++){
 	double dnum;
@@ -12430,7 +12454,7 @@ yyreduce:
     break;
 
   case 384:
-#line 5030 "Gmsh.y"
+#line 5054 "Gmsh.y"
     {
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(3) - (4)].l), tags);
       GModel::current()->getGEOInternals()->setCompoundMesh((yyvsp[(2) - (4)].i), tags);
@@ -12439,7 +12463,7 @@ yyreduce:
     break;
 
   case 385:
-#line 5041 "Gmsh.y"
+#line 5065 "Gmsh.y"
     {
       if(gmsh_yyfactory == "OpenCASCADE" && GModel::current()->getOCCInternals())
         GModel::current()->getOCCInternals()->removeAllDuplicates();
@@ -12449,7 +12473,7 @@ yyreduce:
     break;
 
   case 386:
-#line 5048 "Gmsh.y"
+#line 5072 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(2) - (3)].c), "Geometry")){
         if(gmsh_yyfactory == "OpenCASCADE" && GModel::current()->getOCCInternals())
@@ -12467,7 +12491,7 @@ yyreduce:
     break;
 
   case 387:
-#line 5063 "Gmsh.y"
+#line 5087 "Gmsh.y"
     {
       std::vector<int> tags; ListOfDouble2Vector((yyvsp[(4) - (6)].l), tags);
       if(gmsh_yyfactory == "OpenCASCADE" && GModel::current()->getOCCInternals())
@@ -12479,22 +12503,22 @@ yyreduce:
     break;
 
   case 388:
-#line 5076 "Gmsh.y"
+#line 5100 "Gmsh.y"
     { (yyval.c) = (char*)"Homology"; ;}
     break;
 
   case 389:
-#line 5077 "Gmsh.y"
+#line 5101 "Gmsh.y"
     { (yyval.c) = (char*)"Cohomology"; ;}
     break;
 
   case 390:
-#line 5078 "Gmsh.y"
+#line 5102 "Gmsh.y"
     { (yyval.c) = (char*)"Betti"; ;}
     break;
 
   case 391:
-#line 5083 "Gmsh.y"
+#line 5107 "Gmsh.y"
     {
       std::vector<int> domain, subdomain, dim;
       for(int i = 0; i < 4; i++) dim.push_back(i);
@@ -12503,7 +12527,7 @@ yyreduce:
     break;
 
   case 392:
-#line 5089 "Gmsh.y"
+#line 5113 "Gmsh.y"
     {
       std::vector<int> domain, subdomain, dim;
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (5)].l)); i++){
@@ -12518,7 +12542,7 @@ yyreduce:
     break;
 
   case 393:
-#line 5101 "Gmsh.y"
+#line 5125 "Gmsh.y"
     {
       std::vector<int> domain, subdomain, dim;
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (7)].l)); i++){
@@ -12539,7 +12563,7 @@ yyreduce:
     break;
 
   case 394:
-#line 5119 "Gmsh.y"
+#line 5143 "Gmsh.y"
     {
       std::vector<int> domain, subdomain, dim;
       for(int i = 0; i < List_Nbr((yyvsp[(6) - (10)].l)); i++){
@@ -12565,47 +12589,47 @@ yyreduce:
     break;
 
   case 395:
-#line 5146 "Gmsh.y"
+#line 5170 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (1)].d);           ;}
     break;
 
   case 396:
-#line 5147 "Gmsh.y"
+#line 5171 "Gmsh.y"
     { (yyval.d) = (yyvsp[(2) - (3)].d);           ;}
     break;
 
   case 397:
-#line 5148 "Gmsh.y"
+#line 5172 "Gmsh.y"
     { (yyval.d) = -(yyvsp[(2) - (2)].d);          ;}
     break;
 
   case 398:
-#line 5149 "Gmsh.y"
+#line 5173 "Gmsh.y"
     { (yyval.d) = (yyvsp[(2) - (2)].d);           ;}
     break;
 
   case 399:
-#line 5150 "Gmsh.y"
+#line 5174 "Gmsh.y"
     { (yyval.d) = !(yyvsp[(2) - (2)].d);          ;}
     break;
 
   case 400:
-#line 5151 "Gmsh.y"
+#line 5175 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) - (yyvsp[(3) - (3)].d);      ;}
     break;
 
   case 401:
-#line 5152 "Gmsh.y"
+#line 5176 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) + (yyvsp[(3) - (3)].d);      ;}
     break;
 
   case 402:
-#line 5153 "Gmsh.y"
+#line 5177 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) * (yyvsp[(3) - (3)].d);      ;}
     break;
 
   case 403:
-#line 5155 "Gmsh.y"
+#line 5179 "Gmsh.y"
     {
       if(!(yyvsp[(3) - (3)].d))
 	yymsg(0, "Division by zero in '%g / %g'", (yyvsp[(1) - (3)].d), (yyvsp[(3) - (3)].d));
@@ -12615,267 +12639,267 @@ yyreduce:
     break;
 
   case 404:
-#line 5161 "Gmsh.y"
+#line 5185 "Gmsh.y"
     { (yyval.d) = (int)(yyvsp[(1) - (3)].d) | (int)(yyvsp[(3) - (3)].d); ;}
     break;
 
   case 405:
-#line 5162 "Gmsh.y"
+#line 5186 "Gmsh.y"
     { (yyval.d) = (int)(yyvsp[(1) - (3)].d) & (int)(yyvsp[(3) - (3)].d); ;}
     break;
 
   case 406:
-#line 5163 "Gmsh.y"
+#line 5187 "Gmsh.y"
     { (yyval.d) = (int)(yyvsp[(1) - (3)].d) % (int)(yyvsp[(3) - (3)].d); ;}
     break;
 
   case 407:
-#line 5164 "Gmsh.y"
+#line 5188 "Gmsh.y"
     { (yyval.d) = pow((yyvsp[(1) - (3)].d), (yyvsp[(3) - (3)].d));  ;}
     break;
 
   case 408:
-#line 5165 "Gmsh.y"
+#line 5189 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) < (yyvsp[(3) - (3)].d);      ;}
     break;
 
   case 409:
-#line 5166 "Gmsh.y"
+#line 5190 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) > (yyvsp[(3) - (3)].d);      ;}
     break;
 
   case 410:
-#line 5167 "Gmsh.y"
+#line 5191 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) <= (yyvsp[(3) - (3)].d);     ;}
     break;
 
   case 411:
-#line 5168 "Gmsh.y"
+#line 5192 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) >= (yyvsp[(3) - (3)].d);     ;}
     break;
 
   case 412:
-#line 5169 "Gmsh.y"
+#line 5193 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) == (yyvsp[(3) - (3)].d);     ;}
     break;
 
   case 413:
-#line 5170 "Gmsh.y"
+#line 5194 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) != (yyvsp[(3) - (3)].d);     ;}
     break;
 
   case 414:
-#line 5171 "Gmsh.y"
+#line 5195 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) && (yyvsp[(3) - (3)].d);     ;}
     break;
 
   case 415:
-#line 5172 "Gmsh.y"
+#line 5196 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (3)].d) || (yyvsp[(3) - (3)].d);     ;}
     break;
 
   case 416:
-#line 5173 "Gmsh.y"
+#line 5197 "Gmsh.y"
     { (yyval.d) = ((int)(yyvsp[(1) - (3)].d) >> (int)(yyvsp[(3) - (3)].d)); ;}
     break;
 
   case 417:
-#line 5174 "Gmsh.y"
+#line 5198 "Gmsh.y"
     { (yyval.d) = ((int)(yyvsp[(1) - (3)].d) << (int)(yyvsp[(3) - (3)].d)); ;}
     break;
 
   case 418:
-#line 5175 "Gmsh.y"
+#line 5199 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (5)].d) ? (yyvsp[(3) - (5)].d) : (yyvsp[(5) - (5)].d); ;}
     break;
 
   case 419:
-#line 5176 "Gmsh.y"
+#line 5200 "Gmsh.y"
     { (yyval.d) = exp((yyvsp[(3) - (4)].d));      ;}
     break;
 
   case 420:
-#line 5177 "Gmsh.y"
+#line 5201 "Gmsh.y"
     { (yyval.d) = log((yyvsp[(3) - (4)].d));      ;}
     break;
 
   case 421:
-#line 5178 "Gmsh.y"
+#line 5202 "Gmsh.y"
     { (yyval.d) = log10((yyvsp[(3) - (4)].d));    ;}
     break;
 
   case 422:
-#line 5179 "Gmsh.y"
+#line 5203 "Gmsh.y"
     { (yyval.d) = sqrt((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 423:
-#line 5180 "Gmsh.y"
+#line 5204 "Gmsh.y"
     { (yyval.d) = sin((yyvsp[(3) - (4)].d));      ;}
     break;
 
   case 424:
-#line 5181 "Gmsh.y"
+#line 5205 "Gmsh.y"
     { (yyval.d) = asin((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 425:
-#line 5182 "Gmsh.y"
+#line 5206 "Gmsh.y"
     { (yyval.d) = cos((yyvsp[(3) - (4)].d));      ;}
     break;
 
   case 426:
-#line 5183 "Gmsh.y"
+#line 5207 "Gmsh.y"
     { (yyval.d) = acos((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 427:
-#line 5184 "Gmsh.y"
+#line 5208 "Gmsh.y"
     { (yyval.d) = tan((yyvsp[(3) - (4)].d));      ;}
     break;
 
   case 428:
-#line 5185 "Gmsh.y"
+#line 5209 "Gmsh.y"
     { (yyval.d) = atan((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 429:
-#line 5186 "Gmsh.y"
+#line 5210 "Gmsh.y"
     { (yyval.d) = atan2((yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].d));;}
     break;
 
   case 430:
-#line 5187 "Gmsh.y"
+#line 5211 "Gmsh.y"
     { (yyval.d) = sinh((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 431:
-#line 5188 "Gmsh.y"
+#line 5212 "Gmsh.y"
     { (yyval.d) = cosh((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 432:
-#line 5189 "Gmsh.y"
+#line 5213 "Gmsh.y"
     { (yyval.d) = tanh((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 433:
-#line 5190 "Gmsh.y"
+#line 5214 "Gmsh.y"
     { (yyval.d) = fabs((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 434:
-#line 5191 "Gmsh.y"
+#line 5215 "Gmsh.y"
     { (yyval.d) = std::abs((yyvsp[(3) - (4)].d)); ;}
     break;
 
   case 435:
-#line 5192 "Gmsh.y"
+#line 5216 "Gmsh.y"
     { (yyval.d) = floor((yyvsp[(3) - (4)].d));    ;}
     break;
 
   case 436:
-#line 5193 "Gmsh.y"
+#line 5217 "Gmsh.y"
     { (yyval.d) = ceil((yyvsp[(3) - (4)].d));     ;}
     break;
 
   case 437:
-#line 5194 "Gmsh.y"
+#line 5218 "Gmsh.y"
     { (yyval.d) = floor((yyvsp[(3) - (4)].d) + 0.5); ;}
     break;
 
   case 438:
-#line 5195 "Gmsh.y"
+#line 5219 "Gmsh.y"
     { (yyval.d) = fmod((yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].d)); ;}
     break;
 
   case 439:
-#line 5196 "Gmsh.y"
+#line 5220 "Gmsh.y"
     { (yyval.d) = fmod((yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].d)); ;}
     break;
 
   case 440:
-#line 5197 "Gmsh.y"
+#line 5221 "Gmsh.y"
     { (yyval.d) = sqrt((yyvsp[(3) - (6)].d) * (yyvsp[(3) - (6)].d) + (yyvsp[(5) - (6)].d) * (yyvsp[(5) - (6)].d)); ;}
     break;
 
   case 441:
-#line 5198 "Gmsh.y"
+#line 5222 "Gmsh.y"
     { (yyval.d) = (yyvsp[(3) - (4)].d) * (double)rand() / (double)RAND_MAX; ;}
     break;
 
   case 442:
-#line 5199 "Gmsh.y"
+#line 5223 "Gmsh.y"
     { (yyval.d) = std::max((yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].d)); ;}
     break;
 
   case 443:
-#line 5200 "Gmsh.y"
+#line 5224 "Gmsh.y"
     { (yyval.d) = std::min((yyvsp[(3) - (6)].d), (yyvsp[(5) - (6)].d)); ;}
     break;
 
   case 444:
-#line 5209 "Gmsh.y"
+#line 5233 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (1)].d); ;}
     break;
 
   case 445:
-#line 5210 "Gmsh.y"
+#line 5234 "Gmsh.y"
     { (yyval.d) = 3.141592653589793; ;}
     break;
 
   case 446:
-#line 5211 "Gmsh.y"
+#line 5235 "Gmsh.y"
     { (yyval.d) = (double)ImbricatedTest; ;}
     break;
 
   case 447:
-#line 5212 "Gmsh.y"
+#line 5236 "Gmsh.y"
     { (yyval.d) = Msg::GetCommRank(); ;}
     break;
 
   case 448:
-#line 5213 "Gmsh.y"
+#line 5237 "Gmsh.y"
     { (yyval.d) = Msg::GetCommSize(); ;}
     break;
 
   case 449:
-#line 5214 "Gmsh.y"
+#line 5238 "Gmsh.y"
     { (yyval.d) = GetGmshMajorVersion(); ;}
     break;
 
   case 450:
-#line 5215 "Gmsh.y"
+#line 5239 "Gmsh.y"
     { (yyval.d) = GetGmshMinorVersion(); ;}
     break;
 
   case 451:
-#line 5216 "Gmsh.y"
+#line 5240 "Gmsh.y"
     { (yyval.d) = GetGmshPatchVersion(); ;}
     break;
 
   case 452:
-#line 5217 "Gmsh.y"
+#line 5241 "Gmsh.y"
     { (yyval.d) = Cpu(); ;}
     break;
 
   case 453:
-#line 5218 "Gmsh.y"
+#line 5242 "Gmsh.y"
     { (yyval.d) = GetMemoryUsage()/1024./1024.; ;}
     break;
 
   case 454:
-#line 5219 "Gmsh.y"
+#line 5243 "Gmsh.y"
     { (yyval.d) = TotalRam(); ;}
     break;
 
   case 455:
-#line 5224 "Gmsh.y"
+#line 5248 "Gmsh.y"
     { init_options(); ;}
     break;
 
   case 456:
-#line 5226 "Gmsh.y"
+#line 5250 "Gmsh.y"
     {
       std::vector<double> val(1, (yyvsp[(3) - (6)].d));
       Msg::ExchangeOnelabParameter("", val, floatOptions, charOptions);
@@ -12884,12 +12908,12 @@ yyreduce:
     break;
 
   case 457:
-#line 5232 "Gmsh.y"
+#line 5256 "Gmsh.y"
     { (yyval.d) = (yyvsp[(1) - (1)].d); ;}
     break;
 
   case 458:
-#line 5234 "Gmsh.y"
+#line 5258 "Gmsh.y"
     {
       (yyval.d) = Msg::GetOnelabNumber((yyvsp[(3) - (4)].c));
       Free((yyvsp[(3) - (4)].c));
@@ -12897,7 +12921,7 @@ yyreduce:
     break;
 
   case 459:
-#line 5239 "Gmsh.y"
+#line 5263 "Gmsh.y"
     {
       (yyval.d) = Msg::GetOnelabNumber((yyvsp[(3) - (6)].c), (yyvsp[(5) - (6)].d));
       Free((yyvsp[(3) - (6)].c));
@@ -12905,70 +12929,70 @@ yyreduce:
     break;
 
   case 460:
-#line 5244 "Gmsh.y"
+#line 5268 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_Float((yyvsp[(1) - (1)].c2).char1, (yyvsp[(1) - (1)].c2).char2);
     ;}
     break;
 
   case 461:
-#line 5249 "Gmsh.y"
+#line 5273 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_Float(NULL, (yyvsp[(1) - (4)].c), 2, (int)(yyvsp[(3) - (4)].d));
     ;}
     break;
 
   case 462:
-#line 5254 "Gmsh.y"
+#line 5278 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_Float(NULL, (yyvsp[(1) - (4)].c), 2, (int)(yyvsp[(3) - (4)].d));
     ;}
     break;
 
   case 463:
-#line 5258 "Gmsh.y"
+#line 5282 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_Float((yyvsp[(3) - (4)].c2).char1, (yyvsp[(3) - (4)].c2).char2, 1, 0, 0., 1);
     ;}
     break;
 
   case 464:
-#line 5262 "Gmsh.y"
+#line 5286 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float((yyvsp[(3) - (6)].c2).char1, (yyvsp[(3) - (6)].c2).char2, (yyvsp[(5) - (6)].c), 0, 0., 1);
     ;}
     break;
 
   case 465:
-#line 5266 "Gmsh.y"
+#line 5290 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_Float((yyvsp[(3) - (5)].c2).char1, (yyvsp[(3) - (5)].c2).char2, 1, 0, (yyvsp[(4) - (5)].d), 2);
     ;}
     break;
 
   case 466:
-#line 5270 "Gmsh.y"
+#line 5294 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float((yyvsp[(3) - (7)].c2).char1, (yyvsp[(3) - (7)].c2).char2, (yyvsp[(5) - (7)].c), 0, (yyvsp[(6) - (7)].d), 2);
     ;}
     break;
 
   case 467:
-#line 5274 "Gmsh.y"
+#line 5298 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_Float((yyvsp[(3) - (8)].c2).char1, (yyvsp[(3) - (8)].c2).char2, 2, (int)(yyvsp[(5) - (8)].d), (yyvsp[(7) - (8)].d), 2);
     ;}
     break;
 
   case 468:
-#line 5278 "Gmsh.y"
+#line 5302 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float((yyvsp[(3) - (10)].c2).char1, (yyvsp[(3) - (10)].c2).char2, (yyvsp[(5) - (10)].c), (int)(yyvsp[(7) - (10)].d), (yyvsp[(9) - (10)].d), 2);
     ;}
     break;
 
   case 469:
-#line 5282 "Gmsh.y"
+#line 5306 "Gmsh.y"
     {
       std::string tmp = FixRelativePath(gmsh_yyname, (yyvsp[(3) - (4)].c));
       (yyval.d) = !StatFile(tmp);
@@ -12977,7 +13001,7 @@ yyreduce:
     break;
 
   case 470:
-#line 5288 "Gmsh.y"
+#line 5312 "Gmsh.y"
     {
       if(gmsh_yysymbols.count((yyvsp[(2) - (4)].c))){
         gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(2) - (4)].c)]);
@@ -12995,14 +13019,14 @@ yyreduce:
     break;
 
   case 471:
-#line 5303 "Gmsh.y"
+#line 5327 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float_getDim((yyvsp[(2) - (6)].c2).char1, (yyvsp[(2) - (6)].c2).char2, (yyvsp[(4) - (6)].c));
     ;}
     break;
 
   case 472:
-#line 5307 "Gmsh.y"
+#line 5331 "Gmsh.y"
     {
       std::string struct_namespace((yyvsp[(3) - (4)].c));
       (yyval.d) = (double)gmsh_yynamespaces[struct_namespace].size();
@@ -13011,7 +13035,7 @@ yyreduce:
     break;
 
   case 473:
-#line 5313 "Gmsh.y"
+#line 5337 "Gmsh.y"
     {
       std::string struct_namespace(std::string(""));
       (yyval.d) = (double)gmsh_yynamespaces[struct_namespace].size();
@@ -13019,14 +13043,15 @@ yyreduce:
     break;
 
   case 474:
-#line 5318 "Gmsh.y"
+#line 5342 "Gmsh.y"
     {
-      if(!gmsh_yysymbols.count((yyvsp[(1) - (2)].c))){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find((yyvsp[(1) - (2)].c));
+      if(it == gmsh_yysymbols.end()){
 	yymsg(0, "Unknown variable '%s'", (yyvsp[(1) - (2)].c));
 	(yyval.d) = 0.;
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(1) - (2)].c)]);
+        gmsh_yysymbol &s(it->second);
         if(s.value.empty()){
           yymsg(0, "Uninitialized variable '%s'", (yyvsp[(1) - (2)].c));
           (yyval.d) = 0.;
@@ -13041,15 +13066,16 @@ yyreduce:
     break;
 
   case 475:
-#line 5337 "Gmsh.y"
+#line 5362 "Gmsh.y"
     {
       int index = (int)(yyvsp[(3) - (5)].d);
-      if(!gmsh_yysymbols.count((yyvsp[(1) - (5)].c))){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find((yyvsp[(1) - (5)].c));
+      if(it == gmsh_yysymbols.end()){
 	yymsg(0, "Unknown variable '%s'", (yyvsp[(1) - (5)].c));
 	(yyval.d) = 0.;
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(1) - (5)].c)]);
+        gmsh_yysymbol &s(it->second);
         if((int)s.value.size() < index + 1){
           yymsg(0, "Uninitialized variable '%s[%d]'", (yyvsp[(1) - (5)].c), index);
           (yyval.d) = 0.;
@@ -13064,15 +13090,16 @@ yyreduce:
     break;
 
   case 476:
-#line 5357 "Gmsh.y"
+#line 5383 "Gmsh.y"
     {
       int index = (int)(yyvsp[(3) - (5)].d);
-      if(!gmsh_yysymbols.count((yyvsp[(1) - (5)].c))){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find((yyvsp[(1) - (5)].c));
+      if(it == gmsh_yysymbols.end()){
 	yymsg(0, "Unknown variable '%s'", (yyvsp[(1) - (5)].c));
 	(yyval.d) = 0.;
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[(yyvsp[(1) - (5)].c)]);
+        gmsh_yysymbol &s(it->second);
         if((int)s.value.size() < index + 1){
           yymsg(0, "Uninitialized variable '%s[%d]'", (yyvsp[(1) - (5)].c), index);
           (yyval.d) = 0.;
@@ -13087,49 +13114,49 @@ yyreduce:
     break;
 
   case 477:
-#line 5378 "Gmsh.y"
+#line 5405 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float(NULL, (yyvsp[(1) - (3)].c), (yyvsp[(3) - (3)].c));
     ;}
     break;
 
   case 478:
-#line 5382 "Gmsh.y"
+#line 5409 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float((yyvsp[(1) - (5)].c), (yyvsp[(3) - (5)].c), (yyvsp[(5) - (5)].c));
     ;}
     break;
 
   case 479:
-#line 5386 "Gmsh.y"
+#line 5413 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float(NULL, (yyvsp[(1) - (6)].c), (yyvsp[(3) - (6)].c), (int)(yyvsp[(5) - (6)].d));
     ;}
     break;
 
   case 480:
-#line 5390 "Gmsh.y"
+#line 5417 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float((yyvsp[(1) - (8)].c), (yyvsp[(3) - (8)].c), (yyvsp[(5) - (8)].c), (int)(yyvsp[(7) - (8)].d));
     ;}
     break;
 
   case 481:
-#line 5394 "Gmsh.y"
+#line 5421 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float(NULL, (yyvsp[(1) - (6)].c), (yyvsp[(3) - (6)].c), (int)(yyvsp[(5) - (6)].d));
     ;}
     break;
 
   case 482:
-#line 5398 "Gmsh.y"
+#line 5425 "Gmsh.y"
     {
       (yyval.d) = treat_Struct_FullName_dot_tSTRING_Float((yyvsp[(1) - (8)].c), (yyvsp[(3) - (8)].c), (yyvsp[(5) - (8)].c), (int)(yyvsp[(7) - (8)].d));
     ;}
     break;
 
   case 483:
-#line 5402 "Gmsh.y"
+#line 5429 "Gmsh.y"
     {
       NumberOption(GMSH_GET, (yyvsp[(1) - (6)].c), (int)(yyvsp[(3) - (6)].d), (yyvsp[(6) - (6)].c), (yyval.d));
       Free((yyvsp[(1) - (6)].c)); Free((yyvsp[(6) - (6)].c));
@@ -13137,7 +13164,7 @@ yyreduce:
     break;
 
   case 484:
-#line 5407 "Gmsh.y"
+#line 5434 "Gmsh.y"
     {
       double d = 0.;
       if(NumberOption(GMSH_GET, (yyvsp[(1) - (4)].c), 0, (yyvsp[(3) - (4)].c), d)){
@@ -13150,7 +13177,7 @@ yyreduce:
     break;
 
   case 485:
-#line 5417 "Gmsh.y"
+#line 5444 "Gmsh.y"
     {
       double d = 0.;
       if(NumberOption(GMSH_GET, (yyvsp[(1) - (7)].c), (int)(yyvsp[(3) - (7)].d), (yyvsp[(6) - (7)].c), d)){
@@ -13163,7 +13190,7 @@ yyreduce:
     break;
 
   case 486:
-#line 5427 "Gmsh.y"
+#line 5454 "Gmsh.y"
     {
       (yyval.d) = Msg::GetValue((yyvsp[(3) - (6)].c), (yyvsp[(5) - (6)].d));
       Free((yyvsp[(3) - (6)].c));
@@ -13171,7 +13198,7 @@ yyreduce:
     break;
 
   case 487:
-#line 5432 "Gmsh.y"
+#line 5459 "Gmsh.y"
     {
       int matches = 0;
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (6)].l)); i++){
@@ -13185,7 +13212,7 @@ yyreduce:
     break;
 
   case 488:
-#line 5443 "Gmsh.y"
+#line 5470 "Gmsh.y"
     {
       std::string s((yyvsp[(3) - (6)].c)), substr((yyvsp[(5) - (6)].c));
       if(s.find(substr) != std::string::npos)
@@ -13197,7 +13224,7 @@ yyreduce:
     break;
 
   case 489:
-#line 5452 "Gmsh.y"
+#line 5479 "Gmsh.y"
     {
       (yyval.d) = strlen((yyvsp[(3) - (4)].c));
       Free((yyvsp[(3) - (4)].c));
@@ -13205,7 +13232,7 @@ yyreduce:
     break;
 
   case 490:
-#line 5457 "Gmsh.y"
+#line 5484 "Gmsh.y"
     {
       (yyval.d) = strcmp((yyvsp[(3) - (6)].c), (yyvsp[(5) - (6)].c));
       Free((yyvsp[(3) - (6)].c)); Free((yyvsp[(5) - (6)].c));
@@ -13213,7 +13240,7 @@ yyreduce:
     break;
 
   case 491:
-#line 5462 "Gmsh.y"
+#line 5489 "Gmsh.y"
     {
       int align = 0, font = 0, fontsize = CTX::instance()->glFontSize;
       if(List_Nbr((yyvsp[(3) - (4)].l)) % 2){
@@ -13240,27 +13267,27 @@ yyreduce:
     break;
 
   case 492:
-#line 5489 "Gmsh.y"
+#line 5516 "Gmsh.y"
     { (yyval.d) = 0.; ;}
     break;
 
   case 493:
-#line 5491 "Gmsh.y"
+#line 5518 "Gmsh.y"
     { (yyval.d) = (yyvsp[(2) - (2)].d);;}
     break;
 
   case 494:
-#line 5496 "Gmsh.y"
+#line 5523 "Gmsh.y"
     { (yyval.c) = NULL; ;}
     break;
 
   case 495:
-#line 5498 "Gmsh.y"
+#line 5525 "Gmsh.y"
     { (yyval.c) = (yyvsp[(2) - (2)].c);;}
     break;
 
   case 496:
-#line 5503 "Gmsh.y"
+#line 5530 "Gmsh.y"
     {
       std::string struct_namespace((yyvsp[(2) - (3)].c2).char1? (yyvsp[(2) - (3)].c2).char1 : std::string("")),
         struct_name((yyvsp[(2) - (3)].c2).char2);
@@ -13270,7 +13297,7 @@ yyreduce:
     break;
 
   case 497:
-#line 5510 "Gmsh.y"
+#line 5537 "Gmsh.y"
     {
       std::string struct_namespace((yyvsp[(2) - (7)].c2).char1? (yyvsp[(2) - (7)].c2).char1 : std::string("")),
         struct_name((yyvsp[(2) - (7)].c2).char2);
@@ -13286,100 +13313,100 @@ yyreduce:
     break;
 
   case 498:
-#line 5526 "Gmsh.y"
+#line 5553 "Gmsh.y"
     { (yyval.c2).char1 = NULL; (yyval.c2).char2 = (yyvsp[(1) - (1)].c); ;}
     break;
 
   case 499:
-#line 5528 "Gmsh.y"
+#line 5555 "Gmsh.y"
     { (yyval.c2).char1 = (yyvsp[(1) - (3)].c); (yyval.c2).char2 = (yyvsp[(3) - (3)].c); ;}
     break;
 
   case 500:
-#line 5533 "Gmsh.y"
+#line 5560 "Gmsh.y"
     { (yyval.i) = 99; ;}
     break;
 
   case 501:
-#line 5535 "Gmsh.y"
+#line 5562 "Gmsh.y"
     { (yyval.i) = (int)(yyvsp[(2) - (2)].d); ;}
     break;
 
   case 502:
-#line 5540 "Gmsh.y"
+#line 5567 "Gmsh.y"
     { (yyval.i) = 0; ;}
     break;
 
   case 503:
-#line 5542 "Gmsh.y"
+#line 5569 "Gmsh.y"
     { (yyval.i) = (yyvsp[(2) - (3)].i); ;}
     break;
 
   case 504:
-#line 5547 "Gmsh.y"
+#line 5574 "Gmsh.y"
     {
       memcpy((yyval.v), (yyvsp[(1) - (1)].v), 5*sizeof(double));
     ;}
     break;
 
   case 505:
-#line 5551 "Gmsh.y"
+#line 5578 "Gmsh.y"
     {
       for(int i = 0; i < 5; i++) (yyval.v)[i] = -(yyvsp[(2) - (2)].v)[i];
     ;}
     break;
 
   case 506:
-#line 5555 "Gmsh.y"
+#line 5582 "Gmsh.y"
     {
       for(int i = 0; i < 5; i++) (yyval.v)[i] = (yyvsp[(2) - (2)].v)[i];
     ;}
     break;
 
   case 507:
-#line 5559 "Gmsh.y"
+#line 5586 "Gmsh.y"
     {
       for(int i = 0; i < 5; i++) (yyval.v)[i] = (yyvsp[(1) - (3)].v)[i] - (yyvsp[(3) - (3)].v)[i];
     ;}
     break;
 
   case 508:
-#line 5563 "Gmsh.y"
+#line 5590 "Gmsh.y"
     {
       for(int i = 0; i < 5; i++) (yyval.v)[i] = (yyvsp[(1) - (3)].v)[i] + (yyvsp[(3) - (3)].v)[i];
     ;}
     break;
 
   case 509:
-#line 5570 "Gmsh.y"
+#line 5597 "Gmsh.y"
     {
       (yyval.v)[0] = (yyvsp[(2) - (11)].d);  (yyval.v)[1] = (yyvsp[(4) - (11)].d);  (yyval.v)[2] = (yyvsp[(6) - (11)].d);  (yyval.v)[3] = (yyvsp[(8) - (11)].d); (yyval.v)[4] = (yyvsp[(10) - (11)].d);
     ;}
     break;
 
   case 510:
-#line 5574 "Gmsh.y"
+#line 5601 "Gmsh.y"
     {
       (yyval.v)[0] = (yyvsp[(2) - (9)].d);  (yyval.v)[1] = (yyvsp[(4) - (9)].d);  (yyval.v)[2] = (yyvsp[(6) - (9)].d);  (yyval.v)[3] = (yyvsp[(8) - (9)].d); (yyval.v)[4] = 1.0;
     ;}
     break;
 
   case 511:
-#line 5578 "Gmsh.y"
+#line 5605 "Gmsh.y"
     {
       (yyval.v)[0] = (yyvsp[(2) - (7)].d);  (yyval.v)[1] = (yyvsp[(4) - (7)].d);  (yyval.v)[2] = (yyvsp[(6) - (7)].d);  (yyval.v)[3] = 0.0; (yyval.v)[4] = 1.0;
     ;}
     break;
 
   case 512:
-#line 5582 "Gmsh.y"
+#line 5609 "Gmsh.y"
     {
       (yyval.v)[0] = (yyvsp[(2) - (7)].d);  (yyval.v)[1] = (yyvsp[(4) - (7)].d);  (yyval.v)[2] = (yyvsp[(6) - (7)].d);  (yyval.v)[3] = 0.0; (yyval.v)[4] = 1.0;
     ;}
     break;
 
   case 513:
-#line 5589 "Gmsh.y"
+#line 5616 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(List_T*));
       List_Add((yyval.l), &((yyvsp[(1) - (1)].l)));
@@ -13387,14 +13414,14 @@ yyreduce:
     break;
 
   case 514:
-#line 5594 "Gmsh.y"
+#line 5621 "Gmsh.y"
     {
       List_Add((yyval.l), &((yyvsp[(3) - (3)].l)));
     ;}
     break;
 
   case 515:
-#line 5601 "Gmsh.y"
+#line 5628 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(double));
       List_Add((yyval.l), &((yyvsp[(1) - (1)].d)));
@@ -13402,14 +13429,14 @@ yyreduce:
     break;
 
   case 516:
-#line 5606 "Gmsh.y"
+#line 5633 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(1) - (1)].l);
     ;}
     break;
 
   case 517:
-#line 5610 "Gmsh.y"
+#line 5637 "Gmsh.y"
     {
       // creates an empty list
       (yyval.l) = List_Create(2, 1, sizeof(double));
@@ -13417,14 +13444,14 @@ yyreduce:
     break;
 
   case 518:
-#line 5615 "Gmsh.y"
+#line 5642 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(2) - (3)].l);
     ;}
     break;
 
   case 519:
-#line 5619 "Gmsh.y"
+#line 5646 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(3) - (4)].l);
       for(int i = 0; i < List_Nbr((yyval.l)); i++){
@@ -13435,7 +13462,7 @@ yyreduce:
     break;
 
   case 520:
-#line 5627 "Gmsh.y"
+#line 5654 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(4) - (5)].l);
       for(int i = 0; i < List_Nbr((yyval.l)); i++){
@@ -13446,21 +13473,21 @@ yyreduce:
     break;
 
   case 521:
-#line 5638 "Gmsh.y"
+#line 5665 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(1) - (1)].l);
     ;}
     break;
 
   case 522:
-#line 5642 "Gmsh.y"
+#line 5669 "Gmsh.y"
     {
       (yyval.l) = 0;
     ;}
     break;
 
   case 523:
-#line 5646 "Gmsh.y"
+#line 5673 "Gmsh.y"
     {
       if(!strcmp((yyvsp[(1) - (1)].c), "*") || !strcmp((yyvsp[(1) - (1)].c), "all")){
         (yyval.l) = 0;
@@ -13474,7 +13501,7 @@ yyreduce:
     break;
 
   case 524:
-#line 5660 "Gmsh.y"
+#line 5687 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(2) - (2)].l);
       for(int i = 0; i < List_Nbr((yyval.l)); i++){
@@ -13485,7 +13512,7 @@ yyreduce:
     break;
 
   case 525:
-#line 5668 "Gmsh.y"
+#line 5695 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(3) - (3)].l);
       for(int i = 0; i < List_Nbr((yyval.l)); i++){
@@ -13496,7 +13523,7 @@ yyreduce:
     break;
 
   case 526:
-#line 5676 "Gmsh.y"
+#line 5703 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(double));
       for(double d = (yyvsp[(1) - (3)].d); ((yyvsp[(1) - (3)].d) < (yyvsp[(3) - (3)].d)) ? (d <= (yyvsp[(3) - (3)].d)) : (d >= (yyvsp[(3) - (3)].d));
@@ -13506,7 +13533,7 @@ yyreduce:
     break;
 
   case 527:
-#line 5683 "Gmsh.y"
+#line 5710 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(double));
       if(!(yyvsp[(5) - (5)].d)){  //|| ($1 < $3 && $5 < 0) || ($1 > $3 && $5 > 0)
@@ -13519,7 +13546,7 @@ yyreduce:
     break;
 
   case 528:
-#line 5693 "Gmsh.y"
+#line 5720 "Gmsh.y"
     {
       (yyval.l) = List_Create(3, 1, sizeof(double));
       int tag = (int)(yyvsp[(3) - (4)].d);
@@ -13545,7 +13572,7 @@ yyreduce:
     break;
 
   case 529:
-#line 5716 "Gmsh.y"
+#line 5743 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       getAllElementaryTags(0, (yyval.l));
@@ -13553,7 +13580,7 @@ yyreduce:
     break;
 
   case 530:
-#line 5721 "Gmsh.y"
+#line 5748 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       getAllElementaryTags(0, (yyval.l));
@@ -13562,7 +13589,7 @@ yyreduce:
     break;
 
   case 531:
-#line 5727 "Gmsh.y"
+#line 5754 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       getAllElementaryTags((yyvsp[(1) - (4)].i), (yyval.l));
@@ -13570,7 +13597,7 @@ yyreduce:
     break;
 
   case 532:
-#line 5732 "Gmsh.y"
+#line 5759 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       getAllElementaryTags((yyvsp[(1) - (2)].i), (yyval.l));
@@ -13579,7 +13606,7 @@ yyreduce:
     break;
 
   case 533:
-#line 5738 "Gmsh.y"
+#line 5765 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       if(!(yyvsp[(3) - (3)].l)){
@@ -13593,7 +13620,7 @@ yyreduce:
     break;
 
   case 534:
-#line 5749 "Gmsh.y"
+#line 5776 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       getParentTags((yyvsp[(2) - (3)].i), (yyvsp[(3) - (3)].l), (yyval.l));
@@ -13602,7 +13629,7 @@ yyreduce:
     break;
 
   case 535:
-#line 5755 "Gmsh.y"
+#line 5782 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       if(List_Nbr((yyvsp[(4) - (4)].l)) < 6) {
@@ -13619,7 +13646,7 @@ yyreduce:
     break;
 
   case 536:
-#line 5769 "Gmsh.y"
+#line 5796 "Gmsh.y"
     {
       (yyval.l) = List_Create(10, 10, sizeof(double));
       getBoundingBox((yyvsp[(2) - (5)].i), (yyvsp[(4) - (5)].l), (yyval.l));
@@ -13628,7 +13655,7 @@ yyreduce:
     break;
 
   case 537:
-#line 5775 "Gmsh.y"
+#line 5802 "Gmsh.y"
     {
       (yyval.l) = List_Create(1, 1, sizeof(double));
       double m = 0;
@@ -13643,7 +13670,7 @@ yyreduce:
     break;
 
   case 538:
-#line 5787 "Gmsh.y"
+#line 5814 "Gmsh.y"
     {
       (yyval.l) = List_Create(3, 1, sizeof(double));
       double x = 0., y = 0., z = 0.;
@@ -13660,7 +13687,7 @@ yyreduce:
     break;
 
   case 539:
-#line 5801 "Gmsh.y"
+#line 5828 "Gmsh.y"
     {
       (yyval.l) = List_Create(List_Nbr((yyvsp[(1) - (1)].l)), 1, sizeof(double));
       for(int i = 0; i < List_Nbr((yyvsp[(1) - (1)].l)); i++){
@@ -13673,7 +13700,7 @@ yyreduce:
     break;
 
   case 540:
-#line 5811 "Gmsh.y"
+#line 5838 "Gmsh.y"
     {
       (yyval.l) = List_Create(List_Nbr((yyvsp[(1) - (1)].l)), 1, sizeof(double));
       for(int i = 0; i < List_Nbr((yyvsp[(1) - (1)].l)); i++){
@@ -13686,7 +13713,7 @@ yyreduce:
     break;
 
   case 541:
-#line 5821 "Gmsh.y"
+#line 5848 "Gmsh.y"
     {
       (yyval.l) = List_Create(List_Nbr((yyvsp[(1) - (1)].l)), 1, sizeof(double));
       for(int i = 0; i < List_Nbr((yyvsp[(1) - (1)].l)); i++){
@@ -13699,7 +13726,7 @@ yyreduce:
     break;
 
   case 542:
-#line 5831 "Gmsh.y"
+#line 5858 "Gmsh.y"
     {
       (yyval.l) = List_Create(20, 20, sizeof(double));
       if(!gmsh_yysymbols.count((yyvsp[(1) - (3)].c)))
@@ -13714,21 +13741,21 @@ yyreduce:
     break;
 
   case 543:
-#line 5843 "Gmsh.y"
+#line 5870 "Gmsh.y"
     {
       (yyval.l) = treat_Struct_FullName_dot_tSTRING_ListOfFloat(NULL, (yyvsp[(1) - (5)].c), (yyvsp[(3) - (5)].c));
     ;}
     break;
 
   case 544:
-#line 5847 "Gmsh.y"
+#line 5874 "Gmsh.y"
     {
       (yyval.l) = treat_Struct_FullName_dot_tSTRING_ListOfFloat((yyvsp[(1) - (7)].c), (yyvsp[(3) - (7)].c), (yyvsp[(5) - (7)].c));
     ;}
     break;
 
   case 545:
-#line 5852 "Gmsh.y"
+#line 5879 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(double));
       if(!gmsh_yysymbols.count((yyvsp[(3) - (4)].c)))
@@ -13743,28 +13770,28 @@ yyreduce:
     break;
 
   case 546:
-#line 5864 "Gmsh.y"
+#line 5891 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(3) - (4)].l);
     ;}
     break;
 
   case 547:
-#line 5868 "Gmsh.y"
+#line 5895 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(3) - (4)].l);
     ;}
     break;
 
   case 548:
-#line 5872 "Gmsh.y"
+#line 5899 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(4) - (6)].l);
     ;}
     break;
 
   case 549:
-#line 5876 "Gmsh.y"
+#line 5903 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(double));
       if(!gmsh_yysymbols.count((yyvsp[(1) - (6)].c)))
@@ -13785,7 +13812,7 @@ yyreduce:
     break;
 
   case 550:
-#line 5894 "Gmsh.y"
+#line 5921 "Gmsh.y"
     {
       (yyval.l) = List_Create(20,20,sizeof(double));
       for(int i = 0; i < (int)(yyvsp[(7) - (8)].d); i++) {
@@ -13796,7 +13823,7 @@ yyreduce:
     break;
 
   case 551:
-#line 5902 "Gmsh.y"
+#line 5929 "Gmsh.y"
     {
       (yyval.l) = List_Create(20,20,sizeof(double));
       for(int i = 0; i < (int)(yyvsp[(7) - (8)].d); i++) {
@@ -13807,7 +13834,7 @@ yyreduce:
     break;
 
   case 552:
-#line 5910 "Gmsh.y"
+#line 5937 "Gmsh.y"
     {
       Msg::Barrier();
       FILE *File;
@@ -13839,7 +13866,7 @@ yyreduce:
     break;
 
   case 553:
-#line 5939 "Gmsh.y"
+#line 5966 "Gmsh.y"
     {
       double x0 = (yyvsp[(3) - (14)].d), x1 = (yyvsp[(5) - (14)].d), y0 = (yyvsp[(7) - (14)].d), y1 = (yyvsp[(9) - (14)].d), ys = (yyvsp[(11) - (14)].d);
       int N = (int)(yyvsp[(13) - (14)].d);
@@ -13852,7 +13879,7 @@ yyreduce:
     break;
 
   case 554:
-#line 5949 "Gmsh.y"
+#line 5976 "Gmsh.y"
     {
       std::vector<double> tmp;
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (4)].l)); i++){
@@ -13871,7 +13898,7 @@ yyreduce:
     break;
 
   case 555:
-#line 5965 "Gmsh.y"
+#line 5992 "Gmsh.y"
     {
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (4)].l)); i++){
         double *d = (double*)List_Pointer((yyvsp[(3) - (4)].l), i);
@@ -13882,7 +13909,7 @@ yyreduce:
     break;
 
   case 556:
-#line 5976 "Gmsh.y"
+#line 6003 "Gmsh.y"
     {
       (yyval.l) = List_Create(2, 1, sizeof(double));
       List_Add((yyval.l), &((yyvsp[(1) - (1)].d)));
@@ -13890,21 +13917,21 @@ yyreduce:
     break;
 
   case 557:
-#line 5981 "Gmsh.y"
+#line 6008 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(1) - (1)].l);
     ;}
     break;
 
   case 558:
-#line 5985 "Gmsh.y"
+#line 6012 "Gmsh.y"
     {
       List_Add((yyval.l), &((yyvsp[(3) - (3)].d)));
     ;}
     break;
 
   case 559:
-#line 5989 "Gmsh.y"
+#line 6016 "Gmsh.y"
     {
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (3)].l)); i++){
 	double d;
@@ -13916,21 +13943,21 @@ yyreduce:
     break;
 
   case 560:
-#line 6001 "Gmsh.y"
+#line 6028 "Gmsh.y"
     {
       (yyval.u) = CTX::instance()->packColor((int)(yyvsp[(2) - (9)].d), (int)(yyvsp[(4) - (9)].d), (int)(yyvsp[(6) - (9)].d), (int)(yyvsp[(8) - (9)].d));
     ;}
     break;
 
   case 561:
-#line 6005 "Gmsh.y"
+#line 6032 "Gmsh.y"
     {
       (yyval.u) = CTX::instance()->packColor((int)(yyvsp[(2) - (7)].d), (int)(yyvsp[(4) - (7)].d), (int)(yyvsp[(6) - (7)].d), 255);
     ;}
     break;
 
   case 562:
-#line 6017 "Gmsh.y"
+#line 6044 "Gmsh.y"
     {
       int flag = 0;
       if(gmsh_yystringsymbols.count((yyvsp[(1) - (1)].c))){
@@ -13950,7 +13977,7 @@ yyreduce:
     break;
 
   case 563:
-#line 6034 "Gmsh.y"
+#line 6061 "Gmsh.y"
     {
       unsigned int val = 0;
       ColorOption(GMSH_GET, (yyvsp[(1) - (5)].c), 0, (yyvsp[(5) - (5)].c), val);
@@ -13960,14 +13987,14 @@ yyreduce:
     break;
 
   case 564:
-#line 6044 "Gmsh.y"
+#line 6071 "Gmsh.y"
     {
       (yyval.l) = (yyvsp[(2) - (3)].l);
     ;}
     break;
 
   case 565:
-#line 6048 "Gmsh.y"
+#line 6075 "Gmsh.y"
     {
       (yyval.l) = List_Create(256, 10, sizeof(unsigned int));
       GmshColorTable *ct = GetColorTable((int)(yyvsp[(3) - (6)].d));
@@ -13982,7 +14009,7 @@ yyreduce:
     break;
 
   case 566:
-#line 6063 "Gmsh.y"
+#line 6090 "Gmsh.y"
     {
       (yyval.l) = List_Create(256, 10, sizeof(unsigned int));
       List_Add((yyval.l), &((yyvsp[(1) - (1)].u)));
@@ -13990,21 +14017,21 @@ yyreduce:
     break;
 
   case 567:
-#line 6068 "Gmsh.y"
+#line 6095 "Gmsh.y"
     {
       List_Add((yyval.l), &((yyvsp[(3) - (3)].u)));
     ;}
     break;
 
   case 568:
-#line 6075 "Gmsh.y"
+#line 6102 "Gmsh.y"
     {
       (yyval.c) = (yyvsp[(1) - (1)].c);
     ;}
     break;
 
   case 569:
-#line 6079 "Gmsh.y"
+#line 6106 "Gmsh.y"
     {
       // No need to extend to Struct_FullName (a Tag is not a String)
       (yyval.c) = treat_Struct_FullName_String(NULL, (yyvsp[(1) - (1)].c));
@@ -14012,7 +14039,7 @@ yyreduce:
     break;
 
   case 570:
-#line 6084 "Gmsh.y"
+#line 6111 "Gmsh.y"
     {
       std::string val;
       int j = (int)(yyvsp[(3) - (4)].d);
@@ -14029,7 +14056,7 @@ yyreduce:
     break;
 
   case 571:
-#line 6098 "Gmsh.y"
+#line 6125 "Gmsh.y"
     {
       std::string val;
       int j = (int)(yyvsp[(3) - (4)].d);
@@ -14046,35 +14073,35 @@ yyreduce:
     break;
 
   case 572:
-#line 6112 "Gmsh.y"
+#line 6139 "Gmsh.y"
     {
       (yyval.c) = treat_Struct_FullName_dot_tSTRING_String(NULL, (yyvsp[(1) - (3)].c), (yyvsp[(3) - (3)].c));
     ;}
     break;
 
   case 573:
-#line 6116 "Gmsh.y"
+#line 6143 "Gmsh.y"
     {
       (yyval.c) = treat_Struct_FullName_dot_tSTRING_String((yyvsp[(1) - (5)].c), (yyvsp[(3) - (5)].c), (yyvsp[(5) - (5)].c));
     ;}
     break;
 
   case 574:
-#line 6120 "Gmsh.y"
+#line 6147 "Gmsh.y"
     {
       (yyval.c) = treat_Struct_FullName_dot_tSTRING_String(NULL, (yyvsp[(1) - (6)].c), (yyvsp[(3) - (6)].c), (int)(yyvsp[(5) - (6)].d));
     ;}
     break;
 
   case 575:
-#line 6124 "Gmsh.y"
+#line 6151 "Gmsh.y"
     {
       (yyval.c) = treat_Struct_FullName_dot_tSTRING_String((yyvsp[(1) - (8)].c), (yyvsp[(3) - (8)].c), (yyvsp[(5) - (8)].c), (int)(yyvsp[(7) - (8)].d));
     ;}
     break;
 
   case 576:
-#line 6128 "Gmsh.y"
+#line 6155 "Gmsh.y"
     {
       std::string out;
       StringOption(GMSH_GET, (yyvsp[(1) - (6)].c), (int)(yyvsp[(3) - (6)].d), (yyvsp[(6) - (6)].c), out);
@@ -14085,7 +14112,7 @@ yyreduce:
     break;
 
   case 577:
-#line 6136 "Gmsh.y"
+#line 6163 "Gmsh.y"
     {
       std::string name = GModel::current()->getElementaryName((yyvsp[(1) - (4)].i), (int)(yyvsp[(3) - (4)].d));
       (yyval.c) = (char*)Malloc((name.size() + 1) * sizeof(char));
@@ -14094,7 +14121,7 @@ yyreduce:
     break;
 
   case 578:
-#line 6142 "Gmsh.y"
+#line 6169 "Gmsh.y"
     {
       std::string name = GModel::current()->getPhysicalName((yyvsp[(2) - (5)].i), (int)(yyvsp[(4) - (5)].d));
       (yyval.c) = (char*)Malloc((name.size() + 1) * sizeof(char));
@@ -14103,21 +14130,21 @@ yyreduce:
     break;
 
   case 579:
-#line 6151 "Gmsh.y"
+#line 6178 "Gmsh.y"
     {
       (yyval.c) = (yyvsp[(1) - (1)].c);
     ;}
     break;
 
   case 580:
-#line 6155 "Gmsh.y"
+#line 6182 "Gmsh.y"
     {
       (yyval.c) = (yyvsp[(3) - (4)].c);
     ;}
     break;
 
   case 581:
-#line 6159 "Gmsh.y"
+#line 6186 "Gmsh.y"
     {
       (yyval.c) = (char *)Malloc(32 * sizeof(char));
       time_t now;
@@ -14128,7 +14155,7 @@ yyreduce:
     break;
 
   case 582:
-#line 6167 "Gmsh.y"
+#line 6194 "Gmsh.y"
     {
       std::string exe = Msg::GetExecutableName();
       (yyval.c) = (char *)Malloc(exe.size() + 1);
@@ -14137,7 +14164,7 @@ yyreduce:
     break;
 
   case 583:
-#line 6173 "Gmsh.y"
+#line 6200 "Gmsh.y"
     {
       std::string action = Msg::GetOnelabAction();
       (yyval.c) = (char *)Malloc(action.size() + 1);
@@ -14146,14 +14173,14 @@ yyreduce:
     break;
 
   case 584:
-#line 6179 "Gmsh.y"
+#line 6206 "Gmsh.y"
     {
       (yyval.c) = strsave((char*)"Gmsh");
     ;}
     break;
 
   case 585:
-#line 6183 "Gmsh.y"
+#line 6210 "Gmsh.y"
     {
       std::string env = GetEnvironmentVar((yyvsp[(3) - (4)].c));
       (yyval.c) = (char *)Malloc((env.size() + 1) * sizeof(char));
@@ -14163,7 +14190,7 @@ yyreduce:
     break;
 
   case 586:
-#line 6190 "Gmsh.y"
+#line 6217 "Gmsh.y"
     {
       std::string s = Msg::GetString((yyvsp[(3) - (6)].c), (yyvsp[(5) - (6)].c));
       (yyval.c) = (char *)Malloc((s.size() + 1) * sizeof(char));
@@ -14174,7 +14201,7 @@ yyreduce:
     break;
 
   case 587:
-#line 6198 "Gmsh.y"
+#line 6225 "Gmsh.y"
     {
       std::string s = Msg::GetOnelabString((yyvsp[(3) - (4)].c));
       (yyval.c) = (char *)Malloc((s.size() + 1) * sizeof(char));
@@ -14184,7 +14211,7 @@ yyreduce:
     break;
 
   case 588:
-#line 6205 "Gmsh.y"
+#line 6232 "Gmsh.y"
     {
       std::string s = Msg::GetOnelabString((yyvsp[(3) - (6)].c), (yyvsp[(5) - (6)].c));
       (yyval.c) = (char *)Malloc((s.size() + 1) * sizeof(char));
@@ -14195,21 +14222,21 @@ yyreduce:
     break;
 
   case 589:
-#line 6214 "Gmsh.y"
+#line 6241 "Gmsh.y"
     {
       (yyval.c) = treat_Struct_FullName_String(NULL, (yyvsp[(3) - (5)].c2).char2, 1, 0, (yyvsp[(4) - (5)].c), 2);
     ;}
     break;
 
   case 590:
-#line 6218 "Gmsh.y"
+#line 6245 "Gmsh.y"
     {
       (yyval.c) = treat_Struct_FullName_dot_tSTRING_String((yyvsp[(3) - (7)].c2).char1, (yyvsp[(3) - (7)].c2).char2, (yyvsp[(5) - (7)].c), 0, (yyvsp[(6) - (7)].c), 2);
     ;}
     break;
 
   case 591:
-#line 6222 "Gmsh.y"
+#line 6249 "Gmsh.y"
     {
       int size = 1;
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (4)].l)); i++)
@@ -14227,7 +14254,7 @@ yyreduce:
     break;
 
   case 592:
-#line 6237 "Gmsh.y"
+#line 6264 "Gmsh.y"
     {
       (yyval.c) = (char *)Malloc((strlen((yyvsp[(3) - (4)].c)) + 1) * sizeof(char));
       int i;
@@ -14244,7 +14271,7 @@ yyreduce:
     break;
 
   case 593:
-#line 6251 "Gmsh.y"
+#line 6278 "Gmsh.y"
     {
       (yyval.c) = (char *)Malloc((strlen((yyvsp[(3) - (4)].c)) + 1) * sizeof(char));
       int i;
@@ -14261,7 +14288,7 @@ yyreduce:
     break;
 
   case 594:
-#line 6265 "Gmsh.y"
+#line 6292 "Gmsh.y"
     {
       std::string input = (yyvsp[(3) - (8)].c);
       std::string substr_old = (yyvsp[(5) - (8)].c);
@@ -14276,7 +14303,7 @@ yyreduce:
     break;
 
   case 595:
-#line 6277 "Gmsh.y"
+#line 6304 "Gmsh.y"
     {
       int size = 1;
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (4)].l)); i++)
@@ -14295,7 +14322,7 @@ yyreduce:
     break;
 
   case 596:
-#line 6293 "Gmsh.y"
+#line 6320 "Gmsh.y"
     {
       int i = 0;
       while ((yyvsp[(3) - (4)].c)[i]) {
@@ -14307,7 +14334,7 @@ yyreduce:
     break;
 
   case 597:
-#line 6302 "Gmsh.y"
+#line 6329 "Gmsh.y"
     {
       int i = 0;
       while ((yyvsp[(3) - (4)].c)[i]) {
@@ -14319,7 +14346,7 @@ yyreduce:
     break;
 
   case 598:
-#line 6311 "Gmsh.y"
+#line 6338 "Gmsh.y"
     {
       int i = 0;
       while ((yyvsp[(3) - (4)].c)[i]) {
@@ -14332,7 +14359,7 @@ yyreduce:
     break;
 
   case 599:
-#line 6321 "Gmsh.y"
+#line 6348 "Gmsh.y"
     {
       if((yyvsp[(3) - (8)].d)){
         (yyval.c) = (yyvsp[(5) - (8)].c);
@@ -14346,7 +14373,7 @@ yyreduce:
     break;
 
   case 600:
-#line 6332 "Gmsh.y"
+#line 6359 "Gmsh.y"
     {
       std::string in = (yyvsp[(3) - (8)].c);
       std::string out = in.substr((int)(yyvsp[(5) - (8)].d), (int)(yyvsp[(7) - (8)].d));
@@ -14357,7 +14384,7 @@ yyreduce:
     break;
 
   case 601:
-#line 6340 "Gmsh.y"
+#line 6367 "Gmsh.y"
     {
       std::string in = (yyvsp[(3) - (6)].c);
       std::string out = in.substr((int)(yyvsp[(5) - (6)].d), std::string::npos);
@@ -14368,14 +14395,14 @@ yyreduce:
     break;
 
   case 602:
-#line 6348 "Gmsh.y"
+#line 6375 "Gmsh.y"
     {
       (yyval.c) = (yyvsp[(3) - (4)].c);
     ;}
     break;
 
   case 603:
-#line 6352 "Gmsh.y"
+#line 6379 "Gmsh.y"
     {
       char tmpstring[5000];
       int i = printListOfDouble((yyvsp[(3) - (6)].c), (yyvsp[(5) - (6)].l), tmpstring);
@@ -14397,7 +14424,7 @@ yyreduce:
     break;
 
   case 604:
-#line 6371 "Gmsh.y"
+#line 6398 "Gmsh.y"
     {
       std::string tmp = FixRelativePath(gmsh_yyname, (yyvsp[(3) - (4)].c));
       (yyval.c) = (char*)Malloc((tmp.size() + 1) * sizeof(char));
@@ -14407,7 +14434,7 @@ yyreduce:
     break;
 
   case 605:
-#line 6378 "Gmsh.y"
+#line 6405 "Gmsh.y"
     {
       std::string tmp = SplitFileName(GetAbsolutePath(gmsh_yyname))[0];
       (yyval.c) = (char*)Malloc((tmp.size() + 1) * sizeof(char));
@@ -14416,7 +14443,7 @@ yyreduce:
     break;
 
   case 606:
-#line 6384 "Gmsh.y"
+#line 6411 "Gmsh.y"
     {
       std::string tmp = GetFileNameWithoutPath(gmsh_yyname);
       (yyval.c) = (char*)Malloc((tmp.size() + 1) * sizeof(char));
@@ -14425,7 +14452,7 @@ yyreduce:
     break;
 
   case 607:
-#line 6390 "Gmsh.y"
+#line 6417 "Gmsh.y"
     {
       std::string tmp = SplitFileName((yyvsp[(3) - (4)].c))[0];
       (yyval.c) = (char*)Malloc((tmp.size() + 1) * sizeof(char));
@@ -14435,7 +14462,7 @@ yyreduce:
     break;
 
   case 608:
-#line 6397 "Gmsh.y"
+#line 6424 "Gmsh.y"
     {
       std::string tmp = GetAbsolutePath((yyvsp[(3) - (4)].c));
       (yyval.c) = (char*)Malloc((tmp.size() + 1) * sizeof(char));
@@ -14445,12 +14472,12 @@ yyreduce:
     break;
 
   case 609:
-#line 6404 "Gmsh.y"
+#line 6431 "Gmsh.y"
     { init_options(); ;}
     break;
 
   case 610:
-#line 6406 "Gmsh.y"
+#line 6433 "Gmsh.y"
     {
       std::string val((yyvsp[(3) - (6)].c));
       Msg::ExchangeOnelabParameter("", val, floatOptions, charOptions);
@@ -14461,7 +14488,7 @@ yyreduce:
     break;
 
   case 611:
-#line 6414 "Gmsh.y"
+#line 6441 "Gmsh.y"
     {
       std::string out;
       const std::string * key_struct = NULL;
@@ -14485,37 +14512,37 @@ yyreduce:
     break;
 
   case 612:
-#line 6438 "Gmsh.y"
+#line 6465 "Gmsh.y"
     { struct_namespace = std::string(""); (yyval.d) = (yyvsp[(2) - (2)].d); ;}
     break;
 
   case 613:
-#line 6440 "Gmsh.y"
+#line 6467 "Gmsh.y"
     { struct_namespace = (yyvsp[(1) - (4)].c); Free((yyvsp[(1) - (4)].c)); (yyval.d) = (yyvsp[(4) - (4)].d); ;}
     break;
 
   case 614:
-#line 6446 "Gmsh.y"
+#line 6473 "Gmsh.y"
     { (yyval.l) = (yyvsp[(3) - (4)].l); ;}
     break;
 
   case 615:
-#line 6451 "Gmsh.y"
+#line 6478 "Gmsh.y"
     { (yyval.l) = (yyvsp[(1) - (1)].l); ;}
     break;
 
   case 616:
-#line 6453 "Gmsh.y"
+#line 6480 "Gmsh.y"
     { (yyval.l) = (yyvsp[(1) - (1)].l); ;}
     break;
 
   case 617:
-#line 6458 "Gmsh.y"
+#line 6485 "Gmsh.y"
     { (yyval.l) = (yyvsp[(2) - (3)].l); ;}
     break;
 
   case 618:
-#line 6463 "Gmsh.y"
+#line 6490 "Gmsh.y"
     {
       (yyval.l) = List_Create(20,20,sizeof(char*));
       List_Add((yyval.l), &((yyvsp[(1) - (1)].c)));
@@ -14523,19 +14550,19 @@ yyreduce:
     break;
 
   case 619:
-#line 6468 "Gmsh.y"
+#line 6495 "Gmsh.y"
     { (yyval.l) = (yyvsp[(1) - (1)].l); ;}
     break;
 
   case 620:
-#line 6470 "Gmsh.y"
+#line 6497 "Gmsh.y"
     {
       List_Add((yyval.l), &((yyvsp[(3) - (3)].c)));
     ;}
     break;
 
   case 621:
-#line 6474 "Gmsh.y"
+#line 6501 "Gmsh.y"
     {
       for(int i = 0; i < List_Nbr((yyvsp[(3) - (3)].l)); i++){
 	char* c;
@@ -14547,7 +14574,7 @@ yyreduce:
     break;
 
   case 622:
-#line 6486 "Gmsh.y"
+#line 6513 "Gmsh.y"
     {
       (yyval.l) = List_Create(20, 20, sizeof(char *));
       if(!gmsh_yystringsymbols.count((yyvsp[(1) - (3)].c)))
@@ -14564,21 +14591,21 @@ yyreduce:
     break;
 
   case 623:
-#line 6500 "Gmsh.y"
+#line 6527 "Gmsh.y"
     {
       (yyval.l) = treat_Struct_FullName_dot_tSTRING_ListOfString(NULL, (yyvsp[(1) - (5)].c), (yyvsp[(3) - (5)].c));
     ;}
     break;
 
   case 624:
-#line 6504 "Gmsh.y"
+#line 6531 "Gmsh.y"
     {
       (yyval.l) = treat_Struct_FullName_dot_tSTRING_ListOfString((yyvsp[(1) - (7)].c), (yyvsp[(3) - (7)].c), (yyvsp[(5) - (7)].c));
     ;}
     break;
 
   case 625:
-#line 6511 "Gmsh.y"
+#line 6538 "Gmsh.y"
     {
       char tmpstr[256];
       sprintf(tmpstr, "_%d", (int)(yyvsp[(4) - (5)].d));
@@ -14589,7 +14616,7 @@ yyreduce:
     break;
 
   case 626:
-#line 6519 "Gmsh.y"
+#line 6546 "Gmsh.y"
     {
       char tmpstr[256];
       sprintf(tmpstr, "_%d", (int)(yyvsp[(4) - (5)].d));
@@ -14600,7 +14627,7 @@ yyreduce:
     break;
 
   case 627:
-#line 6527 "Gmsh.y"
+#line 6554 "Gmsh.y"
     {
       char tmpstr[256];
       sprintf(tmpstr, "_%d", (int)(yyvsp[(7) - (8)].d));
@@ -14611,23 +14638,23 @@ yyreduce:
     break;
 
   case 628:
-#line 6538 "Gmsh.y"
+#line 6565 "Gmsh.y"
     { (yyval.c) = (yyvsp[(1) - (1)].c); ;}
     break;
 
   case 629:
-#line 6540 "Gmsh.y"
+#line 6567 "Gmsh.y"
     { (yyval.c) = (yyvsp[(1) - (1)].c); ;}
     break;
 
   case 630:
-#line 6543 "Gmsh.y"
+#line 6570 "Gmsh.y"
     { (yyval.c) = (yyvsp[(3) - (4)].c); ;}
     break;
 
 
 /* Line 1267 of yacc.c.  */
-#line 14631 "Gmsh.tab.cpp"
+#line 14658 "Gmsh.tab.cpp"
       default: break;
     }
   YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
@@ -14841,13 +14868,14 @@ yyreturn:
 }
 
 
-#line 6546 "Gmsh.y"
+#line 6573 "Gmsh.y"
 
 
 void assignVariable(const std::string &name, int index, int assignType,
                     double value)
 {
-  if(!gmsh_yysymbols.count(name)){
+  std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find(name);
+  if(it == gmsh_yysymbols.end()){
     if(!assignType){
       gmsh_yysymbol &s(gmsh_yysymbols[name]);
       s.list = true;
@@ -14858,7 +14886,7 @@ void assignVariable(const std::string &name, int index, int assignType,
       yymsg(0, "Unknown variable '%s'", name.c_str());
   }
   else{
-    gmsh_yysymbol &s(gmsh_yysymbols[name]);
+    gmsh_yysymbol &s(it->second);
     if(s.list){
       if((int)s.value.size() < index + 1) s.value.resize(index + 1, 0.);
       switch(assignType){
@@ -14885,7 +14913,8 @@ void assignVariables(const std::string &name, List_T *indices, int assignType,
     yymsg(0, "Incompatible array dimensions in affectation");
   }
   else{
-    if(!gmsh_yysymbols.count(name)){
+    std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find(name);
+    if(it == gmsh_yysymbols.end()){
       if(!assignType){
         gmsh_yysymbol &s(gmsh_yysymbols[name]);
         s.list = true;
@@ -14899,7 +14928,7 @@ void assignVariables(const std::string &name, List_T *indices, int assignType,
         yymsg(0, "Unknown variable '%s'", name.c_str());
     }
     else{
-      gmsh_yysymbol &s(gmsh_yysymbols[name]);
+      gmsh_yysymbol &s(it->second);
       if(s.list){
         for(int i = 0; i < List_Nbr(indices); i++){
           int index = (int)(*(double*)List_Pointer(indices, i));
@@ -14925,10 +14954,11 @@ void assignVariables(const std::string &name, List_T *indices, int assignType,
 
 void incrementVariable(const std::string &name, int index, double value)
 {
-  if(!gmsh_yysymbols.count(name))
+  std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find(name);
+  if(it == gmsh_yysymbols.end())
     yymsg(0, "Unknown variable '%s'", name.c_str());
   else{
-    gmsh_yysymbol &s(gmsh_yysymbols[name]);
+    gmsh_yysymbol &s(it->second);
     if(s.list){
       if((int)s.value.size() < index + 1) s.value.resize(index + 1, 0.);
       s.value[index] += value;
@@ -15509,11 +15539,12 @@ double treat_Struct_FullName_Float
 (char* c1, char* c2, int type_var, int index, double val_default, int type_treat)
 {
   double out;
-  if(!c1 && gmsh_yysymbols.count(c2)){
+  std::map<std::string, gmsh_yysymbol>::iterator it;
+  if(!c1 && (it = gmsh_yysymbols.find(c2)) != gmsh_yysymbols.end()){
     if (type_treat == 1) out = 1.; // Exists (type_treat == 1)
     else { // Get (0) or GetForced (2)
       if (type_var == 1) {
-        gmsh_yysymbol &s(gmsh_yysymbols[c2]);
+        gmsh_yysymbol &s(it->second);
         if(s.value.empty()){
           out = val_default;
           if (type_treat == 0) yymsg(0, "Uninitialized variable '%s'", c2);
@@ -15522,7 +15553,7 @@ double treat_Struct_FullName_Float
           out = s.value[0];
       }
       else if (type_var == 2) {
-        gmsh_yysymbol &s(gmsh_yysymbols[c2]);
+        gmsh_yysymbol &s(it->second);
         if(index < 0 || (int)s.value.size() < index + 1){
           out = val_default;
           if (type_treat == 0) yymsg(0, "Uninitialized variable '%s[%d]'", c2, index);
@@ -807,11 +807,14 @@ Affectation :
     }
   | String__Index NumericAffectation ListOfDouble tEND
     {
-      if(!gmsh_yysymbols.count($1) && $2 && List_Nbr($3) == 1){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find($1);
+      if(it == gmsh_yysymbols.end() && $2 && List_Nbr($3) == 1){
         yymsg(0, "Unknown variable '%s'", $1);
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[$1]);
+        if(it == gmsh_yysymbols.end())
+          it = gmsh_yysymbols.insert(std::make_pair(std::string($1), gmsh_yysymbol())).first;
+        gmsh_yysymbol &s(it->second);
         if(!$2) s.list = (List_Nbr($3) != 1); // list if 0 or > 1 elements
         if(!s.list){ // single expression
           if(List_Nbr($3) != 1){
@@ -869,10 +872,11 @@ Affectation :
     }
   | String__Index NumericIncrement tEND
     {
-      if(!gmsh_yysymbols.count($1))
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find($1);
+      if(it == gmsh_yysymbols.end())
 	yymsg(0, "Unknown variable '%s'", $1);
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[$1]);
+        gmsh_yysymbol &s(it->second);
         if(!s.list && s.value.empty())
           yymsg(0, "Uninitialized variable '%s'", $1);
         else if(!s.list)
@@ -3666,8 +3670,10 @@ Loop :
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if($3 > $5)
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -3683,8 +3689,10 @@ Loop :
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if(($7 > 0. && $3 > $5) || ($7 < 0. && $3 < $5))
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -3704,8 +3712,10 @@ Loop :
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if($5 > $7)
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -3726,8 +3736,10 @@ Loop :
       yylinenoImbricatedLoopsTab[ImbricatedLoop] = gmsh_yylineno;
       if(($9 > 0. && $5 > $7) || ($9 < 0. && $5 < $7))
 	skip("For", "EndFor");
-      else
+      else{
+        gmsh_yystartloop(ImbricatedLoop);
 	ImbricatedLoop++;
+      }
       if(ImbricatedLoop > MAX_RECUR_LOOPS - 1){
 	yymsg(0, "Reached maximum number of imbricated loops");
 	ImbricatedLoop = MAX_RECUR_LOOPS - 1;
@@ -3762,11 +3774,17 @@ Loop :
 	double x0 = LoopControlVariablesTab[ImbricatedLoop - 1][0];
 	double x1 = LoopControlVariablesTab[ImbricatedLoop - 1][1];
         if((step > 0. && x0 <= x1) || (step < 0. && x0 >= x1)){
-	  fsetpos(gmsh_yyin, &yyposImbricatedLoopsTab[ImbricatedLoop - 1]);
-	  gmsh_yylineno = yylinenoImbricatedLoopsTab[ImbricatedLoop - 1];
+          // replay the cached tokens of the body, or rewind the file if the
+          // body could not be cached
+          if(!gmsh_yyrepeatloop(ImbricatedLoop - 1)){
+	    fsetpos(gmsh_yyin, &yyposImbricatedLoopsTab[ImbricatedLoop - 1]);
+	    gmsh_yylineno = yylinenoImbricatedLoopsTab[ImbricatedLoop - 1];
+          }
 	}
-	else
+	else{
 	  ImbricatedLoop--;
+          gmsh_yyendloop(ImbricatedLoop);
+        }
       }
     }
   | tMacro tSTRING
@@ -3790,12 +3808,16 @@ Loop :
       if(!FunctionManager::Instance()->leaveFunction
          (&gmsh_yyin, gmsh_yyname, gmsh_yylineno))
 	yymsg(0, "Error while exiting function");
+      else
+        gmsh_yypoptokens();
     }
   | tCall String__Index tEND
     {
       if(!FunctionManager::Instance()->enterFunction
          (std::string($2), &gmsh_yyin, gmsh_yyname, gmsh_yylineno))
 	yymsg(0, "Unknown function '%s'", $2);
+      else
+        gmsh_yypushtokens();
       Free($2);
     }
   | tCall StringExpr tEND
@@ -3803,6 +3825,8 @@ Loop :
       if(!FunctionManager::Instance()->enterFunction
          (std::string($2), &gmsh_yyin, gmsh_yyname, gmsh_yylineno))
 	yymsg(0, "Unknown function '%s'", $2);
+      else
+        gmsh_yypushtokens();
       Free($2);
     }
   | tIf '(' FExpr ')'
@@ -5316,12 +5340,13 @@ FExpr_Single :
     }
   | String__Index NumericIncrement
     {
-      if(!gmsh_yysymbols.count($1)){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find($1);
+      if(it == gmsh_yysymbols.end()){
 	yymsg(0, "Unknown variable '%s'", $1);
 	$$ = 0.;
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[$1]);
+        gmsh_yysymbol &s(it->second);
         if(s.value.empty()){
           yymsg(0, "Uninitialized variable '%s'", $1);
           $$ = 0.;
@@ -5336,12 +5361,13 @@ FExpr_Single :
   | String__Index '[' FExpr ']' NumericIncrement
     {
       int index = (int)$3;
-      if(!gmsh_yysymbols.count($1)){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find($1);
+      if(it == gmsh_yysymbols.end()){
 	yymsg(0, "Unknown variable '%s'", $1);
 	$$ = 0.;
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[$1]);
+        gmsh_yysymbol &s(it->second);
         if((int)s.value.size() < index + 1){
           yymsg(0, "Uninitialized variable '%s[%d]'", $1, index);
           $$ = 0.;
@@ -5356,12 +5382,13 @@ FExpr_Single :
   | String__Index '(' FExpr ')' NumericIncrement
     {
       int index = (int)$3;
-      if(!gmsh_yysymbols.count($1)){
+      std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find($1);
+      if(it == gmsh_yysymbols.end()){
 	yymsg(0, "Unknown variable '%s'", $1);
 	$$ = 0.;
       }
       else{
-        gmsh_yysymbol &s(gmsh_yysymbols[$1]);
+        gmsh_yysymbol &s(it->second);
         if((int)s.value.size() < index + 1){
           yymsg(0, "Uninitialized variable '%s[%d]'", $1, index);
           $$ = 0.;
@@ -6548,7 +6575,8 @@ String__Index :
 void assignVariable(const std::string &name, int index, int assignType,
                     double value)
 {
-  if(!gmsh_yysymbols.count(name)){
+  std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find(name);
+  if(it == gmsh_yysymbols.end()){
     if(!assignType){
       gmsh_yysymbol &s(gmsh_yysymbols[name]);
       s.list = true;
@@ -6559,7 +6587,7 @@ void assignVariable(const std::string &name, int index, int assignType,
       yymsg(0, "Unknown variable '%s'", name.c_str());
   }
   else{
-    gmsh_yysymbol &s(gmsh_yysymbols[name]);
+    gmsh_yysymbol &s(it->second);
     if(s.list){
       if((int)s.value.size() < index + 1) s.value.resize(index + 1, 0.);
       switch(assignType){
@@ -6586,7 +6614,8 @@ void assignVariables(const std::string &name, List_T *indices, int assignType,
     yymsg(0, "Incompatible array dimensions in affectation");
   }
   else{
-    if(!gmsh_yysymbols.count(name)){
+    std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find(name);
+    if(it == gmsh_yysymbols.end()){
       if(!assignType){
         gmsh_yysymbol &s(gmsh_yysymbols[name]);
         s.list = true;
@@ -6600,7 +6629,7 @@ void assignVariables(const std::string &name, List_T *indices, int assignType,
         yymsg(0, "Unknown variable '%s'", name.c_str());
     }
     else{
-      gmsh_yysymbol &s(gmsh_yysymbols[name]);
+      gmsh_yysymbol &s(it->second);
       if(s.list){
         for(int i = 0; i < List_Nbr(indices); i++){
           int index = (int)(*(double*)List_Pointer(indices, i));
@@ -6626,10 +6655,11 @@ void assignVariables(const std::string &name, List_T *indices, int assignType,
 
 void incrementVariable(const std::string &name, int index, double value)
 {
-  if(!gmsh_yysymbols.count(name))
+  std::map<std::string, gmsh_yysymbol>::iterator it = gmsh_yysymbols.find(name);
+  if(it == gmsh_yysymbols.end())
     yymsg(0, "Unknown variable '%s'", name.c_str());
   else{
-    gmsh_yysymbol &s(gmsh_yysymbols[name]);
+    gmsh_yysymbol &s(it->second);
     if(s.list){
       if((int)s.value.size() < index + 1) s.value.resize(index + 1, 0.);
       s.value[index] += value;
@@ -7210,11 +7240,12 @@ double treat_Struct_FullName_Float
 (char* c1, char* c2, int type_var, int index, double val_default, int type_treat)
 {
   double out;
-  if(!c1 && gmsh_yysymbols.count(c2)){
+  std::map<std::string, gmsh_yysymbol>::iterator it;
+  if(!c1 && (it = gmsh_yysymbols.find(c2)) != gmsh_yysymbols.end()){
     if (type_treat == 1) out = 1.; // Exists (type_treat == 1)
     else { // Get (0) or GetForced (2)
       if (type_var == 1) {
-        gmsh_yysymbol &s(gmsh_yysymbols[c2]);
+        gmsh_yysymbol &s(it->second);
         if(s.value.empty()){
           out = val_default;
           if (type_treat == 0) yymsg(0, "Uninitialized variable '%s'", c2);
@@ -7223,7 +7254,7 @@ double treat_Struct_FullName_Float
           out = s.value[0];
       }
       else if (type_var == 2) {
-        gmsh_yysymbol &s(gmsh_yysymbols[c2]);
+        gmsh_yysymbol &s(it->second);
         if(index < 0 || (int)s.value.size() < index + 1){
           out = val_default;
           if (type_treat == 0) yymsg(0, "Uninitialized variable '%s[%d]'", c2, index);
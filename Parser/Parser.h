@@ -15,6 +15,13 @@ int gmsh_yyparse();
 int gmsh_yylex();
 void gmsh_yyflush();
 
+// token cache for the bodies of For ... EndFor loops (see Gmsh.l)
+void gmsh_yystartloop(int level);
+bool gmsh_yyrepeatloop(int level);
+void gmsh_yyendloop(int level);
+void gmsh_yypushtokens();
+void gmsh_yypoptokens();
+
 class gmsh_yysymbol{
  public:
   bool list;
@@ -231,7 +231,7 @@ PView *GMSH_DistancePlugin::execute(PView *v)
 #elif defined(HAVE_GMM)
     linearSystemCSRGmm<double> *lsys = new linearSystemCSRGmm<double>;
 #else
-    linearSystemFull<double> *lsys = new linearSystemFull<double>;
+    linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
     dofManager<double> *dofView = new dofManager<double>(lsys);
 
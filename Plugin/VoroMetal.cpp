@@ -9,15 +9,20 @@
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <unordered_map>
 #include "GmshConfig.h"
 #include "GModel.h"
+#include "GModelIO_GEO.h"
+#include "Context.h"
 #include "GmshMessage.h"
 #include "MElement.h"
 #include "VoroMetal.h"
 
 StringXNumber VoroMetalOptions_Number[] = {
   {GMSH_FULLRC, "ComputeBestSeeds", NULL, 0.},
-  {GMSH_FULLRC, "ComputeMicrostructure", NULL, 1.}};
+  {GMSH_FULLRC, "ComputeMicrostructure", NULL, 1.},
+  {GMSH_FULLRC, "WriteFiles", NULL, 1.}};
 
 StringXString VoroMetalOptions_String[] = {
   {GMSH_FULLRC, "SeedsFile", NULL, "seeds.txt"},
@@ -33,7 +38,12 @@ GMSH_Plugin *GMSH_RegisterVoroMetalPlugin()
 std::string GMSH_VoroMetalPlugin::getHelp() const
 {
   return "Plugin(VoroMetal) creates microstructures using Voronoi "
-         "diagrams.\n\n";
+         "diagrams.\n\n"
+         "The grains are created directly as GEO entities in the current "
+         "model, with periodic boundary surfaces. If `WriteFiles' is set, "
+         "the microstructure is also exported in "
+         "`MicrostructurePolycrystal3D.geo', together with the `SET.map', "
+         "`PERIODIC.map' and `table.txt' files.";
 }
 
 int GMSH_VoroMetalPlugin::getNbOptions() const
@@ -105,7 +115,8 @@ void voroMetal3D::execute(GRegion *gr, double h)
 }
 
 void voroMetal3D::execute(std::vector<double> &properties, int radical,
-                          double h, double xMax, double yMax, double zMax)
+                          double h, double xMax, double yMax, double zMax,
+                          bool writeFiles, GModel *model)
 {
   std::size_t i;
   std::vector<SPoint3> vertices;
@@ -115,285 +126,321 @@ void voroMetal3D::execute(std::vector<double> &properties, int radical,
       SPoint3(properties[4 * i], properties[4 * i + 1], properties[4 * i + 2]));
     radii.push_back(properties[4 * i + 3]);
   }
-  execute(vertices, radii, radical, h, xMax, yMax, zMax);
+  execute(vertices, radii, radical, h, xMax, yMax, zMax, writeFiles, model);
 }
 
+namespace {
+
+  // faces and vertices of a Voronoi cell, as returned by voro++
+  struct voroCell {
+    SPoint3 generator;
+    std::vector<int> faces;
+    std::vector<double> vertices;
+  };
+
+  void storeCell(voronoicell_neighbor &c, const SPoint3 &p, voroCell &cell)
+  {
+    cell.generator = p;
+    c.face_vertices(cell.faces);
+    c.vertices(p.x(), p.y(), p.z(), cell.vertices);
+  }
+
+  struct voroPointKey {
+    long long i, j, k;
+    bool operator==(const voroPointKey &other) const
+    {
+      return i == other.i && j == other.j && k == other.k;
+    }
+  };
+
+  struct voroPointKeyHash {
+    std::size_t operator()(const voroPointKey &key) const
+    {
+      return (std::size_t)(key.i * 73856093LL ^ key.j * 19349663LL ^
+                           key.k * 83492791LL);
+    }
+  };
+
+  // Voronoi vertices shared by neighboring cells, merged if they are closer
+  // than the geometrical tolerance: the coordinates are hashed on a grid of
+  // the size of the tolerance, and the 27 neighboring grid cells are searched
+  class voroPoints {
+  private:
+    double _eps;
+    std::unordered_multimap<voroPointKey, int, voroPointKeyHash> _hash;
+    std::vector<SPoint3> _xyz;
+    voroPointKey _key(const SPoint3 &p) const
+    {
+      voroPointKey key = {(long long)std::floor(p.x() / _eps),
+                          (long long)std::floor(p.y() / _eps),
+                          (long long)std::floor(p.z() / _eps)};
+      return key;
+    }
+
+  public:
+    voroPoints(double eps) : _eps(eps) {}
+    // index of the point p, or -1 if no point is close enough
+    int find(const SPoint3 &p) const
+    {
+      voroPointKey key = _key(p);
+      for(int i = -1; i <= 1; i++) {
+        for(int j = -1; j <= 1; j++) {
+          for(int k = -1; k <= 1; k++) {
+            voroPointKey n = {key.i + i, key.j + j, key.k + k};
+            typedef std::unordered_multimap<voroPointKey, int,
+                                            voroPointKeyHash>::const_iterator
+              iter;
+            std::pair<iter, iter> range = _hash.equal_range(n);
+            for(iter it = range.first; it != range.second; ++it) {
+              if(p.distance(_xyz[it->second]) < _eps) return it->second;
+            }
+          }
+        }
+      }
+      return -1;
+    }
+    int insert(const SPoint3 &p)
+    {
+      _xyz.push_back(p);
+      _hash.insert(std::make_pair(_key(p), (int)_xyz.size() - 1));
+      return _xyz.size() - 1;
+    }
+  };
+
+} // namespace
+
 void voroMetal3D::execute(std::vector<SPoint3> &vertices,
                           std::vector<double> &radii, int radical, double h,
-                          double xMax, double yMax, double zMax)
+                          double xMax, double yMax, double zMax,
+                          bool writeFiles, GModel *model)
 {
+  if(!model) model = GModel::current();
   std::size_t i;
   std::size_t j;
-  std::size_t k;
-  int start;
   std::size_t end;
-  int index1;
-  int index2;
-  int val;
-  int face_number;
-  int last;
-  int mem;
+  int start;
   int number;
   double x, y, z;
-  double x1, y1, z1;
-  double x2, y2, z2;
-  double delta;
   double min_x, max_x;
   double min_y, max_y;
   double min_z, max_z;
-  double min_area;
-  voronoicell_neighbor *pointer;
   voronoicell_neighbor cell;
-  std::vector<int> faces;
-  std::vector<double> voronoi_vertices;
-  std::vector<voronoicell_neighbor *> pointers;
-  std::vector<SPoint3> generators;
-  std::vector<int> temp;
-  std::vector<int> temp2;
-  std::vector<double> areas;
-  std::map<int, int> table;
-  geo_cell obj;
-
-  min_x = 1000000000.0;
-  max_x = -1000000000.0;
-  min_y = 1000000000.0;
-  max_y = -1000000000.0;
-  min_z = 1000000000.0;
-  max_z = -1000000000.0;
-  for(i = 0; i < vertices.size(); i++) {
-    min_x = std::min(vertices[i].x(), min_x);
-    max_x = std::max(vertices[i].x(), max_x);
-    min_y = std::min(vertices[i].y(), min_y);
-    max_y = std::max(vertices[i].y(), max_y);
-    min_z = std::min(vertices[i].z(), min_z);
-    max_z = std::max(vertices[i].z(), max_z);
-  }
+  std::vector<voroCell> cells(vertices.size());
+  std::vector<int> table(vertices.size(), -1);
 
-  delta = 0.2 * (max_x - min_x);
   min_x = min_y = min_z = 0;
-  // max_x=max_y=max_z = 1;
   max_x = xMax;
   max_y = yMax;
   max_z = zMax;
-  delta = 0;
 
-  container contA(min_x - delta, max_x + delta, min_y - delta, max_y + delta,
-                  min_z - delta, max_z + delta, 6, 6, 6, true, true, true,
-                  vertices.size());
-  container_poly contB(min_x - delta, max_x + delta, min_y - delta,
-                       max_y + delta, min_z - delta, max_z + delta, 6, 6, 6,
-                       true, true, true, vertices.size());
-
-  for(i = 0; i < vertices.size(); i++) {
-    if(radical == 0) {
+  if(radical == 0) {
+    container contA(min_x, max_x, min_y, max_y, min_z, max_z, 6, 6, 6, true,
+                    true, true, vertices.size());
+    for(i = 0; i < vertices.size(); i++)
       contA.put(i, vertices[i].x(), vertices[i].y(), vertices[i].z());
-    }
-    else {
-      contB.put(i, vertices[i].x(), vertices[i].y(), vertices[i].z(), radii[i]);
-    }
-  }
-
-  number = 0;
 
-  c_loop_all loopA(contA);
-  c_loop_all loopB(contB);
-
-  if(radical == 0) {
-    loopA.start();
-    do {
-      contA.compute_cell(cell, loopA);
-      loopA.pos(x, y, z);
-      pointer = new voronoicell_neighbor();
-      *pointer = cell;
-      pointers.push_back(pointer);
-      generators.push_back(SPoint3(x, y, z));
-      table.insert(std::pair<int, int>(loopA.pid(), number));
-      number++;
-    } while(loopA.inc());
+    // the cells are numbered in the order of the voro++ blocks (as with a
+    // c_loop_all loop), and the blocks are computed in parallel, each thread
+    // with its own voro_compute (the one of the container is not reentrant)
+    std::vector<int> offsets(contA.nxyz + 1, 0);
+    for(int ijk = 0; ijk < contA.nxyz; ijk++)
+      offsets[ijk + 1] = offsets[ijk] + contA.co[ijk];
+    cells.resize(offsets[contA.nxyz]);
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+    {
+      voro_compute<container> vc(contA, 2 * contA.nx + 1, 2 * contA.ny + 1,
+                                 2 * contA.nz + 1);
+      voronoicell_neighbor c;
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+      for(int ijk = 0; ijk < contA.nxyz; ijk++) {
+        int bk = ijk / contA.nxy, ijkt = ijk - contA.nxy * bk;
+        int bj = ijkt / contA.nx, bi = ijkt - bj * contA.nx;
+        for(int q = 0; q < contA.co[ijk]; q++) {
+          vc.compute_cell(c, ijk, q, bi, bj, bk);
+          double *p = contA.p[ijk] + 3 * q;
+          storeCell(c, SPoint3(p[0], p[1], p[2]), cells[offsets[ijk] + q]);
+          table[contA.id[ijk][q]] = offsets[ijk] + q;
+        }
+      }
+    }
   }
   else {
+    // the radical tessellation keeps the current particle radius in the
+    // container: the cells are computed serially
+    container_poly contB(min_x, max_x, min_y, max_y, min_z, max_z, 6, 6, 6,
+                         true, true, true, vertices.size());
+    for(i = 0; i < vertices.size(); i++)
+      contB.put(i, vertices[i].x(), vertices[i].y(), vertices[i].z(),
+                radii[i]);
+    c_loop_all loopB(contB);
+    number = 0;
     loopB.start();
     do {
       contB.compute_cell(cell, loopB);
       loopB.pos(x, y, z);
-      pointer = new voronoicell_neighbor();
-      *pointer = cell;
-      pointers.push_back(pointer);
-      generators.push_back(SPoint3(x, y, z));
-      table.insert(std::pair<int, int>(loopB.pid(), number));
+      storeCell(cell, SPoint3(x, y, z), cells[number]);
+      table[loopB.pid()] = number;
       number++;
     } while(loopB.inc());
+    cells.resize(number);
   }
 
-  std::ofstream file6("table.txt");
-  if(!file6.is_open()) {
-    Msg::Error("Could not open file 'table.txt'");
-    return;
-  }
-
-  for(i = 0; i < vertices.size(); i++) {
-    file6 << i + 1 << " " << table[i] + 1 << "\n";
+  std::ofstream file, file2, file5, file6;
+  if(writeFiles) {
+    file6.open("table.txt");
+    if(!file6.is_open()) {
+      Msg::Error("Could not open file 'table.txt'");
+      return;
+    }
+    for(i = 0; i < vertices.size(); i++) {
+      file6 << i + 1 << " " << table[i] + 1 << "\n";
+    }
+    file.open("MicrostructurePolycrystal3D.pos");
+    if(!file.is_open()) {
+      Msg::Error("Could not open file 'MicrostructurePolycrystal3D.pos'");
+      return;
+    }
+    file << "View \"test\" {\n";
+    file2.open("MicrostructurePolycrystal3D.geo");
+    if(!file2.is_open()) {
+      Msg::Error("Could not open file 'MicrostructurePolycrystal3D.geo'");
+      return;
+    }
+    file5.open("SET.map");
+    if(!file5.is_open()) {
+      Msg::Error("Could not open file 'SET.map'");
+      return;
+    }
+    file2 << "c=" << h << ";\n";
   }
 
+  // build the GEO entities directly, with the points, curves and surfaces
+  // shared by neighboring cells created only once (instead of merging the
+  // duplicates afterwards with "Coherence"); the model is made current while
+  // the entities are created, since the GEO kernel looks them up there
+  GModel *current = GModel::current();
+  GModel::setCurrent(model);
+  GEO_Internals *geo = model->getGEOInternals();
   initialize_counter();
-
-  min_area = 1000000000.0;
-
-  for(i = 0; i < pointers.size(); i++) {
-    areas.clear();
-    pointers[i]->face_areas(areas);
-    for(j = 0; j < areas.size(); j++) {
-      if(areas[j] < min_area) {
-        min_area = areas[j];
+  const int dims[6] = {0, 1, -1, 2, -2, 3};
+  for(i = 0; i < 6; i++)
+    counter = std::max(counter, geo->getMaxTag(dims[i]) + 1);
+  counter = std::max(counter, geo->getMaxPhysicalTag() + 1);
+
+  voroPoints points(CTX::instance()->geom.tolerance *
+                    std::sqrt(xMax * xMax + yMax * yMax + zMax * zMax));
+  std::vector<int> pointTags;
+  std::map<std::pair<int, int>, int> lines;
+  std::map<std::vector<int>, int> surfaces;
+  std::vector<int> allSurfaces;
+  std::vector<int> cellPoints, loop, facePoints, shell;
+  int countVolume = 0;
+  for(i = 0; i < cells.size(); i++) {
+    const voroCell &c = cells[i];
+    cellPoints.resize(c.vertices.size() / 3);
+    for(j = 0; j < cellPoints.size(); j++) {
+      SPoint3 p(c.vertices[3 * j], c.vertices[3 * j + 1],
+                c.vertices[3 * j + 2]);
+      int index = points.find(p);
+      if(index < 0) {
+        index = points.insert(p);
+        int tag = get_counter();
+        geo->addVertex(tag, p.x(), p.y(), p.z(), h);
+        if(writeFiles) print_geo_point(tag, p.x(), p.y(), p.z(), file2);
+        pointTags.push_back(tag);
+        increase_counter();
       }
+      cellPoints[j] = pointTags[index];
     }
-  }
-
-  std::ofstream file("MicrostructurePolycrystal3D.pos");
-  if(!file.is_open()) {
-    Msg::Error("Could not open file 'MicrostructurePolycrystal3D.pos'");
-    return;
-  }
-  file << "View \"test\" {\n";
-
-  std::ofstream file2("MicrostructurePolycrystal3D.geo");
-  if(!file2.is_open()) {
-    Msg::Error("Could not open file 'MicrostructurePolycrystal3D.geo'");
-    return;
-  }
-  std::ofstream file5("SET.map");
-  if(!file5.is_open()) {
-    Msg::Error("Could not open file 'SET.map'");
-    return;
-  }
-  file2 << "c=" << h << ";\n";
-  int countPeriodSurf = 0;
-  int countVolume = 0;
-  for(i = 0; i < pointers.size(); i++) {
-    obj = geo_cell();
-    faces.clear();
-    voronoi_vertices.clear();
-    pointers[i]->face_vertices(faces);
-    pointers[i]->vertices(generators[i].x(), generators[i].y(),
-                          generators[i].z(), voronoi_vertices);
-    obj.line_loops.resize(pointers[i]->number_of_faces());
-    obj.orientations.resize(pointers[i]->number_of_faces());
-    face_number = 0;
+    shell.clear();
     end = 0;
-    while(end < faces.size()) {
+    while(end < c.faces.size()) {
       start = end + 1;
-      end = start + faces[end];
+      end = start + c.faces[end];
+      loop.clear();
+      facePoints.clear();
       for(j = start; j < end; j++) {
-        if(j < end - 1) {
-          index1 = faces[j];
-          index2 = faces[j + 1];
-        }
-        else {
-          index1 = faces[end - 1];
-          index2 = faces[start];
-        }
-        x1 = voronoi_vertices[3 * index1];
-        y1 = voronoi_vertices[3 * index1 + 1];
-        z1 = voronoi_vertices[3 * index1 + 2];
-        x2 = voronoi_vertices[3 * index2];
-        y2 = voronoi_vertices[3 * index2 + 1];
-        z2 = voronoi_vertices[3 * index2 + 2];
-        print_segment(SPoint3(x1, y1, z1), SPoint3(x2, y2, z2), file);
-
-        val = obj.search_line(std::pair<int, int>(index1, index2));
-        if(val == -1) {
-          obj.lines.push_back(std::pair<int, int>(index1, index2));
-          obj.line_loops[face_number].push_back(obj.lines.size() - 1);
-          val = obj.lines.size() - 1;
-        }
-        else {
-          obj.line_loops[face_number].push_back(val);
-        }
-
-        last = obj.line_loops[face_number].size() - 1;
-        if(last == 0) {
-          obj.orientations[face_number].push_back(0);
-        }
-        else if(obj.lines[obj.line_loops[face_number][last - 1]].second ==
-                obj.lines[val].first) {
-          obj.orientations[face_number][last - 1] = 0;
-          obj.orientations[face_number].push_back(0);
-        }
-        else if(obj.lines[obj.line_loops[face_number][last - 1]].first ==
-                obj.lines[val].first) {
-          obj.orientations[face_number][last - 1] = 1;
-          obj.orientations[face_number].push_back(0);
+        int index1 = c.faces[j];
+        int index2 = (j < end - 1) ? c.faces[j + 1] : c.faces[start];
+        if(writeFiles)
+          print_segment(SPoint3(&c.vertices[3 * index1]),
+                        SPoint3(&c.vertices[3 * index2]), file);
+        int p1 = cellPoints[index1], p2 = cellPoints[index2];
+        if(p1 == p2) continue;
+        facePoints.push_back(p1);
+        std::pair<int, int> key(std::min(p1, p2), std::max(p1, p2));
+        std::map<std::pair<int, int>, int>::iterator it = lines.find(key);
+        if(it == lines.end()) {
+          int tag = get_counter();
+          geo->addLine(tag, key.first, key.second);
+          if(writeFiles) print_geo_line(tag, key.first, key.second, file2);
+          it = lines.insert(std::make_pair(key, tag)).first;
+          increase_counter();
         }
-        else if(obj.lines[obj.line_loops[face_number][last - 1]].second ==
-                obj.lines[val].second) {
-          obj.orientations[face_number][last - 1] = 0;
-          obj.orientations[face_number].push_back(1);
+        loop.push_back((p1 == key.first) ? it->second : -it->second);
+      }
+      if(loop.size() < 3) continue;
+      std::sort(facePoints.begin(), facePoints.end());
+      std::map<std::vector<int>, int>::iterator it = surfaces.find(facePoints);
+      if(it == surfaces.end()) {
+        int tag = get_counter();
+        geo->addLineLoop(tag, loop);
+        if(writeFiles) {
+          file2 << "Line Loop(" << tag << ")={";
+          for(std::size_t k = 0; k < loop.size(); k++)
+            file2 << (k ? "," : "") << loop[k];
+          file2 << "};\n";
         }
-        else {
-          obj.orientations[face_number][last - 1] = 1;
-          obj.orientations[face_number].push_back(1);
+        increase_counter();
+        int stag = get_counter();
+        geo->addPlaneSurface(stag, std::vector<int>(1, tag));
+        if(writeFiles) {
+          print_geo_face(stag, tag, file2);
+          file5 << stag << "\t"
+                << "SURFACE" << stag << "\t"
+                << "NSET\n";
         }
+        it = surfaces.insert(std::make_pair(facePoints, stag)).first;
+        allSurfaces.push_back(stag);
+        increase_counter();
       }
-
-      face_number++;
-    }
-
-    for(j = 0; j < voronoi_vertices.size() / 3; j++) {
-      print_geo_point(get_counter(), voronoi_vertices[3 * j],
-                      voronoi_vertices[3 * j + 1], voronoi_vertices[3 * j + 2],
-                      file2);
-      obj.points2.push_back(get_counter());
-      increase_counter();
-    }
-
-    for(j = 0; j < obj.lines.size(); j++) {
-      print_geo_line(get_counter(), obj.points2[obj.lines[j].first],
-                     obj.points2[obj.lines[j].second], file2);
-      obj.lines2.push_back(get_counter());
-      increase_counter();
-    }
-
-    for(j = 0; j < obj.line_loops.size(); j++) {
-      temp.clear();
-      temp2.clear();
-      for(k = 0; k < obj.line_loops[j].size(); k++) {
-        temp.push_back(obj.lines2[obj.line_loops[j][k]]);
-        temp2.push_back(obj.orientations[j][k]);
-      }
-      print_geo_line_loop(get_counter(), temp, temp2, file2);
-      obj.line_loops2.push_back(get_counter());
-      increase_counter();
-    }
-
-    for(j = 0; j < obj.line_loops2.size(); j++) {
-      print_geo_face(get_counter(), obj.line_loops2[j], file2);
-      countPeriodSurf++;
-      file5 << get_counter() << "\t"
-            << "SURFACE" << get_counter() << "\t"
-            << "NSET\n";
-      obj.faces2.push_back(get_counter());
-      increase_counter();
+      shell.push_back(it->second);
     }
 
-    print_geo_face_loop(get_counter(), obj.faces2, file2);
-    obj.face_loops2 = get_counter();
+    int tag = get_counter();
+    geo->addSurfaceLoop(tag, shell);
+    if(writeFiles) print_geo_face_loop(tag, shell, file2);
     increase_counter();
-
-    print_geo_volume(get_counter(), obj.face_loops2, file2);
-    mem = get_counter();
+    int vtag = get_counter();
+    geo->addVolume(vtag, std::vector<int>(1, tag));
     countVolume++;
-    file5 << get_counter() << "\t"
-          << "GRAIN" << countVolume << "\t"
-          << "ELSET\n";
+    if(writeFiles) {
+      print_geo_volume(vtag, tag, file2);
+      file5 << vtag << "\t"
+            << "GRAIN" << countVolume << "\t"
+            << "ELSET\n";
+    }
     increase_counter();
-    print_geo_physical_volume(get_counter(), mem, file2);
+    geo->modifyPhysicalGroup(3, get_counter(), 0, std::vector<int>(1, vtag));
+    if(writeFiles) print_geo_physical_volume(get_counter(), vtag, file2);
     increase_counter();
   }
 
-  file2 << "Coherence;\n";
-  file << "};\n";
+  geo->modifyPhysicalGroup(2, 11, 0, allSurfaces);
+  if(writeFiles) {
+    file2 << "Physical Surface(11)={";
+    for(i = 0; i < allSurfaces.size(); i++)
+      file2 << (i ? "," : "") << allSurfaces[i];
+    file2 << "};\n";
+    file << "};\n";
+  }
 
-  for(i = 0; i < pointers.size(); i++) delete pointers[i];
+  geo->synchronize(model);
+  GModel::setCurrent(current);
 }
 
 void voroMetal3D::print_segment(SPoint3 p1, SPoint3 p2, std::ofstream &file)
@@ -471,7 +518,7 @@ void voroMetal3D::print_geo_face_loop(int index, std::vector<int> &indices,
 }
 
 void voroMetal3D::correspondance(double e, double xMax, double yMax,
-                                 double zMax)
+                                 double zMax, bool writeFiles)
 {
   std::size_t i;
   std::size_t j;
@@ -558,17 +605,20 @@ void voroMetal3D::correspondance(double e, double xMax, double yMax,
   }
 
   count = 0;
-  std::ofstream file("MicrostructurePolycrystal3D.pos");
-  if(!file.is_open()) {
-    Msg::Error("Could not open file 'MicrostructurePolycrystal3D.pos'");
-    return;
-  }
-  file << "View \"test\" {\n";
+  std::ofstream file, file2, file3, file4;
+  if(writeFiles) {
+    file.open("MicrostructurePolycrystal3D.pos");
+    if(!file.is_open()) {
+      Msg::Error("Could not open file 'MicrostructurePolycrystal3D.pos'");
+      return;
+    }
+    file << "View \"test\" {\n";
 
-  std::ofstream file2("PERIODIC.map");
-  if(!file2.is_open()) {
-    Msg::Error("Could not open file 'PERIODIC.map'");
-    return;
+    file2.open("PERIODIC.map");
+    if(!file2.is_open()) {
+      Msg::Error("Could not open file 'PERIODIC.map'");
+      return;
+    }
   }
 
   for(i = 0; i < faces.size(); i++) {
@@ -590,182 +640,184 @@ void voroMetal3D::correspondance(double e, double xMax, double yMax,
           it6->second = 1;
           pairs.push_back(std::pair<GFace *, GFace *>(faces[i], faces[j]));
           categories.push_back(val);
-          print_segment(p1, p2, file);
-          if(std::abs((p2.x() - p1.x() - 1.0)) < 0.0001) {
-            if(std::abs((p2.y() - p1.y())) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tFRONT = FRONT + SURFACE" << faces[j]->tag()
-                      << "\n";
-                file2 << "NSET\tBACK = BACK + SURFACE" << faces[i]->tag()
-                      << "\n";
-              }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTTOP = FRONTTOP + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKBOTTOM = BACKBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTBOTTOM = FRONTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKTOP = BACKTOP + SURFACE" << faces[i]->tag()
-                      << "\n";
-              }
-            }
-            else if(std::abs((p2.y() - p1.y() - 1.0)) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tFRONTRIGHT = FRONTRIGHT + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKLEFT = BACKLEFT + SURFACE"
-                      << faces[i]->tag() << "\n";
-              }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTRIGHTTOP = FRONTRIGHTTOP + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKLEFTBOTTOM = BACKLEFTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTRIGHTBOTTOM = FRONTRIGHTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKLEFTTOP = BACKLEFTTOP + SURFACE"
-                      << faces[i]->tag() << "\n";
-              }
-            }
-            else if(std::abs((p1.y() - p2.y() - 1.0)) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tFRONTLEFT = FRONTLEFT + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKRIGHT = BACKRIGHT + SURFACE"
-                      << faces[i]->tag() << "\n";
-              }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTLEFTTOP = FRONTLEFTTOP + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKRIGHTBOTTOM = BACKRIGHTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTLEFTBOTTOM = FRONTLEFTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tBACKRIGHTTOP = BACKRIGHTTOP + SURFACE"
-                      << faces[i]->tag() << "\n";
+          if(writeFiles) {
+            print_segment(p1, p2, file);
+            if(std::abs((p2.x() - p1.x() - 1.0)) < 0.0001) {
+              if(std::abs((p2.y() - p1.y())) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tFRONT = FRONT + SURFACE" << faces[j]->tag()
+                        << "\n";
+                  file2 << "NSET\tBACK = BACK + SURFACE" << faces[i]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTTOP = FRONTTOP + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKBOTTOM = BACKBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTBOTTOM = FRONTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKTOP = BACKTOP + SURFACE" << faces[i]->tag()
+                        << "\n";
+                }
               }
-            }
-          }
-          else if(std::abs((p1.x() - p2.x() - 1.0)) < 0.0001) {
-            if(std::abs((p2.y() - p1.y())) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tFRONT = FRONT + SURFACE" << faces[i]->tag()
-                      << "\n";
-                file2 << "NSET\tBACK = BACK + SURFACE" << faces[j]->tag()
-                      << "\n";
-              }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTBOTTOM = FRONTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKTOP = BACKTOP + SURFACE" << faces[j]->tag()
-                      << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTTOP = FRONTTOP + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKBOTTOM = BACKBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
-              }
-            }
-            else if(std::abs((p2.y() - p1.y() - 1.0)) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tFRONTLEFT = FRONTLEFT + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKRIGHT = BACKRIGHT + SURFACE"
-                      << faces[j]->tag() << "\n";
-              }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTLEFTBOTTOM = FRONTLEFTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKRIGHTTOP = BACKRIGHTTOP + SURFACE"
-                      << faces[j]->tag() << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTLEFTTOP = FRONTLEFTTOP + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKRIGHTBOTTOM = BACKRIGHTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
+              else if(std::abs((p2.y() - p1.y() - 1.0)) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tFRONTRIGHT = FRONTRIGHT + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKLEFT = BACKLEFT + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTRIGHTTOP = FRONTRIGHTTOP + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKLEFTBOTTOM = BACKLEFTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTRIGHTBOTTOM = FRONTRIGHTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKLEFTTOP = BACKLEFTTOP + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
               }
-            }
-            else if(std::abs((p1.y() - p2.y() - 1.0)) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tFRONTRIGHT = FRONTRIGHT + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKLEFT = BACKLEFT + SURFACE"
-                      << faces[j]->tag() << "\n";
-              }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTRIGHTBOTTOM = FRONTRIGHTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKLEFTTOP = BACKLEFTTOP + SURFACE"
-                      << faces[j]->tag() << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tFRONTRIGHTTOP = FRONTRIGHTTOP + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tBACKLEFTBOTTOM = BACKLEFTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
+              else if(std::abs((p1.y() - p2.y() - 1.0)) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tFRONTLEFT = FRONTLEFT + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKRIGHT = BACKRIGHT + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTLEFTTOP = FRONTLEFTTOP + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKRIGHTBOTTOM = BACKRIGHTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTLEFTBOTTOM = FRONTLEFTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBACKRIGHTTOP = BACKRIGHTTOP + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
               }
             }
-          }
-          else if(std::abs((p1.x() - p2.x())) < 0.0001) {
-            if(std::abs((p2.y() - p1.y() - 1.0)) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tRIGHT = RIGHT + SURFACE" << faces[j]->tag()
-                      << "\n";
-                file2 << "NSET\tLEFT = LEFT + SURFACE" << faces[i]->tag()
-                      << "\n";
+            else if(std::abs((p1.x() - p2.x() - 1.0)) < 0.0001) {
+              if(std::abs((p2.y() - p1.y())) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tFRONT = FRONT + SURFACE" << faces[i]->tag()
+                        << "\n";
+                  file2 << "NSET\tBACK = BACK + SURFACE" << faces[j]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTBOTTOM = FRONTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKTOP = BACKTOP + SURFACE" << faces[j]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTTOP = FRONTTOP + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKBOTTOM = BACKBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
               }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tRIGHTTOP = RIGHTTOP + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tLEFTBOTTOM = LEFTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
+              else if(std::abs((p2.y() - p1.y() - 1.0)) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tFRONTLEFT = FRONTLEFT + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKRIGHT = BACKRIGHT + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTLEFTBOTTOM = FRONTLEFTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKRIGHTTOP = BACKRIGHTTOP + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTLEFTTOP = FRONTLEFTTOP + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKRIGHTBOTTOM = BACKRIGHTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
               }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tRIGHTBOTTOM = RIGHTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
-                file2 << "NSET\tLEFTTOP = LEFTTOP + SURFACE" << faces[i]->tag()
-                      << "\n";
+              else if(std::abs((p1.y() - p2.y() - 1.0)) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tFRONTRIGHT = FRONTRIGHT + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKLEFT = BACKLEFT + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTRIGHTBOTTOM = FRONTRIGHTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKLEFTTOP = BACKLEFTTOP + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tFRONTRIGHTTOP = FRONTRIGHTTOP + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBACKLEFTBOTTOM = BACKLEFTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
               }
             }
-            else if(std::abs((p1.y() - p2.y() - 1.0)) < 0.0001) {
-              if(std::abs((p2.z() - p1.z())) < 0.0001) {
-                file2 << "NSET\tRIGHT = RIGHT + SURFACE" << faces[i]->tag()
-                      << "\n";
-                file2 << "NSET\tLEFT = LEFT + SURFACE" << faces[j]->tag()
-                      << "\n";
+            else if(std::abs((p1.x() - p2.x())) < 0.0001) {
+              if(std::abs((p2.y() - p1.y() - 1.0)) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tRIGHT = RIGHT + SURFACE" << faces[j]->tag()
+                        << "\n";
+                  file2 << "NSET\tLEFT = LEFT + SURFACE" << faces[i]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tRIGHTTOP = RIGHTTOP + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tLEFTBOTTOM = LEFTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tRIGHTBOTTOM = RIGHTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                  file2 << "NSET\tLEFTTOP = LEFTTOP + SURFACE" << faces[i]->tag()
+                        << "\n";
+                }
               }
-              else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tRIGHTBOTTOM = RIGHTBOTTOM + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tLEFTTOP = LEFTTOP + SURFACE" << faces[j]->tag()
-                      << "\n";
+              else if(std::abs((p1.y() - p2.y() - 1.0)) < 0.0001) {
+                if(std::abs((p2.z() - p1.z())) < 0.0001) {
+                  file2 << "NSET\tRIGHT = RIGHT + SURFACE" << faces[i]->tag()
+                        << "\n";
+                  file2 << "NSET\tLEFT = LEFT + SURFACE" << faces[j]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tRIGHTBOTTOM = RIGHTBOTTOM + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tLEFTTOP = LEFTTOP + SURFACE" << faces[j]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tRIGHTTOP = RIGHTTOP + SURFACE"
+                        << faces[i]->tag() << "\n";
+                  file2 << "NSET\tLEFTBOTTOM = LEFTBOTTOM + SURFACE"
+                        << faces[j]->tag() << "\n";
+                }
               }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tRIGHTTOP = RIGHTTOP + SURFACE"
-                      << faces[i]->tag() << "\n";
-                file2 << "NSET\tLEFTBOTTOM = LEFTBOTTOM + SURFACE"
-                      << faces[j]->tag() << "\n";
-              }
-            }
-            else if(std::abs((p1.y() - p2.y())) < 0.0001) {
-              if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tTOP = TOP + SURFACE" << faces[j]->tag() << "\n";
-                file2 << "NSET\tBOTTOM = BOTTOM + SURFACE" << faces[i]->tag()
-                      << "\n";
-              }
-              else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
-                file2 << "NSET\tTOP = TOP + SURFACE" << faces[i]->tag() << "\n";
-                file2 << "NSET\tBOTTOM = BOTTOM + SURFACE" << faces[j]->tag()
-                      << "\n";
+              else if(std::abs((p1.y() - p2.y())) < 0.0001) {
+                if(std::abs((p2.z() - p1.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tTOP = TOP + SURFACE" << faces[j]->tag() << "\n";
+                  file2 << "NSET\tBOTTOM = BOTTOM + SURFACE" << faces[i]->tag()
+                        << "\n";
+                }
+                else if(std::abs((p1.z() - p2.z() - 1.0)) < 0.0001) {
+                  file2 << "NSET\tTOP = TOP + SURFACE" << faces[i]->tag() << "\n";
+                  file2 << "NSET\tBOTTOM = BOTTOM + SURFACE" << faces[j]->tag()
+                        << "\n";
+                }
               }
             }
           }
@@ -775,35 +827,25 @@ void voroMetal3D::correspondance(double e, double xMax, double yMax,
     }
   }
 
-  file << "};\n";
-
-  std::ofstream file3;
-  file3.open("MicrostructurePolycrystal3D.geo", std::ios::out | std::ios::app);
-  if(!file3.is_open()) {
-    Msg::Error("Could not open file 'MicrostructurePolycrystal3D.geo'");
-    return;
-  }
-  file3.precision(17);
-
-  std::ofstream file4("MicrostructurePolycrystal3D2.pos");
-  if(!file4.is_open()) {
-    Msg::Error("Could not open file 'MicrostructurePolycrystal3D2.pos'");
-    return;
-  }
-  file4 << "View \"test\" {\n";
+  if(writeFiles) {
+    file << "};\n";
 
-  file3 << "Physical Surface(11)={";
+    file3.open("MicrostructurePolycrystal3D.geo",
+               std::ios::out | std::ios::app);
+    if(!file3.is_open()) {
+      Msg::Error("Could not open file 'MicrostructurePolycrystal3D.geo'");
+      return;
+    }
+    file3.precision(17);
 
-  count = 0;
-  for(it = model->firstFace(); it != model->lastFace(); it++) {
-    gf = *it;
-    if(count > 0) file3 << ",";
-    file3 << gf->tag();
-    count++;
+    file4.open("MicrostructurePolycrystal3D2.pos");
+    if(!file4.is_open()) {
+      Msg::Error("Could not open file 'MicrostructurePolycrystal3D2.pos'");
+      return;
+    }
+    file4 << "View \"test\" {\n";
   }
 
-  file3 << "};\n";
-
   for(i = 0; i < pairs.size(); i++) {
     gf1 = pairs[i].first;
     gf2 = pairs[i].second;
@@ -818,6 +860,16 @@ void voroMetal3D::correspondance(double e, double xMax, double yMax,
       cg2 += SPoint3((*it2)->x(), (*it2)->y(), (*it2)->z());
     }
     SVector3 dx = (cg2 - cg1) * (1. / gv1.size());
+
+    // the surfaces are in the current model: set the periodicity directly
+    std::vector<double> tfo(16, 0.);
+    tfo[0] = tfo[5] = tfo[10] = tfo[15] = 1.;
+    tfo[3] = -dx.x();
+    tfo[7] = -dx.y();
+    tfo[11] = -dx.z();
+    gf1->setMeshMaster(gf2, tfo);
+    if(!writeFiles) continue;
+
     edges1 = gf1->edges();
     edges2 = gf2->edges();
     orientations1 = gf1->edgeOrientations();
@@ -924,7 +976,7 @@ void voroMetal3D::correspondance(double e, double xMax, double yMax,
           << " } Translate { " << -dx.x() << "," << -dx.y() << "," << -dx.z()
           << "};\n";
   }
-  file4 << "};\n";
+  if(writeFiles) file4 << "};\n";
 }
 
 bool voroMetal3D::correspondance(double delta_x, double delta_y, double delta_z,
@@ -1026,7 +1078,7 @@ bool voroMetal3D::equal(double x, double y, double e)
   return flag;
 }
 
-static void microstructure(const char *filename)
+static void microstructure(const char *filename, bool writeFiles)
 {
   int j;
   int radical;
@@ -1055,10 +1107,9 @@ static void microstructure(const char *filename)
       file >> properties[4 * j + 3];
     }
     voroMetal3D vm1;
-    vm1.execute(properties, radical, 0.1, xMax, yMax, zMax);
-    GModel::current()->load("MicrostructurePolycrystal3D.geo");
+    vm1.execute(properties, radical, 0.1, xMax, yMax, zMax, writeFiles);
     voroMetal3D vm2;
-    vm2.correspondance(0.00001, xMax, yMax, zMax);
+    vm2.correspondance(0.00001, xMax, yMax, zMax, writeFiles);
   }
 }
 
@@ -1091,6 +1142,8 @@ static void computeBestSeeds(const char *filename)
       file >> properties[4 * j + 2];
       file >> properties[4 * j + 3];
     }
+    // the trial models must not become the current model
+    GModel::setCurrent(GModel::current());
     std::cout << "Before count" << std::endl;
     std::vector<double> listDistances;
     listDistances.clear();
@@ -1115,14 +1168,12 @@ static void computeBestSeeds(const char *filename)
         propertiesModified[4 * j] += 0.01;
         voroMetal3D vm1;
         std::cout << "before execute" << std::endl;
-        // std::remove("MicrostructurePolycrystal3D.geo");
-        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax);
-        // GModel::current()->destroy();
+        // the trial microstructure is built in a separate model, without
+        // writing any file
         GModel *m = new GModel();
-        // GModel::current()->load("MicrostructurePolycrystal3D.geo");
-        m->load("MicrostructurePolycrystal3D.geo");
+        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax, false,
+                    m);
         double distMinTmp = 1000.0;
-        // GModel *m = GModel::current();
         for(GModel::eiter ite = m->firstEdge(); ite != m->lastEdge(); ite++) {
           GEdge *eTmp = (*ite);
           GVertex *vTmp1 = eTmp->getBeginVertex();
@@ -1156,14 +1207,12 @@ static void computeBestSeeds(const char *filename)
         propertiesModified[4 * j + 1] += 0.01;
         voroMetal3D vm1;
         std::cout << "before execute" << std::endl;
-        // std::remove("MicrostructurePolycrystal3D.geo");
-        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax);
-        // GModel::current()->destroy();
+        // the trial microstructure is built in a separate model, without
+        // writing any file
         GModel *m = new GModel();
-        // GModel::current()->load("MicrostructurePolycrystal3D.geo");
-        m->load("MicrostructurePolycrystal3D.geo");
+        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax, false,
+                    m);
         double distMinTmp = 1000.0;
-        // GModel *m = GModel::current();
         for(GModel::eiter ite = m->firstEdge(); ite != m->lastEdge(); ite++) {
           GEdge *eTmp = (*ite);
           GVertex *vTmp1 = eTmp->getBeginVertex();
@@ -1197,14 +1246,12 @@ static void computeBestSeeds(const char *filename)
         propertiesModified[4 * j + 2] += 0.01;
         voroMetal3D vm1;
         std::cout << "before execute" << std::endl;
-        // std::remove("MicrostructurePolycrystal3D.geo");
-        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax);
-        // GModel::current()->destroy();
+        // the trial microstructure is built in a separate model, without
+        // writing any file
         GModel *m = new GModel();
-        // GModel::current()->load("MicrostructurePolycrystal3D.geo");
-        m->load("MicrostructurePolycrystal3D.geo");
+        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax, false,
+                    m);
         double distMinTmp = 1000.0;
-        // GModel *m = GModel::current();
         for(GModel::eiter ite = m->firstEdge(); ite != m->lastEdge(); ite++) {
           GEdge *eTmp = (*ite);
           GVertex *vTmp1 = eTmp->getBeginVertex();
@@ -1238,14 +1285,12 @@ static void computeBestSeeds(const char *filename)
         propertiesModified[4 * j] -= 0.01;
         voroMetal3D vm1;
         std::cout << "before execute" << std::endl;
-        // std::remove("MicrostructurePolycrystal3D.geo");
-        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax);
-        // GModel::current()->destroy();
+        // the trial microstructure is built in a separate model, without
+        // writing any file
         GModel *m = new GModel();
-        // GModel::current()->load("MicrostructurePolycrystal3D.geo");
-        m->load("MicrostructurePolycrystal3D.geo");
+        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax, false,
+                    m);
         double distMinTmp = 1000.0;
-        // GModel *m = GModel::current();
         for(GModel::eiter ite = m->firstEdge(); ite != m->lastEdge(); ite++) {
           GEdge *eTmp = (*ite);
           GVertex *vTmp1 = eTmp->getBeginVertex();
@@ -1279,14 +1324,12 @@ static void computeBestSeeds(const char *filename)
         propertiesModified[4 * j + 1] -= 0.01;
         voroMetal3D vm1;
         std::cout << "before execute" << std::endl;
-        // std::remove("MicrostructurePolycrystal3D.geo");
-        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax);
-        // GModel::current()->destroy();
+        // the trial microstructure is built in a separate model, without
+        // writing any file
         GModel *m = new GModel();
-        // GModel::current()->load("MicrostructurePolycrystal3D.geo");
-        m->load("MicrostructurePolycrystal3D.geo");
+        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax, false,
+                    m);
         double distMinTmp = 1000.0;
-        // GModel *m = GModel::current();
         for(GModel::eiter ite = m->firstEdge(); ite != m->lastEdge(); ite++) {
           GEdge *eTmp = (*ite);
           GVertex *vTmp1 = eTmp->getBeginVertex();
@@ -1320,14 +1363,12 @@ static void computeBestSeeds(const char *filename)
         propertiesModified[4 * j + 2] -= 0.01;
         voroMetal3D vm1;
         std::cout << "before execute" << std::endl;
-        // std::remove("MicrostructurePolycrystal3D.geo");
-        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax);
-        // GModel::current()->destroy();
+        // the trial microstructure is built in a separate model, without
+        // writing any file
         GModel *m = new GModel();
-        // GModel::current()->load("MicrostructurePolycrystal3D.geo");
-        m->load("MicrostructurePolycrystal3D.geo");
+        vm1.execute(propertiesModified, radical, 0.1, xMax, yMax, zMax, false,
+                    m);
         double distMinTmp = 1000.0;
-        // GModel *m = GModel::current();
         for(GModel::eiter ite = m->firstEdge(); ite != m->lastEdge(); ite++) {
           GEdge *eTmp = (*ite);
           GVertex *vTmp1 = eTmp->getBeginVertex();
@@ -1377,7 +1418,6 @@ static void computeBestSeeds(const char *filename)
     }
     voroMetal3D vm1;
     vm1.execute(properties, radical, 0.1, xMax, yMax, zMax);
-    GModel::current()->load("MicrostructurePolycrystal3D.geo");
     voroMetal3D vm2;
     vm2.correspondance(0.00001, xMax, yMax, zMax);
     for(std::size_t iTmp = 0; iTmp < listDistances.size(); iTmp++) {
@@ -1397,9 +1437,10 @@ PView *GMSH_VoroMetalPlugin::execute(PView *v)
 {
   int runBestSeeds = (int)VoroMetalOptions_Number[0].def;
   int runMicrostructure = (int)VoroMetalOptions_Number[1].def;
+  bool writeFiles = (bool)VoroMetalOptions_Number[2].def;
   std::string seedsFile = VoroMetalOptions_String[0].def;
   if(runBestSeeds) computeBestSeeds(seedsFile.c_str());
-  if(runMicrostructure) microstructure(seedsFile.c_str());
+  if(runMicrostructure) microstructure(seedsFile.c_str(), writeFiles);
   return v;
 }
 
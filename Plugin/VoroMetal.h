@@ -9,31 +9,6 @@
 #include <vector>
 #include "Plugin.h"
 
-class geo_cell {
-public:
-  std::vector<std::pair<int, int> > lines;
-  std::vector<std::vector<int> > line_loops;
-  std::vector<std::vector<int> > orientations;
-  std::vector<int> points2;
-  std::vector<int> lines2;
-  std::vector<int> line_loops2;
-  std::vector<int> faces2;
-  int face_loops2;
-  geo_cell() {}
-  ~geo_cell() {}
-  int search_line(std::pair<int, int> line)
-  {
-    std::size_t i;
-    for(i = 0; i < lines.size(); i++) {
-      if(lines[i].first == line.first && lines[i].second == line.second)
-        return i;
-      if(lines[i].first == line.second && lines[i].second == line.first)
-        return i;
-    }
-    return -1;
-  }
-};
-
 class voroMetal3D {
 private:
   int counter;
@@ -43,9 +18,14 @@ public:
   ~voroMetal3D() {}
   void execute(double);
   void execute(GRegion *, double);
+  // compute the Voronoi cells and create the corresponding GEO entities in
+  // the given model (the current model by default); the .geo, .pos and .map
+  // files are optionally written
   void execute(std::vector<SPoint3> &, std::vector<double> &, int, double,
-               double, double, double);
-  void execute(std::vector<double> &, int, double, double, double, double);
+               double, double, double, bool writeFiles = true,
+               GModel *model = 0);
+  void execute(std::vector<double> &, int, double, double, double, double,
+               bool writeFiles = true, GModel *model = 0);
   void print_segment(SPoint3, SPoint3, std::ofstream &);
   void initialize_counter();
   void increase_counter();
@@ -59,7 +39,7 @@ public:
   void print_geo_line_loop(int, std::vector<int> &, std::vector<int> &,
                            std::ofstream &);
   void print_geo_face_loop(int, std::vector<int> &, std::ofstream &);
-  void correspondance(double, double, double, double);
+  void correspondance(double, double, double, double, bool writeFiles = true);
   bool correspondance(double, double, double, double, int &, double, double,
                       double);
   void correspondance(double, double, double, double, int, bool &, double,
@@ -122,7 +122,7 @@ void elasticitySolver::solve()
 #elif defined(HAVE_GMM)
   linearSystemCSRGmm<double> *lsys = new linearSystemCSRGmm<double>;
 #else
-  linearSystemFull<double> *lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   assemble(lsys);
@@ -170,7 +170,7 @@ void frameSolver2d::solve()
   lsys->setGmres(1);
   lsys->setNoisy(1);
 #else
-  linearSystemFull<double> *lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   if(pAssembler) delete pAssembler;
@@ -197,4 +197,33 @@ public:
   ;
 };
 
+// Dependency-free solver for CSR systems: a sparse LDL^T factorization with a
+// fill-reducing ordering ("ldlt", the default, used when the matrix is
+// symmetric; falling back to "gmres" if it is not, if a pivot is tiny or if
+// the residual after one step of iterative refinement is larger than the
+// tolerance), or Jacobi-preconditioned conjugate gradients ("cg") or
+// ILU(0)-preconditioned restarted GMRES ("gmres").
+template <class scalar>
+class linearSystemCSRBuiltin : public linearSystemCSR<scalar> {
+private:
+  std::string _method;
+  double _tol;
+  int _noisy;
+  int _maxIter;
+
+public:
+  linearSystemCSRBuiltin(const std::string &method = "ldlt", double tol = 1e-8,
+                         int noisy = 0)
+    : _method(method), _tol(tol), _noisy(noisy), _maxIter(10000)
+  {
+  }
+  virtual ~linearSystemCSRBuiltin() {}
+  void setMethod(const std::string &method) { _method = method; }
+  void setPrec(double p) { _tol = p; }
+  void setNoisy(int n) { _noisy = n; }
+  void setMaxIterations(int n) { _maxIter = n; }
+  void setGmres(int n) { _method = (n ? "gmres" : "cg"); }
+  virtual int systemSolve();
+};
+
 #endif
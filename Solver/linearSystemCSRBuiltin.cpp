@@ -0,0 +1,503 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "GmshConfig.h"
+#include "GmshMessage.h"
+#include "linearSystemCSR.h"
+
+#if defined(HAVE_METIS)
+extern "C" {
+#include <metis.h>
+}
+#endif
+
+// Sparse matrix in compressed row storage, with sorted column indices (as
+// returned by linearSystemCSR::getMatrix)
+struct csrMatrix {
+  int n;
+  const INDEX_TYPE *jptr, *ai;
+  const double *a;
+};
+
+static void csrMult(const csrMatrix &A, const std::vector<double> &x,
+                    std::vector<double> &y)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < A.n; i++) {
+    double s = 0.;
+    for(INDEX_TYPE p = A.jptr[i]; p < A.jptr[i + 1]; p++)
+      s += A.a[p] * x[A.ai[p]];
+    y[i] = s;
+  }
+}
+
+static double dot(const std::vector<double> &x, const std::vector<double> &y)
+{
+  double s = 0.;
+  for(std::size_t i = 0; i < x.size(); i++) s += x[i] * y[i];
+  return s;
+}
+
+static bool csrIsSymmetric(const csrMatrix &A)
+{
+  for(int i = 0; i < A.n; i++) {
+    for(INDEX_TYPE p = A.jptr[i]; p < A.jptr[i + 1]; p++) {
+      const int j = A.ai[p];
+      if(j == i) continue;
+      const INDEX_TYPE *q =
+        std::lower_bound(A.ai + A.jptr[j], A.ai + A.jptr[j + 1], i);
+      if(q == A.ai + A.jptr[j + 1] || *q != i) {
+        if(A.a[p] != 0.) return false;
+        continue;
+      }
+      const double aij = A.a[p], aji = A.a[q - A.ai];
+      if(std::abs(aij - aji) >
+         1e-12 * std::max(std::abs(aij), std::abs(aji)))
+        return false;
+    }
+  }
+  return true;
+}
+
+class degreeLessThan {
+private:
+  const std::vector<int> &_degree;
+
+public:
+  degreeLessThan(const std::vector<int> &degree) : _degree(degree) {}
+  bool operator()(int i, int j) const { return _degree[i] < _degree[j]; }
+};
+
+// Reverse Cuthill-McKee ordering of the graph of a symmetric matrix, starting
+// each connected component from a node of minimum degree
+static void reverseCuthillMcKee(const csrMatrix &A, std::vector<int> &perm)
+{
+  const int n = A.n;
+  std::vector<int> degree(n);
+  for(int i = 0; i < n; i++) degree[i] = A.jptr[i + 1] - A.jptr[i];
+  std::vector<int> nodes(n);
+  for(int i = 0; i < n; i++) nodes[i] = i;
+  std::stable_sort(nodes.begin(), nodes.end(), degreeLessThan(degree));
+  std::vector<char> visited(n, 0);
+  perm.clear();
+  perm.reserve(n);
+  std::vector<int> neighbors;
+  for(int s = 0; s < n; s++) {
+    if(visited[nodes[s]]) continue;
+    std::size_t head = perm.size();
+    perm.push_back(nodes[s]);
+    visited[nodes[s]] = 1;
+    while(head < perm.size()) {
+      const int i = perm[head++];
+      neighbors.clear();
+      for(INDEX_TYPE p = A.jptr[i]; p < A.jptr[i + 1]; p++) {
+        if(!visited[A.ai[p]]) {
+          visited[A.ai[p]] = 1;
+          neighbors.push_back(A.ai[p]);
+        }
+      }
+      std::stable_sort(neighbors.begin(), neighbors.end(),
+                       degreeLessThan(degree));
+      perm.insert(perm.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+  std::reverse(perm.begin(), perm.end());
+}
+
+// Fill-reducing ordering of a symmetric matrix: perm[k] is the (old) index of
+// the k-th unknown of the permuted matrix
+static void fillReducingOrdering(const csrMatrix &A, std::vector<int> &perm)
+{
+#if defined(HAVE_METIS)
+  // nested dissection on the graph of the matrix (without the diagonal)
+  std::vector<idx_t> xadj(A.n + 1), adjncy;
+  adjncy.reserve(A.jptr[A.n]);
+  xadj[0] = 0;
+  for(int i = 0; i < A.n; i++) {
+    for(INDEX_TYPE p = A.jptr[i]; p < A.jptr[i + 1]; p++)
+      if(A.ai[p] != i) adjncy.push_back(A.ai[p]);
+    xadj[i + 1] = adjncy.size();
+  }
+  if(!adjncy.empty()) {
+    idx_t nvtxs = A.n;
+    std::vector<idx_t> mperm(A.n), miperm(A.n);
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    if(METIS_NodeND(&nvtxs, &xadj[0], &adjncy[0], NULL, options, &mperm[0],
+                    &miperm[0]) == METIS_OK) {
+      perm.assign(mperm.begin(), mperm.end());
+      return;
+    }
+    Msg::Warning("METIS ordering failed: using reverse Cuthill-McKee");
+  }
+#endif
+  reverseCuthillMcKee(A, perm);
+}
+
+// Up-looking sparse LDL^T factorization of P A P^T, with A symmetric (only
+// the entries of the upper triangle of the permuted matrix are used). The
+// elimination tree gives the nonzero pattern of each row of L, which is
+// computed by a symbolic pass before the numerical one (T. A. Davis,
+// "Algorithm 849: A concise sparse Cholesky factorization package", ACM TOMS,
+// 2005).
+class sparseLDLT {
+private:
+  int _n;
+  std::vector<int> _perm, _iperm;
+  std::vector<INDEX_TYPE> _lp;
+  std::vector<int> _li;
+  std::vector<double> _lx, _d;
+
+public:
+  // return false if a pivot is zero or tiny relative to the largest diagonal
+  // entry of the matrix (there is no pivoting, so that a symmetric indefinite
+  // matrix can break down even if it is not singular)
+  bool factorize(const csrMatrix &A, const std::vector<int> &perm,
+                 double pivotTol = 1e-14)
+  {
+    const int n = _n = A.n;
+    double maxDiag = 0.;
+    for(int i = 0; i < n; i++)
+      for(INDEX_TYPE p = A.jptr[i]; p < A.jptr[i + 1]; p++)
+        if(A.ai[p] == i) maxDiag = std::max(maxDiag, std::abs(A.a[p]));
+    _perm = perm;
+    _iperm.resize(n);
+    for(int k = 0; k < n; k++) _iperm[_perm[k]] = k;
+
+    // symbolic factorization: elimination tree and column counts of L
+    std::vector<int> parent(n), flag(n), lnz(n);
+    for(int k = 0; k < n; k++) {
+      parent[k] = -1;
+      flag[k] = k;
+      lnz[k] = 0;
+      const int kk = _perm[k];
+      for(INDEX_TYPE p = A.jptr[kk]; p < A.jptr[kk + 1]; p++) {
+        int i = _iperm[A.ai[p]];
+        if(i >= k) continue;
+        for(; flag[i] != k; i = parent[i]) {
+          if(parent[i] == -1) parent[i] = k;
+          lnz[i]++;
+          flag[i] = k;
+        }
+      }
+    }
+    _lp.resize(n + 1);
+    _lp[0] = 0;
+    for(int k = 0; k < n; k++) _lp[k + 1] = _lp[k] + lnz[k];
+    _li.resize(_lp[n]);
+    _lx.resize(_lp[n]);
+    _d.resize(n);
+
+    // numerical factorization, row by row
+    std::vector<double> y(n, 0.);
+    std::vector<int> pattern(n);
+    for(int k = 0; k < n; k++) {
+      int top = n;
+      flag[k] = k;
+      lnz[k] = 0;
+      const int kk = _perm[k];
+      for(INDEX_TYPE p = A.jptr[kk]; p < A.jptr[kk + 1]; p++) {
+        int i = _iperm[A.ai[p]];
+        if(i > k) continue;
+        y[i] += A.a[p];
+        int len = 0;
+        for(; flag[i] != k; i = parent[i]) {
+          pattern[len++] = i;
+          flag[i] = k;
+        }
+        while(len > 0) pattern[--top] = pattern[--len];
+      }
+      _d[k] = y[k];
+      y[k] = 0.;
+      for(; top < n; top++) {
+        const int i = pattern[top];
+        const double yi = y[i];
+        y[i] = 0.;
+        const INDEX_TYPE p2 = _lp[i] + lnz[i];
+        for(INDEX_TYPE p = _lp[i]; p < p2; p++) y[_li[p]] -= _lx[p] * yi;
+        const double lki = yi / _d[i];
+        _d[k] -= lki * yi;
+        _li[p2] = k;
+        _lx[p2] = lki;
+        lnz[i]++;
+      }
+      if(!(std::abs(_d[k]) > pivotTol * maxDiag)) return false;
+    }
+    return true;
+  }
+  std::size_t getNumNonZeros() const { return _lx.size(); }
+  void solve(const std::vector<double> &b, std::vector<double> &x) const
+  {
+    std::vector<double> y(_n);
+    for(int k = 0; k < _n; k++) y[k] = b[_perm[k]];
+    for(int j = 0; j < _n; j++)
+      for(INDEX_TYPE p = _lp[j]; p < _lp[j + 1]; p++)
+        y[_li[p]] -= _lx[p] * y[j];
+    for(int j = 0; j < _n; j++) y[j] /= _d[j];
+    for(int j = _n - 1; j >= 0; j--)
+      for(INDEX_TYPE p = _lp[j]; p < _lp[j + 1]; p++)
+        y[j] -= _lx[p] * y[_li[p]];
+    for(int k = 0; k < _n; k++) x[_perm[k]] = y[k];
+  }
+};
+
+// Incomplete LU factorization with the sparsity pattern of the matrix
+class incompleteLU {
+private:
+  int _n;
+  std::vector<INDEX_TYPE> _jptr, _diag;
+  std::vector<int> _ai;
+  std::vector<double> _a;
+
+public:
+  // return false if a diagonal entry is missing or becomes zero
+  bool factorize(const csrMatrix &A)
+  {
+    const int n = _n = A.n;
+    _jptr.assign(A.jptr, A.jptr + n + 1);
+    _ai.assign(A.ai, A.ai + A.jptr[n]);
+    _a.assign(A.a, A.a + A.jptr[n]);
+    _diag.resize(n);
+    std::vector<INDEX_TYPE> pos(n, -1);
+    for(int i = 0; i < n; i++) {
+      _diag[i] = -1;
+      for(INDEX_TYPE p = _jptr[i]; p < _jptr[i + 1]; p++) {
+        pos[_ai[p]] = p;
+        if(_ai[p] == i) _diag[i] = p;
+      }
+      if(_diag[i] < 0) return false;
+      for(INDEX_TYPE p = _jptr[i]; p < _diag[i]; p++) {
+        const int k = _ai[p];
+        _a[p] /= _a[_diag[k]];
+        for(INDEX_TYPE q = _diag[k] + 1; q < _jptr[k + 1]; q++)
+          if(pos[_ai[q]] >= 0) _a[pos[_ai[q]]] -= _a[p] * _a[q];
+      }
+      if(_a[_diag[i]] == 0.) return false;
+      for(INDEX_TYPE p = _jptr[i]; p < _jptr[i + 1]; p++) pos[_ai[p]] = -1;
+    }
+    return true;
+  }
+  // x = (LU)^-1 b
+  void solve(const std::vector<double> &b, std::vector<double> &x) const
+  {
+    for(int i = 0; i < _n; i++) {
+      double s = b[i];
+      for(INDEX_TYPE p = _jptr[i]; p < _diag[i]; p++) s -= _a[p] * x[_ai[p]];
+      x[i] = s;
+    }
+    for(int i = _n - 1; i >= 0; i--) {
+      double s = x[i];
+      for(INDEX_TYPE p = _diag[i] + 1; p < _jptr[i + 1]; p++)
+        s -= _a[p] * x[_ai[p]];
+      x[i] = s / _a[_diag[i]];
+    }
+  }
+};
+
+// Jacobi-preconditioned conjugate gradients; return the number of iterations,
+// or -1 if the method did not converge
+static int conjugateGradients(const csrMatrix &A, const std::vector<double> &b,
+                              std::vector<double> &x, double tol, int maxIter)
+{
+  const int n = A.n;
+  std::vector<double> invDiag(n, 1.);
+  for(int i = 0; i < n; i++) {
+    for(INDEX_TYPE p = A.jptr[i]; p < A.jptr[i + 1]; p++)
+      if(A.ai[p] == i && A.a[p] != 0.) invDiag[i] = 1. / A.a[p];
+  }
+  std::vector<double> r(n), z(n), d(n), q(n);
+  csrMult(A, x, q);
+  for(int i = 0; i < n; i++) r[i] = b[i] - q[i];
+  const double normb = std::sqrt(dot(b, b));
+  if(normb == 0.) {
+    std::fill(x.begin(), x.end(), 0.);
+    return 0;
+  }
+  for(int i = 0; i < n; i++) d[i] = z[i] = invDiag[i] * r[i];
+  double rz = dot(r, z);
+  for(int it = 0; it < maxIter; it++) {
+    if(std::sqrt(dot(r, r)) <= tol * normb) return it;
+    csrMult(A, d, q);
+    const double dq = dot(d, q);
+    if(dq == 0.) return -1;
+    const double alpha = rz / dq;
+    for(int i = 0; i < n; i++) {
+      x[i] += alpha * d[i];
+      r[i] -= alpha * q[i];
+      z[i] = invDiag[i] * r[i];
+    }
+    const double rz2 = dot(r, z);
+    const double beta = rz2 / rz;
+    rz = rz2;
+    for(int i = 0; i < n; i++) d[i] = z[i] + beta * d[i];
+  }
+  return -1;
+}
+
+// Restarted GMRES with right preconditioning by ILU(0) (or no preconditioning
+// if the incomplete factorization breaks down); return the number of
+// iterations, or -1 if the method did not converge
+static int gmres(const csrMatrix &A, const std::vector<double> &b,
+                 std::vector<double> &x, double tol, int maxIter,
+                 int restart = 100)
+{
+  const int n = A.n;
+  incompleteLU ilu;
+  const bool precond = ilu.factorize(A);
+  if(!precond)
+    Msg::Warning("Incomplete LU factorization failed: using unpreconditioned "
+                 "GMRES");
+  const double normb = std::sqrt(dot(b, b));
+  if(normb == 0.) {
+    std::fill(x.begin(), x.end(), 0.);
+    return 0;
+  }
+  const int m = std::max(1, std::min(restart, n));
+  std::vector<std::vector<double> > v(m + 1, std::vector<double>(n));
+  std::vector<std::vector<double> > h(m + 1, std::vector<double>(m, 0.));
+  std::vector<double> cs(m), sn(m), g(m + 1), w(n), z(n), y(m);
+  int it = 0;
+  while(it < maxIter) {
+    csrMult(A, x, w);
+    for(int i = 0; i < n; i++) v[0][i] = b[i] - w[i];
+    double beta = std::sqrt(dot(v[0], v[0]));
+    if(beta <= tol * normb) return it;
+    for(int i = 0; i < n; i++) v[0][i] /= beta;
+    std::fill(g.begin(), g.end(), 0.);
+    g[0] = beta;
+    int k = 0;
+    for(; k < m && it < maxIter; k++, it++) {
+      if(precond)
+        ilu.solve(v[k], z);
+      else
+        z = v[k];
+      csrMult(A, z, w);
+      // modified Gram-Schmidt
+      for(int j = 0; j <= k; j++) {
+        h[j][k] = dot(w, v[j]);
+        for(int i = 0; i < n; i++) w[i] -= h[j][k] * v[j][i];
+      }
+      h[k + 1][k] = std::sqrt(dot(w, w));
+      if(h[k + 1][k] != 0.)
+        for(int i = 0; i < n; i++) v[k + 1][i] = w[i] / h[k + 1][k];
+      // apply the previous Givens rotations, and compute the new one
+      for(int j = 0; j < k; j++) {
+        const double t = cs[j] * h[j][k] + sn[j] * h[j + 1][k];
+        h[j + 1][k] = -sn[j] * h[j][k] + cs[j] * h[j + 1][k];
+        h[j][k] = t;
+      }
+      const double r = std::sqrt(h[k][k] * h[k][k] + h[k + 1][k] * h[k + 1][k]);
+      if(r == 0.) {
+        // breakdown (e.g. for a singular matrix): count the iteration, so that
+        // the restarts cannot loop forever without any progress
+        k++;
+        it++;
+        break;
+      }
+      cs[k] = h[k][k] / r;
+      sn[k] = h[k + 1][k] / r;
+      h[k][k] = r;
+      h[k + 1][k] = 0.;
+      g[k + 1] = -sn[k] * g[k];
+      g[k] = cs[k] * g[k];
+      if(std::abs(g[k + 1]) <= tol * normb) {
+        k++;
+        it++;
+        break;
+      }
+    }
+    // update the solution with the Krylov vectors
+    for(int j = k - 1; j >= 0; j--) {
+      double s = g[j];
+      for(int l = j + 1; l < k; l++) s -= h[j][l] * y[l];
+      y[j] = (h[j][j] != 0.) ? s / h[j][j] : 0.;
+    }
+    std::fill(w.begin(), w.end(), 0.);
+    for(int j = 0; j < k; j++)
+      for(int i = 0; i < n; i++) w[i] += y[j] * v[j][i];
+    if(precond)
+      ilu.solve(w, z);
+    else
+      z = w;
+    for(int i = 0; i < n; i++) x[i] += z[i];
+  }
+  csrMult(A, x, w);
+  double res = 0.;
+  for(int i = 0; i < n; i++) res += (b[i] - w[i]) * (b[i] - w[i]);
+  return (std::sqrt(res) <= tol * normb) ? it : -1;
+}
+
+template <> int linearSystemCSRBuiltin<double>::systemSolve()
+{
+  if(!_b || _b->empty()) return 1;
+  csrMatrix A;
+  A.n = _b->size();
+  INDEX_TYPE *jptr, *ai;
+  double *a;
+  getMatrix(jptr, ai, a);
+  A.jptr = jptr;
+  A.ai = ai;
+  A.a = a;
+
+  std::string method = _method;
+  if(method == "ldlt") {
+    if(!csrIsSymmetric(A)) {
+      if(_noisy) Msg::Info("Matrix is not symmetric: using GMRES");
+      method = "gmres";
+    }
+    else {
+      std::vector<int> perm;
+      fillReducingOrdering(A, perm);
+      sparseLDLT ldlt;
+      if(ldlt.factorize(A, perm)) {
+        if(_noisy)
+          Msg::Info("Sparse LDL^T factorization: %d unknowns, %lu nonzeros "
+                    "in L",
+                    A.n, (unsigned long)ldlt.getNumNonZeros());
+        ldlt.solve(*_b, *_x);
+        // one step of iterative refinement, then check the residual
+        std::vector<double> r(A.n), dx(A.n);
+        csrMult(A, *_x, r);
+        for(int i = 0; i < A.n; i++) r[i] = (*_b)[i] - r[i];
+        ldlt.solve(r, dx);
+        for(int i = 0; i < A.n; i++) (*_x)[i] += dx[i];
+        csrMult(A, *_x, r);
+        for(int i = 0; i < A.n; i++) r[i] = (*_b)[i] - r[i];
+        const double res = std::sqrt(dot(r, r));
+        const double normb = std::sqrt(dot(*_b, *_b));
+        if(res <= _tol * normb) return 1;
+        Msg::Warning("Inaccurate sparse LDL^T solution (relative residual %g): "
+                     "using GMRES", normb ? res / normb : res);
+        if(!std::isfinite(res)) std::fill(_x->begin(), _x->end(), 0.);
+      }
+      else
+        Msg::Warning("Zero pivot in sparse LDL^T factorization: using GMRES");
+      method = "gmres";
+    }
+  }
+
+  int it;
+  if(method == "cg")
+    it = conjugateGradients(A, *_b, *_x, _tol, _maxIter);
+  else if(method == "gmres")
+    it = gmres(A, *_b, *_x, _tol, _maxIter);
+  else {
+    Msg::Error("Unknown linear solver '%s'", method.c_str());
+    return 0;
+  }
+  if(it < 0) {
+    Msg::Warning("%s did not converge in %d iterations",
+                 (method == "cg") ? "Conjugate gradient" : "GMRES", _maxIter);
+    return 0;
+  }
+  if(_noisy) Msg::Info("%s converged in %d iterations",
+                       (method == "cg") ? "Conjugate gradient" : "GMRES", it);
+  return 1;
+}
@@ -46,7 +46,7 @@ void thermicSolver::solve()
   lsys->setGmres(1);
   lsys->setNoisy(1);
 #else
-  linearSystemFull<double> *lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
   assemble(lsys);
   lsys->systemSolve();
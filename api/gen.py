@@ -312,6 +312,15 @@ mesh.add('getBasisFunctionsForElements', doc, None, iint('elementType'), ivector
 doc = '''Preallocate data before calling `getBasisFunctionsForElements' with `numTasks' > 1. For C and C++ only.'''
 mesh.add_special('preallocateBasisFunctions', doc, ['onlycc++'], None, iint('elementType'), iint('numIntegrationPoints'), istring('functionSpaceType'), ovectordouble('basisFunctions'), iint('tag', '-1'))
 
+doc = '''Get the orientations of the elements of type `elementType' in the entity of tag `tag', for the function space `functionSpaceType'. The orientation of an element determines how its edge and face basis functions are reoriented in `getBasisFunctionsForElements'. `orientations' returns the distinct orientations (integers between 0 and `getNumberOfOrientations' - 1) found among the elements, in increasing order, and `elementOrientations' returns for each element the index of its orientation in `orientations'. Together with `getBasisFunctionsForOrientations', this gives the same data as `getBasisFunctionsForElements' with one table per orientation instead of one per element. Warning: this is an experimental feature and will probably change in a future release.'''
+mesh.add('getBasisFunctionsOrientationForElements', doc, None, iint('elementType'), istring('functionSpaceType'), ovectorint('orientations'), ovectorint('elementOrientations'), iint('tag', '-1'))
+
+doc = '''Get the number of possible orientations of the elements of type `elementType' for the function space `functionSpaceType'.'''
+mesh.add('getNumberOfOrientations', doc, oint, iint('elementType'), istring('functionSpaceType'))
+
+doc = '''Get the basis functions of the elements of type `elementType' with the orientations `orientations' (as returned by `getBasisFunctionsOrientationForElements') at the integration points `integrationPoints', for the function space `functionSpaceType'. `numComponents' returns the number C of components of a basis function. `numFunctionsPerElements' returns the number N of basis functions per element. `basisFunctions' returns the value of the basis functions at the integration points for each orientation: [o1g1f1,..., o1g1fN, o1g2f1,..., o2g1f1, ...] when C == 1 or [o1g1f1u, o1g1f1v,..., o1g1fNw, o1g2f1u,..., o2g1f1u, ...]. Warning: this is an experimental feature and will probably change in a future release.'''
+mesh.add('getBasisFunctionsForOrientations', doc, None, iint('elementType'), ivectordouble('integrationPoints'), istring('functionSpaceType'), ivectorint('orientations'), oint('numComponents'), oint('numFunctionsPerElements'), ovectordouble('basisFunctions'))
+
 doc = '''Generate the `keys' for the elements of type `elementType' in the entity of tag `tag', for the `functionSpaceType' function space. Each key uniquely identifies a basis function in the function space. If `returnCoord' is set, the `coord' vector contains the x, y, z coordinates locating basis functions for sorting purposes. Warning: this is an experimental feature and will probably change in a future release.'''
 mesh.add('getKeysForElements', doc, None, iint('elementType'), istring('functionSpaceType'), ovectorpair('keys'), ovectordouble('coord'), iint('tag', '-1'), ibool('returnCoord', 'true', 'True'))
 
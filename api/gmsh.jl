@@ -1738,6 +1738,85 @@ function getBasisFunctionsForElements(elementType, integrationPoints, functionSp
     return api_numComponents_[], api_numFunctionsPerElements_[], basisFunctions
 end
 
+"""
+    gmsh.model.mesh.getBasisFunctionsOrientationForElements(elementType, functionSpaceType, tag = -1)
+
+Get the orientations of the elements of type `elementType` in the entity of tag
+`tag`, for the function space `functionSpaceType`. The orientation of an element
+determines how its edge and face basis functions are reoriented in
+`getBasisFunctionsForElements`. `orientations` returns the distinct orientations
+(integers between 0 and `getNumberOfOrientations` - 1) found among the elements,
+in increasing order, and `elementOrientations` returns for each element the
+index of its orientation in `orientations`. Together with
+`getBasisFunctionsForOrientations`, this gives the same data as
+`getBasisFunctionsForElements` with one table per orientation instead of one per
+element. Warning: this is an experimental feature and will probably change in a
+future release.
+
+Return `orientations`, `elementOrientations`.
+"""
+function getBasisFunctionsOrientationForElements(elementType, functionSpaceType, tag = -1)
+    api_orientations_ = Ref{Ptr{Cint}}()
+    api_orientations_n_ = Ref{Csize_t}()
+    api_elementOrientations_ = Ref{Ptr{Cint}}()
+    api_elementOrientations_n_ = Ref{Csize_t}()
+    ierr = Ref{Cint}()
+    ccall((:gmshModelMeshGetBasisFunctionsOrientationForElements, gmsh.lib), Cvoid,
+          (Cint, Ptr{Cchar}, Ptr{Ptr{Cint}}, Ptr{Csize_t}, Ptr{Ptr{Cint}}, Ptr{Csize_t}, Cint, Ptr{Cint}),
+          elementType, functionSpaceType, api_orientations_, api_orientations_n_, api_elementOrientations_, api_elementOrientations_n_, tag, ierr)
+    ierr[] != 0 && error("gmshModelMeshGetBasisFunctionsOrientationForElements returned non-zero error code: $(ierr[])")
+    orientations = unsafe_wrap(Array, api_orientations_[], api_orientations_n_[], own=true)
+    elementOrientations = unsafe_wrap(Array, api_elementOrientations_[], api_elementOrientations_n_[], own=true)
+    return orientations, elementOrientations
+end
+
+"""
+    gmsh.model.mesh.getNumberOfOrientations(elementType, functionSpaceType)
+
+Get the number of possible orientations of the elements of type `elementType`
+for the function space `functionSpaceType`.
+
+Return an integer value.
+"""
+function getNumberOfOrientations(elementType, functionSpaceType)
+    ierr = Ref{Cint}()
+    api__result__ = ccall((:gmshModelMeshGetNumberOfOrientations, gmsh.lib), Cint,
+          (Cint, Ptr{Cchar}, Ptr{Cint}),
+          elementType, functionSpaceType, ierr)
+    ierr[] != 0 && error("gmshModelMeshGetNumberOfOrientations returned non-zero error code: $(ierr[])")
+    return api__result__
+end
+
+"""
+    gmsh.model.mesh.getBasisFunctionsForOrientations(elementType, integrationPoints, functionSpaceType, orientations)
+
+Get the basis functions of the elements of type `elementType` with the
+orientations `orientations` (as returned by
+`getBasisFunctionsOrientationForElements`) at the integration points
+`integrationPoints`, for the function space `functionSpaceType`. `numComponents`
+returns the number C of components of a basis function.
+`numFunctionsPerElements` returns the number N of basis functions per element.
+`basisFunctions` returns the value of the basis functions at the integration
+points for each orientation: [o1g1f1,..., o1g1fN, o1g2f1,..., o2g1f1, ...] when
+C == 1 or [o1g1f1u, o1g1f1v,..., o1g1fNw, o1g2f1u,..., o2g1f1u, ...]. Warning:
+this is an experimental feature and will probably change in a future release.
+
+Return `numComponents`, `numFunctionsPerElements`, `basisFunctions`.
+"""
+function getBasisFunctionsForOrientations(elementType, integrationPoints, functionSpaceType, orientations)
+    api_numComponents_ = Ref{Cint}()
+    api_numFunctionsPerElements_ = Ref{Cint}()
+    api_basisFunctions_ = Ref{Ptr{Cdouble}}()
+    api_basisFunctions_n_ = Ref{Csize_t}()
+    ierr = Ref{Cint}()
+    ccall((:gmshModelMeshGetBasisFunctionsForOrientations, gmsh.lib), Cvoid,
+          (Cint, Ptr{Cdouble}, Csize_t, Ptr{Cchar}, Ptr{Cint}, Csize_t, Ptr{Cint}, Ptr{Cint}, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Ptr{Cint}),
+          elementType, convert(Vector{Cdouble}, integrationPoints), length(integrationPoints), functionSpaceType, convert(Vector{Cint}, orientations), length(orientations), api_numComponents_, api_numFunctionsPerElements_, api_basisFunctions_, api_basisFunctions_n_, ierr)
+    ierr[] != 0 && error("gmshModelMeshGetBasisFunctionsForOrientations returned non-zero error code: $(ierr[])")
+    basisFunctions = unsafe_wrap(Array, api_basisFunctions_[], api_basisFunctions_n_[], own=true)
+    return api_numComponents_[], api_numFunctionsPerElements_[], basisFunctions
+end
+
 """
     gmsh.model.mesh.getKeysForElements(elementType, functionSpaceType, tag = -1, returnCoord = true)
 
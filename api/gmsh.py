@@ -2249,6 +2249,107 @@ class model:
                 api_numFunctionsPerElements_.value,
                 _ovectordouble(api_basisFunctions_, api_basisFunctions_n_.value))
 
+        @staticmethod
+        def getBasisFunctionsOrientationForElements(elementType, functionSpaceType, tag=-1):
+            """
+            gmsh.model.mesh.getBasisFunctionsOrientationForElements(elementType, functionSpaceType, tag=-1)
+
+            Get the orientations of the elements of type `elementType' in the entity of
+            tag `tag', for the function space `functionSpaceType'. The orientation of
+            an element determines how its edge and face basis functions are reoriented
+            in `getBasisFunctionsForElements'. `orientations' returns the distinct
+            orientations (integers between 0 and `getNumberOfOrientations' - 1) found
+            among the elements, in increasing order, and `elementOrientations' returns
+            for each element the index of its orientation in `orientations'. Together
+            with `getBasisFunctionsForOrientations', this gives the same data as
+            `getBasisFunctionsForElements' with one table per orientation instead of
+            one per element. Warning: this is an experimental feature and will probably
+            change in a future release.
+
+            Return `orientations', `elementOrientations'.
+            """
+            api_orientations_, api_orientations_n_ = POINTER(c_int)(), c_size_t()
+            api_elementOrientations_, api_elementOrientations_n_ = POINTER(c_int)(), c_size_t()
+            ierr = c_int()
+            lib.gmshModelMeshGetBasisFunctionsOrientationForElements(
+                c_int(elementType),
+                c_char_p(functionSpaceType.encode()),
+                byref(api_orientations_), byref(api_orientations_n_),
+                byref(api_elementOrientations_), byref(api_elementOrientations_n_),
+                c_int(tag),
+                byref(ierr))
+            if ierr.value != 0:
+                raise ValueError(
+                    "gmshModelMeshGetBasisFunctionsOrientationForElements returned non-zero error code: ",
+                    ierr.value)
+            return (
+                _ovectorint(api_orientations_, api_orientations_n_.value),
+                _ovectorint(api_elementOrientations_, api_elementOrientations_n_.value))
+
+        @staticmethod
+        def getNumberOfOrientations(elementType, functionSpaceType):
+            """
+            gmsh.model.mesh.getNumberOfOrientations(elementType, functionSpaceType)
+
+            Get the number of possible orientations of the elements of type
+            `elementType' for the function space `functionSpaceType'.
+
+            Return an integer value.
+            """
+            ierr = c_int()
+            api__result__ = lib.gmshModelMeshGetNumberOfOrientations(
+                c_int(elementType),
+                c_char_p(functionSpaceType.encode()),
+                byref(ierr))
+            if ierr.value != 0:
+                raise ValueError(
+                    "gmshModelMeshGetNumberOfOrientations returned non-zero error code: ",
+                    ierr.value)
+            return api__result__
+
+        @staticmethod
+        def getBasisFunctionsForOrientations(elementType, integrationPoints, functionSpaceType, orientations):
+            """
+            gmsh.model.mesh.getBasisFunctionsForOrientations(elementType, integrationPoints, functionSpaceType, orientations)
+
+            Get the basis functions of the elements of type `elementType' with the
+            orientations `orientations' (as returned by
+            `getBasisFunctionsOrientationForElements') at the integration points
+            `integrationPoints', for the function space `functionSpaceType'.
+            `numComponents' returns the number C of components of a basis function.
+            `numFunctionsPerElements' returns the number N of basis functions per
+            element. `basisFunctions' returns the value of the basis functions at the
+            integration points for each orientation: [o1g1f1,..., o1g1fN, o1g2f1,...,
+            o2g1f1, ...] when C == 1 or [o1g1f1u, o1g1f1v,..., o1g1fNw, o1g2f1u,...,
+            o2g1f1u, ...]. Warning: this is an experimental feature and will probably
+            change in a future release.
+
+            Return `numComponents', `numFunctionsPerElements', `basisFunctions'.
+            """
+            api_integrationPoints_, api_integrationPoints_n_ = _ivectordouble(integrationPoints)
+            api_orientations_, api_orientations_n_ = _ivectorint(orientations)
+            api_numComponents_ = c_int()
+            api_numFunctionsPerElements_ = c_int()
+            api_basisFunctions_, api_basisFunctions_n_ = POINTER(c_double)(), c_size_t()
+            ierr = c_int()
+            lib.gmshModelMeshGetBasisFunctionsForOrientations(
+                c_int(elementType),
+                api_integrationPoints_, api_integrationPoints_n_,
+                c_char_p(functionSpaceType.encode()),
+                api_orientations_, api_orientations_n_,
+                byref(api_numComponents_),
+                byref(api_numFunctionsPerElements_),
+                byref(api_basisFunctions_), byref(api_basisFunctions_n_),
+                byref(ierr))
+            if ierr.value != 0:
+                raise ValueError(
+                    "gmshModelMeshGetBasisFunctionsForOrientations returned non-zero error code: ",
+                    ierr.value)
+            return (
+                api_numComponents_.value,
+                api_numFunctionsPerElements_.value,
+                _ovectordouble(api_basisFunctions_, api_basisFunctions_n_.value))
+
         @staticmethod
         def getKeysForElements(elementType, functionSpaceType, tag=-1, returnCoord=True):
             """
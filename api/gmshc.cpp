@@ -1194,6 +1194,49 @@ GMSH_API void gmshModelMeshPreallocateBasisFunctions(const int elementType, cons
   }
 }
 
+GMSH_API void gmshModelMeshGetBasisFunctionsOrientationForElements(const int elementType, const char * functionSpaceType, int ** orientations, size_t * orientations_n, int ** elementOrientations, size_t * elementOrientations_n, const int tag, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    std::vector<int> api_orientations_;
+    std::vector<int> api_elementOrientations_;
+    gmsh::model::mesh::getBasisFunctionsOrientationForElements(elementType, functionSpaceType, api_orientations_, api_elementOrientations_, tag);
+    vector2ptr(api_orientations_, orientations, orientations_n);
+    vector2ptr(api_elementOrientations_, elementOrientations, elementOrientations_n);
+  }
+  catch(int api_ierr_){
+    if(ierr) *ierr = api_ierr_;
+  }
+}
+
+GMSH_API int gmshModelMeshGetNumberOfOrientations(const int elementType, const char * functionSpaceType, int * ierr)
+{
+  int result_api_ = 0;
+  if(ierr) *ierr = 0;
+  try {
+    result_api_ = gmsh::model::mesh::getNumberOfOrientations(elementType, functionSpaceType);
+  }
+  catch(int api_ierr_){
+    if(ierr) *ierr = api_ierr_;
+  }
+  return result_api_;
+}
+
+GMSH_API void gmshModelMeshGetBasisFunctionsForOrientations(const int elementType, double * integrationPoints, size_t integrationPoints_n, const char * functionSpaceType, int * orientations, size_t orientations_n, int * numComponents, int * numFunctionsPerElements, double ** basisFunctions, size_t * basisFunctions_n, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    std::vector<double> api_integrationPoints_(integrationPoints, integrationPoints + integrationPoints_n);
+    std::vector<int> api_orientations_(orientations, orientations + orientations_n);
+    std::vector<double> api_basisFunctions_;
+    gmsh::model::mesh::getBasisFunctionsForOrientations(elementType, api_integrationPoints_, functionSpaceType, api_orientations_, *numComponents, *numFunctionsPerElements, api_basisFunctions_);
+    vector2ptr(api_basisFunctions_, basisFunctions, basisFunctions_n);
+  }
+  catch(int api_ierr_){
+    if(ierr) *ierr = api_ierr_;
+  }
+}
+
 GMSH_API void gmshModelMeshGetKeysForElements(const int elementType, const char * functionSpaceType, int ** keys, size_t * keys_n, double ** coord, size_t * coord_n, const int tag, const int returnCoord, int * ierr)
 {
   if(ierr) *ierr = 0;
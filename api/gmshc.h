@@ -810,6 +810,50 @@ GMSH_API void gmshModelMeshPreallocateBasisFunctions(const int elementType,
                                                      const int tag,
                                                      int * ierr);
 
+/* Get the orientations of the elements of type `elementType' in the entity of
+ * tag `tag', for the function space `functionSpaceType'. The orientation of
+ * an element determines how its edge and face basis functions are reoriented
+ * in `getBasisFunctionsForElements'. `orientations' returns the distinct
+ * orientations (integers between 0 and `getNumberOfOrientations' - 1) found
+ * among the elements, in increasing order, and `elementOrientations' returns
+ * for each element the index of its orientation in `orientations'. Together
+ * with `getBasisFunctionsForOrientations', this gives the same data as
+ * `getBasisFunctionsForElements' with one table per orientation instead of
+ * one per element. Warning: this is an experimental feature and will probably
+ * change in a future release. */
+GMSH_API void gmshModelMeshGetBasisFunctionsOrientationForElements(const int elementType,
+                                                                   const char * functionSpaceType,
+                                                                   int ** orientations, size_t * orientations_n,
+                                                                   int ** elementOrientations, size_t * elementOrientations_n,
+                                                                   const int tag,
+                                                                   int * ierr);
+
+/* Get the number of possible orientations of the elements of type
+ * `elementType' for the function space `functionSpaceType'. */
+GMSH_API int gmshModelMeshGetNumberOfOrientations(const int elementType,
+                                                  const char * functionSpaceType,
+                                                  int * ierr);
+
+/* Get the basis functions of the elements of type `elementType' with the
+ * orientations `orientations' (as returned by
+ * `getBasisFunctionsOrientationForElements') at the integration points
+ * `integrationPoints', for the function space `functionSpaceType'.
+ * `numComponents' returns the number C of components of a basis function.
+ * `numFunctionsPerElements' returns the number N of basis functions per
+ * element. `basisFunctions' returns the value of the basis functions at the
+ * integration points for each orientation: [o1g1f1,..., o1g1fN, o1g2f1,...,
+ * o2g1f1, ...] when C == 1 or [o1g1f1u, o1g1f1v,..., o1g1fNw, o1g2f1u,...,
+ * o2g1f1u, ...]. Warning: this is an experimental feature and will probably
+ * change in a future release. */
+GMSH_API void gmshModelMeshGetBasisFunctionsForOrientations(const int elementType,
+                                                            double * integrationPoints, size_t integrationPoints_n,
+                                                            const char * functionSpaceType,
+                                                            int * orientations, size_t orientations_n,
+                                                            int * numComponents,
+                                                            int * numFunctionsPerElements,
+                                                            double ** basisFunctions, size_t * basisFunctions_n,
+                                                            int * ierr);
+
 /* Generate the `keys' for the elements of type `elementType' in the entity of
  * tag `tag', for the `functionSpaceType' function space. Each key uniquely
  * identifies a basis function in the function space. If `returnCoord' is set,
@@ -283,7 +283,7 @@ void highOrderTools::applySmoothingTo(std::vector<MElement *> &all, GFace *gf)
 #elif defined(HAVE_GMM)
   linearSystemCSRGmm<double> *lsys = new linearSystemCSRGmm<double>;
 #else
-  linearSystemFull<double> *lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   // compute the straight sided positions of high order nodes that are
@@ -615,7 +615,7 @@ double highOrderTools::_applyIncrementalDisplacement(
 #elif defined(HAVE_GMM)
   linearSystemCSRGmm<double> *lsys = new linearSystemCSRGmm<double>;
 #else
-  linearSystemFull<double> *lsys = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   // assume that the mesh is OK, yet already curved
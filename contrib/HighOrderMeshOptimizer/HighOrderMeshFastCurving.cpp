@@ -25,10 +25,12 @@
 // Contributors: Thomas Toulorge, Jonathan Lambrechts
 
 #include <cstdio>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <string>
 #include <cmath>
+#include <unordered_map>
 #include "HighOrderMeshFastCurving.h"
 #include "GmshConfig.h"
 #include "GModel.h"
@@ -40,6 +42,8 @@
 #include "MPrism.h"
 #include "MEdge.h"
 #include "MFace.h"
+#include "MEdgeHash.h"
+#include "MFaceHash.h"
 #include "OS.h"
 #include "SVector3.h"
 #include "BasisFactory.h"
@@ -53,32 +57,92 @@
 
 namespace {
 
-  typedef std::map<MEdge, std::vector<MElement *>, MEdgeLessThan> MEdgeVecMEltMap;
-  typedef std::map<MFace, std::vector<MElement *>, MFaceLessThan> MFaceVecMEltMap;
+  // Elements adjacent to an edge or a face
+  class MEltRange {
+  public:
+    MEltRange(MElement *const *begin, std::size_t size)
+      : _begin(begin), _size(size)
+    {
+    }
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    MElement *operator[](std::size_t i) const { return _begin[i]; }
+
+  private:
+    MElement *const *_begin;
+    std::size_t _size;
+  };
+
+  // Edge (resp. face) -> element connectivity: the edges (faces) are numbered
+  // through a hash table, and the adjacent elements are stored contiguously
+  // for each edge (face), in the order in which they were added. Lookups do
+  // not modify the connectivity, so that columns can be searched concurrently.
+  template <class Key, class Hash, class Equal> class MEltConnectivity {
+  public:
+    void add(const Key &key, MElement *elt)
+    {
+      const std::size_t idx =
+        _index.insert(std::make_pair(key, _index.size())).first->second;
+      _incidence.push_back(std::make_pair(idx, elt));
+    }
+    // Sort the incidences added so far by edge (face)
+    void finalize()
+    {
+      _offset.assign(_index.size() + 1, 0);
+      for(std::size_t i = 0; i < _incidence.size(); i++)
+        _offset[_incidence[i].first + 1]++;
+      for(std::size_t i = 0; i < _index.size(); i++)
+        _offset[i + 1] += _offset[i];
+      _elements.resize(_incidence.size());
+      std::vector<std::size_t> pos(_offset.begin(), _offset.end() - 1);
+      for(std::size_t i = 0; i < _incidence.size(); i++)
+        _elements[pos[_incidence[i].first]++] = _incidence[i].second;
+      std::vector<std::pair<std::size_t, MElement *> >().swap(_incidence);
+    }
+    MEltRange elements(const Key &key) const
+    {
+      typename std::unordered_map<Key, std::size_t, Hash, Equal>::const_iterator
+        it = _index.find(key);
+      if(it == _index.end()) return MEltRange(0, 0);
+      return MEltRange(&_elements[_offset[it->second]],
+                       _offset[it->second + 1] - _offset[it->second]);
+    }
+
+  private:
+    std::unordered_map<Key, std::size_t, Hash, Equal> _index;
+    std::vector<std::pair<std::size_t, MElement *> > _incidence;
+    std::vector<std::size_t> _offset;
+    std::vector<MElement *> _elements;
+  };
+
+  typedef MEltConnectivity<MEdge, MEdgeHash, MEdgeEqual> MEdge2MElts;
+  typedef MEltConnectivity<MFace, MFaceHash, MFaceEqual> MFace2MElts;
 
   // Compute edge -> element connectivity (for 2D elements)
-  void calcEdge2Elements(GEntity *entity, MEdgeVecMEltMap &ed2el)
+  void calcEdge2Elements(GEntity *entity, MEdge2MElts &ed2el)
   {
     for(std::size_t iEl = 0; iEl < entity->getNumMeshElements(); iEl++) {
       MElement *elt = entity->getMeshElement(iEl);
       //    elt->setVisibility(0); // fordebug
       if(elt->getDim() == 2)
         for(int iEdge = 0; iEdge < elt->getNumEdges(); iEdge++) {
-          ed2el[elt->getEdge(iEdge)].push_back(elt);
+          ed2el.add(elt->getEdge(iEdge), elt);
         }
     }
+    ed2el.finalize();
   }
 
   // Compute face -> element connectivity (for 3D elements)
-  void calcFace2Elements(GEntity *entity, MFaceVecMEltMap &face2el)
+  void calcFace2Elements(GEntity *entity, MFace2MElts &face2el)
   {
     for(std::size_t iEl = 0; iEl < entity->getNumMeshElements(); iEl++) {
       MElement *elt = entity->getMeshElement(iEl);
       //    elt->setVisibility(0); // fordebug
       if(elt->getDim() == 3)
         for(int iFace = 0; iFace < elt->getNumFaces(); iFace++)
-          face2el[elt->getFace(iFace)].push_back(elt);
+          face2el.add(elt->getFace(iFace), elt);
     }
+    face2el.finalize();
   }
 
   void makeStraight(MElement *el, const std::set<MVertex *> &movedVert)
@@ -216,7 +280,7 @@ namespace {
       elTopEd = MEdge(elMaxEd.getVertex(1), elMaxEd.getVertex(0));
   }
 
-  void getColumnQuad(MEdgeVecMEltMap &ed2el, const FastCurvingParameters &p,
+  void getColumnQuad(const MEdge2MElts &ed2el, const FastCurvingParameters &p,
                      MEdge &elBaseEd, std::vector<MElement *> &blob,
                      MElement *&aboveElt)
   {
@@ -225,7 +289,7 @@ namespace {
     MElement *el = 0;
 
     for(int iLayer = 0; iLayer < p.maxNumLayers; iLayer++) {
-      std::vector<MElement *> newElts = ed2el[elBaseEd];
+      const MEltRange newElts = ed2el.elements(elBaseEd);
       if((iLayer > 0) && (newElts.size() < 2)) {
         aboveElt = 0;
         break;
@@ -246,7 +310,7 @@ namespace {
     }
   }
 
-  void getColumnTri(MEdgeVecMEltMap &ed2el, const FastCurvingParameters &p,
+  void getColumnTri(const MEdge2MElts &ed2el, const FastCurvingParameters &p,
                     MEdge &elBaseEd, std::vector<MElement *> &blob,
                     MElement *&aboveElt)
   {
@@ -257,7 +321,7 @@ namespace {
 
     for(int iLayer = 0; iLayer < p.maxNumLayers; iLayer++) {
       // Get first element in layer
-      std::vector<MElement *> newElts0 = ed2el[elBaseEd];
+      const MEltRange newElts0 = ed2el.elements(elBaseEd);
       if((iLayer > 0) && (newElts0.size() < 2)) {
         aboveElt = 0;
         break;
@@ -273,7 +337,7 @@ namespace {
       if(std::abs(dot(tangentBase, tangentTop0)) < maxDPIn) break;
 
       // Get second element in layer
-      std::vector<MElement *> newElts1 = ed2el[elTopEd0];
+      const MEltRange newElts1 = ed2el.elements(elTopEd0);
       if(newElts1.size() < 2) {
         aboveElt = 0;
         break;
@@ -299,13 +363,14 @@ namespace {
     }
   }
 
-  bool getColumn2D(MEdgeVecMEltMap &ed2el, const FastCurvingParameters &p,
+  bool getColumn2D(const MEdge2MElts &ed2el, const FastCurvingParameters &p,
                    const MEdge &baseEd, std::vector<MVertex *> &baseVert,
                    std::vector<MVertex *> &topPrimVert,
                    std::vector<MElement *> &blob, MElement *&aboveElt)
   {
     // Get first element and base vertices
-    std::vector<MElement *> firstElts = ed2el[baseEd];
+    const MEltRange firstElts = ed2el.elements(baseEd);
+    if(firstElts.empty()) return false;
     MElement *el = firstElts[0];
     int iFirstElEd, iDum;
     el->getEdgeInfo(baseEd, iFirstElEd, iDum);
@@ -475,7 +540,7 @@ namespace {
   }
 
   // Column of tets: assume tets obtained from subdivision of prism
-  void getColumnTet(MFaceVecMEltMap &face2el, const FastCurvingParameters &p,
+  void getColumnTet(const MFace2MElts &face2el, const FastCurvingParameters &p,
                     MFace &elBaseFace, std::vector<MElement *> &blob,
                     MElement *&aboveElt)
   {
@@ -486,7 +551,7 @@ namespace {
 
     for(int iLayer = 0; iLayer < p.maxNumLayers; iLayer++) {
       // Get first element in layer
-      std::vector<MElement *> newElts0 = face2el[elBaseFace];
+      const MEltRange newElts0 = face2el.elements(elBaseFace);
       if((iLayer > 0) && (newElts0.size() < 2)) {
         aboveElt = 0;
         break;
@@ -503,7 +568,7 @@ namespace {
       if(std::abs(dot(normBase, normTop0)) < maxDPIn) break;
 
       // Get second element in layer
-      std::vector<MElement *> newElts1 = face2el[elTopFace0];
+      const MEltRange newElts1 = face2el.elements(elTopFace0);
       if(newElts1.size() < 2) {
         aboveElt = 0;
         break;
@@ -518,7 +583,7 @@ namespace {
       if(std::abs(dot(normTop0, normTop1)) < maxDPIn) break;
 
       // Get third element in layer
-      std::vector<MElement *> newElts2 = face2el[elTopFace1];
+      const MEltRange newElts2 = face2el.elements(elTopFace1);
       if(newElts2.size() < 2) {
         aboveElt = 0;
         break;
@@ -548,7 +613,7 @@ namespace {
     }
   }
 
-  void getColumnPrismHex(int elType, MFaceVecMEltMap &face2el,
+  void getColumnPrismHex(int elType, const MFace2MElts &face2el,
                          const FastCurvingParameters &p, MFace &elBaseFace,
                          std::vector<MElement *> &blob, MElement *&aboveElt)
   {
@@ -557,7 +622,7 @@ namespace {
     MElement *el = 0;
 
     for(int iLayer = 0; iLayer < p.maxNumLayers; iLayer++) {
-      std::vector<MElement *> newElts = face2el[elBaseFace];
+      const MEltRange newElts = face2el.elements(elBaseFace);
       if((iLayer > 0) && (newElts.size() < 2)) {
         aboveElt = 0;
         break;
@@ -583,14 +648,15 @@ namespace {
     }
   }
 
-  bool getColumn3D(MFaceVecMEltMap &face2el, const FastCurvingParameters &p,
+  bool getColumn3D(const MFace2MElts &face2el, const FastCurvingParameters &p,
                    const MFace &baseFace, std::vector<MVertex *> &baseVert,
                    std::vector<MVertex *> &topPrimVert,
                    std::vector<MElement *> &blob, MElement *&aboveElt)
   {
     // Get first element and base vertices
     const int nbBaseFaceVert = baseFace.getNumVertices();
-    std::vector<MElement *> firstElts = face2el[baseFace];
+    const MEltRange firstElts = face2el.elements(baseFace);
+    if(firstElts.empty()) return false;
     MElement *el = firstElts[0];
     int iFirstElFace = -1, iDum;
     el->getFaceInfo(baseFace, iFirstElFace, iDum, iDum);
@@ -982,23 +1048,29 @@ namespace {
     return minJacDet / maxJacDet;
   }
 
-  void curveColumn(const FastCurvingParameters &p, GEntity *ent,
-                   GEntity *bndEnt, int metaElType,
-                   std::vector<MVertex *> &baseVert,
-                   const std::vector<MVertex *> &topPrimVert,
-                   MElement *aboveElt, std::vector<MElement *> &blob,
+  // Column of elements above a boundary element
+  struct BLColumn {
+    int metaElType;
+    std::vector<MVertex *> baseVert, topPrimVert;
+    std::vector<MElement *> blob;
+    MElement *aboveElt;
+    BLColumn() : metaElType(0), aboveElt(0) {}
+  };
+
+  void curveColumn(const FastCurvingParameters &p, BLColumn &col,
                    std::set<MVertex *> &movedVert, DbgOutputMeta &dbgOut)
   {
     static const double MINQUAL = 0.01, TOL = 0.01, MAXITER = 10;
 
+    const int metaElType = col.metaElType;
+    std::vector<MVertex *> &baseVert = col.baseVert;
+    const std::vector<MVertex *> &topPrimVert = col.topPrimVert;
+    MElement *aboveElt = col.aboveElt;
+    std::vector<MElement *> &blob = col.blob;
+
     // Order
     const int order = blob[0]->getPolynomialOrder();
 
-    // If 2D P2 and allowed, modify base vertices to minimize distance between
-    // wall edge and CAD
-    if((p.optimizeGeometry) && (metaElType == TYPE_QUA) && (order == 2))
-      optimizeCADDist2DP2(bndEnt, baseVert);
-
     // Create meta-element
     MetaEl metaElt(metaElType, order, baseVert, topPrimVert);
 
@@ -1036,32 +1108,28 @@ namespace {
     }
 
     // Curve elements
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
     dbgOut.addMetaEl(metaElt);
-    for(int iEl = 0; iEl < blob.size(); iEl++) {
+    for(int iEl = 0; iEl < blob.size(); iEl++)
       curveElement(metaElt, movedVert, blob[iEl]);
-      ent->curvedBLElements.insert(blob[iEl]);
-    }
   }
 
-  void curveMeshFromBndElt(MEdgeVecMEltMap &ed2el, MFaceVecMEltMap &face2el,
-                           GEntity *ent, GEntity *bndEnt, MElement *bndElt,
-                           std::set<MVertex *> movedVert,
-                           const FastCurvingParameters &p,
-                           DbgOutputMeta &dbgOut)
+  bool getColumnFromBndElt(const MEdge2MElts &ed2el,
+                           const MFace2MElts &face2el,
+                           const FastCurvingParameters &p, MElement *bndElt,
+                           BLColumn &col)
   {
     const int bndType = bndElt->getType();
-    int metaElType;
     bool foundCol;
-    std::vector<MVertex *> baseVert, topPrimVert;
-    std::vector<MElement *> blob;
-    MElement *aboveElt = 0;
     if(bndType == TYPE_LIN) { // 1D boundary
       MVertex *vb0 = bndElt->getVertex(0);
       MVertex *vb1 = bndElt->getVertex(1);
-      metaElType = TYPE_QUA;
+      col.metaElType = TYPE_QUA;
       MEdge baseEd(vb0, vb1);
-      foundCol =
-        getColumn2D(ed2el, p, baseEd, baseVert, topPrimVert, blob, aboveElt);
+      foundCol = getColumn2D(ed2el, p, baseEd, col.baseVert, col.topPrimVert,
+                             col.blob, col.aboveElt);
     }
     else { // 2D boundary
       MVertex *vb0 = bndElt->getVertex(0);
@@ -1070,37 +1138,100 @@ namespace {
       MVertex *vb3;
       if(bndType == TYPE_QUA) {
         vb3 = bndElt->getVertex(3);
-        metaElType = TYPE_HEX;
+        col.metaElType = TYPE_HEX;
       }
       else {
         vb3 = 0;
-        metaElType = TYPE_PRI;
+        col.metaElType = TYPE_PRI;
       }
       MFace baseFace(vb0, vb1, vb2, vb3);
-      foundCol = getColumn3D(face2el, p, baseFace, baseVert, topPrimVert, blob,
-                             aboveElt);
+      foundCol = getColumn3D(face2el, p, baseFace, col.baseVert,
+                             col.topPrimVert, col.blob, col.aboveElt);
+    }
+    return foundCol && !col.blob.empty();
+  }
+
+  // Greedy colouring of the columns, in the order of the columns: two columns
+  // sharing a node get different colours, so that all the columns of a colour
+  // can be curved concurrently. The columns of colour c are
+  // byColor[colorOffset[c] ... colorOffset[c + 1] - 1], in increasing order.
+  void colorColumns(const std::vector<BLColumn> &columns,
+                    std::vector<std::size_t> &colorOffset,
+                    std::vector<std::size_t> &byColor)
+  {
+    // node -> column adjacency, stored contiguously
+    std::unordered_map<MVertex *, std::size_t> vertIndex;
+    std::vector<std::pair<std::size_t, std::size_t> > incidence;
+    for(std::size_t i = 0; i < columns.size(); i++) {
+      const std::vector<MElement *> &blob = columns[i].blob;
+      for(std::size_t iEl = 0; iEl < blob.size(); iEl++) {
+        for(std::size_t iV = 0; iV < blob[iEl]->getNumVertices(); iV++) {
+          const std::size_t idx =
+            vertIndex
+              .insert(std::make_pair(blob[iEl]->getVertex(iV), vertIndex.size()))
+              .first->second;
+          incidence.push_back(std::make_pair(idx, i));
+        }
+      }
     }
-    if(!foundCol || blob.empty())
-      return; // Skip bnd. el. if top vertices not found
-    DbgOutputCol dbgOutCol;
-    dbgOutCol.addBlob(blob);
-    //  dbgOutCol.write("col_KO", bndElt->getNum());
-    if(aboveElt == 0)
-      std::cout << "DBGTT: aboveElt = 0 for bnd. elt. " << bndElt->getNum()
-                << std::endl;
-    curveColumn(p, ent, bndEnt, metaElType, baseVert, topPrimVert, aboveElt,
-                blob, movedVert, dbgOut);
-    //  dbgOutCol.write("col_OK", bndElt->getNum());
+    std::sort(incidence.begin(), incidence.end());
+    incidence.erase(std::unique(incidence.begin(), incidence.end()),
+                    incidence.end());
+    std::vector<std::size_t> vertOffset(vertIndex.size() + 1, 0);
+    for(std::size_t i = 0; i < incidence.size(); i++)
+      vertOffset[incidence[i].first + 1]++;
+    for(std::size_t i = 0; i < vertIndex.size(); i++)
+      vertOffset[i + 1] += vertOffset[i];
+
+    // column -> nodes, from the same incidences
+    std::vector<std::size_t> colOffset(columns.size() + 1, 0);
+    for(std::size_t i = 0; i < incidence.size(); i++)
+      colOffset[incidence[i].second + 1]++;
+    for(std::size_t i = 0; i < columns.size(); i++)
+      colOffset[i + 1] += colOffset[i];
+    std::vector<std::size_t> col2vert(incidence.size());
+    std::vector<std::size_t> pos(colOffset.begin(), colOffset.end() - 1);
+    for(std::size_t i = 0; i < incidence.size(); i++)
+      col2vert[pos[incidence[i].second]++] = incidence[i].first;
+
+    // smallest colour not used by a previous column sharing a node
+    std::vector<int> color(columns.size(), -1);
+    std::vector<std::size_t> used;
+    std::vector<std::size_t> count;
+    for(std::size_t i = 0; i < columns.size(); i++) {
+      for(std::size_t k = colOffset[i]; k < colOffset[i + 1]; k++) {
+        const std::size_t v = col2vert[k];
+        for(std::size_t l = vertOffset[v]; l < vertOffset[v + 1]; l++) {
+          const int c = color[incidence[l].second];
+          if(c >= 0) used[c] = i + 1;
+        }
+      }
+      std::size_t c = 0;
+      while(c < used.size() && used[c] == i + 1) c++;
+      if(c == used.size()) {
+        used.push_back(0);
+        count.push_back(0);
+      }
+      color[i] = (int)c;
+      count[c]++;
+    }
+
+    colorOffset.assign(count.size() + 1, 0);
+    for(std::size_t c = 0; c < count.size(); c++)
+      colorOffset[c + 1] = colorOffset[c] + count[c];
+    byColor.resize(columns.size());
+    pos.assign(colorOffset.begin(), colorOffset.end() - 1);
+    for(std::size_t i = 0; i < columns.size(); i++) byColor[pos[color[i]]++] = i;
   }
 
-  void getColumnsAndcurveBoundaryLayer(MEdgeVecMEltMap &ed2el,
-                                       MFaceVecMEltMap &face2el, GEntity *ent,
+  void getColumnsAndcurveBoundaryLayer(const MEdge2MElts &ed2el,
+                                       const MFace2MElts &face2el, GEntity *ent,
                                        GEntity *bndEnt,
                                        std::list<MElement *> &bndElts,
                                        const FastCurvingParameters &p,
                                        const SVector3 &normal)
   {
-    // inspired from curveMeshFromBndElt
+    // inspired from getColumnFromBndElt
 
     std::vector<std::pair<MElement *, std::vector<MElement *> > > bndEl2column;
     std::vector<MElement *> aboveElements;
@@ -1120,8 +1251,7 @@ namespace {
 
         // Check if baseEd is adjacent to an element of the face
         // (the contrary can happen with degenerate edge, see fix b91a1b822)
-        MEdgeVecMEltMap::iterator myit = ed2el.find(baseEd);
-        if(myit == ed2el.end()) {
+        if(ed2el.elements(baseEd).empty()) {
           ++it;
           continue;
         }
@@ -1177,7 +1307,7 @@ namespace {
     //  else curve3DBoundaryLayer(bndEl2column);
   }
 
-  void curveMeshFromBnd(MEdgeVecMEltMap &ed2el, MFaceVecMEltMap &face2el,
+  void curveMeshFromBnd(const MEdge2MElts &ed2el, const MFace2MElts &face2el,
                         GEntity *ent, GEntity *bndEnt,
                         const FastCurvingParameters &p, SVector3 const normal)
   {
@@ -1213,22 +1343,109 @@ namespace {
       return;
     }
 
-    // Loop over boundary elements to curve them by columns
+    // Find the columns above the boundary elements
+    const std::vector<MElement *> bndElVec(bndEl.begin(), bndEl.end());
+    std::vector<BLColumn> allColumns(bndElVec.size());
+    std::vector<char> foundCol(bndElVec.size(), 0);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for(int i = 0; i < (int)bndElVec.size(); i++)
+      foundCol[i] =
+        getColumnFromBndElt(ed2el, face2el, p, bndElVec[i], allColumns[i]);
+    std::vector<BLColumn> columns;
+    columns.reserve(bndElVec.size());
+    for(std::size_t i = 0; i < bndElVec.size(); i++) {
+      if(!foundCol[i]) continue; // Skip bnd. el. if top vertices not found
+      if(allColumns[i].aboveElt == 0)
+        std::cout << "DBGTT: aboveElt = 0 for bnd. elt. "
+                  << bndElVec[i]->getNum() << std::endl;
+      columns.push_back(BLColumn());
+      std::swap(columns.back(), allColumns[i]);
+    }
+    std::vector<BLColumn>().swap(allColumns);
+    if(columns.empty()) return;
+
+    // If 2D P2 and allowed, modify base vertices to minimize distance between
+    // wall edge and CAD. The base vertices of a column only belong to its
+    // boundary element, so that this can be done for all columns before
+    // curving them; the CAD queries of the OpenCASCADE kernel are not
+    // thread-safe, though.
+    if(p.optimizeGeometry) {
+      std::vector<std::size_t> toOptimize;
+      for(std::size_t i = 0; i < columns.size(); i++)
+        if((columns[i].metaElType == TYPE_QUA) &&
+           (columns[i].blob[0]->getPolynomialOrder() == 2))
+          toOptimize.push_back(i);
+      if(!toOptimize.empty()) {
+        // Create the basis used in the distance computation once, serially
+        MLine3 line(columns[toOptimize[0]].baseVert);
+        BasisFactory::getGradientBasis(line.getTypeForMSH(),
+                                       FuncSpaceData(&line));
+      }
+#if defined(_OPENMP)
+      const bool parallelCAD =
+        (bndEnt->getNativeType() != GEntity::OpenCascadeModel);
+#pragma omp parallel for schedule(dynamic) if(parallelCAD)
+#endif
+      for(int i = 0; i < (int)toOptimize.size(); i++)
+        optimizeCADDist2DP2(bndEnt, columns[toOptimize[i]].baseVert);
+    }
+
+    // Curve the columns colour by colour, columns of the same colour (which do
+    // not share any node) being curved concurrently: the result does not
+    // depend on the number of threads. The quality measures used to curve
+    // the outer boundary of the layer are not thread-safe, so that the
+    // columns are curved serially in that case.
     DbgOutputMeta dbgOut;
-    std::set<MVertex *> movedVert;
-    for(std::list<MElement *>::iterator itBE = bndEl.begin();
-        itBE != bndEl.end(); itBE++) // Loop over bnd. elements
-      curveMeshFromBndElt(ed2el, face2el, ent, bndEnt, *itBE, movedVert, p,
-                          dbgOut);
+    if(p.curveOuterBL != FastCurvingParameters::OUTER_NOCURVE) {
+      for(std::size_t i = 0; i < columns.size(); i++) {
+        std::set<MVertex *> movedVert;
+        curveColumn(p, columns[i], movedVert, dbgOut);
+      }
+    }
+    else {
+      // Create the bases used by the meta-elements and the elements serially
+      std::set<std::pair<int, int> > metaTypes;
+      std::set<int> types;
+      for(std::size_t i = 0; i < columns.size(); i++) {
+        const BLColumn &col = columns[i];
+        const int order = col.blob[0]->getPolynomialOrder();
+        if(metaTypes.insert(std::make_pair(col.metaElType, order)).second)
+          MetaEl metaElt(col.metaElType, order, col.baseVert, col.topPrimVert);
+        for(std::size_t iEl = 0; iEl < col.blob.size(); iEl++) {
+          if(types.insert(col.blob[iEl]->getTypeForMSH()).second) {
+            col.blob[iEl]->getFunctionSpace();
+            col.blob[iEl]->getFunctionSpace(1);
+          }
+        }
+      }
+      std::vector<std::size_t> colorOffset, byColor;
+      colorColumns(columns, colorOffset, byColor);
+      for(std::size_t c = 0; c + 1 < colorOffset.size(); c++) {
+        const int start = (int)colorOffset[c];
+        const int end = (int)colorOffset[c + 1];
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for(int i = start; i < end; i++) {
+          std::set<MVertex *> movedVert;
+          curveColumn(p, columns[byColor[i]], movedVert, dbgOut);
+        }
+      }
+    }
+    for(std::size_t i = 0; i < columns.size(); i++)
+      ent->curvedBLElements.insert(columns[i].blob.begin(),
+                                   columns[i].blob.end());
     //  dbgOut.write("meta-elements", bndEnt->tag());
   }
 
   void gather3Dcolumns(
-    MFaceVecMEltMap &face2el, GEntity *ent, GEntity *bndEnt,
+    const MFace2MElts &face2el, GEntity *ent, GEntity *bndEnt,
     const FastCurvingParameters &p,
     std::vector<std::pair<MElement *, std::vector<MElement *> > > &bndEl2column)
   {
-    // inspired from curveMeshFromBnd and curveMeshFromBndElt
+    // inspired from curveMeshFromBnd and getColumnFromBndElt
 
     if(bndEnt->dim() != 2) {
       Msg::Error("Cannot process model entity %i of dim %i", bndEnt->tag(),
@@ -1347,8 +1564,8 @@ void HighOrderMeshFastCurving(GModel *gm, FastCurvingParameters &p,
 
     // Compute edge/face -> elt. connectivity
     Msg::Info("Computing connectivity for entity %i...", gEnt->tag());
-    MEdgeVecMEltMap ed2el;
-    MFaceVecMEltMap face2el;
+    MEdge2MElts ed2el;
+    MFace2MElts face2el;
     if(p.dim == 2)
       calcEdge2Elements(gEnt, ed2el);
     else
@@ -68,8 +68,8 @@ void HighOrderMeshPeriodicity::_relocateMasterVertices()
       Msg::Info("Relocating nodes of master surface %i using slave %i",
                 master->tag(), slave->tag());
 
-      std::map<MVertex *, MVertex *> &vertS2M = slave->correspondingVertices;
-      std::map<MVertex *, MVertex *>::iterator vit;
+      MVertexPairs &vertS2M = slave->correspondingVertices;
+      MVertexPairs::iterator vit;
       for(vit = vertS2M.begin(); vit != vertS2M.end(); ++vit) {
         MFaceVertex *v = dynamic_cast<MFaceVertex *>(vit->second);
         if(v && v->onWhat() == master) {
@@ -84,7 +84,7 @@ void HighOrderMeshPeriodicity::_relocateMasterVertices()
         }
       }
 
-      std::map<MVertex *, MVertex *> &pointS2M = slave->correspondingHOPoints;
+      MVertexPairs &pointS2M = slave->correspondingHOPoints;
       for(vit = pointS2M.begin(); vit != pointS2M.end(); ++vit) {
         MFaceVertex *v = dynamic_cast<MFaceVertex *>(vit->second);
         if(v && v->onWhat() == master) {
@@ -126,9 +126,9 @@ void HighOrderMeshPeriodicity::_relocateMasterVertices()
           se->getBeginVertex() ? se->getBeginVertex()->tag() : -1,
           se->getEndVertex() ? se->getEndVertex()->tag() : -1);
 
-        std::map<MVertex *, MVertex *>::iterator vit;
+        MVertexPairs::iterator vit;
 
-        std::map<MVertex *, MVertex *> &vertS2M = slave->correspondingVertices;
+        MVertexPairs &vertS2M = slave->correspondingVertices;
         for(vit = vertS2M.begin(); vit != vertS2M.end(); ++vit) {
           MEdgeVertex *v = dynamic_cast<MEdgeVertex *>(vit->second);
           if(v && v->onWhat() == master) {
@@ -136,7 +136,7 @@ void HighOrderMeshPeriodicity::_relocateMasterVertices()
             v->setXYZ(v->x() + gp.x(), v->y() + gp.y(), v->z() + gp.z());
           }
         }
-        std::map<MVertex *, MVertex *> &pointS2M = slave->correspondingHOPoints;
+        MVertexPairs &pointS2M = slave->correspondingHOPoints;
         for(vit = pointS2M.begin(); vit != pointS2M.end(); ++vit) {
           MEdgeVertex *v = dynamic_cast<MEdgeVertex *>(vit->second);
           if(v && v->onWhat() == master) {
@@ -190,9 +190,9 @@ void HighOrderMeshPeriodicity::_copyBackMasterVertices()
       const std::vector<double> &tfo = slave->affineTransform;
       if(tfo.size() < 16) break;
 
-      std::map<MVertex *, MVertex *>::iterator vit;
+      MVertexPairs::iterator vit;
 
-      std::map<MVertex *, MVertex *> &vertS2M = slave->correspondingVertices;
+      MVertexPairs &vertS2M = slave->correspondingVertices;
       for(vit = vertS2M.begin(); vit != vertS2M.end(); ++vit) {
         MFaceVertex *sv = dynamic_cast<MFaceVertex *>(vit->first);
         MFaceVertex *mv = dynamic_cast<MFaceVertex *>(vit->second);
@@ -207,7 +207,7 @@ void HighOrderMeshPeriodicity::_copyBackMasterVertices()
 
       int idx = 0;
 
-      std::map<MVertex *, MVertex *> &pointS2M = slave->correspondingHOPoints;
+      MVertexPairs &pointS2M = slave->correspondingHOPoints;
       for(vit = pointS2M.begin(); vit != pointS2M.end(); ++vit) {
         MFaceVertex *sv = dynamic_cast<MFaceVertex *>(vit->first);
         MFaceVertex *mv = dynamic_cast<MFaceVertex *>(vit->second);
@@ -232,9 +232,9 @@ void HighOrderMeshPeriodicity::_copyBackMasterVertices()
       const std::vector<double> tfo = slave->affineTransform;
       if(tfo.size() < 16) break;
 
-      std::map<MVertex *, MVertex *>::iterator vit;
+      MVertexPairs::iterator vit;
 
-      std::map<MVertex *, MVertex *> &vertS2M = slave->correspondingVertices;
+      MVertexPairs &vertS2M = slave->correspondingVertices;
       for(vit = vertS2M.begin(); vit != vertS2M.end(); ++vit) {
         MEdgeVertex *sv = dynamic_cast<MEdgeVertex *>(vit->first);
         MEdgeVertex *mv = dynamic_cast<MEdgeVertex *>(vit->second);
@@ -252,7 +252,7 @@ void HighOrderMeshPeriodicity::_copyBackMasterVertices()
         }
       }
 
-      std::map<MVertex *, MVertex *> &pointS2M = slave->correspondingHOPoints;
+      MVertexPairs &pointS2M = slave->correspondingHOPoints;
       for(vit = pointS2M.begin(); vit != pointS2M.end(); ++vit) {
         MEdgeVertex *sv = dynamic_cast<MEdgeVertex *>(vit->first);
         MEdgeVertex *mv = dynamic_cast<MEdgeVertex *>(vit->second);
@@ -211,7 +211,7 @@ void backgroundMesh2D::propagateValues(DoubleStorageType &dirichlet,
   linearSystemCSRGmm<double> *_lsys = new linearSystemCSRGmm<double>;
   _lsys->setGmres(1);
 #else
-   linearSystemFull<double> *_lsys = new linearSystemFull<double>;
+   linearSystemCSRBuiltin<double> *_lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   dofManager<double> myAssembler(_lsys);
@@ -118,7 +118,7 @@ void backgroundMesh3D::propagateValues(DoubleStorageType &dirichlet,
   linearSystemCSRGmm<double> *lsys = new linearSystemCSRGmm<double>;
   lsys->setGmres(1);
 #else
-   linearSystemFull<double> *lsys = new linearSystemFull<double>;
+   linearSystemCSRBuiltin<double> *lsys = new linearSystemCSRBuiltin<double>;
 #endif
 
   size_t i;
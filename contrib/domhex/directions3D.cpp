@@ -1221,7 +1221,7 @@ void Size_field::solve(GRegion *gr)
 #elif defined(HAVE_GMM)
   linearSystemCSRGmm<double> *system = new linearSystemCSRGmm<double>;
 #else
-  linearSystemFull<double> *system = new linearSystemFull<double>;
+  linearSystemCSRBuiltin<double> *system = new linearSystemCSRBuiltin<double>;
 #endif
 
   size_t i;
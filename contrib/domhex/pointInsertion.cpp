@@ -443,6 +443,73 @@ void Filler2D::pointInsertion2D(GFace *gf, std::vector<MVertex *> &packed,
   }
 }
 
+// evaluation of a spawn of the 3D front
+struct spawnCandidate {
+  bool ok;
+  double h, rank[3];
+  double min[3], max[3];
+  STensor3 crossfield;
+};
+
+// evaluate the spawns of a front point: a spawn is kept if it lies in the
+// domain, far enough from the boundary, from the points already inserted and
+// from the spawns already kept for the same parent. The inserted points are
+// only read, so that front points that are far enough from each other can be
+// treated concurrently
+static void evaluateSpawns(frameFieldBackgroundMesh3D *bgm,
+                           RTree<MVertex *, double, 3, double> &rtree,
+                           MVertex *parent, std::vector<MVertex *> &spawns,
+                           bool use_vectorial_smoothness,
+                           std::vector<spawnCandidate> &candidates)
+{
+  candidates.resize(spawns.size());
+  Wrapper3D wrapper;
+  for(std::size_t i = 0; i < spawns.size(); i++) {
+    spawnCandidate &c = candidates[i];
+    c.ok = false;
+    MVertex *individual = spawns[i];
+    const double x = individual->x();
+    const double y = individual->y();
+    const double z = individual->z();
+    if(!bgm->inDomain(x, y, z)) continue;
+
+    MVertex *closest = bgm->get_nearest_neighbor(individual);
+    c.h = bgm->size(closest); // get approximate size, closest vertex, faster ?!
+    if(!far_from_boundary_3D(bgm, individual, c.h)) continue;
+
+    bgm->eval_approximate_crossfield(closest, c.crossfield);
+    fill_min_max(x, y, z, c.h, c.min, c.max);
+
+    bool ok = true;
+    for(std::size_t j = 0; j < i && ok; j++) {
+      const spawnCandidate &s = candidates[j];
+      if(!s.ok) continue;
+      bool overlap = true;
+      for(int k = 0; k < 3; k++)
+        if(c.min[k] > s.max[k] || s.min[k] > c.max[k]) overlap = false;
+      if(overlap &&
+         infinity_distance_3D(individual, spawns[j], c.crossfield) < k1 * c.h)
+        ok = false;
+    }
+    if(!ok) continue;
+
+    wrapper.set_ok(true);
+    wrapper.set_individual(individual);
+    wrapper.set_parent(parent);
+    wrapper.set_size(&c.h);
+    wrapper.set_crossfield(&c.crossfield);
+    rtree.Search(c.min, c.max, rtree_callback_3D, &wrapper);
+    if(!wrapper.get_ok()) continue;
+
+    c.ok = true;
+    if(!use_vectorial_smoothness)
+      c.rank[0] = bgm->get_smoothness(x, y, z);
+    else
+      for(int idir = 0; idir < 3; idir++)
+        c.rank[idir] = bgm->get_vectorial_smoothness(idir, x, y, z);
+  }
+}
+
 bool Filler3D::treat_region(GRegion *gr)
 {
   BGMManager::set_use_cross_field(true);
@@ -610,115 +677,127 @@ bool Filler3D::treat_region(GRegion *gr)
   // TODO: si fifo était list of *PTR -> pas de copies, gain temps ?
   Wrapper3D wrapper;
   wrapper.set_bgm(bgm);
-  MVertex *parent, *individual;
   new_vertices.clear();
-  bool spawn_created;
   int priority_counter = 0;
-  STensor3 crossfield;
-  int parent_layer;
-
-  while(!fifo->empty()) {
-    parent = fifo->get_first_vertex();
-    //    parent_limit = fifo->get_first_limit();
-    parent_layer = fifo->get_first_layer();
 
-    //    if(parent_limit!=-1 && parent_layer>=parent_limit()){
-    //      continue;
-    //    }
+  // the element octree of the background mesh is built on demand: make sure
+  // it exists before it is queried concurrently
+  bgm->getOctree();
+
+  // advance the front by batches of points: the points of a batch are taken
+  // in the order of the front, as long as their smoothness is within the
+  // rounding threshold of the smoothness of the first one, and as long as
+  // their zones of influence do not overlap (the others are put back at the
+  // head of the front; with a fifo, the batch ends at the first overlap, so
+  // that the points are processed in the same order whatever the number of
+  // threads); the spawns of the batch are then evaluated concurrently, and
+  // inserted in the order of the batch
+  const int nthreads = Msg::GetMaxThreads();
+  const std::size_t maxBatch = (nthreads > 1) ? 16 * nthreads : 1;
+  std::vector<smoothness_vertex_pair *> batch, deferred;
+  std::vector<double> boxes;
+  std::vector<std::vector<MVertex *> > spawns;
+  std::vector<std::vector<spawnCandidate> > candidates;
 
-    std::vector<MVertex *> spawns;
-    if(!use_vectorial_smoothness) {
-      spawns.resize(6);
-      computeSixNeighbors(bgm, parent, spawns, fifo->get_first_crossfield(),
-                          fifo->get_first_size());
+  while(!fifo->empty()) {
+    batch.clear();
+    deferred.clear();
+    boxes.clear();
+    for(std::size_t scanned = 0; !fifo->empty() && batch.size() < maxBatch &&
+                                 scanned < 4 * maxBatch;
+        scanned++) {
+      smoothness_vertex_pair *svp = fifo->pop_first();
+      if(batch.size() && svp->rank < batch[0]->rank - 0.05) {
+        deferred.push_back(svp);
+        break;
+      }
+      // the spawns lie at a distance size of the point, and are checked
+      // against the points in boxes of half-width sqrt3 times their size
+      fill_min_max(svp->v->x(), svp->v->y(), svp->v->z(), 2.5 * svp->size,
+                   min, max);
+      bool overlap = false;
+      for(std::size_t k = 0; k < batch.size() && !overlap; k++) {
+        const double *b = &boxes[6 * k];
+        overlap = true;
+        for(int l = 0; l < 3; l++)
+          if(min[l] > b[3 + l] || b[l] > max[l]) overlap = false;
+      }
+      if(overlap) {
+        deferred.push_back(svp);
+        if(use_fifo) break;
+        continue;
+      }
+      batch.push_back(svp);
+      boxes.insert(boxes.end(), min, min + 3);
+      boxes.insert(boxes.end(), max, max + 3);
     }
-    else {
-      spawns.resize(2);
-      computeTwoNeighbors(bgm, parent, spawns, fifo->get_first_direction(),
-                          fifo->get_first_size());
+    for(std::size_t k = deferred.size(); k > 0; k--)
+      fifo->push_first(deferred[k - 1]);
+
+    spawns.resize(batch.size());
+    candidates.resize(batch.size());
+    for(std::size_t k = 0; k < batch.size(); k++) {
+      if(!use_vectorial_smoothness) {
+        spawns[k].resize(6);
+        computeSixNeighbors(bgm, batch[k]->v, spawns[k], batch[k]->cf,
+                            batch[k]->size);
+      }
+      else {
+        spawns[k].resize(2);
+        computeTwoNeighbors(bgm, batch[k]->v, spawns[k], batch[k]->direction,
+                            batch[k]->size);
+      }
     }
-    fifo->erase_first();
-
-    //    std::cout << "while, fifo->size()=" << fifo->size() << " parent=(" <<
-    //    parent->x() << "," << parent->y() << "," << parent->z() << ")" <<
-    //    std::endl;
-
-    for(unsigned int i = 0; i < spawns.size(); i++) {
-      spawn_created = false;
-      individual = spawns[i];
-      x = individual->x();
-      y = individual->y();
-      z = individual->z();
-      //      std::cout << " working on candidate " << "(" << individual->x() <<
-      //      ","
-      //      << individual->y() << "," << individual->z() << ")" << std::endl;
-
-      if(bgm->inDomain(x, y, z)) {
-        //        std::cout << "   spawn " << i << " in domain" << std::endl;
-
-        MVertex *closest = bgm->get_nearest_neighbor(individual);
-        h =
-          bgm->size(closest); // get approximate size, closest vertex, faster ?!
-
-        if(far_from_boundary_3D(bgm, individual, h)) {
-          //        std::cout << "   spawn " << i << " far from bnd" <<
-          //        std::endl;
-          bgm->eval_approximate_crossfield(closest, crossfield);
-          wrapper.set_ok(true);
-          wrapper.set_individual(individual);
-          wrapper.set_parent(parent);
-          wrapper.set_size(&h);
-          wrapper.set_crossfield(&crossfield);
-
-          fill_min_max(x, y, z, h, min, max);
-
-          rtree.Search(min, max, rtree_callback_3D, &wrapper);
-
-          if(wrapper.get_ok()) {
-            //        std::cout << "   spawn " << i << " wrapper OK" <<
-            //        std::endl;
-
-            if(!use_vectorial_smoothness) {
-              smoothness_vertex_pair *svp = new smoothness_vertex_pair();
-              svp->v = individual;
-              svp->rank = bgm->get_smoothness(individual->x(), individual->y(),
-                                              individual->z());
-              svp->dir = 0;
-              svp->layer = parent_layer + 1;
-              svp->size = h;
-              svp->cf = crossfield;
-              fifo->insert(svp);
-              if(debug) {
-                smoothness_forplot[svp->v] = svp->rank;
-                vert_priority[individual] = priority_counter++;
-              }
-            }
-            else {
-              if(debug) vert_priority[individual] = priority_counter++;
-              for(int idir = 0; idir < 3; idir++) {
-                smoothness_vertex_pair *svp = new smoothness_vertex_pair();
-                svp->v = individual;
-                svp->rank = bgm->get_vectorial_smoothness(idir, x, y, z);
-                svp->dir = idir;
-                svp->layer = parent_layer + 1;
-                svp->size = h;
-                for(int k = 0; k < 3; k++)
-                  svp->direction(k) = crossfield(k, idir);
-                svp->cf = crossfield;
-                fifo->insert(svp);
-              }
-            }
-
-            rtree.Insert(min, max, individual);
-            new_vertices.push_back(individual);
-            spawn_created = true;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+    for(int k = 0; k < (int)batch.size(); k++)
+      evaluateSpawns(bgm, rtree, batch[k]->v, spawns[k],
+                     use_vectorial_smoothness, candidates[k]);
+
+    for(std::size_t k = 0; k < batch.size(); k++) {
+      for(std::size_t i = 0; i < spawns[k].size(); i++) {
+        MVertex *individual = spawns[k][i];
+        const spawnCandidate &c = candidates[k][i];
+        if(!c.ok) {
+          delete individual;
+          continue;
+        }
+        if(!use_vectorial_smoothness) {
+          smoothness_vertex_pair *svp = new smoothness_vertex_pair();
+          svp->v = individual;
+          svp->rank = c.rank[0];
+          svp->dir = 0;
+          svp->layer = batch[k]->layer + 1;
+          svp->size = c.h;
+          svp->cf = c.crossfield;
+          fifo->insert(svp);
+          if(debug) {
+            smoothness_forplot[svp->v] = svp->rank;
+            vert_priority[individual] = priority_counter++;
           }
         }
+        else {
+          if(debug) vert_priority[individual] = priority_counter++;
+          for(int idir = 0; idir < 3; idir++) {
+            smoothness_vertex_pair *svp = new smoothness_vertex_pair();
+            svp->v = individual;
+            svp->rank = c.rank[idir];
+            svp->dir = idir;
+            svp->layer = batch[k]->layer + 1;
+            svp->size = c.h;
+            for(int l = 0; l < 3; l++)
+              svp->direction(l) = c.crossfield(l, idir);
+            svp->cf = c.crossfield;
+            fifo->insert(svp);
+          }
+        }
+        rtree.Insert(c.min, c.max, individual);
+        new_vertices.push_back(individual);
       }
-      if(!spawn_created) {
-        delete individual;
-      }
-    } // end loop on spawns
+      delete batch[k];
+    }
   }
 
   // ProfilerStop();
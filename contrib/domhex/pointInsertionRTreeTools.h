@@ -9,7 +9,7 @@
 #define POINTINSERTIONRTREETOOLS_H
 
 #include <cmath>
-#include <queue>
+#include <deque>
 #include "MVertex.h"
 #include "STensor3.h"
 #include "BackgroundMesh3D.h"
@@ -182,6 +182,11 @@ public:
   virtual int get_first_layer() = 0;
   virtual SVector3 get_first_direction() = 0;
   virtual void erase_first() = 0;
+  // remove the first point from the list, and give its ownership to the caller
+  virtual smoothness_vertex_pair *pop_first() = 0;
+  // put back a point removed by pop_first(), ahead of the points with the same
+  // priority
+  virtual void push_first(smoothness_vertex_pair *svp) { insert(svp); }
   virtual bool empty() = 0;
 };
 
@@ -210,6 +215,12 @@ public:
     points.erase(points.begin());
     delete ptr;
   }
+  virtual smoothness_vertex_pair *pop_first()
+  {
+    smoothness_vertex_pair *ptr = *(points.begin());
+    points.erase(points.begin());
+    return ptr;
+  }
   virtual bool empty() { return points.empty(); }
 
 protected:
@@ -239,7 +250,7 @@ public:
   {
     while(!empty()) erase_first();
   };
-  virtual void insert(smoothness_vertex_pair *svp) { points.push(svp); }
+  virtual void insert(smoothness_vertex_pair *svp) { points.push_back(svp); }
   virtual unsigned int size() { return points.size(); }
   virtual MVertex *get_first_vertex() { return (points.front())->v; }
   virtual STensor3 get_first_crossfield() { return (points.front())->cf; }
@@ -253,13 +264,23 @@ public:
   virtual void erase_first()
   {
     smoothness_vertex_pair *ptr = points.front();
-    points.pop();
+    points.pop_front();
     delete ptr;
   }
+  virtual smoothness_vertex_pair *pop_first()
+  {
+    smoothness_vertex_pair *ptr = points.front();
+    points.pop_front();
+    return ptr;
+  }
+  virtual void push_first(smoothness_vertex_pair *svp)
+  {
+    points.push_front(svp);
+  }
   virtual bool empty() { return points.empty(); }
 
 protected:
-  std::queue<smoothness_vertex_pair *> points;
+  std::deque<smoothness_vertex_pair *> points;
 };
 
 #endif
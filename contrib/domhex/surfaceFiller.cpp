@@ -38,31 +38,36 @@
 //
 // we aim at generating a rectangle with sizes size_1 and size_2 along t1 and t2
 
-bool compute4neighbors(
+// small deterministic perturbation of the new points, which only depends on
+// the parent point (rand() is neither reentrant nor reproducible when several
+// fronts are advanced concurrently)
+static double perturbation(const SPoint2 &p, int k)
+{
+  const double s =
+    sin(12.9898 * p.x() + 78.233 * p.y() + 37.719 * k) * 43758.5453;
+  return 1.e-7 * (s - floor(s));
+}
+
+static bool compute4neighbors(
   GFace *gf, // the surface
-  MVertex *v_center, // the wertex for which we wnt to generate 4 neighbors
-  SPoint2 &midpoint,
+  backgroundMesh *bgm, // the background mesh of the surface
+  const SPoint3 &center, // the point for which we want to generate 4 neighbors
+  const SPoint2 &midpoint, // its parametric coordinates
   bool goNonLinear, // do we compute the position in the real surface which is
                     // nonlinear
   SPoint2 newP[4][NUMDIR], // look into other directions
   SMetric3 &metricField, FILE *crossf = 0) // the mesh metric
 {
-  // we assume that v is on surface gf
-
-  // get the parameter of the point on the surface
-  reparamMeshVertexOnFace(v_center, gf, midpoint);
-
-  double L =
-    backgroundMesh::current()->operator()(midpoint[0], midpoint[1], 0.0);
+  double L = (*bgm)(midpoint[0], midpoint[1], 0.0);
   metricField = SMetric3(1. / (L * L));
   FieldManager *fields = gf->model()->getFields();
   if(fields->getBackgroundField() > 0) {
     Field *f = fields->get(fields->getBackgroundField());
     if(!f->isotropic()) {
-      (*f)(v_center->x(), v_center->y(), v_center->z(), metricField, gf);
+      (*f)(center.x(), center.y(), center.z(), metricField, gf);
     }
     else {
-      L = (*f)(v_center->x(), v_center->y(), v_center->z(), gf);
+      L = (*f)(center.x(), center.y(), center.z(), gf);
       metricField = SMetric3(1. / (L * L));
     }
   }
@@ -88,9 +93,7 @@ bool compute4neighbors(
   SVector3 basis_v = crossprod(n, basis_u);
 
   for(int DIR = 0; DIR < NUMDIR; DIR++) {
-    double quadAngle =
-      backgroundMesh::current()->getAngle(midpoint[0], midpoint[1], 0) +
-      DIRS[DIR];
+    double quadAngle = bgm->getAngle(midpoint[0], midpoint[1], 0) + DIRS[DIR];
 
     // normalize vector t1 that is tangent to gf at midpoint
     SVector3 t1 = basis_u * cos(quadAngle) + basis_v * sin(quadAngle);
@@ -101,17 +104,17 @@ bool compute4neighbors(
     SVector3 t2 = crossprod(n, t1);
     t2.normalize();
     if(DIR == 0 && crossf)
-      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", v_center->x(),
-              v_center->y(), v_center->z(), t1.x(), t1.y(), t1.z());
+      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", center.x(),
+              center.y(), center.z(), t1.x(), t1.y(), t1.z());
     if(DIR == 0 && crossf)
-      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", v_center->x(),
-              v_center->y(), v_center->z(), t2.x(), t2.y(), t2.z());
+      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", center.x(),
+              center.y(), center.z(), t2.x(), t2.y(), t2.z());
     if(DIR == 0 && crossf)
-      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", v_center->x(),
-              v_center->y(), v_center->z(), -t1.x(), -t1.y(), -t1.z());
+      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", center.x(),
+              center.y(), center.z(), -t1.x(), -t1.y(), -t1.z());
     if(DIR == 0 && crossf)
-      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", v_center->x(),
-              v_center->y(), v_center->z(), -t2.x(), -t2.y(), -t2.z());
+      fprintf(crossf, "VP(%g,%g,%g) {%g,%g,%g};\n", center.x(),
+              center.y(), center.z(), -t2.x(), -t2.y(), -t2.z());
 
     double size_1 = sqrt(1. / dot(t1, metricField, t1));
     double size_2 = sqrt(1. / dot(t2, metricField, t2));
@@ -161,15 +164,14 @@ bool compute4neighbors(
       size_param_1 = size_param_2 = std::min(size_param_1, size_param_2);
     }
 
-    const double EPS = 1.e-7;
-    double r1 = EPS * (double)rand() / RAND_MAX;
-    double r2 = EPS * (double)rand() / RAND_MAX;
-    double r3 = EPS * (double)rand() / RAND_MAX;
-    double r4 = EPS * (double)rand() / RAND_MAX;
-    double r5 = EPS * (double)rand() / RAND_MAX;
-    double r6 = EPS * (double)rand() / RAND_MAX;
-    double r7 = EPS * (double)rand() / RAND_MAX;
-    double r8 = EPS * (double)rand() / RAND_MAX;
+    double r1 = perturbation(midpoint, 8 * DIR);
+    double r2 = perturbation(midpoint, 8 * DIR + 1);
+    double r3 = perturbation(midpoint, 8 * DIR + 2);
+    double r4 = perturbation(midpoint, 8 * DIR + 3);
+    double r5 = perturbation(midpoint, 8 * DIR + 4);
+    double r6 = perturbation(midpoint, 8 * DIR + 5);
+    double r7 = perturbation(midpoint, 8 * DIR + 6);
+    double r8 = perturbation(midpoint, 8 * DIR + 7);
     double newPoint[4][2] = {{midpoint[0] - covar1[0] * size_param_1 + r1,
                               midpoint[1] - covar1[1] * size_param_1 + r2},
                              {midpoint[0] - covar2[0] * size_param_2 + r3,
@@ -184,9 +186,9 @@ bool compute4neighbors(
     double ERR[4];
     for(int i = 0; i < 4; i++) {
       GPoint pp = gf->point(SPoint2(newPoint[i][0], newPoint[i][1]));
-      double D = sqrt((pp.x() - v_center->x()) * (pp.x() - v_center->x()) +
-                      (pp.y() - v_center->y()) * (pp.y() - v_center->y()) +
-                      (pp.z() - v_center->z()) * (pp.z() - v_center->z()));
+      double D = sqrt((pp.x() - center.x()) * (pp.x() - center.x()) +
+                      (pp.y() - center.y()) * (pp.y() - center.y()) +
+                      (pp.z() - center.z()) * (pp.z() - center.z()));
       ERR[i] = 100 * fabs(D - L) / (D + L);
     }
 
@@ -197,14 +199,14 @@ bool compute4neighbors(
         if(ERR[i] > 12) {
           double uvt[3] = {newPoint[i][0], newPoint[i][1], 0.0}; //
           curveFunctorCircle cf(
-            dirs[i], n, SVector3(v_center->x(), v_center->y(), v_center->z()),
+            dirs[i], n, SVector3(center.x(), center.y(), center.z()),
             L);
           if(intersectCurveSurface(cf, ss, uvt, size_param_1 * 1.e-3)) { //
             GPoint pp = gf->point(SPoint2(uvt[0], uvt[1]));
             double D =
-              sqrt((pp.x() - v_center->x()) * (pp.x() - v_center->x()) +
-                   (pp.y() - v_center->y()) * (pp.y() - v_center->y()) +
-                   (pp.z() - v_center->z()) * (pp.z() - v_center->z()));
+              sqrt((pp.x() - center.x()) * (pp.x() - center.x()) +
+                   (pp.y() - center.y()) * (pp.y() - center.y()) +
+                   (pp.z() - center.z()) * (pp.z() - center.z()));
             double DP =
               sqrt((newPoint[i][0] - uvt[0]) * (newPoint[i][0] - uvt[0]) +
                    (newPoint[i][1] - uvt[1]) * (newPoint[i][1] - uvt[1]));
@@ -229,6 +231,23 @@ bool compute4neighbors(
   return true;
 }
 
+bool compute4neighbors(
+  GFace *gf, // the surface
+  MVertex *v_center, // the wertex for which we wnt to generate 4 neighbors
+  SPoint2 &midpoint,
+  bool goNonLinear, // do we compute the position in the real surface which is
+                    // nonlinear
+  SPoint2 newP[4][NUMDIR], // look into other directions
+  SMetric3 &metricField, FILE *crossf = 0) // the mesh metric
+{
+  // we assume that v is on surface gf
+
+  // get the parameter of the point on the surface
+  reparamMeshVertexOnFace(v_center, gf, midpoint);
+  return compute4neighbors(gf, backgroundMesh::current(), v_center->point(),
+                           midpoint, goNonLinear, newP, metricField, crossf);
+}
+
 // recover element around vertex v and interpolate smoothness on this element...
 double get_smoothness(MVertex *v, GFace *gf,
                       const std::map<MVertex *, double> &vertices2smoothness)
@@ -747,6 +766,66 @@ void packingOfParallelogramsSmoothness(GFace *gf,
   }
 }
 
+// new point of the packing, whose mesh vertex is only created once all the
+// points of the current front batch have been computed
+struct packingCandidate {
+  SPoint3 xyz;
+  surfacePointWithExclusionRegion *sp;
+};
+
+// advance the front from one of its points: the new points are the neighbors
+// (in the first direction that gives at least one) that do not lie in the
+// exclusion region of a point already packed, nor in the one of a previous
+// new point of the same parent. The packed points are only read, so that
+// front points that are far enough from each other can be treated
+// concurrently
+static void packNeighbors(
+  GFace *gf, backgroundMesh *bgm, surfacePointWithExclusionRegion *parent,
+  RTree<surfacePointWithExclusionRegion *, double, 2, double> &rtree,
+  bool goNonLinear, FILE *crossf, std::vector<packingCandidate> &candidates)
+{
+  SMetric3 metricField(1.0);
+  SPoint2 newp[4][NUMDIR];
+  for(int dir = 0; dir < NUMDIR; dir++) {
+    for(int i = 0; i < 4; i++) {
+      const SPoint2 &p = parent->_p[i][dir];
+      if(!bgm->inDomain(p.x(), p.y(), 0)) continue;
+      bool tooClose = false;
+      for(std::size_t j = 0; j < candidates.size() && !tooClose; j++)
+        tooClose = candidates[j].sp->inExclusionZone(p);
+      if(tooClose) continue;
+      my_wrapper w(p);
+      double _min[2] = {p.x() - 1.e-1, p.y() - 1.e-1},
+             _max[2] = {p.x() + 1.e-1, p.y() + 1.e-1};
+      rtree.Search(_min, _max, rtree_callback, &w);
+      if(w._tooclose) continue;
+      GPoint gp = gf->point(p);
+      SPoint2 midpoint(gp.u(), gp.v());
+      packingCandidate c;
+      c.xyz = SPoint3(gp.x(), gp.y(), gp.z());
+      compute4neighbors(gf, bgm, c.xyz, midpoint, goNonLinear, newp,
+                        metricField, crossf);
+      c.sp = new surfacePointWithExclusionRegion(0, newp, midpoint, metricField);
+      candidates.push_back(c);
+    }
+    if(candidates.size()) break;
+  }
+}
+
+// box in which the new points of a front point (and their exclusion regions)
+// are guaranteed to lie: 3 times the exclusion region of the point
+static void influenceBox(const surfacePointWithExclusionRegion *sp,
+                         double _min[2], double _max[2])
+{
+  sp->minmax(_min, _max);
+  for(int i = 0; i < 2; i++) {
+    const double c = 0.5 * (_min[i] + _max[i]);
+    const double h = 1.5 * (_max[i] - _min[i]);
+    _min[i] = c - h;
+    _max[i] = c + h;
+  }
+}
+
 // fills a surface with points in order to build a nice quad mesh
 
 void packingOfParallelograms(GFace *gf, std::vector<MVertex *> &packed,
@@ -761,32 +840,30 @@ void packingOfParallelograms(GFace *gf, std::vector<MVertex *> &packed,
 
   const bool goNonLinear = true;
 
+  // the debug output is written by a single thread
+  const int nthreads = debug ? 1 : Msg::GetMaxThreads();
+
+  // the background mesh is attached to the calling thread
+  backgroundMesh *bgm = backgroundMesh::current();
+
   if(debug){
     std::stringstream ssa;
     ssa << "oldbgm_angles_" << gf->tag() << ".pos";
-    backgroundMesh::current()->print(ssa.str(), gf, 1);
+    bgm->print(ssa.str(), gf, 1);
   }
 
-  // get all the boundary vertices
-  std::set<MVertex *> bnd_vertices;
+  // get all the boundary vertices, in the order of the elements
+  std::vector<MVertex *> bnd_vertices;
+  std::set<MVertex *> touched;
   for(unsigned int i = 0; i < gf->getNumMeshElements(); i++) {
     MElement *element = gf->getMeshElement(i);
     for(std::size_t j = 0; j < element->getNumVertices(); j++) {
       MVertex *vertex = element->getVertex(j);
-      if(vertex->onWhat()->dim() < 2) bnd_vertices.insert(vertex);
+      if(vertex->onWhat()->dim() < 2 && touched.insert(vertex).second)
+        bnd_vertices.push_back(vertex);
     }
   }
 
-  // put boundary vertices in a fifo queue
-  std::set<surfacePointWithExclusionRegion *,
-           compareSurfacePointWithExclusionRegionPtr> fifo;
-  std::vector<surfacePointWithExclusionRegion *> vertices;
-  // put the RTREE
-  RTree<surfacePointWithExclusionRegion *, double, 2, double> rtree;
-  SMetric3 metricField(1.0);
-  SPoint2 newp[4][NUMDIR];
-  std::set<MVertex *>::iterator it = bnd_vertices.begin();
-
   char NAME[345];
   sprintf(NAME, "crossReal%d.pos", gf->tag());
   FILE *crossf = NULL;
@@ -794,46 +871,111 @@ void packingOfParallelograms(GFace *gf, std::vector<MVertex *> &packed,
     crossf = Fopen(NAME, "w");
   }
   if(crossf) fprintf(crossf, "View \"\"{\n");
-  for(; it != bnd_vertices.end(); ++it) {
+
+  // compute the neighbors of the boundary vertices
+  std::vector<surfacePointWithExclusionRegion *> vertices(bnd_vertices.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+  for(int i = 0; i < (int)bnd_vertices.size(); i++) {
+    SMetric3 metricField(1.0);
+    SPoint2 newp[4][NUMDIR];
     SPoint2 midpoint;
-    compute4neighbors(gf, *it, midpoint, goNonLinear, newp, metricField,
-                      crossf);
-    surfacePointWithExclusionRegion *sp =
-      new surfacePointWithExclusionRegion(*it, newp, midpoint, metricField);
-    fifo.insert(sp);
-    vertices.push_back(sp);
+    reparamMeshVertexOnFace(bnd_vertices[i], gf, midpoint);
+    compute4neighbors(gf, bgm, bnd_vertices[i]->point(), midpoint, goNonLinear,
+                      newp, metricField, crossf);
+    vertices[i] = new surfacePointWithExclusionRegion(bnd_vertices[i], newp,
+                                                      midpoint, metricField);
+  }
+
+  // put boundary vertices in a fifo queue
+  std::set<surfacePointWithExclusionRegion *,
+           compareSurfacePointWithExclusionRegionPtr> fifo;
+  // put the RTREE
+  RTree<surfacePointWithExclusionRegion *, double, 2, double> rtree;
+  for(std::size_t i = 0; i < vertices.size(); i++) {
+    fifo.insert(vertices[i]);
     double _min[2], _max[2];
-    sp->minmax(_min, _max);
-    rtree.Insert(_min, _max, sp);
+    vertices[i]->minmax(_min, _max);
+    rtree.Insert(_min, _max, vertices[i]);
   }
 
   //  printf("initially : %d vertices in the domain\n",vertices.size());
 
+  // advance the front by batches of points: the points of a batch are taken
+  // in the order of the front, as long as they are not farther from the
+  // boundary than the first one by more than half its size (their new points
+  // would not have been processed before them anyway), and as long as their
+  // zones of influence do not overlap; the new points of the batch are then
+  // computed concurrently, and added to the front in the order of the batch
+  const std::size_t maxBatch = (nthreads > 1) ? 16 * nthreads : 1;
+  std::vector<surfacePointWithExclusionRegion *> batch;
+  std::vector<double> boxes;
+  std::vector<std::vector<packingCandidate> > candidates;
   while(!fifo.empty()) {
-    surfacePointWithExclusionRegion *parent = *fifo.begin();
-    fifo.erase(fifo.begin());
-    for(int dir = 0; dir < NUMDIR; dir++) {
-      int countOK = 0;
-      for(int i = 0; i < 4; i++) {
-        if(!inExclusionZone(parent->_p[i][dir], rtree, vertices)) {
-          countOK++;
-          GPoint gp = gf->point(parent->_p[i][dir]);
-          MFaceVertex *v =
-            new MFaceVertex(gp.x(), gp.y(), gp.z(), gf, gp.u(), gp.v());
-          SPoint2 midpoint;
-          compute4neighbors(gf, v, midpoint, goNonLinear, newp, metricField,
-                            crossf);
-          surfacePointWithExclusionRegion *sp =
-            new surfacePointWithExclusionRegion(v, newp, midpoint, metricField,
-                                                parent);
-          fifo.insert(sp);
-          vertices.push_back(sp);
-          double _min[2], _max[2];
-          sp->minmax(_min, _max);
-          rtree.Insert(_min, _max, sp);
-        }
+    batch.clear();
+    boxes.clear();
+    double limit = (*fifo.begin())->_distanceSummed;
+    if(maxBatch > 1) {
+      fullMatrix<double> V(3, 3);
+      fullVector<double> S(3);
+      (*fifo.begin())->_meshMetric.eig(V, S);
+      const double l = std::max(std::max(S(0), S(1)), S(2));
+      limit += 0.5 / sqrt(l);
+    }
+    std::set<surfacePointWithExclusionRegion *,
+             compareSurfacePointWithExclusionRegionPtr>::iterator it =
+      fifo.begin();
+    for(std::size_t scanned = 0; it != fifo.end() &&
+                                 batch.size() < maxBatch &&
+                                 scanned < 4 * maxBatch;
+        scanned++) {
+      surfacePointWithExclusionRegion *sp = *it;
+      if(sp->_distanceSummed > limit) break;
+      double _min[2], _max[2];
+      influenceBox(sp, _min, _max);
+      bool overlap = false;
+      for(std::size_t k = 0; k < batch.size() && !overlap; k++) {
+        const double *b = &boxes[4 * k];
+        overlap = _min[0] <= b[2] && b[0] <= _max[0] && _min[1] <= b[3] &&
+                  b[1] <= _max[1];
+      }
+      if(overlap) {
+        ++it;
+        continue;
+      }
+      batch.push_back(sp);
+      boxes.push_back(_min[0]);
+      boxes.push_back(_min[1]);
+      boxes.push_back(_max[0]);
+      boxes.push_back(_max[1]);
+      fifo.erase(it++);
+    }
+
+    candidates.resize(batch.size());
+    for(std::size_t k = 0; k < batch.size(); k++) candidates[k].clear();
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+    for(int k = 0; k < (int)batch.size(); k++)
+      packNeighbors(gf, bgm, batch[k], rtree, goNonLinear, crossf,
+                    candidates[k]);
+
+    for(std::size_t k = 0; k < batch.size(); k++) {
+      surfacePointWithExclusionRegion *parent = batch[k];
+      for(std::size_t j = 0; j < candidates[k].size(); j++) {
+        const packingCandidate &c = candidates[k][j];
+        surfacePointWithExclusionRegion *sp = c.sp;
+        sp->_v = new MFaceVertex(c.xyz.x(), c.xyz.y(), c.xyz.z(), gf,
+                                 sp->_center.x(), sp->_center.y());
+        sp->_distanceSummed =
+          parent->_distanceSummed + distance(parent->_v, sp->_v);
+        fifo.insert(sp);
+        vertices.push_back(sp);
+        double _min[2], _max[2];
+        sp->minmax(_min, _max);
+        rtree.Insert(_min, _max, sp);
       }
-      if(countOK) break;
     }
   }
   if(crossf) {
@@ -854,8 +996,6 @@ void packingOfParallelograms(GFace *gf, std::vector<MVertex *> &packed,
     if(vertices[i]->_v->onWhat() == gf) {
       packed.push_back(vertices[i]->_v);
       metrics.push_back(vertices[i]->_meshMetric);
-      SPoint2 midpoint;
-      reparamMeshVertexOnFace(vertices[i]->_v, gf, midpoint);
     }
     delete vertices[i];
   }
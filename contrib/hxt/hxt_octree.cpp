@@ -1760,6 +1760,34 @@ HXTStatus hxtOctreeSearch(HXTForest *forest, std::vector<double> *x, std::vector
   return HXT_STATUS_OK;
 }
 
+static void hxtOctreeGetLeavesCallback(p4est_iter_volume_info_t * info, void *user_data){
+  std::vector<double> *leaves = (std::vector<double> *) user_data;
+  size_data_t *data = (size_data_t *) info->quad->p.user_data;
+  double min[3], max[3];
+  hxtOctreeGetBboxOctant(info->p4est, info->treeid, info->quad, min, max);
+  leaves->push_back(min[0]);
+  leaves->push_back(min[1]);
+  leaves->push_back(min[2]);
+  leaves->push_back(fmax(max[0] - min[0], fmax(max[1] - min[1], max[2] - min[2])));
+  leaves->push_back(data->size);
+}
+
+/* Export the leaves of the forest (in the order of the space filling curve of
+   p4est) as 5 doubles per leaf: the coordinates of the lower corner, the side
+   length and the size. The result does not depend on p4est anymore and can be
+   queried concurrently, or saved to disk. */
+HXTStatus hxtOctreeGetLeaves(HXTForest *forest, std::vector<double> *leaves){
+  leaves->clear();
+  leaves->reserve(5 * forest->p4est->local_num_quadrants);
+  p4est_iterate(forest->p4est, NULL, (void *) leaves, hxtOctreeGetLeavesCallback,
+                NULL,
+#ifdef P4_TO_P8
+                NULL,
+#endif
+                NULL);
+  return HXT_STATUS_OK;
+}
+
 static bool rtreeCallback(int id, void *ctx) {
   std::vector<int>* vec = reinterpret_cast< std::vector<int>* >(ctx);
   vec->push_back(id);
@@ -103,6 +103,8 @@ HXTStatus hxtForestDelete(HXTForest **forest);
 HXTStatus hxtOctreeRTreeIntersection(HXTForest *forest);
 HXTStatus hxtOctreeCurvatureRefine(HXTForest *forest, int nMax);
 HXTStatus hxtOctreeSearchOne(HXTForest *forest, double x, double y, double z, double *size);
+HXTStatus hxtOctreeSearch(HXTForest *forest, std::vector<double> *x, std::vector<double> *y, std::vector<double> *z, std::vector<double> *size);
+HXTStatus hxtOctreeGetLeaves(HXTForest *forest, std::vector<double> *leaves);
 HXTStatus hxtOctreeSurfacesProches(HXTForest *forest);
 HXTStatus hxtOctreeElementEstimation(HXTForest *forest, double *elemEstimate);
 
@@ -0,0 +1,173 @@
+// Gmsh - Copyright (C) 1997-2020 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+// Regression test for the built-in sparse solver (linearSystemCSRBuiltin):
+// sparse LDL^T factorization, with its GMRES fallback for tiny pivots and
+// inaccurate solutions, on symmetric positive definite, symmetric indefinite
+// and singular systems.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include "gmsh.h"
+#include "linearSystemCSR.h"
+
+class triplets {
+public:
+  int n;
+  std::vector<int> row, col;
+  std::vector<double> val;
+  triplets(int size) : n(size) {}
+  void add(int i, int j, double v)
+  {
+    row.push_back(i);
+    col.push_back(j);
+    val.push_back(v);
+  }
+  void mult(const std::vector<double> &x, std::vector<double> &y) const
+  {
+    y.assign(n, 0.);
+    for(std::size_t k = 0; k < val.size(); k++)
+      y[row[k]] += val[k] * x[col[k]];
+  }
+};
+
+// solve the system with right-hand side b, and return the solver status, the
+// solution x and the relative residual
+static int solve(const triplets &A, const std::vector<double> &b,
+                 std::vector<double> &x, double &residual, int maxIter = 10000)
+{
+  linearSystemCSRBuiltin<double> sys("ldlt", 1e-10);
+  sys.setMaxIterations(maxIter);
+  sys.allocate(A.n);
+  for(std::size_t k = 0; k < A.val.size(); k++)
+    sys.addToMatrix(A.row[k], A.col[k], A.val[k]);
+  for(int i = 0; i < A.n; i++) sys.addToRightHandSide(i, b[i]);
+  int status = sys.systemSolve();
+  x.resize(A.n);
+  for(int i = 0; i < A.n; i++) sys.getFromSolution(i, x[i]);
+  std::vector<double> Ax;
+  A.mult(x, Ax);
+  double r = 0., nb = 0.;
+  for(int i = 0; i < A.n; i++) {
+    r += (b[i] - Ax[i]) * (b[i] - Ax[i]);
+    nb += b[i] * b[i];
+  }
+  residual = std::sqrt(r / nb);
+  return status;
+}
+
+static int check(const char *name, bool ok)
+{
+  printf("%-50s %s\n", name, ok ? "ok" : "FAILED");
+  return ok ? 0 : 1;
+}
+
+// 1D Laplacian; with Neumann boundary conditions if "singular"
+static triplets laplacian(int n, bool singular)
+{
+  triplets A(n);
+  for(int i = 0; i < n; i++) {
+    A.add(i, i, (singular && (i == 0 || i == n - 1)) ? 1. : 2.);
+    if(i) A.add(i, i - 1, -1.);
+    if(i < n - 1) A.add(i, i + 1, -1.);
+  }
+  return A;
+}
+
+static double maxError(const std::vector<double> &x,
+                       const std::vector<double> &xe)
+{
+  double e = 0.;
+  for(std::size_t i = 0; i < x.size(); i++)
+    e = std::max(e, std::abs(x[i] - xe[i]));
+  return e;
+}
+
+int main(int argc, char **argv)
+{
+  gmsh::initialize(argc, argv, false);
+  int failed = 0;
+  double res;
+  std::vector<double> x, b;
+
+  // symmetric positive definite
+  {
+    const int n = 2000;
+    triplets A = laplacian(n, false);
+    std::vector<double> xe(n);
+    for(int i = 0; i < n; i++) xe[i] = std::sin(0.01 * i);
+    A.mult(xe, b);
+    int status = solve(A, b, x, res);
+    failed += check("SPD: solution", status == 1 && maxError(x, xe) < 1e-6);
+  }
+
+  // symmetric indefinite, with nonzero pivots
+  {
+    const int n = 2000;
+    triplets A(n);
+    for(int i = 0; i < n; i++) {
+      A.add(i, i, (i % 2) ? -4. : 4.);
+      if(i) A.add(i, i - 1, 1.);
+      if(i < n - 1) A.add(i, i + 1, 1.);
+    }
+    std::vector<double> xe(n);
+    for(int i = 0; i < n; i++) xe[i] = std::cos(0.01 * i);
+    A.mult(xe, b);
+    int status = solve(A, b, x, res);
+    failed += check("indefinite: solution",
+                    status == 1 && maxError(x, xe) < 1e-6);
+  }
+
+  // symmetric indefinite saddle point problem, with a zero diagonal block
+  // (zero pivots in the factorization without pivoting)
+  {
+    const int m = 200, n = 2 * m;
+    triplets A(n);
+    for(int i = 0; i < m; i++) {
+      A.add(i, i, 2.);
+      if(i) A.add(i, i - 1, -1.);
+      if(i < m - 1) A.add(i, i + 1, -1.);
+      A.add(i, m + i, 1.);
+      A.add(m + i, i, 1.);
+    }
+    std::vector<double> xe(n);
+    for(int i = 0; i < n; i++) xe[i] = 1. + 0.001 * i;
+    A.mult(xe, b);
+    int status = solve(A, b, x, res);
+    failed += check("saddle point: solution",
+                    status == 1 && maxError(x, xe) < 1e-6);
+  }
+
+  // singular, with a consistent right-hand side: any solution is fine
+  {
+    const int n = 50;
+    triplets A = laplacian(n, true);
+    std::vector<double> xe(n);
+    for(int i = 0; i < n; i++) xe[i] = std::sin(0.1 * i);
+    A.mult(xe, b);
+    int status = solve(A, b, x, res);
+    failed += check("singular, consistent: residual",
+                    status == 1 && res < 1e-8);
+  }
+
+  // singular, with an inconsistent right-hand side: the solver must report
+  // the failure, without producing NaNs
+  {
+    const int n = 50;
+    triplets A = laplacian(n, true);
+    b.assign(n, 1.);
+    int status = solve(A, b, x, res, 500);
+    bool finite = true;
+    for(int i = 0; i < n; i++)
+      if(!std::isfinite(x[i])) finite = false;
+    failed += check("singular, inconsistent: failure reported",
+                    status == 0 && finite);
+  }
+
+  gmsh::finalize();
+  return failed ? 1 : 0;
+}